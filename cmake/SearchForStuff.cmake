@@ -565,6 +565,10 @@ if (PKG_CONFIG_FOUND)
     add_definitions( -DLIBBULLET_VERSION_GT_282 )
   endif()
 
+  if (BULLET_VERSION VERSION_GREATER 2.87)
+    add_definitions( -DLIBBULLET_VERSION_GT_287 )
+  endif()
+
   ########################################
   # Find libusb
   pkg_check_modules(libusb-1.0 libusb-1.0)
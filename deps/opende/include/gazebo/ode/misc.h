@@ -53,6 +53,12 @@ ODE_API int dRandInt (int n);
 /* return a random real number between 0..1 */
 ODE_API dReal dRandReal(void);
 
+/* reentrant versions of dRand and dRandInt, which advance the seed given
+ * by the caller instead of the global one.
+ */
+ODE_API unsigned long dRandR(unsigned long *seed);
+ODE_API int dRandIntR(unsigned long *seed, int n);
+
 /* print out a matrix */
 #ifdef __cplusplus
 ODE_API void dPrintMatrix (const dReal *A, int n, int m, char *fmt = "%10.4f ",
@@ -83,6 +83,72 @@ ODE_API dBodyID dWorldGetBody(dWorldID world, int id);
  */
 ODE_API void dWorldDestroy (dWorldID world);
 
+/**
+ * @brief Get the size of the buffer needed by dWorldSaveState.
+ * @ingroup world
+ * @param world the identifier of the world.
+ * @return the size in bytes, which changes when bodies or joints are added
+ * or removed.
+ */
+ODE_API size_t dWorldGetStateSize (dWorldID world);
+
+/**
+ * @brief Save the state of a world that changes as it steps.
+ *
+ * This includes the poses, velocities, force accumulators, enabled flags
+ * and auto-disable counters of the bodies, the lambdas used to warm start
+ * the joints, the unwrapped joint angles, and the random number seed of
+ * the world, so restoring one world leaves the others alone.
+ * Contact joints are not saved, since they are created again by the next
+ * collision pass. The buffer is only valid for this world, while no body
+ * or joint is added or removed.
+ *
+ * The geoms of every body are marked as moved, in the same order as
+ * dWorldRestoreState does, so that the simple and hash spaces report the
+ * colliding pairs in the same order after saving and after restoring.
+ *
+ * @ingroup world
+ * @param world the identifier of the world.
+ * @param buffer storage of at least dWorldGetStateSize bytes.
+ */
+ODE_API void dWorldSaveState (dWorldID world, void *buffer);
+
+/**
+ * @brief Restore the state saved by dWorldSaveState, bit for bit.
+ *
+ * Contact joints are left untouched, and should be emptied by the caller.
+ *
+ * @ingroup world
+ * @param world the identifier of the world.
+ * @param buffer the saved state.
+ * @param size size of the buffer in bytes.
+ * @return 1 on success, or 0 if the buffer does not match the bodies and
+ * joints of the world, in which case the world is not changed.
+ */
+ODE_API int dWorldRestoreState (dWorldID world, const void *buffer,
+    size_t size);
+
+/**
+ * @brief Set the random number seed of a world.
+ *
+ * The solvers of a world draw their random numbers from its own seed, so
+ * worlds stepped on different threads neither share nor race on the
+ * global seed of dRandSetSeed. A new world starts from the global seed.
+ *
+ * @ingroup world
+ * @param world the identifier of the world.
+ * @param seed the new seed.
+ */
+ODE_API void dWorldSetRandSeed (dWorldID world, unsigned long seed);
+
+/**
+ * @brief Get the random number seed of a world.
+ * @ingroup world
+ * @param world the identifier of the world.
+ * @return the current seed, which advances as the world draws numbers.
+ */
+ODE_API unsigned long dWorldGetRandSeed (dWorldID world);
+
 
 /**
  * @brief Set the world's global gravity vector.
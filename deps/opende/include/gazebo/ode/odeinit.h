@@ -65,7 +65,7 @@ extern "C" {
  * after creation. See description of the function for more details.
  *
  * If @c dInitFlagManualThreadCleanup was not specified during initialization,
- * calls to @c dCleanupODEAllDataForThread are not allowed.
+ * @c dCleanupODEAllDataForThread only releases collision detection data early.
  *
  * @see dInitODE2
  * @see dAllocateODEDataForThread
@@ -194,7 +194,9 @@ ODE_API int dAllocateODEDataForThread(unsigned int uiAllocateFlags);
  * were using ODE.
  *
  * If library was initialized without @c dInitFlagManualThreadCleanup flag
- * @c dCleanupODEAllDataForThread must not be called.
+ * the function only releases the collision detection data of current thread, which
+ * is otherwise kept until the thread exits. The data is allocated again by the next
+ * call to @c dAllocateODEDataForThread.
  *
  * @see dAllocateODEDataForThread
  * @see dInitODE2
@@ -32,8 +32,14 @@ static unsigned long seed = 0;
 
 unsigned long dRand()
 {
-  seed = (1664525UL*seed + 1013904223UL) & 0xffffffff;
-  return seed;
+  return dRandR(&seed);
+}
+
+
+unsigned long dRandR(unsigned long *s)
+{
+  *s = (1664525UL*(*s) + 1013904223UL) & 0xffffffff;
+  return *s;
 }
 
 
@@ -62,14 +68,20 @@ int dTestRand()
 }
 
 
-// adam's all-int straightforward(?) dRandInt (0..n-1)
 int dRandInt (int n)
+{
+  return dRandIntR(&seed, n);
+}
+
+
+// adam's all-int straightforward(?) dRandInt (0..n-1)
+int dRandIntR (unsigned long *s, int n)
 {
   // seems good; xor-fold and modulus
   const unsigned long un = n;
   // Since there is no memory barrier macro in ODE assign via volatile variable 
   // to prevent compiler reusing seed as value of `r'
-  volatile unsigned long raw_r = dRand();
+  volatile unsigned long raw_r = dRandR(s);
   unsigned long r = raw_r;
   
   // note: probably more aggressive than it needs to be -- might be
@@ -202,6 +202,7 @@ struct dxWorld : public dBase {
   dxContactParameters contactp;
   dxDampingParameters dampingp; // damping parameters
   dReal max_angular_speed;      // limit the angular velocity to this magnitude
+  unsigned long rand_seed;      // random number state of this world's solvers
   boost::threadpool::pool *threadpool;
   boost::threadpool::pool *row_threadpool;
 };
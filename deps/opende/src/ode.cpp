@@ -1680,6 +1680,7 @@ dxWorld * dWorldCreate()
   w->dampingp.linear_threshold = REAL(0.01) * REAL(0.01);
   w->dampingp.angular_threshold = REAL(0.01) * REAL(0.01);
   w->max_angular_speed = dInfinity;
+  w->rand_seed = dRandGetSeed();
 
   w->threadpool = NULL; // new boost::threadpool::pool(0);
   w->row_threadpool = NULL; // new boost::threadpool::pool(0);
@@ -1760,6 +1761,256 @@ void dWorldDestroy (dxWorld *w)
   delete w;
 }
 
+//****************************************************************************
+// world state snapshots
+
+// Header of a world state buffer.
+struct dxWorldStateHeader
+{
+  size_t size;          // size of the whole buffer
+  int nb;               // number of bodies
+  int nj;               // number of joints, excluding contact joints
+  unsigned long seed;   // random number seed
+};
+
+// State of a body that changes as the world steps. It is followed by the
+// average_samples entries of the linear and angular velocity buffers.
+struct dxBodyState
+{
+  dxBody *body;         // identity of the body, checked on restore
+  unsigned flags;
+  dxPosR posr;
+  dQuaternion q;
+  dVector3 lvel,avel;
+  dVector3 facc,tacc;
+  dVector3 finite_rot_axis;
+  dReal adis_timeleft;
+  int adis_stepsleft;
+  unsigned int average_counter;
+  int average_ready;
+  unsigned int average_samples;
+};
+
+// State of a joint that changes as the world steps: the lambdas used to
+// warm start the next step, and the angles that don't wrap at +/-pi.
+struct dxJointState
+{
+  dxJoint *joint;       // identity of the joint, checked on restore
+  dReal lambda[6];
+  dReal lambda_erp[6];
+  dReal cumulative_angle[2];
+};
+
+static dReal *jointCumulativeAngle (dxJoint *j, int i)
+{
+  switch (j->type()) {
+  case dJointTypeHinge:
+    return i == 0 ? &static_cast<dxJointHinge*>(j)->cumulative_angle : 0;
+  case dJointTypeScrew:
+    return i == 0 ? &static_cast<dxJointScrew*>(j)->cumulative_angle : 0;
+  case dJointTypeUniversal:
+    return i == 0 ? &static_cast<dxJointUniversal*>(j)->cumulative_angle1 :
+                    &static_cast<dxJointUniversal*>(j)->cumulative_angle2;
+  case dJointTypeGearbox:
+    return i == 0 ? &static_cast<dxJointGearbox*>(j)->cumulative_angle1 :
+                    &static_cast<dxJointGearbox*>(j)->cumulative_angle2;
+  default:
+    return 0;
+  }
+}
+
+// The order in which the spaces report colliding pairs follows the order
+// in which their geoms were last moved, and that order changes the contact
+// joints and so the solution. Saving and restoring both move the geoms of
+// every body in the same order, so that stepping after either gives the
+// same results.
+static void markBodyGeomsMoved (dxWorld *w)
+{
+  for (dxBody *b = w->firstbody; b; b = (dxBody*)b->next) {
+    for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
+      dGeomMoved (geom);
+  }
+}
+
+size_t dWorldGetStateSize (dWorldID w)
+{
+  dAASSERT (w);
+  size_t size = sizeof(dxWorldStateHeader);
+  for (dxBody *b = w->firstbody; b; b = (dxBody*)b->next)
+    size += sizeof(dxBodyState) + 2 * b->adis.average_samples * sizeof(dVector3);
+  for (dxJoint *j = w->firstjoint; j; j = (dxJoint*)j->next) {
+    if (j->type() != dJointTypeContact)
+      size += sizeof(dxJointState);
+  }
+  return size;
+}
+
+void dWorldSaveState (dWorldID w, void *buffer)
+{
+  dAASSERT (w && buffer);
+  char *out = static_cast<char*>(buffer);
+
+  dxWorldStateHeader header;
+  header.size = dWorldGetStateSize (w);
+  header.nb = 0;
+  header.nj = 0;
+  header.seed = w->rand_seed;
+  char *headerOut = out;
+  out += sizeof(header);
+
+  for (dxBody *b = w->firstbody; b; b = (dxBody*)b->next) {
+    dxBodyState state;
+    memset (&state,0,sizeof(state));
+    state.body = b;
+    state.flags = b->flags;
+    state.posr = b->posr;
+    memcpy (state.q,b->q,sizeof(dQuaternion));
+    memcpy (state.lvel,b->lvel,sizeof(dVector3));
+    memcpy (state.avel,b->avel,sizeof(dVector3));
+    memcpy (state.facc,b->facc,sizeof(dVector3));
+    memcpy (state.tacc,b->tacc,sizeof(dVector3));
+    memcpy (state.finite_rot_axis,b->finite_rot_axis,sizeof(dVector3));
+    state.adis_timeleft = b->adis_timeleft;
+    state.adis_stepsleft = b->adis_stepsleft;
+    state.average_counter = b->average_counter;
+    state.average_ready = b->average_ready;
+    state.average_samples = b->adis.average_samples;
+    memcpy (out,&state,sizeof(state));
+    out += sizeof(state);
+
+    const size_t bufferSize = state.average_samples * sizeof(dVector3);
+    if (bufferSize > 0) {
+      memcpy (out,b->average_lvel_buffer,bufferSize);
+      out += bufferSize;
+      memcpy (out,b->average_avel_buffer,bufferSize);
+      out += bufferSize;
+    }
+    header.nb++;
+  }
+
+  for (dxJoint *j = w->firstjoint; j; j = (dxJoint*)j->next) {
+    if (j->type() == dJointTypeContact)
+      continue;
+    dxJointState state;
+    memset (&state,0,sizeof(state));
+    state.joint = j;
+    memcpy (state.lambda,j->lambda,sizeof(state.lambda));
+    memcpy (state.lambda_erp,j->lambda_erp,sizeof(state.lambda_erp));
+    for (int i = 0; i < 2; i++) {
+      const dReal *angle = jointCumulativeAngle (j,i);
+      if (angle)
+        state.cumulative_angle[i] = *angle;
+    }
+    memcpy (out,&state,sizeof(state));
+    out += sizeof(state);
+    header.nj++;
+  }
+
+  memcpy (headerOut,&header,sizeof(header));
+  markBodyGeomsMoved (w);
+}
+
+int dWorldRestoreState (dWorldID w, const void *buffer, size_t size)
+{
+  dAASSERT (w && buffer);
+  const char *in = static_cast<const char*>(buffer);
+
+  // Check that the buffer matches the bodies and joints of the world
+  // before changing anything.
+  dxWorldStateHeader header;
+  if (size < sizeof(header))
+    return 0;
+  memcpy (&header,in,sizeof(header));
+  if (header.size != size || header.size != dWorldGetStateSize (w))
+    return 0;
+
+  const char *check = in + sizeof(header);
+  int nb = 0;
+  for (dxBody *b = w->firstbody; b; b = (dxBody*)b->next, nb++) {
+    dxBodyState state;
+    memcpy (&state,check,sizeof(state));
+    if (state.body != b || state.average_samples != b->adis.average_samples)
+      return 0;
+    check += sizeof(state) + 2 * state.average_samples * sizeof(dVector3);
+  }
+  int nj = 0;
+  for (dxJoint *j = w->firstjoint; j; j = (dxJoint*)j->next) {
+    if (j->type() == dJointTypeContact)
+      continue;
+    dxJointState state;
+    memcpy (&state,check,sizeof(state));
+    if (state.joint != j)
+      return 0;
+    check += sizeof(state);
+    nj++;
+  }
+  if (nb != header.nb || nj != header.nj)
+    return 0;
+
+  in += sizeof(header);
+  for (dxBody *b = w->firstbody; b; b = (dxBody*)b->next) {
+    dxBodyState state;
+    memcpy (&state,in,sizeof(state));
+    in += sizeof(state);
+
+    b->flags = state.flags;
+    b->posr = state.posr;
+    memcpy (b->q,state.q,sizeof(dQuaternion));
+    memcpy (b->lvel,state.lvel,sizeof(dVector3));
+    memcpy (b->avel,state.avel,sizeof(dVector3));
+    memcpy (b->facc,state.facc,sizeof(dVector3));
+    memcpy (b->tacc,state.tacc,sizeof(dVector3));
+    memcpy (b->finite_rot_axis,state.finite_rot_axis,sizeof(dVector3));
+    b->adis_timeleft = state.adis_timeleft;
+    b->adis_stepsleft = state.adis_stepsleft;
+    b->average_counter = state.average_counter;
+    b->average_ready = state.average_ready;
+
+    const size_t bufferSize = state.average_samples * sizeof(dVector3);
+    if (bufferSize > 0) {
+      memcpy (b->average_lvel_buffer,in,bufferSize);
+      in += bufferSize;
+      memcpy (b->average_avel_buffer,in,bufferSize);
+      in += bufferSize;
+    }
+
+  }
+
+  for (dxJoint *j = w->firstjoint; j; j = (dxJoint*)j->next) {
+    if (j->type() == dJointTypeContact)
+      continue;
+    dxJointState state;
+    memcpy (&state,in,sizeof(state));
+    in += sizeof(state);
+
+    memcpy (j->lambda,state.lambda,sizeof(state.lambda));
+    memcpy (j->lambda_erp,state.lambda_erp,sizeof(state.lambda_erp));
+    for (int i = 0; i < 2; i++) {
+      dReal *angle = jointCumulativeAngle (j,i);
+      if (angle)
+        *angle = state.cumulative_angle[i];
+    }
+  }
+
+  w->rand_seed = header.seed;
+  markBodyGeomsMoved (w);
+  return 1;
+}
+
+
+void dWorldSetRandSeed (dWorldID w, unsigned long seed)
+{
+  dAASSERT (w);
+  w->rand_seed = seed;
+}
+
+
+unsigned long dWorldGetRandSeed (dWorldID w)
+{
+  dAASSERT (w);
+  return w->rand_seed;
+}
+
 
 void dWorldSetGravity (dWorldID w, dReal x, dReal y, dReal z)
 {
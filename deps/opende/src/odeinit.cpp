@@ -459,7 +459,23 @@ static bool gzInternalAllocateODEDataForThread(unsigned int uiAllocateFlags)
 static void gzInternalCleanupODEAllDataForThread()
 {
 #if dTLS_ENABLED
-	GZCOdeTls::CleanupForThread();
+	if (gzIsODEModeInitialized(OIM_MANUALTLSCLEANUP))
+	{
+		GZCOdeTls::CleanupForThread();
+	}
+
+	// With automatic cleanup the TLS slot is released on thread exit, but
+	// threads of a pool may outlive their use of collision detection by far.
+	// Release their collision data now; it is allocated again on demand.
+	if (gzIsODEModeInitialized(OIM_AUTOTLSCLEANUP))
+	{
+		const unsigned uDataAllocationFlags = GZCOdeTls::gzGetDataAllocationFlags(OTK_AUTOCLEANUP);
+
+		if (uDataAllocationFlags & TLD_INTERNAL_COLLISIONDATA_ALLOCATED)
+		{
+			FreeThreadCollisionData(OIM_AUTOTLSCLEANUP);
+		}
+	}
 #endif
 }
 
@@ -512,7 +512,7 @@ void dxQuickStepper (dxWorldProcessContext *context,
                caccel,caccel_erp,cforce,
                rhs,rhs_erp,rhs_precon,
                lo,hi,cfm,findex,
-               &world->qs
+               &world->qs, &world->rand_seed
 #ifdef USE_TPROW
                , world->row_threadpool
 #endif
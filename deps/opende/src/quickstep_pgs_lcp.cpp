@@ -274,7 +274,7 @@ static void* ComputeRows(void *p)
       #endif
       //  int swapi = dRandInt(i+1); // swap across engire matrix
       for (int i=startRow+1; i<startRow+nRows; i++) { // swap within boundary of our own segment
-        int swapi = dRandInt(i+1-startRow)+startRow; // swap within boundary of our own segment
+        int swapi = dRandIntR(params->rand_seed,i+1-startRow)+startRow; // swap within boundary of our own segment
         //printf("xxxxxxxx>id %d swaping order[%d].index=%d order[%d].index=%d\n",thread_id,i,order[i].index,swapi,order[swapi].index);
         IndexError tmp = order[i];
         order[i] = order[swapi];
@@ -975,7 +975,7 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
+  dxQuickStepParameters *qs, unsigned long *rand_seed
 #ifdef USE_TPROW
   , boost::threadpool::pool* row_threadpool
 #endif
@@ -1267,6 +1267,7 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
       params_erp[thread_id].vnew  = vnew_erp;  /// \TODO need to allocate vnew_erp
 #endif
       params_erp[thread_id].qs  = qs;
+      params_erp[thread_id].rand_seed = rand_seed;
       // if every one reorders constraints, this might just work
       // comment out below if using defaults (0 and m) so every
       // thread runs through all joints
@@ -1335,6 +1336,7 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     params[thread_id].vnew  = vnew;
 #endif
     params[thread_id].qs  = qs;
+    params[thread_id].rand_seed = rand_seed;
     // if every one reorders constraints, this might just work
     // comment out below if using defaults (0 and m) so every
     // thread runs through all joints
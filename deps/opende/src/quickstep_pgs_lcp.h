@@ -43,7 +43,7 @@ void PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
+  dxQuickStepParameters *qs, unsigned long *rand_seed
 #ifdef USE_TPROW
   , boost::threadpool::pool* row_threadpool
 #endif
@@ -129,6 +129,7 @@ struct dxPGSLCPParameters {
     bool inline_position_correction;
     bool position_correction_thread;
     dxQuickStepParameters *qs;
+    unsigned long *rand_seed; // random number state of the world
     int nStart;   // 0
     int nChunkSize;
     int m; // m
@@ -147,6 +147,8 @@ bool Server::ParseArgs(int _argc, char **_argv)
   visibleDesc.add_options()
     ("version,v", "Output version information.")
     ("verbose", "Increase the messages written to the terminal.")
+    ("async_log", "Write the console messages from a background thread, "
+     "collapsing repeated messages.")
     ("help,h", "Produce this help message.")
     ("pause,u", "Start the server in a paused state.")
     ("physics,e", po::value<std::string>(),
@@ -164,6 +166,9 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("record_resources", "Recording with model meshes and materials.")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
+    ("batch", po::value<unsigned int>(),
+     "Run N independent copies of the world, named <world>_<i>, each on "
+     "its own thread and with its own random number seed.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
      "Load a plugin.")
@@ -225,6 +230,9 @@ bool Server::ParseArgs(int _argc, char **_argv)
     gazebo::common::Console::SetQuiet(false);
   }
 
+  if (this->dataPtr->vm.count("async_log"))
+    gazebo::common::Console::SetAsync(true);
+
   if (this->dataPtr->vm.count("minimal_comms"))
     gazebo::transport::setMinimalComms(true);
   else
@@ -282,6 +290,20 @@ bool Server::ParseArgs(int _argc, char **_argv)
     }
   }
 
+  if (this->dataPtr->vm.count("batch"))
+  {
+    if (this->dataPtr->vm.count("play"))
+    {
+      gzerr << "Log playback can't run a batch of worlds, "
+            << "ignoring --batch\n";
+    }
+    else
+    {
+      this->dataPtr->params["batch"] = boost::lexical_cast<std::string>(
+          this->dataPtr->vm["batch"].as<unsigned int>());
+    }
+  }
+
   if (!this->PreLoad())
   {
     gzerr << "Unable to load gazebo\n";
@@ -455,8 +477,40 @@ bool Server::LoadImpl(sdf::ElementPtr _elem,
     }
   }
 
+  unsigned int batch = 0;
+  common::StrStr_M::iterator biter = this->dataPtr->params.find("batch");
+  if (biter != this->dataPtr->params.end())
+  {
+    try
+    {
+      batch = boost::lexical_cast<unsigned int>(biter->second);
+    }
+    catch(...)
+    {
+      gzerr << "Unable to cast batch[" << biter->second << "] "
+        << "to unsigned integer\n";
+    }
+  }
+
   sdf::ElementPtr worldElem = _elem->GetElement("world");
-  if (worldElem)
+  if (worldElem && batch > 1)
+  {
+    // Create the copies of the world, which share the parsed SDF and the
+    // meshes, and step independently
+    try
+    {
+      physics::create_world_batch(worldElem, batch,
+          ignition::math::Rand::Seed());
+    }
+    catch(common::Exception &e)
+    {
+      gzthrow("Failed to load the batch of Worlds\n"  << e);
+    }
+
+    gzmsg << "Running a batch of " << batch << " copies of world ["
+          << worldElem->Get<std::string>("name") << "]\n";
+  }
+  else if (worldElem)
   {
     physics::WorldPtr world = physics::create_world();
 
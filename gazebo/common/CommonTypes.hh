@@ -81,6 +81,7 @@ namespace gazebo
     class MouseEvent;
     class NumericAnimation;
     class Param;
+    class PluginUsage;
     class PoseAnimation;
     class SkeletonAnimation;
     class SphericalCoordinates;
@@ -123,6 +124,10 @@ namespace gazebo
     /// \def BatteryPtr
     /// \brief Standrd shared pointer to a Battery object
     typedef std::shared_ptr<Battery> BatteryPtr;
+
+    /// \def PluginUsagePtr
+    /// \brief Standard shared pointer to a PluginUsage object
+    typedef std::shared_ptr<PluginUsage> PluginUsagePtr;
   }
 
   namespace event
@@ -14,7 +14,17 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/regex.hpp>
@@ -37,6 +47,562 @@ Logger Console::warn("[Wrn] ", 33, Logger::STDERR);
 
 bool Console::quiet = true;
 
+namespace
+{
+  /// \brief Number of messages each thread can queue.
+  const uint64_t kConsoleRingSize = 1024;
+
+  /// \brief Time between two writes of the queued messages.
+  const std::chrono::milliseconds kConsoleWritePeriod(10);
+
+  /// \brief True when the messages are written by the queue.
+  std::atomic<bool> g_consoleAsync(false);
+
+  /// \brief True once the calling thread's console state is destroyed, so
+  /// that messages written during the exit of the thread are not queued.
+  thread_local bool t_consoleGone = false;
+
+  /// \brief A message line waiting to be written.
+  struct ConsoleRecord
+  {
+    /// \brief Order of the message among all threads.
+    uint64_t seq = 0;
+
+    /// \brief Wall time the message was queued at.
+    common::Time time;
+
+    /// \brief Line, with its prefix and call site, ending in a newline.
+    std::string text;
+
+    /// \brief File and line of the message, empty if unknown.
+    std::string callsite;
+
+    /// \brief Terminal color.
+    int color = 0;
+
+    /// \brief True to write to stderr instead of stdout.
+    bool toStderr = false;
+
+    /// \brief False for messages written to the log file only.
+    bool terminal = true;
+  };
+
+  /// \brief Messages of one thread, written by that thread and read by the
+  /// background thread, without locks.
+  class ConsoleRing
+  {
+    /// \brief Add a message.
+    /// \param[in] _record The message.
+    /// \return False if the ring is full.
+    public: bool Push(ConsoleRecord &&_record)
+    {
+      const uint64_t tail = this->tail.load(std::memory_order_relaxed);
+      if (tail - this->head.load(std::memory_order_acquire) >=
+          kConsoleRingSize)
+      {
+        return false;
+      }
+      this->slots[tail % kConsoleRingSize] = std::move(_record);
+      this->tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Remove the oldest message.
+    /// \param[out] _record The message.
+    /// \return False if the ring is empty.
+    public: bool Pop(ConsoleRecord &_record)
+    {
+      const uint64_t head = this->head.load(std::memory_order_relaxed);
+      if (head == this->tail.load(std::memory_order_acquire))
+        return false;
+      _record = std::move(this->slots[head % kConsoleRingSize]);
+      this->head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    /// \brief Check whether the ring holds no message.
+    /// \return True if empty.
+    public: bool Empty() const
+    {
+      return this->head.load(std::memory_order_acquire) ==
+          this->tail.load(std::memory_order_acquire);
+    }
+
+    /// \brief Messages.
+    public: std::vector<ConsoleRecord> slots =
+        std::vector<ConsoleRecord>(kConsoleRingSize);
+
+    /// \brief Index of the next message to read.
+    public: std::atomic<uint64_t> head{0};
+
+    /// \brief Index of the next message to write.
+    public: std::atomic<uint64_t> tail{0};
+
+    /// \brief Number of messages dropped because the ring was full.
+    public: std::atomic<uint64_t> dropped{0};
+  };
+
+  /// \brief State of a thread that writes messages in asynchronous mode.
+  struct ConsoleThread
+  {
+    /// \brief Queue the messages left without a newline, before the copies
+    /// of the loggers go away.
+    ~ConsoleThread()
+    {
+      for (auto &local : this->streams)
+      {
+        auto buf = dynamic_cast<std::stringbuf *>(local.second->rdbuf());
+        if (buf && !buf->str().empty())
+          (*local.second) << '\n';
+      }
+      this->streams.clear();
+      t_consoleGone = true;
+    }
+
+    /// \brief Ring of the thread, created on its first message.
+    std::shared_ptr<ConsoleRing> ring;
+
+    /// \brief The thread's copy of each logger, keyed by the logger.
+    std::vector<std::pair<const void *, std::unique_ptr<std::ostream>>>
+        streams;
+  };
+
+  /// \brief State of the calling thread.
+  thread_local ConsoleThread t_console;
+
+  /// \brief Message rate limit of a call site.
+  struct ConsoleBucket
+  {
+    /// \brief Messages that can be written now.
+    double tokens = -1;
+
+    /// \brief Time the tokens were counted at.
+    common::Time time;
+
+    /// \brief Messages dropped since the last one written.
+    uint64_t suppressed = 0;
+  };
+
+  /// \brief Background thread writing the messages of all the rings.
+  class ConsoleQueue
+  {
+    /// \brief Get the queue.
+    /// \return The queue, created on the first call.
+    public: static ConsoleQueue &Instance()
+    {
+      static ConsoleQueue queue;
+      return queue;
+    }
+
+    /// \brief Destructor. Writes the queued messages.
+    public: ~ConsoleQueue()
+    {
+      g_consoleAsync = false;
+      this->Stop();
+    }
+
+    /// \brief Start the background thread.
+    public: void Start()
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->thread.joinable())
+        return;
+      this->stop = false;
+      this->thread = std::thread(&ConsoleQueue::Run, this);
+    }
+
+    /// \brief Write the queued messages and stop the background thread.
+    public: void Stop()
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->thread.joinable())
+          return;
+        this->stop = true;
+      }
+      this->wakeCond.notify_all();
+      this->thread.join();
+    }
+
+    /// \brief Wait until the queued messages are written.
+    public: void Flush()
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      if (!this->thread.joinable() || this->stop)
+        return;
+      const uint64_t target = ++this->flushRequested;
+      this->wakeCond.notify_all();
+      this->doneCond.wait(lock, [&]
+          {
+            return this->flushDone >= target || this->stop;
+          });
+    }
+
+    /// \brief Queue a message of the calling thread.
+    /// \param[in] _record The message.
+    public: void Push(ConsoleRecord &&_record)
+    {
+      ConsoleThread &local = t_console;
+      if (!local.ring)
+      {
+        local.ring = std::make_shared<ConsoleRing>();
+        std::lock_guard<std::mutex> lock(this->ringsMutex);
+        this->rings.push_back(local.ring);
+      }
+
+      _record.seq = this->seq.fetch_add(1, std::memory_order_relaxed);
+      if (!local.ring->Push(std::move(_record)))
+        local.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// \brief Set the rate limit of a call site.
+    /// \param[in] _callsite File and line, empty for the default.
+    /// \param[in] _rate Messages per second, zero for no limit.
+    public: void SetRateLimit(const std::string &_callsite,
+                const double _rate)
+    {
+      std::lock_guard<std::mutex> lock(this->ratesMutex);
+      if (_callsite.empty())
+        this->defaultRate = std::max(0.0, _rate);
+      else if (_rate > 0)
+        this->rates[_callsite] = _rate;
+      else
+        this->rates.erase(_callsite);
+    }
+
+    /// \brief Write the queued messages periodically, or when asked to.
+    private: void Run()
+    {
+      while (true)
+      {
+        uint64_t requested;
+        bool stopping;
+        {
+          std::unique_lock<std::mutex> lock(this->mutex);
+          this->wakeCond.wait_for(lock, kConsoleWritePeriod, [&]
+              {
+                return this->stop || this->flushRequested > this->flushDone;
+              });
+          requested = this->flushRequested;
+          stopping = this->stop;
+        }
+
+        this->Write(requested > this->flushDone || stopping);
+
+        {
+          std::lock_guard<std::mutex> lock(this->mutex);
+          this->flushDone = requested;
+        }
+        this->doneCond.notify_all();
+
+        if (stopping)
+          break;
+      }
+    }
+
+    /// \brief Write the messages of all the rings.
+    /// \param[in] _all True to also write the count of the repeats of the
+    /// last message.
+    private: void Write(const bool _all)
+    {
+      std::vector<std::shared_ptr<ConsoleRing>> current;
+      {
+        std::lock_guard<std::mutex> lock(this->ringsMutex);
+        // Forget the rings of the threads that are gone once they are read
+        this->rings.erase(std::remove_if(this->rings.begin(),
+              this->rings.end(), [](const std::shared_ptr<ConsoleRing> &_r)
+              {
+                return _r.use_count() == 1 && _r->Empty();
+              }), this->rings.end());
+        current = this->rings;
+      }
+
+      uint64_t dropped = 0;
+      this->batch.clear();
+      for (auto &ring : current)
+      {
+        ConsoleRecord record;
+        while (ring->Pop(record))
+          this->batch.push_back(std::move(record));
+        dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+      }
+      std::sort(this->batch.begin(), this->batch.end(),
+          [](const ConsoleRecord &_a, const ConsoleRecord &_b)
+          {
+            return _a.seq < _b.seq;
+          });
+
+      const common::Time now = common::Time::GetWallTime();
+      for (auto &record : this->batch)
+      {
+        if (!this->Allow(record))
+          continue;
+
+        // Collapse the repeats of the last message
+        if (this->repeats >= 0 && record.text == this->last.text &&
+            record.callsite == this->last.callsite &&
+            record.terminal == this->last.terminal)
+        {
+          if (this->repeats++ == 0)
+            this->repeatStart = now;
+          continue;
+        }
+        this->WriteRepeats();
+        this->Output(record);
+        this->last = std::move(record);
+        this->repeats = 0;
+      }
+
+      if (this->repeats > 0 &&
+          (_all || now - this->repeatStart >= common::Time::Second))
+      {
+        this->WriteRepeats();
+      }
+
+      if (dropped > 0)
+      {
+        ConsoleRecord record;
+        record.time = now;
+        record.text = "[Wrn] " + std::to_string(dropped) +
+            " console messages dropped, the queue was full\n";
+        record.color = 33;
+        record.toStderr = true;
+        this->Output(record);
+      }
+
+      this->Commit();
+    }
+
+    /// \brief Check the rate limit of a message's call site.
+    /// \param[in,out] _record The message, to which the number of
+    /// dropped messages is added.
+    /// \return False if the message is over the limit.
+    private: bool Allow(ConsoleRecord &_record)
+    {
+      if (_record.callsite.empty())
+        return true;
+
+      double rate;
+      {
+        std::lock_guard<std::mutex> lock(this->ratesMutex);
+        auto iter = this->rates.find(_record.callsite);
+        rate = iter != this->rates.end() ? iter->second : this->defaultRate;
+      }
+
+      if (!(rate > 0))
+        return true;
+
+      // Token bucket, holding up to a second of messages
+      ConsoleBucket &bucket = this->buckets[_record.callsite];
+      const double burst = std::max(1.0, rate);
+      if (bucket.tokens < 0)
+        bucket.tokens = burst;
+      else
+      {
+        bucket.tokens = std::min(burst, bucket.tokens +
+            (_record.time - bucket.time).Double() * rate);
+      }
+      bucket.time = _record.time;
+
+      if (bucket.tokens < 1)
+      {
+        ++bucket.suppressed;
+        return false;
+      }
+      bucket.tokens -= 1;
+
+      if (bucket.suppressed > 0)
+      {
+        _record.text.insert(_record.text.size() - 1, " [" +
+            std::to_string(bucket.suppressed) + " similar messages dropped]");
+        bucket.suppressed = 0;
+      }
+      return true;
+    }
+
+    /// \brief Write the count of the repeats of the last message.
+    private: void WriteRepeats()
+    {
+      if (this->repeats <= 0)
+        return;
+
+      ConsoleRecord record(this->last);
+      record.time = common::Time::GetWallTime();
+      record.text = "Last message repeated " +
+          std::to_string(this->repeats) + " times\n";
+      this->Output(record);
+      this->repeats = 0;
+    }
+
+    /// \brief Add a message to the output.
+    /// \param[in] _record The message.
+    private: void Output(const ConsoleRecord &_record)
+    {
+      std::ostringstream stamp;
+      stamp << "(" << _record.time << ") ";
+      this->fileOut += stamp.str() + _record.text;
+
+      if (!_record.terminal || Console::GetQuiet())
+        return;
+
+      std::string &out = _record.toStderr ? this->stderrOut : this->stdoutOut;
+#ifndef _WIN32
+      out += "\033[1;" + std::to_string(_record.color) + "m" + _record.text +
+          "\033[0m";
+#else
+      out += _record.text;
+#endif
+    }
+
+    /// \brief Write the output to the terminal and the log file.
+    private: void Commit()
+    {
+      if (!this->stdoutOut.empty())
+      {
+        std::cout << this->stdoutOut;
+        std::cout.flush();
+        this->stdoutOut.clear();
+      }
+      if (!this->stderrOut.empty())
+      {
+        std::cerr << this->stderrOut;
+        this->stderrOut.clear();
+      }
+      if (!this->fileOut.empty())
+      {
+        Console::log << this->fileOut;
+        Console::log.flush();
+        this->fileOut.clear();
+      }
+    }
+
+    /// \brief Rings of all the threads.
+    private: std::vector<std::shared_ptr<ConsoleRing>> rings;
+
+    /// \brief Protects the rings.
+    private: std::mutex ringsMutex;
+
+    /// \brief Order of the next message.
+    private: std::atomic<uint64_t> seq{0};
+
+    /// \brief Rate limits of the call sites.
+    private: std::map<std::string, double> rates;
+
+    /// \brief Rate limit of the other call sites.
+    private: double defaultRate = 0;
+
+    /// \brief Protects the rate limits.
+    private: std::mutex ratesMutex;
+
+    /// \brief Token buckets of the rate limited call sites.
+    private: std::map<std::string, ConsoleBucket> buckets;
+
+    /// \brief Messages read from the rings.
+    private: std::vector<ConsoleRecord> batch;
+
+    /// \brief Last message written.
+    private: ConsoleRecord last;
+
+    /// \brief Number of repeats of the last message, -1 before the first
+    /// message.
+    private: int64_t repeats = -1;
+
+    /// \brief Time of the first repeat not written.
+    private: common::Time repeatStart;
+
+    /// \brief Output for stdout.
+    private: std::string stdoutOut;
+
+    /// \brief Output for stderr.
+    private: std::string stderrOut;
+
+    /// \brief Output for the log file.
+    private: std::string fileOut;
+
+    /// \brief Background thread.
+    private: std::thread thread;
+
+    /// \brief True to stop the background thread.
+    private: bool stop = false;
+
+    /// \brief Number of flushes asked for.
+    private: uint64_t flushRequested = 0;
+
+    /// \brief Number of flushes done.
+    private: uint64_t flushDone = 0;
+
+    /// \brief Protects the thread, stop and the flush counts.
+    private: std::mutex mutex;
+
+    /// \brief Wakes the background thread.
+    private: std::condition_variable wakeCond;
+
+    /// \brief Signals a flush.
+    private: std::condition_variable doneCond;
+  };
+
+  /// \brief Queue the complete lines of a thread's copy of a logger.
+  /// \param[in,out] _buf Buffer of the copy, left with the incomplete line.
+  /// \param[in,out] _header Text written before the first line, cleared.
+  /// \param[in] _callsite File and line of the message.
+  /// \param[in] _color Terminal color.
+  /// \param[in] _toStderr True to write to stderr.
+  /// \param[in] _terminal False to write to the log file only.
+  void queueLines(std::stringbuf &_buf, std::string &_header,
+      const std::string &_callsite, const int _color, const bool _toStderr,
+      const bool _terminal)
+  {
+    const std::string text = _buf.str();
+    std::size_t start = 0;
+    std::size_t end;
+    while ((end = text.find('\n', start)) != std::string::npos)
+    {
+      ConsoleRecord record;
+      record.time = common::Time::GetWallTime();
+      record.text = _header + text.substr(start, end + 1 - start);
+      record.callsite = _callsite;
+      record.color = _color;
+      record.toStderr = _toStderr;
+      record.terminal = _terminal;
+      ConsoleQueue::Instance().Push(std::move(record));
+      _header.clear();
+      start = end + 1;
+    }
+
+    if (start > 0)
+      _buf.str(text.substr(start));
+  }
+
+  /// \brief Check whether the calling thread queues its messages.
+  /// \return True in asynchronous mode, until the thread exits.
+  bool queueMessages()
+  {
+    return g_consoleAsync && !t_consoleGone;
+  }
+
+  /// \brief Get the calling thread's copy of a logger.
+  /// \param[in] _logger The logger.
+  /// \return The copy, null if there is none yet.
+  std::ostream *localStream(const void *_logger)
+  {
+    for (auto &local : t_console.streams)
+    {
+      if (local.first == _logger)
+        return local.second.get();
+    }
+    return nullptr;
+  }
+
+  /// \brief Add the calling thread's copy of a logger.
+  /// \param[in] _logger The logger.
+  /// \param[in] _stream The copy, owned by the thread from now on.
+  void addLocalStream(const void *_logger, std::ostream *_stream)
+  {
+    t_console.streams.emplace_back(_logger,
+        std::unique_ptr<std::ostream>(_stream));
+  }
+}
+
 //////////////////////////////////////////////////
 void Console::SetQuiet(bool _quiet)
 {
@@ -49,6 +615,49 @@ bool Console::GetQuiet()
   return quiet;
 }
 
+//////////////////////////////////////////////////
+void Console::SetAsync(const bool _async)
+{
+  if (_async)
+  {
+    ConsoleQueue::Instance().Start();
+    g_consoleAsync = true;
+  }
+  else if (g_consoleAsync)
+  {
+    g_consoleAsync = false;
+    ConsoleQueue::Instance().Stop();
+  }
+}
+
+//////////////////////////////////////////////////
+bool Console::Async()
+{
+  return g_consoleAsync;
+}
+
+//////////////////////////////////////////////////
+void Console::Flush()
+{
+  if (g_consoleAsync)
+    ConsoleQueue::Instance().Flush();
+}
+
+//////////////////////////////////////////////////
+void Console::SetRateLimit(const std::string &_file, const int _line,
+    const double _rate)
+{
+  const std::size_t index = _file.find_last_of("/") + 1;
+  ConsoleQueue::Instance().SetRateLimit(
+      _file.substr(index) + ":" + std::to_string(_line), _rate);
+}
+
+//////////////////////////////////////////////////
+void Console::SetDefaultRateLimit(const double _rate)
+{
+  ConsoleQueue::Instance().SetRateLimit("", _rate);
+}
+
 /////////////////////////////////////////////////
 Logger::Logger(const std::string &_prefix, int _color, LogType _type)
   : std::ostream(new Buffer(_type, _color)), color(_color), prefix(_prefix)
@@ -65,6 +674,9 @@ Logger::~Logger()
 /////////////////////////////////////////////////
 Logger &Logger::operator()()
 {
+  if (queueMessages())
+    return this->Local("", 0);
+
   Console::log << "(" << Time::GetWallTime() << ") ";
   (*this) << this->prefix;
 
@@ -74,6 +686,9 @@ Logger &Logger::operator()()
 /////////////////////////////////////////////////
 Logger &Logger::operator()(const std::string &_file, int _line)
 {
+  if (queueMessages())
+    return this->Local(_file, _line);
+
   int index = _file.find_last_of("/") + 1;
 
   Console::log << "(" << Time::GetWallTime() << ") ";
@@ -86,6 +701,35 @@ Logger &Logger::operator()(const std::string &_file, int _line)
   return (*this);
 }
 
+/////////////////////////////////////////////////
+Logger &Logger::Local(const std::string &_file, int _line)
+{
+  Logger *local = static_cast<Logger *>(localStream(this));
+  if (!local)
+  {
+    local = new Logger(this->prefix, this->color,
+        static_cast<Buffer *>(this->rdbuf())->type);
+    static_cast<Buffer *>(local->rdbuf())->async = true;
+    addLocalStream(this, local);
+  }
+
+  // A message without a newline ends where the next one starts
+  Buffer *buf = static_cast<Buffer *>(local->rdbuf());
+  if (!buf->str().empty())
+    (*local) << '\n';
+
+  buf->header = this->prefix;
+  buf->callsite.clear();
+  if (!_file.empty())
+  {
+    const std::size_t index = _file.find_last_of("/") + 1;
+    buf->callsite = _file.substr(index) + ":" + std::to_string(_line);
+    buf->header += "[" + buf->callsite + "] ";
+  }
+
+  return *local;
+}
+
 /////////////////////////////////////////////////
 Logger::Buffer::Buffer(LogType _type, int _color)
   :  type(_type), color(_color)
@@ -109,6 +753,13 @@ Logger::Buffer::~Buffer()
 /////////////////////////////////////////////////
 int Logger::Buffer::sync()
 {
+  if (this->async)
+  {
+    queueLines(*this, this->header, this->callsite, this->color,
+        this->type == Logger::STDERR, true);
+    return 0;
+  }
+
   // Log messages to disk
   Console::log << this->str();
   Console::log.flush();
@@ -226,6 +877,9 @@ void FileLogger::Init(const std::string &_prefix, const std::string &_filename)
 /////////////////////////////////////////////////
 FileLogger &FileLogger::operator()()
 {
+  if (queueMessages())
+    return this->Local();
+
   (*this) << "(" << Time::GetWallTime() << ") ";
   return (*this);
 }
@@ -234,12 +888,38 @@ FileLogger &FileLogger::operator()()
 FileLogger &FileLogger::operator()(const std::string &_file, int _line)
 {
   int index = _file.find_last_of("/") + 1;
+  if (queueMessages())
+  {
+    FileLogger &local = this->Local();
+    local << "[" << _file.substr(index , _file.size() - index) << ":"
+      << _line << "]";
+    return local;
+  }
+
   (*this) << "(" << Time::GetWallTime() << ") ["
     << _file.substr(index , _file.size() - index) << ":" << _line << "]";
 
   return (*this);
 }
 
+/////////////////////////////////////////////////
+FileLogger &FileLogger::Local()
+{
+  FileLogger *local = static_cast<FileLogger *>(localStream(this));
+  if (!local)
+  {
+    local = new FileLogger("");
+    static_cast<Buffer *>(local->rdbuf())->async = true;
+    addLocalStream(this, local);
+  }
+
+  // A message without a newline ends where the next one starts
+  if (!static_cast<Buffer *>(local->rdbuf())->str().empty())
+    (*local) << '\n';
+
+  return *local;
+}
+
 /////////////////////////////////////////////////
 std::string FileLogger::GetMasterPort()
 {
@@ -291,6 +971,13 @@ FileLogger::Buffer::~Buffer()
 /////////////////////////////////////////////////
 int FileLogger::Buffer::sync()
 {
+  if (this->async)
+  {
+    std::string header;
+    queueLines(*this, header, "", 0, false, false);
+    return 0;
+  }
+
   if (!this->stream)
     return -1;
 
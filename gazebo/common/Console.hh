@@ -103,6 +103,11 @@ namespace gazebo
       /// \return Full path of the directory.
       public: std::string GetLogDirectory() const;
 
+      /// \brief Get the copy of this logger used by the calling thread in
+      /// asynchronous mode.
+      /// \return Reference to the copy.
+      private: FileLogger &Local();
+
       /// \brief Get the port of the master.
       /// \return The port of the master.
       private: static std::string GetMasterPort();
@@ -124,6 +129,10 @@ namespace gazebo
 
                    /// \brief Stream to output information into.
                    public: std::ofstream *stream;
+
+                   /// \brief True if this is a thread's copy of the logger,
+                   /// which queues its lines, see Console::SetAsync.
+                   public: bool async = false;
                  };
 
       /// \brief Stores the full path of the directory where all the log files
@@ -190,8 +199,27 @@ namespace gazebo
                    /// parameters (SGR). See
                    /// http://en.wikipedia.org/wiki/ANSI_escape_code#Colors
                    public: int color;
+
+                   /// \brief True if this is a thread's copy of the logger,
+                   /// which queues its lines, see Console::SetAsync.
+                   public: bool async = false;
+
+                   /// \brief Prefix and call site written before the next
+                   /// queued line.
+                   public: std::string header;
+
+                   /// \brief File and line of the message being written,
+                   /// empty if unknown.
+                   public: std::string callsite;
                  };
 
+      /// \brief Get the copy of this logger used by the calling thread in
+      /// asynchronous mode, ready for a new message.
+      /// \param[in] _file Filename of the message, may be empty.
+      /// \param[in] _line Line number in the _file.
+      /// \return Reference to the copy.
+      private: Logger &Local(const std::string &_file, int _line);
+
       /// \brief Color for the output.
       public: int color;
 
@@ -212,6 +240,41 @@ namespace gazebo
       /// \return True to if quiet output is set.
       public: static bool GetQuiet();
 
+      /// \brief Write the messages from a background thread. Each thread
+      /// queues its messages in its own lock-free ring, and the background
+      /// thread writes them to the terminal and the log file. Consecutive
+      /// repeats of a message are written once, followed by their count,
+      /// and the messages of a call site can be rate limited. A message
+      /// is queued when its line ends; a message without a newline is
+      /// queued with the next message of the same thread. When a ring is
+      /// full, its messages are dropped and counted. Disabled by default.
+      /// \param[in] _async True to write from a background thread.
+      public: static void SetAsync(const bool _async);
+
+      /// \brief Get whether the messages are written from a background
+      /// thread.
+      /// \return True if asynchronous.
+      public: static bool Async();
+
+      /// \brief Wait until the queued messages are written. Does nothing
+      /// when not asynchronous.
+      public: static void Flush();
+
+      /// \brief Limit the rate of the messages of a call site, in
+      /// asynchronous mode. The messages over the limit are dropped, and
+      /// their number is added to the next message written.
+      /// \param[in] _file Filename of the call site, such as __FILE__.
+      /// \param[in] _line Line number of the call site.
+      /// \param[in] _rate Maximum messages per second, zero for no limit.
+      public: static void SetRateLimit(const std::string &_file,
+                  const int _line, const double _rate);
+
+      /// \brief Limit the rate of the messages of every call site without
+      /// its own limit, in asynchronous mode.
+      /// \param[in] _rate Maximum messages per second, zero for no limit,
+      /// which is the default.
+      public: static void SetDefaultRateLimit(const double _rate);
+
       /// \brief Global instance of the message logger.
       public: static Logger msg;
 
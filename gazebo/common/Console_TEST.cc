@@ -18,6 +18,8 @@
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
 #include <stdlib.h>
+#include <thread>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/Console.hh"
@@ -274,6 +276,104 @@ TEST_F(Console_TEST, ColorErr)
   EXPECT_TRUE(logContent.find(logString) != std::string::npos);
 }
 
+/////////////////////////////////////////////////
+/// \brief Count the occurrences of a string.
+/// \param[in] _content String to search.
+/// \param[in] _str String to count.
+/// \return Number of occurrences.
+int Count(const std::string &_content, const std::string &_str)
+{
+  int count = 0;
+  for (auto pos = _content.find(_str); pos != std::string::npos;
+       pos = _content.find(_str, pos + 1))
+  {
+    ++count;
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+/// \brief Test the messages written from a background thread
+TEST_F(Console_TEST, Async)
+{
+  gazebo::common::Console::SetAsync(true);
+  EXPECT_TRUE(gazebo::common::Console::Async());
+
+  // Messages of several threads
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([t]()
+        {
+          for (int i = 0; i < g_messageRepeat; ++i)
+            gzwarn << "async thread " << t << " message " << i << std::endl;
+        });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  // Repeats are written once, with their count
+  for (int i = 0; i < 50; ++i)
+    gzerr << "async repeated error" << std::endl;
+
+  // A message without a newline ends at the next one
+  gzlog << "async log without newline";
+  gzlog << "async log next" << std::endl;
+
+  gazebo::common::Console::Flush();
+  std::string logContent = this->GetLogContent();
+
+  for (int t = 0; t < 4; ++t)
+  {
+    for (int i = 0; i < g_messageRepeat; ++i)
+    {
+      std::ostringstream stream;
+      stream << "async thread " << t << " message " << i;
+      EXPECT_EQ(Count(logContent, stream.str()), 1);
+    }
+  }
+  EXPECT_EQ(Count(logContent, "async repeated error"), 1);
+  EXPECT_EQ(Count(logContent, "repeated 49 times"), 1);
+  EXPECT_EQ(Count(logContent, "async log without newline"), 1);
+  EXPECT_EQ(Count(logContent, "async log next"), 1);
+
+  gazebo::common::Console::SetAsync(false);
+  EXPECT_FALSE(gazebo::common::Console::Async());
+}
+
+/////////////////////////////////////////////////
+/// \brief Test the rate limit of a call site
+TEST_F(Console_TEST, AsyncRateLimit)
+{
+  gazebo::common::Console::SetAsync(true);
+
+  // One message per second from the call site in the lambda
+  const int line = __LINE__ + 3;
+  auto warn = [](const int _i)
+  {
+    gzwarn << "rate limited " << _i << std::endl;
+  };
+  gazebo::common::Console::SetRateLimit(__FILE__, line, 1.0);
+
+  for (int i = 0; i < 10; ++i)
+    warn(i);
+  gazebo::common::Console::Flush();
+  std::string logContent = this->GetLogContent();
+  EXPECT_EQ(Count(logContent, "rate limited "), 1);
+  EXPECT_EQ(Count(logContent, "rate limited 0"), 1);
+
+  // The next message reports how many were dropped
+  gazebo::common::Time::Sleep(gazebo::common::Time(1.1));
+  warn(10);
+  gazebo::common::Console::Flush();
+  logContent = this->GetLogContent();
+  EXPECT_EQ(Count(logContent, "rate limited 10 [9 similar messages dropped]"),
+      1);
+
+  gazebo::common::Console::SetRateLimit(__FILE__, line, 0);
+  gazebo::common::Console::SetAsync(false);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -15,10 +15,20 @@
  *
 */
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <algorithm>
+#include <thread>
 #include <boost/filesystem.hpp>
 #include <gazebo/gazebo_config.h>
 
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
 #ifdef HAVE_GDAL
 # pragma GCC diagnostic push
 # pragma GCC diagnostic ignored "-Wfloat-equal"
@@ -38,6 +48,163 @@ using namespace common;
 
 #ifdef HAVE_GDAL
 
+/// \brief Side of a square tile of DEM data, in samples.
+static const unsigned int kDemTileSize = 256;
+
+//////////////////////////////////////////////////
+/// \brief Decode one tile of the scaled raster into the DEM data. If
+/// another thread is already decoding the tile, wait for it instead.
+/// \param[in] _data DEM data.
+/// \param[in] _band Band to read from.
+/// \param[in] _bandMutex Mutex to lock while reading from the band, or
+/// null if the band is owned by the calling thread.
+/// \param[in] _tile Tile index.
+static void DecodeTile(DemPrivate &_data, GDALRasterBand *_band,
+    std::mutex *_bandMutex, const unsigned int _tile)
+{
+  int state = 0;
+  if (!_data.tileStates[_tile].compare_exchange_strong(state, 1))
+  {
+    while (_data.tileStates[_tile].load() != 2)
+      std::this_thread::yield();
+    return;
+  }
+
+  // Tiles in the padding are left at zero
+  const unsigned int x0 = (_tile % _data.tileCount) * kDemTileSize;
+  const unsigned int y0 = (_tile / _data.tileCount) * kDemTileSize;
+  if (x0 < _data.destWidth && y0 < _data.destHeight)
+  {
+    const unsigned int width = std::min(kDemTileSize, _data.destWidth - x0);
+    const unsigned int height = std::min(kDemTileSize, _data.destHeight - y0);
+    const int xSize = _band->GetXSize();
+    const int ySize = _band->GetYSize();
+    const double xRatio = static_cast<double>(xSize) / _data.destWidth;
+    const double yRatio = static_cast<double>(ySize) / _data.destHeight;
+
+    // Read the part of the raster covered by the tile, with the same
+    // scaling as if the whole raster was read at once.
+    GDALRasterIOExtraArg extraArg;
+    INIT_RASTERIO_EXTRA_ARG(extraArg);
+    extraArg.bFloatingPointWindowValidity = TRUE;
+    extraArg.dfXOff = x0 * xRatio;
+    extraArg.dfYOff = y0 * yRatio;
+    extraArg.dfXSize = width * xRatio;
+    extraArg.dfYSize = height * yRatio;
+
+    const int xOff = static_cast<int>(floor(extraArg.dfXOff));
+    const int yOff = static_cast<int>(floor(extraArg.dfYOff));
+    const int xCount = std::min(xSize - xOff,
+        static_cast<int>(ceil(extraArg.dfXOff + extraArg.dfXSize)) - xOff);
+    const int yCount = std::min(ySize - yOff,
+        static_cast<int>(ceil(extraArg.dfYOff + extraArg.dfYSize)) - yOff);
+
+    std::unique_lock<std::mutex> lock;
+    if (_bandMutex)
+      lock = std::unique_lock<std::mutex>(*_bandMutex);
+
+    if (_band->RasterIO(GF_Read, xOff, yOff, xCount, yCount,
+          _data.demData + static_cast<size_t>(y0) * _data.side + x0,
+          width, height, GDT_Float32, sizeof(float),
+          sizeof(float) * static_cast<GSpacing>(_data.side),
+          &extraArg) != CE_None)
+    {
+      gzerr << "Failure calling RasterIO while loading a DEM file\n";
+    }
+  }
+
+  _data.tileStates[_tile] = 2;
+}
+
+/// \brief Decodes tiles of a DEM in parallel, each worker reading from its
+/// own dataset. Optionally computes the elevation range of each tile.
+class DecodeTiles_TBB
+{
+  /// \brief Constructor.
+  /// \param[in] _data DEM data.
+  /// \param[in] _noDataValue Samples at or below this value are left out
+  /// of the elevation range.
+  /// \param[out] _tileMin Minimum elevation of each tile, or null.
+  /// \param[out] _tileMax Maximum elevation of each tile, or null.
+  public: DecodeTiles_TBB(DemPrivate *_data, const double _noDataValue,
+              std::vector<double> *_tileMin, std::vector<double> *_tileMax)
+    : data(_data), noDataValue(_noDataValue), tileMin(_tileMin),
+      tileMax(_tileMax)
+  {
+  }
+
+  public: void operator() (const tbb::blocked_range<unsigned int> &_r) const
+  {
+    // Only open a dataset if there is something left to decode
+    bool decoded = true;
+    for (unsigned int t = _r.begin(); t != _r.end() && decoded; ++t)
+      decoded = this->data->tileStates[t].load() == 2;
+
+    GDALDataset *dataSet = nullptr;
+    if (!decoded)
+    {
+      dataSet = reinterpret_cast<GDALDataset *>(GDALOpen(
+          this->data->fullName.c_str(), GA_ReadOnly));
+    }
+
+    for (unsigned int t = _r.begin(); t != _r.end(); ++t)
+    {
+      if (dataSet)
+        DecodeTile(*this->data, dataSet->GetRasterBand(1), nullptr, t);
+      else
+        DecodeTile(*this->data, this->data->band, &this->data->bandMutex, t);
+
+      if (!this->tileMin || !this->tileMax)
+        continue;
+
+      const unsigned int side = this->data->side;
+      const unsigned int x0 = (t % this->data->tileCount) * kDemTileSize;
+      const unsigned int y0 = (t / this->data->tileCount) * kDemTileSize;
+      const unsigned int x1 = std::min(x0 + kDemTileSize, side);
+      const unsigned int y1 = std::min(y0 + kDemTileSize, side);
+
+      double min = ignition::math::MAX_D;
+      double max = -ignition::math::MAX_D;
+      for (unsigned int y = y0; y < y1; ++y)
+      {
+        const float *row = this->data->demData + static_cast<size_t>(y) * side;
+        for (unsigned int x = x0; x < x1; ++x)
+        {
+          const double d = row[x];
+          if (d < min && d > this->noDataValue)
+            min = d;
+          if (d > max && d > this->noDataValue)
+            max = d;
+        }
+      }
+      (*this->tileMin)[t] = min;
+      (*this->tileMax)[t] = max;
+    }
+
+    if (dataSet)
+      GDALClose(dataSet);
+  }
+
+  private: DemPrivate *data;
+  private: double noDataValue;
+  private: std::vector<double> *tileMin;
+  private: std::vector<double> *tileMax;
+};
+
+//////////////////////////////////////////////////
+/// \brief Drop the decoded DEM data from the resident memory of the
+/// process. It stays in the backing file, and is paged back in on access.
+/// \param[in] _data DEM data.
+static void ReleaseResidentData(DemPrivate &_data)
+{
+#ifndef _WIN32
+  if (_data.demDataSize > 0)
+    madvise(_data.demData, _data.demDataSize, MADV_DONTNEED);
+#else
+  (void)_data;
+#endif
+}
+
 //////////////////////////////////////////////////
 Dem::Dem()
   : dataPtr(new DemPrivate)
@@ -49,7 +216,12 @@ Dem::Dem()
 //////////////////////////////////////////////////
 Dem::~Dem()
 {
-  this->dataPtr->demData.clear();
+#ifndef _WIN32
+  if (this->dataPtr->demDataSize > 0)
+    munmap(this->dataPtr->demData, this->dataPtr->demDataSize);
+#endif
+  this->dataPtr->demData = nullptr;
+  this->dataPtr->demDataBuffer.clear();
 
   if (this->dataPtr->dataSet)
     GDALClose(reinterpret_cast<GDALDataset *>(this->dataPtr->dataSet));
@@ -80,6 +252,7 @@ int Dem::Load(const std::string &_filename)
     return -1;
   }
 
+  this->dataPtr->fullName = fullName;
   this->dataPtr->dataSet = reinterpret_cast<GDALDataset *>(GDALOpen(
     fullName.c_str(), GA_ReadOnly));
 
@@ -139,7 +312,7 @@ int Dem::Load(const std::string &_filename)
 
   this->dataPtr->side = std::max(width, height);
 
-  // Preload the DEM's data
+  // Map the storage of the DEM's data
   if (this->LoadData() != 0)
     return -1;
 
@@ -156,12 +329,40 @@ int Dem::Load(const std::string &_filename)
 
   double min = ignition::math::MAX_D;
   double max = -ignition::math::MAX_D;
-  for (auto d : this->dataPtr->demData)
+
+  // Use the statistics stored with the DEM if there are any, and leave the
+  // tiles to be decoded on first use. Stored statistics only leave out the
+  // samples flagged as nodata, so they can't be used without a nodata value.
+  if (validNoData > 0 && this->dataPtr->band->GetStatistics(
+        FALSE, FALSE, &min, &max, nullptr, nullptr) == CE_None)
   {
-    if (d < min && d > noDataValue)
-      min = d;
-    if (d > max && d > noDataValue)
-      max = d;
+    // Account for the zero padding, like the decoded data would
+    if (this->dataPtr->destWidth < this->dataPtr->side ||
+        this->dataPtr->destHeight < this->dataPtr->side)
+    {
+      if (0 > noDataValue)
+      {
+        min = std::min(min, 0.0);
+        max = std::max(max, 0.0);
+      }
+    }
+  }
+  else
+  {
+    // Decode all the tiles in parallel, and reduce their elevation ranges
+    const unsigned int tiles =
+        this->dataPtr->tileCount * this->dataPtr->tileCount;
+    std::vector<double> tileMin(tiles);
+    std::vector<double> tileMax(tiles);
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, tiles, 4),
+        DecodeTiles_TBB(this->dataPtr, noDataValue, &tileMin, &tileMax));
+
+    for (unsigned int t = 0; t < tiles; ++t)
+    {
+      min = std::min(min, tileMin[t]);
+      max = std::max(max, tileMax[t]);
+    }
+    ReleaseResidentData(*this->dataPtr);
   }
   if (ignition::math::equal(min, ignition::math::MAX_D) ||
       ignition::math::equal(max, -ignition::math::MAX_D))
@@ -176,14 +377,19 @@ int Dem::Load(const std::string &_filename)
 //////////////////////////////////////////////////
 double Dem::GetElevation(double _x, double _y)
 {
-  if (_x >= this->GetWidth() || _y >= this->GetHeight())
+  if (_x < 0 || _y < 0 || _x >= this->GetWidth() || _y >= this->GetHeight())
   {
     gzthrow("Illegal coordinates. You are asking for the elevation in (" <<
           _x << "," << _y << ") but the terrain is [" << this->GetWidth() <<
            " x " << this->GetHeight() << "]\n");
   }
 
-  return this->dataPtr->demData.at(_y * this->GetWidth() + _x);
+  const unsigned int x = static_cast<unsigned int>(_x);
+  const unsigned int y = static_cast<unsigned int>(_y);
+  DecodeTile(*this->dataPtr, this->dataPtr->band, &this->dataPtr->bandMutex,
+      (y / kDemTileSize) * this->dataPtr->tileCount + x / kDemTileSize);
+
+  return this->dataPtr->demData[static_cast<size_t>(y) * this->GetWidth() + x];
 }
 
 //////////////////////////////////////////////////
@@ -275,53 +481,65 @@ void Dem::FillHeightMap(int _subSampling, unsigned int _vertSize,
   // Resize the vector to match the size of the vertices.
   _heights.resize(_vertSize * _vertSize);
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  // Make sure all the tiles are decoded
+  const unsigned int tiles =
+      this->dataPtr->tileCount * this->dataPtr->tileCount;
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, tiles, 4),
+      DecodeTiles_TBB(this->dataPtr, 0, nullptr, nullptr));
+
+  // Iterate over all the vertices, one block of rows per worker
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, _vertSize),
+      [&](const tbb::blocked_range<unsigned int> &_r)
   {
-    double yf = y / static_cast<double>(_subSampling);
-    unsigned int y1 = floor(yf);
-    unsigned int y2 = ceil(yf);
-    if (y2 >= this->dataPtr->side)
-      y2 = this->dataPtr->side - 1;
-    double dy = yf - y1;
-
-    for (unsigned int x = 0; x < _vertSize; ++x)
+    for (unsigned int y = _r.begin(); y != _r.end(); ++y)
     {
-      double xf = x / static_cast<double>(_subSampling);
-      unsigned int x1 = floor(xf);
-      unsigned int x2 = ceil(xf);
-      if (x2 >= this->dataPtr->side)
-        x2 = this->dataPtr->side - 1;
-      double dx = xf - x1;
-
-      double px1 = this->dataPtr->demData[y1 * this->dataPtr->side + x1];
-      double px2 = this->dataPtr->demData[y1 * this->dataPtr->side + x2];
-      float h1 = (px1 - ((px1 - px2) * dx));
-
-      double px3 = this->dataPtr->demData[y2 * this->dataPtr->side + x1];
-      double px4 = this->dataPtr->demData[y2 * this->dataPtr->side + x2];
-      float h2 = (px3 - ((px3 - px4) * dx));
-
-      float h = this->dataPtr->minElevation +
-          (h1 - ((h1 - h2) * dy) - this->dataPtr->minElevation) * _scale.Z();
-
-      // Invert pixel definition so 1=ground, 0=full height,
-      // if the terrain size has a negative z component
-      // this is mainly for backward compatibility
-      if (_size.Z() < 0)
-        h *= -1;
-
-      // Convert to minElevation if a NODATA value is found
-      if (_size.Z() >= 0 && h < this->dataPtr->minElevation)
-        h = this->dataPtr->minElevation;
-
-      // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      double yf = y / static_cast<double>(_subSampling);
+      unsigned int y1 = floor(yf);
+      unsigned int y2 = ceil(yf);
+      if (y2 >= this->dataPtr->side)
+        y2 = this->dataPtr->side - 1;
+      double dy = yf - y1;
+
+      for (unsigned int x = 0; x < _vertSize; ++x)
+      {
+        double xf = x / static_cast<double>(_subSampling);
+        unsigned int x1 = floor(xf);
+        unsigned int x2 = ceil(xf);
+        if (x2 >= this->dataPtr->side)
+          x2 = this->dataPtr->side - 1;
+        double dx = xf - x1;
+
+        double px1 = this->dataPtr->demData[y1 * this->dataPtr->side + x1];
+        double px2 = this->dataPtr->demData[y1 * this->dataPtr->side + x2];
+        float h1 = (px1 - ((px1 - px2) * dx));
+
+        double px3 = this->dataPtr->demData[y2 * this->dataPtr->side + x1];
+        double px4 = this->dataPtr->demData[y2 * this->dataPtr->side + x2];
+        float h2 = (px3 - ((px3 - px4) * dx));
+
+        float h = this->dataPtr->minElevation +
+            (h1 - ((h1 - h2) * dy) - this->dataPtr->minElevation) * _scale.Z();
+
+        // Invert pixel definition so 1=ground, 0=full height,
+        // if the terrain size has a negative z component
+        // this is mainly for backward compatibility
+        if (_size.Z() < 0)
+          h *= -1;
+
+        // Convert to minElevation if a NODATA value is found
+        if (_size.Z() >= 0 && h < this->dataPtr->minElevation)
+          h = this->dataPtr->minElevation;
+
+        // Store the height for future use
+        if (!_flipY)
+          _heights[y * _vertSize + x] = h;
+        else
+          _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      }
     }
-  }
+  });
+
+  ReleaseResidentData(*this->dataPtr);
 }
 
 //////////////////////////////////////////////////
@@ -332,7 +550,6 @@ int Dem::LoadData()
     unsigned int nXSize = this->dataPtr->dataSet->GetRasterXSize();
     unsigned int nYSize = this->dataPtr->dataSet->GetRasterYSize();
     float ratio;
-    std::vector<float> buffer;
 
     if (nXSize == 0 || nYSize == 0)
     {
@@ -357,26 +574,54 @@ int Dem::LoadData()
       destWidth = static_cast<float>(destHeight) / static_cast<float>(ratio);
     }
 
-    // Read the whole raster data and convert it to a GDT_Float32 array.
-    // In this step the DEM is scaled to destWidth x destHeight
-    buffer.resize(destWidth * destHeight);
-    if (this->dataPtr->band->RasterIO(GF_Read, 0, 0, nXSize, nYSize, &buffer[0],
-                         destWidth, destHeight, GDT_Float32, 0, 0) != CE_None)
+    this->dataPtr->destWidth = destWidth;
+    this->dataPtr->destHeight = destHeight;
+
+    // Map zeroed storage for the scaled raster plus its padding. The raster
+    // is decoded into it one tile at a time, see DecodeTile.
+    const size_t count = static_cast<size_t>(this->dataPtr->side) *
+        this->dataPtr->side;
+#ifndef _WIN32
+    boost::filesystem::path tmpPath =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("gazebo_dem_%%%%-%%%%-%%%%-%%%%");
+    int fd = open(tmpPath.string().c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
     {
-      gzerr << "Failure calling RasterIO while loading a DEM file\n";
-      return -1;
+      // The file goes away with the mapping
+      unlink(tmpPath.string().c_str());
+      if (ftruncate(fd, count * sizeof(float)) == 0)
+      {
+        void *addr = mmap(nullptr, count * sizeof(float),
+            PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+          this->dataPtr->demData = static_cast<float *>(addr);
+          this->dataPtr->demDataSize = count * sizeof(float);
+        }
+      }
+      close(fd);
     }
 
-    // Copy and align 'buffer' into the target vector. The destination vector is
-    // initialized to 0, so all the points not contained in 'buffer' will be
-    // extra padding
-    this->dataPtr->demData.resize(this->GetWidth() * this->GetHeight());
-    for (unsigned int y = 0; y < destHeight; ++y)
+    if (!this->dataPtr->demData)
     {
-        std::copy(&buffer[destWidth * y], &buffer[destWidth * y] + destWidth,
-                  this->dataPtr->demData.begin() + this->GetWidth() * y);
+      gzwarn << "Unable to map a temporary file for DEM data, "
+             << "keeping it in memory instead\n";
     }
-    buffer.clear();
+#endif
+    if (!this->dataPtr->demData)
+    {
+      this->dataPtr->demDataBuffer.assign(count, 0.0f);
+      this->dataPtr->demData = this->dataPtr->demDataBuffer.data();
+    }
+
+    this->dataPtr->tileCount =
+        (this->dataPtr->side + kDemTileSize - 1) / kDemTileSize;
+    const unsigned int tiles =
+        this->dataPtr->tileCount * this->dataPtr->tileCount;
+    this->dataPtr->tileStates.reset(new std::atomic<int>[tiles]);
+    for (unsigned int t = 0; t < tiles; ++t)
+      this->dataPtr->tileStates[t] = 0;
 
     return 0;
 }
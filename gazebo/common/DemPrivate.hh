@@ -23,6 +23,10 @@
 
 #ifdef HAVE_GDAL
 # include <gdal_priv.h>
+# include <atomic>
+# include <memory>
+# include <mutex>
+# include <string>
 # include <vector>
 
 namespace gazebo
@@ -57,8 +61,37 @@ namespace gazebo
       /// \brief Maximum elevation in meters.
       public: double maxElevation;
 
-      /// \brief DEM data converted to be OGRE-compatible.
-      public: std::vector<float> demData;
+      /// \brief Full path of the DEM file, used to open one dataset per
+      /// worker thread.
+      public: std::string fullName;
+
+      /// \brief DEM data converted to be OGRE-compatible, side x side
+      /// samples. The data lives in a memory mapped temporary file, so that
+      /// it doesn't have to stay resident, and is decoded one tile at a
+      /// time on first use.
+      public: float *demData = nullptr;
+
+      /// \brief Size of the mapping of demData in bytes.
+      public: size_t demDataSize = 0;
+
+      /// \brief Storage of demData on platforms without memory mapping.
+      public: std::vector<float> demDataBuffer;
+
+      /// \brief Width of the raster after scaling, before padding.
+      public: unsigned int destWidth = 0;
+
+      /// \brief Height of the raster after scaling, before padding.
+      public: unsigned int destHeight = 0;
+
+      /// \brief Number of tiles along each side of demData.
+      public: unsigned int tileCount = 0;
+
+      /// \brief Decode state of every tile: 0 not decoded, 1 being
+      /// decoded, 2 decoded.
+      public: std::unique_ptr<std::atomic<int>[]> tileStates;
+
+      /// \brief Protects the band when tiles are decoded on demand.
+      public: std::mutex bandMutex;
     };
     /// \}
   }
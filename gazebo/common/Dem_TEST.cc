@@ -15,6 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 #include <gtest/gtest.h>
 #include <ignition/math/Angle.hh>
@@ -25,12 +30,214 @@
 #include "test_config.h"
 #include "test/util.hh"
 
+#ifdef HAVE_GDAL
+# include <gdal_priv.h>
+#endif
+
 using namespace gazebo;
 
 class DemTest : public gazebo::testing::AutoLogFixture { };
 
 #ifdef HAVE_GDAL
 
+/// \brief Value of the samples flagged as nodata in the synthetic DEMs.
+static const float kNoData = -9999;
+
+/////////////////////////////////////////////////
+/// \brief Write a synthetic GeoTIFF DEM of hills and valleys, with a few
+/// nodata samples.
+/// \param[in] _filename File to write.
+/// \param[in] _xSize Number of samples along x.
+/// \param[in] _ySize Number of samples along y.
+/// \param[in] _statistics True to flag the nodata value and store the
+/// statistics of the band in the DEM.
+/// \return True on success.
+static bool WriteDem(const std::string &_filename, const int _xSize,
+    const int _ySize, const bool _statistics)
+{
+  GDALAllRegister();
+  GDALDriver *driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+  if (!driver)
+    return false;
+
+  GDALDataset *dataSet = driver->Create(_filename.c_str(), _xSize, _ySize, 1,
+      GDT_Float32, nullptr);
+  if (!dataSet)
+    return false;
+
+  double transform[6] = {0.0, 0.0003, 0.0, 0.0, 0.0, -0.0003};
+  dataSet->SetGeoTransform(transform);
+  dataSet->SetProjection(
+      "GEOGCS[\"WGS 84\",DATUM[\"WGS_1984\",SPHEROID[\"WGS 84\",6378137,"
+      "298.257223563]],PRIMEM[\"Greenwich\",0],UNIT[\"degree\","
+      "0.0174532925199433]]");
+
+  GDALRasterBand *band = dataSet->GetRasterBand(1);
+  if (_statistics)
+    band->SetNoDataValue(kNoData);
+
+  std::vector<float> row(_xSize);
+  bool result = true;
+  for (int y = 0; y < _ySize && result; ++y)
+  {
+    for (int x = 0; x < _xSize; ++x)
+    {
+      if (x % 97 == 13 && y % 89 == 7)
+        row[x] = kNoData;
+      else
+        row[x] = 50.0f + 100.0f * std::sin(x * 0.011f) * std::cos(y * 0.017f);
+    }
+    result = band->RasterIO(GF_Write, 0, y, _xSize, 1, row.data(), _xSize, 1,
+        GDT_Float32, 0, 0) == CE_None;
+  }
+
+  if (result && _statistics)
+  {
+    double min, max, mean, stdDev;
+    result = band->ComputeStatistics(FALSE, &min, &max, &mean, &stdDev,
+        nullptr, nullptr) == CE_None;
+  }
+
+  GDALClose(dataSet);
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a DEM the way Dem did before its data was decoded in tiles:
+/// the whole raster is scaled in a single read, then padded with zeros.
+/// \param[in] _filename DEM file.
+/// \param[out] _side Side of the padded DEM, in samples.
+/// \param[out] _data Padded elevations.
+/// \param[out] _min Minimum elevation.
+/// \param[out] _max Maximum elevation.
+/// \return True on success.
+static bool LoadWholeRaster(const std::string &_filename, unsigned int &_side,
+    std::vector<float> &_data, double &_min, double &_max)
+{
+  GDALDataset *dataSet = reinterpret_cast<GDALDataset *>(GDALOpen(
+      _filename.c_str(), GA_ReadOnly));
+  if (!dataSet)
+    return false;
+
+  GDALRasterBand *band = dataSet->GetRasterBand(1);
+  const unsigned int nXSize = dataSet->GetRasterXSize();
+  const unsigned int nYSize = dataSet->GetRasterYSize();
+
+  unsigned int width = nXSize;
+  if (!ignition::math::isPowerOfTwo(nXSize - 1))
+    width = ignition::math::roundUpPowerOfTwo(nXSize) + 1;
+  unsigned int height = nYSize;
+  if (!ignition::math::isPowerOfTwo(nYSize - 1))
+    height = ignition::math::roundUpPowerOfTwo(nYSize) + 1;
+  _side = std::max(width, height);
+
+  unsigned int destWidth;
+  unsigned int destHeight;
+  if (nXSize > nYSize)
+  {
+    float ratio = static_cast<float>(nXSize) / static_cast<float>(nYSize);
+    destWidth = _side;
+    destHeight = static_cast<float>(destWidth) / ratio;
+  }
+  else
+  {
+    float ratio = static_cast<float>(nYSize) / static_cast<float>(nXSize);
+    destHeight = _side;
+    destWidth = static_cast<float>(destHeight) / ratio;
+  }
+
+  std::vector<float> buffer(destWidth * destHeight);
+  bool result = band->RasterIO(GF_Read, 0, 0, nXSize, nYSize, buffer.data(),
+      destWidth, destHeight, GDT_Float32, 0, 0) == CE_None;
+
+  _data.assign(_side * _side, 0.0f);
+  for (unsigned int y = 0; y < destHeight; ++y)
+  {
+    std::copy(buffer.begin() + y * destWidth,
+        buffer.begin() + (y + 1) * destWidth, _data.begin() + y * _side);
+  }
+
+  int validNoData = 0;
+  double noDataValue = band->GetNoDataValue(&validNoData);
+  if (validNoData <= 0)
+    noDataValue = -9999;
+
+  _min = ignition::math::MAX_D;
+  _max = -ignition::math::MAX_D;
+  for (const float d : _data)
+  {
+    if (d < _min && d > noDataValue)
+      _min = d;
+    if (d > _max && d > noDataValue)
+      _max = d;
+  }
+
+  GDALClose(dataSet);
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Fill a heightmap from elevations loaded by LoadWholeRaster, the
+/// way Dem::FillHeightMap did.
+/// \param[in] _data Padded elevations.
+/// \param[in] _side Side of the padded DEM, in samples.
+/// \param[in] _min Minimum elevation.
+/// \param[in] _subSampling Subsampling factor.
+/// \param[in] _vertSize Number of vertices along each side.
+/// \param[in] _size Size of the terrain.
+/// \param[in] _scale Scale of the terrain.
+/// \param[in] _flipY True to flip the heightmap along y.
+/// \param[out] _heights Heights of the vertices.
+static void FillWholeRasterHeightMap(const std::vector<float> &_data,
+    const unsigned int _side, const float _min, const int _subSampling,
+    const unsigned int _vertSize, const ignition::math::Vector3d &_size,
+    const ignition::math::Vector3d &_scale, const bool _flipY,
+    std::vector<float> &_heights)
+{
+  _heights.resize(_vertSize * _vertSize);
+
+  for (unsigned int y = 0; y < _vertSize; ++y)
+  {
+    double yf = y / static_cast<double>(_subSampling);
+    unsigned int y1 = floor(yf);
+    unsigned int y2 = ceil(yf);
+    if (y2 >= _side)
+      y2 = _side - 1;
+    double dy = yf - y1;
+
+    for (unsigned int x = 0; x < _vertSize; ++x)
+    {
+      double xf = x / static_cast<double>(_subSampling);
+      unsigned int x1 = floor(xf);
+      unsigned int x2 = ceil(xf);
+      if (x2 >= _side)
+        x2 = _side - 1;
+      double dx = xf - x1;
+
+      double px1 = _data[y1 * _side + x1];
+      double px2 = _data[y1 * _side + x2];
+      float h1 = (px1 - ((px1 - px2) * dx));
+
+      double px3 = _data[y2 * _side + x1];
+      double px4 = _data[y2 * _side + x2];
+      float h2 = (px3 - ((px3 - px4) * dx));
+
+      float h = _min + (h1 - ((h1 - h2) * dy) - _min) * _scale.Z();
+
+      if (_size.Z() < 0)
+        h *= -1;
+
+      if (_size.Z() >= 0 && h < _min)
+        h = _min;
+
+      if (!_flipY)
+        _heights[y * _vertSize + x] = h;
+      else
+        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 TEST_F(DemTest, MisingFile)
 {
@@ -223,6 +430,98 @@ TEST_F(DemTest, UnfinishedDem)
   EXPECT_FLOAT_EQ(682, demNoData.GetMinElevation());
   EXPECT_FLOAT_EQ(2932, demNoData.GetMaxElevation());
 }
+
+/////////////////////////////////////////////////
+// Tiles decoded on demand, and tiles decoded up front, give the same
+// elevations and heightmaps as a single read of the whole raster.
+TEST_F(DemTest, TilesMatchWholeRaster)
+{
+  boost::filesystem::path dir = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_dem_test_%%%%-%%%%");
+  boost::filesystem::create_directories(dir);
+
+  // Lazy: landscape, with a nodata value and stored statistics.
+  // Eager: portrait, without either.
+  // Both are scaled up to 1025 samples, which leaves a partial edge tile,
+  // and padded on their short side.
+  struct DemCase
+  {
+    std::string name;
+    int xSize;
+    int ySize;
+    bool statistics;
+  };
+  for (const DemCase &demCase : {DemCase{"lazy", 700, 600, true},
+                                 DemCase{"eager", 600, 700, false}})
+  {
+    SCOPED_TRACE(demCase.name);
+    const std::string filename = (dir / (demCase.name + ".tif")).string();
+    ASSERT_TRUE(WriteDem(filename, demCase.xSize, demCase.ySize,
+        demCase.statistics));
+
+    unsigned int side;
+    std::vector<float> expected;
+    double min, max;
+    ASSERT_TRUE(LoadWholeRaster(filename, side, expected, min, max));
+    EXPECT_EQ(side, 1025u);
+    EXPECT_LT(min, 0.0);
+
+    // Every sample, read one by one
+    common::Dem dem;
+    ASSERT_EQ(dem.Load(filename), 0);
+    ASSERT_EQ(dem.GetWidth(), side);
+    ASSERT_EQ(dem.GetHeight(), side);
+    EXPECT_FLOAT_EQ(dem.GetMinElevation(), min);
+    EXPECT_FLOAT_EQ(dem.GetMaxElevation(), max);
+
+    unsigned int mismatches = 0;
+    for (unsigned int y = 0; y < side; ++y)
+    {
+      for (unsigned int x = 0; x < side; ++x)
+      {
+        if (!ignition::math::equal(dem.GetElevation(x, y),
+              static_cast<double>(expected[y * side + x])))
+        {
+          ++mismatches;
+        }
+      }
+    }
+    EXPECT_EQ(mismatches, 0u);
+
+    // A heightmap filled right after loading, flipped and not
+    common::Dem demHeightmap;
+    ASSERT_EQ(demHeightmap.Load(filename), 0);
+
+    const int subSampling = 2;
+    const unsigned int vertSize = side * subSampling - 1;
+    ignition::math::Vector3d size(demHeightmap.GetWorldWidth(),
+        demHeightmap.GetWorldHeight(),
+        demHeightmap.GetMaxElevation() - demHeightmap.GetMinElevation());
+    ignition::math::Vector3d scale(size.X() / vertSize, size.Y() / vertSize,
+        std::fabs(size.Z()) / demHeightmap.GetMaxElevation());
+
+    for (const bool flipY : {false, true})
+    {
+      std::vector<float> heights;
+      std::vector<float> expectedHeights;
+      demHeightmap.FillHeightMap(subSampling, vertSize, size, scale, flipY,
+          heights);
+      FillWholeRasterHeightMap(expected, side, min, subSampling, vertSize,
+          size, scale, flipY, expectedHeights);
+      ASSERT_EQ(heights.size(), expectedHeights.size());
+
+      mismatches = 0;
+      for (unsigned int i = 0; i < heights.size(); ++i)
+      {
+        if (!ignition::math::equal(heights[i], expectedHeights[i], 1e-4f))
+          ++mismatches;
+      }
+      EXPECT_EQ(mismatches, 0u);
+    }
+  }
+
+  boost::filesystem::remove_all(dir);
+}
 #endif
 
 /////////////////////////////////////////////////
@@ -27,6 +27,12 @@ Event::Event()
 {
 }
 
+//////////////////////////////////////////////////
+Event::Event(const bool _skippable)
+  : signaled(false), skippable(_skippable)
+{
+}
+
 //////////////////////////////////////////////////
 Event::~Event()
 {
@@ -44,6 +50,12 @@ void Event::SetSignaled(const bool _sig)
   this->signaled = _sig;
 }
 
+//////////////////////////////////////////////////
+bool Event::Skippable() const
+{
+  return this->skippable;
+}
+
 //////////////////////////////////////////////////
 Connection::Connection(Event *_e, const int _i)
   : event(_e), id(_i)
@@ -27,6 +27,7 @@
 #include <gazebo/gazebo_config.h>
 #include <gazebo/common/Time.hh>
 #include <gazebo/common/CommonTypes.hh>
+#include <gazebo/common/PluginUsage.hh>
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -45,6 +46,11 @@ namespace gazebo
       /// \brief Constructor
       public: Event();
 
+      /// \brief Constructor.
+      /// \param[in] _skippable True if calls of plugins over their budget
+      /// may be skipped, see Skippable().
+      public: explicit Event(const bool _skippable);
+
       /// \brief Destructor
       public: virtual ~Event();
 
@@ -60,8 +66,18 @@ namespace gazebo
       /// \param[in] _sig True if the event has been signaled.
       public: void SetSignaled(const bool _sig);
 
+      /// \brief Get whether the calls of plugins that skip over budget may
+      /// be skipped. Only events signaled at every world step are
+      /// skippable; missing any other event, such as a reset, would leave a
+      /// plugin in the wrong state.
+      /// \return True if calls may be skipped.
+      public: bool Skippable() const;
+
       /// \brief True if the event has been signaled.
       private: bool signaled;
+
+      /// \brief True if calls over budget may be skipped.
+      private: const bool skippable = false;
     };
 
     /// \brief A class that encapsulates a connection.
@@ -99,6 +115,11 @@ namespace gazebo
       /// \brief Constructor.
       public: EventT();
 
+      /// \brief Constructor.
+      /// \param[in] _skippable True if calls of plugins over their budget
+      /// may be skipped, see Event::Skippable().
+      public: explicit EventT(const bool _skippable);
+
       /// \brief Destructor.
       public: virtual ~EventT();
 
@@ -274,7 +295,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback();
+            this->Call(*iter.second);
         }
       }
 
@@ -289,7 +310,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p);
+            this->Call(*iter.second, _p);
         }
       }
 
@@ -305,7 +326,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p1, _p2);
+            this->Call(*iter.second, _p1, _p2);
         }
       }
 
@@ -322,7 +343,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3);
+            this->Call(*iter.second, _p1, _p2, _p3);
         }
       }
 
@@ -341,7 +362,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4);
+            this->Call(*iter.second, _p1, _p2, _p3, _p4);
         }
       }
 
@@ -362,7 +383,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5);
+            this->Call(*iter.second, _p1, _p2, _p3, _p4, _p5);
         }
       }
 
@@ -384,7 +405,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6);
+            this->Call(*iter.second, _p1, _p2, _p3, _p4, _p5, _p6);
         }
       }
 
@@ -407,7 +428,7 @@ namespace gazebo
         for (const auto &iter: this->connections)
         {
           if (iter.second->on)
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7);
+            this->Call(*iter.second, _p1, _p2, _p3, _p4, _p5, _p6, _p7);
         }
       }
 
@@ -433,7 +454,7 @@ namespace gazebo
         {
           if (iter.second->on)
           {
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
+            this->Call(*iter.second, _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
           }
         }
       }
@@ -462,7 +483,7 @@ namespace gazebo
         {
           if (iter.second->on)
           {
-            iter.second->callback(
+            this->Call(*iter.second,
                 _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9);
           }
         }
@@ -493,7 +514,7 @@ namespace gazebo
         {
           if (iter.second->on)
           {
-            iter.second->callback(
+            this->Call(*iter.second,
                 _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9, _p10);
           }
         }
@@ -509,7 +530,7 @@ namespace gazebo
       {
         /// \brief Constructor
         public: EventConnection(const bool _on, const std::function<T> &_cb)
-                : callback(_cb)
+                : callback(_cb), usage(common::PluginOwner::Current())
         {
           // Windows Visual Studio 2012 does not have atomic_bool constructor,
           // so we have to set "on" using operator=
@@ -521,8 +542,30 @@ namespace gazebo
 
         /// \brief Callback function
         public: std::function<T> callback;
+
+        /// \brief Usage of the plugin that made the connection, null if
+        /// it wasn't made by a plugin.
+        public: common::PluginUsagePtr usage;
       };
 
+      /// \brief Call the callback of a connection, and account for it in
+      /// the usage of its plugin.
+      /// \param[in] _conn The connection.
+      /// \param[in] _args Parameters of the callback.
+      private: template<typename... Args>
+               void Call(const EventConnection &_conn, const Args &... _args)
+      {
+        if (!_conn.usage)
+        {
+          _conn.callback(_args...);
+          return;
+        }
+
+        common::PluginCall call(*_conn.usage, this->Skippable());
+        if (!call.Skipped())
+          _conn.callback(_args...);
+      }
+
       /// \def EvtConnectionMap
       /// \brief Event Connection map typedef.
       typedef std::map<int, std::unique_ptr<EventConnection>> EvtConnectionMap;
@@ -545,6 +588,14 @@ namespace gazebo
     {
     }
 
+    /// \brief Constructor.
+    /// \param[in] _skippable True if calls over budget may be skipped.
+    template<typename T>
+    EventT<T>::EventT(const bool _skippable)
+    : Event(_skippable)
+    {
+    }
+
     /// \brief Destructor. Deletes all the associated connections.
     template<typename T>
     EventT<T>::~EventT()
@@ -30,10 +30,11 @@ EventT<void (std::string, std::string)> Events::setSelectedEntity;
 EventT<void (std::string)> Events::addEntity;
 EventT<void (std::string)> Events::deleteEntity;
 
-EventT<void (const common::UpdateInfo &)> Events::worldUpdateBegin;
-EventT<void (const common::UpdateInfo &)> Events::beforePhysicsUpdate;
+// Plugins over budget may skip the events of a world step, and only these
+EventT<void (const common::UpdateInfo &)> Events::worldUpdateBegin(true);
+EventT<void (const common::UpdateInfo &)> Events::beforePhysicsUpdate(true);
 
-EventT<void ()> Events::worldUpdateEnd;
+EventT<void ()> Events::worldUpdateEnd(true);
 EventT<void ()> Events::worldReset;
 EventT<void ()> Events::timeReset;
 
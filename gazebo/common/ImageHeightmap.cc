@@ -15,6 +15,9 @@
  *
  */
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/ImageHeightmap.hh"
@@ -63,49 +66,53 @@ void ImageHeightmap::FillHeightMap(int _subSampling,
   unsigned int count;
   this->img.GetData(&data, count);
 
-  // Iterate over all the vertices
-  for (unsigned int y = 0; y < _vertSize; ++y)
+  // Iterate over all the vertices, one block of rows per worker
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, _vertSize),
+      [&](const tbb::blocked_range<unsigned int> &_r)
   {
-    // yf ranges between 0 and 4
-    double yf = y / static_cast<double>(_subSampling);
-    int y1 = floor(yf);
-    int y2 = ceil(yf);
-    if (y2 >= imgHeight)
-      y2 = imgHeight-1;
-    double dy = yf - y1;
-
-    for (unsigned int x = 0; x < _vertSize; ++x)
+    for (unsigned int y = _r.begin(); y != _r.end(); ++y)
     {
-      double xf = x / static_cast<double>(_subSampling);
-      int x1 = floor(xf);
-      int x2 = ceil(xf);
-      if (x2 >= imgWidth)
-        x2 = imgWidth-1;
-      double dx = xf - x1;
-
-      double px1 = static_cast<int>(data[y1 * pitch + x1 * bpp]) / 255.0;
-      double px2 = static_cast<int>(data[y1 * pitch + x2 * bpp]) / 255.0;
-      float h1 = (px1 - ((px1 - px2) * dx));
-
-      double px3 = static_cast<int>(data[y2 * pitch + x1 * bpp]) / 255.0;
-      double px4 = static_cast<int>(data[y2 * pitch + x2 * bpp]) / 255.0;
-      float h2 = (px3 - ((px3 - px4) * dx));
-
-      float h = (h1 - ((h1 - h2) * dy)) * _scale.Z();
-
-      // invert pixel definition so 1=ground, 0=full height,
-      //   if the terrain size has a negative z component
-      //   this is mainly for backward compatibility
-      if (_size.Z() < 0)
-        h = 1.0 - h;
-
-      // Store the height for future use
-      if (!_flipY)
-        _heights[y * _vertSize + x] = h;
-      else
-        _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      // yf ranges between 0 and 4
+      double yf = y / static_cast<double>(_subSampling);
+      int y1 = floor(yf);
+      int y2 = ceil(yf);
+      if (y2 >= imgHeight)
+        y2 = imgHeight-1;
+      double dy = yf - y1;
+
+      for (unsigned int x = 0; x < _vertSize; ++x)
+      {
+        double xf = x / static_cast<double>(_subSampling);
+        int x1 = floor(xf);
+        int x2 = ceil(xf);
+        if (x2 >= imgWidth)
+          x2 = imgWidth-1;
+        double dx = xf - x1;
+
+        double px1 = static_cast<int>(data[y1 * pitch + x1 * bpp]) / 255.0;
+        double px2 = static_cast<int>(data[y1 * pitch + x2 * bpp]) / 255.0;
+        float h1 = (px1 - ((px1 - px2) * dx));
+
+        double px3 = static_cast<int>(data[y2 * pitch + x1 * bpp]) / 255.0;
+        double px4 = static_cast<int>(data[y2 * pitch + x2 * bpp]) / 255.0;
+        float h2 = (px3 - ((px3 - px4) * dx));
+
+        float h = (h1 - ((h1 - h2) * dy)) * _scale.Z();
+
+        // invert pixel definition so 1=ground, 0=full height,
+        //   if the terrain size has a negative z component
+        //   this is mainly for backward compatibility
+        if (_size.Z() < 0)
+          h = 1.0 - h;
+
+        // Store the height for future use
+        if (!_flipY)
+          _heights[y * _vertSize + x] = h;
+        else
+          _heights[(_vertSize - y - 1) * _vertSize + x] = h;
+      }
     }
-  }
+  });
 
   delete [] data;
 }
@@ -37,6 +37,7 @@
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/PluginUsage.hh"
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/sensors/SensorTypes.hh"
@@ -251,6 +252,50 @@ namespace gazebo
               this->LoadParam<std::string>(_sdf, _name, _target, _defaultValue);
             }
 
+    /// \brief Create the usage of the plugin. The event callbacks that the
+    /// plugin connects while a common::PluginOwner of its usage is in scope
+    /// are accounted for in it. The SDF of the plugin may set a budget with
+    /// a <gz:budget> custom element, in seconds of wall time per call, and
+    /// <gz:over_budget>skip</gz:over_budget> to skip calls to the events of
+    /// a world step to stay within budget instead of warning.
+    /// \param[in] _name Scoped name of the plugin.
+    /// \param[in] _world Name of the world of the plugin.
+    /// \param[in] _sdf The SDF element of the plugin.
+    public: void CreateUsage(const std::string &_name,
+                const std::string &_world, sdf::ElementPtr _sdf)
+            {
+              this->usage = common::PluginUsage::Create(_name, _world);
+              if (!_sdf)
+                return;
+
+              double budget = 0;
+              bool skip = false;
+              for (sdf::ElementPtr elem = _sdf->GetFirstElement(); elem;
+                   elem = elem->GetNextElement())
+              {
+                const std::string name = elem->GetName();
+                const std::size_t colon = name.find(':');
+                if (colon == std::string::npos)
+                  continue;
+
+                const std::string key = name.substr(colon + 1);
+                if (key == "budget")
+                  budget = elem->Get<double>();
+                else if (key == "over_budget")
+                  skip = elem->Get<std::string>() == "skip";
+              }
+
+              if (budget > 0)
+                this->usage->SetBudget(budget, skip);
+            }
+
+    /// \brief Get the usage of the plugin.
+    /// \return The usage, null if it wasn't created.
+    public: common::PluginUsagePtr Usage() const
+            {
+              return this->usage;
+            }
+
     /// \brief Type of plugin
     protected: PluginType type;
 
@@ -269,6 +314,9 @@ namespace gazebo
 
     /// \brief Handle used for closing the dynamic library.
     private: void *dlHandle;
+
+    /// \brief Time spent in the event callbacks of the plugin.
+    private: common::PluginUsagePtr usage;
   };
 
   /// \class WorldPlugin Plugin.hh common/common.hh
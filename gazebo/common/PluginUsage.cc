@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef _WIN32
+  #include <time.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/PluginUsage.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief Usage of the plugins, by world.
+static std::map<std::string, std::vector<std::weak_ptr<PluginUsage>>>
+    g_usage;
+
+/// \brief Worlds whose plugins are profiled.
+static std::map<std::string, bool> g_profiled;
+
+/// \brief Protects g_usage and g_profiled.
+static std::mutex g_usageMutex;
+
+/// \brief Owner of the connections made by each thread.
+static thread_local PluginUsagePtr g_owner;
+
+/// \brief Shortest time between two warnings about a plugin, in
+/// nanoseconds.
+static const int64_t kWarningPeriod = 5000000000;
+
+/////////////////////////////////////////////////
+/// \brief Get the steady clock time.
+/// \return Time in nanoseconds.
+static int64_t wallNow()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the CPU time of the current thread.
+/// \return Time in nanoseconds, zero where it isn't available.
+static int64_t cpuNow()
+{
+#ifndef _WIN32
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+  return 0;
+}
+
+/////////////////////////////////////////////////
+PluginUsage::PluginUsage(const std::string &_name, const std::string &_world)
+  : name(_name), world(_world)
+{
+}
+
+/////////////////////////////////////////////////
+PluginUsagePtr PluginUsage::Create(const std::string &_name,
+    const std::string &_world)
+{
+  PluginUsagePtr usage(new PluginUsage(_name, _world));
+
+  std::lock_guard<std::mutex> lock(g_usageMutex);
+  usage->profiled = g_profiled[_world];
+
+  auto &usages = g_usage[_world];
+  usages.erase(std::remove_if(usages.begin(), usages.end(),
+        [](const std::weak_ptr<PluginUsage> &_u) { return _u.expired(); }),
+      usages.end());
+  usages.push_back(usage);
+
+  return usage;
+}
+
+/////////////////////////////////////////////////
+void PluginUsage::WorldUsage(const std::string &_world,
+    std::vector<PluginUsagePtr> &_usage)
+{
+  _usage.clear();
+
+  std::lock_guard<std::mutex> lock(g_usageMutex);
+  auto iter = g_usage.find(_world);
+  if (iter == g_usage.end())
+    return;
+
+  for (auto const &weak : iter->second)
+  {
+    if (PluginUsagePtr usage = weak.lock())
+      _usage.push_back(usage);
+  }
+}
+
+/////////////////////////////////////////////////
+void PluginUsage::SetProfiled(const std::string &_world, const bool _profile)
+{
+  std::lock_guard<std::mutex> lock(g_usageMutex);
+  g_profiled[_world] = _profile;
+
+  auto iter = g_usage.find(_world);
+  if (iter == g_usage.end())
+    return;
+
+  for (auto const &weak : iter->second)
+  {
+    if (PluginUsagePtr usage = weak.lock())
+      usage->profiled = _profile;
+  }
+}
+
+/////////////////////////////////////////////////
+const std::string &PluginUsage::Name() const
+{
+  return this->name;
+}
+
+/////////////////////////////////////////////////
+const std::string &PluginUsage::World() const
+{
+  return this->world;
+}
+
+/////////////////////////////////////////////////
+void PluginUsage::SetBudget(const double _budget, const bool _skip)
+{
+  this->budget = static_cast<int64_t>(std::max(0.0, _budget) * 1e9);
+  this->skip = _skip;
+  this->debt = 0;
+}
+
+/////////////////////////////////////////////////
+double PluginUsage::Budget() const
+{
+  return this->budget * 1e-9;
+}
+
+/////////////////////////////////////////////////
+bool PluginUsage::SkipOverBudget() const
+{
+  return this->skip;
+}
+
+/////////////////////////////////////////////////
+bool PluginUsage::Timed() const
+{
+  return this->profiled || this->budget > 0;
+}
+
+/////////////////////////////////////////////////
+uint64_t PluginUsage::Calls() const
+{
+  return this->calls;
+}
+
+/////////////////////////////////////////////////
+uint64_t PluginUsage::Skipped() const
+{
+  return this->skipped;
+}
+
+/////////////////////////////////////////////////
+uint64_t PluginUsage::OverBudget() const
+{
+  return this->overBudget;
+}
+
+/////////////////////////////////////////////////
+double PluginUsage::WallTime() const
+{
+  return this->wallTime * 1e-9;
+}
+
+/////////////////////////////////////////////////
+double PluginUsage::CpuTime() const
+{
+  return this->cpuTime * 1e-9;
+}
+
+/////////////////////////////////////////////////
+double PluginUsage::MaxWallTime() const
+{
+  return this->maxWallTime * 1e-9;
+}
+
+/////////////////////////////////////////////////
+bool PluginUsage::Start(const bool _skippable)
+{
+  ++this->calls;
+
+  // Calls that can't be skipped leave the debt to the next skippable ones
+  if (!this->skip || !_skippable)
+    return true;
+
+  // Each skipped call pays back one budget. The callbacks of a plugin
+  // normally run on one thread, so the debt is not updated atomically.
+  const int64_t owed = this->debt;
+  if (owed <= 0)
+    return true;
+
+  this->debt = std::max<int64_t>(0, owed - this->budget);
+  ++this->skipped;
+  return false;
+}
+
+/////////////////////////////////////////////////
+void PluginUsage::Stop(const int64_t _wall, const int64_t _cpu)
+{
+  this->wallTime += _wall;
+  this->cpuTime += _cpu;
+
+  int64_t longest = this->maxWallTime;
+  while (_wall > longest &&
+         !this->maxWallTime.compare_exchange_weak(longest, _wall))
+  {
+  }
+
+  const int64_t limit = this->budget;
+  if (limit <= 0 || _wall <= limit)
+    return;
+
+  ++this->overBudget;
+  if (this->skip)
+  {
+    this->debt += _wall - limit;
+    return;
+  }
+
+  const int64_t now = wallNow();
+  int64_t last = this->lastWarning;
+  if (now - last >= kWarningPeriod &&
+      this->lastWarning.compare_exchange_strong(last, now))
+  {
+    gzwarn << "Plugin[" << this->name << "] took " << _wall * 1e-6
+           << " ms, over its budget of " << limit * 1e-6 << " ms. "
+           << this->overBudget << " calls over budget so far.\n";
+  }
+}
+
+/////////////////////////////////////////////////
+PluginOwner::PluginOwner(PluginUsagePtr _usage)
+  : previous(g_owner)
+{
+  g_owner = _usage;
+}
+
+/////////////////////////////////////////////////
+PluginOwner::~PluginOwner()
+{
+  g_owner = this->previous;
+}
+
+/////////////////////////////////////////////////
+PluginUsagePtr PluginOwner::Current()
+{
+  return g_owner;
+}
+
+/////////////////////////////////////////////////
+PluginCall::PluginCall(PluginUsage &_usage, const bool _skippable)
+  : usage(_usage)
+{
+  this->skipped = !this->usage.Start(_skippable);
+  if (this->skipped || !this->usage.Timed())
+    return;
+
+  this->timed = true;
+  this->wallStart = wallNow();
+  this->cpuStart = cpuNow();
+}
+
+/////////////////////////////////////////////////
+PluginCall::~PluginCall()
+{
+  if (this->timed)
+  {
+    this->usage.Stop(wallNow() - this->wallStart,
+        cpuNow() - this->cpuStart);
+  }
+}
+
+/////////////////////////////////////////////////
+bool PluginCall::Skipped() const
+{
+  return this->skipped;
+}
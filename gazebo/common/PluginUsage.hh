@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PLUGINUSAGE_HH_
+#define GAZEBO_COMMON_PLUGINUSAGE_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/CommonTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \class PluginUsage PluginUsage.hh common/common.hh
+    /// \brief Time spent by a plugin in its event callbacks.
+    ///
+    /// Event connections made while a PluginOwner is in scope belong to
+    /// its plugin, and every call of their callbacks is counted. The wall
+    /// time and the CPU time of the calling thread are only measured while
+    /// the world of the plugin is profiled, or while the plugin has a
+    /// budget.
+    ///
+    /// A budget is the wall time a plugin may spend per call. A call over
+    /// budget is counted and warned about, or, if the plugin skips over
+    /// budget, its excess time is paid back by skipping its next calls to
+    /// the events of a world step. Other events, such as world reset, are
+    /// always delivered, see event::Event::Skippable().
+    class GZ_COMMON_VISIBLE PluginUsage
+    {
+      /// \brief Constructor.
+      /// \param[in] _name Scoped name of the plugin.
+      /// \param[in] _world Name of the world of the plugin.
+      public: PluginUsage(const std::string &_name, const std::string &_world);
+
+      /// \brief Create the usage of a plugin, and register it with its
+      /// world.
+      /// \param[in] _name Scoped name of the plugin.
+      /// \param[in] _world Name of the world of the plugin.
+      /// \return The usage.
+      public: static PluginUsagePtr Create(const std::string &_name,
+                  const std::string &_world);
+
+      /// \brief Get the usage of the live plugins of a world.
+      /// \param[in] _world Name of the world.
+      /// \param[out] _usage The usage, in order of creation.
+      public: static void WorldUsage(const std::string &_world,
+                  std::vector<PluginUsagePtr> &_usage);
+
+      /// \brief Turn time measurement on or off for the plugins of a world.
+      /// \param[in] _world Name of the world.
+      /// \param[in] _profile True to measure time.
+      public: static void SetProfiled(const std::string &_world,
+                  const bool _profile);
+
+      /// \brief Get the scoped name of the plugin.
+      /// \return Name of the plugin.
+      public: const std::string &Name() const;
+
+      /// \brief Get the world of the plugin.
+      /// \return Name of the world.
+      public: const std::string &World() const;
+
+      /// \brief Set the budget.
+      /// \param[in] _budget Wall time per call, in seconds. Zero for no
+      /// budget.
+      /// \param[in] _skip True to skip calls to pay back time over budget,
+      /// false to only warn.
+      public: void SetBudget(const double _budget, const bool _skip);
+
+      /// \brief Get the budget.
+      /// \return Wall time per call, in seconds. Zero for no budget.
+      public: double Budget() const;
+
+      /// \brief Get whether calls are skipped to stay within budget.
+      /// \return True if calls are skipped.
+      public: bool SkipOverBudget() const;
+
+      /// \brief Get whether calls are timed.
+      /// \return True if the world is profiled or the plugin has a budget.
+      public: bool Timed() const;
+
+      /// \brief Number of calls, skipped ones included.
+      /// \return Calls since creation.
+      public: uint64_t Calls() const;
+
+      /// \brief Number of skipped calls.
+      /// \return Skipped calls since creation.
+      public: uint64_t Skipped() const;
+
+      /// \brief Number of calls over budget.
+      /// \return Calls over budget since creation.
+      public: uint64_t OverBudget() const;
+
+      /// \brief Wall time of the timed calls.
+      /// \return Total time, in seconds.
+      public: double WallTime() const;
+
+      /// \brief CPU time of the timed calls.
+      /// \return Total time, in seconds.
+      public: double CpuTime() const;
+
+      /// \brief Longest wall time of a call.
+      /// \return Time, in seconds.
+      public: double MaxWallTime() const;
+
+      /// \brief Count a call, and tell whether it is skipped to pay back
+      /// time over budget.
+      /// \param[in] _skippable False if the call must not be skipped.
+      /// \return False if the call is skipped.
+      private: bool Start(const bool _skippable);
+
+      /// \brief Account for a timed call.
+      /// \param[in] _wall Wall time of the call, in nanoseconds.
+      /// \param[in] _cpu CPU time of the call, in nanoseconds.
+      private: void Stop(const int64_t _wall, const int64_t _cpu);
+
+      /// \brief Scoped name of the plugin.
+      private: const std::string name;
+
+      /// \brief Name of the world.
+      private: const std::string world;
+
+      /// \brief True while the world is profiled.
+      private: std::atomic<bool> profiled{false};
+
+      /// \brief Budget, in nanoseconds.
+      private: std::atomic<int64_t> budget{0};
+
+      /// \brief True to skip calls over budget.
+      private: std::atomic<bool> skip{false};
+
+      /// \brief Time over budget still to pay back, in nanoseconds.
+      private: std::atomic<int64_t> debt{0};
+
+      /// \brief Number of calls.
+      private: std::atomic<uint64_t> calls{0};
+
+      /// \brief Number of skipped calls.
+      private: std::atomic<uint64_t> skipped{0};
+
+      /// \brief Number of calls over budget.
+      private: std::atomic<uint64_t> overBudget{0};
+
+      /// \brief Wall time, in nanoseconds.
+      private: std::atomic<int64_t> wallTime{0};
+
+      /// \brief CPU time, in nanoseconds.
+      private: std::atomic<int64_t> cpuTime{0};
+
+      /// \brief Longest call, in nanoseconds.
+      private: std::atomic<int64_t> maxWallTime{0};
+
+      /// \brief Steady clock time of the last warning, in nanoseconds.
+      private: std::atomic<int64_t> lastWarning{0};
+
+      /// \brief Friend class.
+      friend class PluginCall;
+    };
+
+    /// \class PluginOwner PluginUsage.hh common/common.hh
+    /// \brief While in scope, makes a plugin the owner of the event
+    /// connections made by the current thread. Scopes nest.
+    class GZ_COMMON_VISIBLE PluginOwner
+    {
+      /// \brief Constructor.
+      /// \param[in] _usage Usage of the plugin.
+      public: explicit PluginOwner(PluginUsagePtr _usage);
+
+      /// \brief Destructor. Restores the previous owner.
+      public: ~PluginOwner();
+
+      /// \brief Get the owner of the connections made by the current
+      /// thread.
+      /// \return Usage of the plugin, null if none.
+      public: static PluginUsagePtr Current();
+
+      /// \brief Previous owner.
+      private: PluginUsagePtr previous;
+    };
+
+    /// \class PluginCall PluginUsage.hh common/common.hh
+    /// \brief Accounts for one call of a plugin callback while in scope.
+    class GZ_COMMON_VISIBLE PluginCall
+    {
+      /// \brief Constructor.
+      /// \param[in] _usage Usage of the plugin.
+      /// \param[in] _skippable False if the call must not be skipped, for
+      /// events other than those of a world step.
+      public: PluginCall(PluginUsage &_usage, const bool _skippable);
+
+      /// \brief Destructor.
+      public: ~PluginCall();
+
+      /// \brief Get whether the call must be skipped.
+      /// \return True to skip the callback.
+      public: bool Skipped() const;
+
+      /// \brief Usage of the plugin.
+      private: PluginUsage &usage;
+
+      /// \brief True if the call is timed.
+      private: bool timed = false;
+
+      /// \brief True if the call is skipped.
+      private: bool skipped = false;
+
+      /// \brief Steady clock time at the start, in nanoseconds.
+      private: int64_t wallStart = 0;
+
+      /// \brief Thread CPU time at the start, in nanoseconds.
+      private: int64_t cpuStart = 0;
+    };
+    /// \}
+  }
+}
+#endif
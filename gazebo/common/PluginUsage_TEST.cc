@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/common/PluginUsage.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class PluginUsageTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(PluginUsageTest, Owner)
+{
+  common::PluginUsagePtr usage =
+    common::PluginUsage::Create("world::model::plugin", "owner_world");
+  EXPECT_EQ(usage->Name(), "world::model::plugin");
+  EXPECT_EQ(usage->World(), "owner_world");
+  EXPECT_FALSE(usage->Timed());
+
+  event::EventT<void (int)> evt;
+  int owned = 0;
+  int notOwned = 0;
+
+  event::ConnectionPtr ownedConn;
+  {
+    common::PluginOwner owner(usage);
+    EXPECT_EQ(common::PluginOwner::Current(), usage);
+    ownedConn = evt.Connect([&owned](int _v) { owned += _v; });
+  }
+  EXPECT_TRUE(common::PluginOwner::Current() == nullptr);
+  event::ConnectionPtr conn = evt.Connect(
+      [&notOwned](int _v) { notOwned += _v; });
+
+  // Calls are counted, but not timed until the world is profiled
+  evt(2);
+  EXPECT_EQ(owned, 2);
+  EXPECT_EQ(notOwned, 2);
+  EXPECT_EQ(usage->Calls(), 1u);
+  EXPECT_DOUBLE_EQ(usage->WallTime(), 0.0);
+
+  common::PluginUsage::SetProfiled("owner_world", true);
+  EXPECT_TRUE(usage->Timed());
+  evt(1);
+  EXPECT_EQ(usage->Calls(), 2u);
+  EXPECT_GT(usage->WallTime(), 0.0);
+  EXPECT_GE(usage->MaxWallTime(), 0.0);
+
+  std::vector<common::PluginUsagePtr> usages;
+  common::PluginUsage::WorldUsage("owner_world", usages);
+  ASSERT_EQ(usages.size(), 1u);
+  EXPECT_EQ(usages[0], usage);
+
+  common::PluginUsage::WorldUsage("other_world", usages);
+  EXPECT_TRUE(usages.empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(PluginUsageTest, Budget)
+{
+  common::PluginUsagePtr usage =
+    common::PluginUsage::Create("plugin", "budget_world");
+
+  event::EventT<void ()> evt(true);
+  int calls = 0;
+  event::ConnectionPtr conn;
+  {
+    common::PluginOwner owner(usage);
+    conn = evt.Connect([&calls]()
+        {
+          ++calls;
+          common::Time::MSleep(2);
+        });
+  }
+
+  // Warn only
+  usage->SetBudget(0.001, false);
+  EXPECT_DOUBLE_EQ(usage->Budget(), 0.001);
+  EXPECT_FALSE(usage->SkipOverBudget());
+  EXPECT_TRUE(usage->Timed());
+  evt();
+  evt();
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(usage->OverBudget(), 2u);
+  EXPECT_EQ(usage->Skipped(), 0u);
+
+  // A call of at least 2 ms over a 1 ms budget is paid back by skipping at
+  // least the next call
+  usage->SetBudget(0.001, true);
+  evt();
+  EXPECT_EQ(calls, 3);
+  evt();
+  EXPECT_EQ(calls, 3);
+  EXPECT_EQ(usage->Skipped(), 1u);
+  EXPECT_EQ(usage->Calls(), 4u);
+
+  // Without a budget, nothing is skipped
+  usage->SetBudget(0, true);
+  evt();
+  EXPECT_EQ(calls, 4);
+}
+
+/////////////////////////////////////////////////
+TEST_F(PluginUsageTest, LifecycleEventsNotSkipped)
+{
+  common::PluginUsagePtr usage =
+    common::PluginUsage::Create("plugin", "lifecycle_world");
+  usage->SetBudget(0.001, true);
+
+  int updates = 0;
+  int resets = 0;
+  int stops = 0;
+  int pauses = 0;
+  int deletes = 0;
+  std::vector<event::ConnectionPtr> connections;
+  {
+    common::PluginOwner owner(usage);
+    connections.push_back(event::Events::ConnectWorldUpdateEnd([&updates]()
+        {
+          ++updates;
+          common::Time::MSleep(5);
+        }));
+    connections.push_back(event::Events::ConnectWorldReset(
+        [&resets]() { ++resets; }));
+    connections.push_back(event::Events::ConnectStop(
+        [&stops]() { ++stops; }));
+    connections.push_back(event::Events::ConnectPause(
+        [&pauses](bool) { ++pauses; }));
+    connections.push_back(event::Events::ConnectDeleteEntity(
+        [&deletes](std::string) { ++deletes; }));
+  }
+
+  // Only the per-step events can be skipped
+  EXPECT_TRUE(event::Events::worldUpdateBegin.Skippable());
+  EXPECT_TRUE(event::Events::beforePhysicsUpdate.Skippable());
+  EXPECT_TRUE(event::Events::worldUpdateEnd.Skippable());
+  EXPECT_FALSE(event::Events::worldReset.Skippable());
+  EXPECT_FALSE(event::Events::stop.Skippable());
+  EXPECT_FALSE(event::Events::pause.Skippable());
+  EXPECT_FALSE(event::Events::deleteEntity.Skippable());
+
+  // The plugin goes over budget, and skips the next update
+  event::Events::worldUpdateEnd();
+  EXPECT_EQ(updates, 1);
+  EXPECT_EQ(usage->OverBudget(), 1u);
+
+  // While it owes time, the lifecycle events still reach it
+  event::Events::worldReset();
+  event::Events::pause(true);
+  event::Events::deleteEntity("model");
+  event::Events::stop();
+  EXPECT_EQ(resets, 1);
+  EXPECT_EQ(pauses, 1);
+  EXPECT_EQ(deletes, 1);
+  EXPECT_EQ(stops, 1);
+  EXPECT_EQ(usage->Skipped(), 0u);
+
+  event::Events::worldUpdateEnd();
+  EXPECT_EQ(updates, 1);
+  EXPECT_EQ(usage->Skipped(), 1u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,6 +15,9 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+
 #include "gazebo/common/SkeletonAnimation.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Assert.hh"
@@ -335,3 +338,186 @@ double SkeletonAnimation::GetLength() const
 {
   return this->length;
 }
+
+//////////////////////////////////////////////////
+const NodeAnimation *SkeletonAnimation::NodeAnimationByName(
+    const std::string &_node) const
+{
+  auto iter = this->animations.find(_node);
+  if (iter == this->animations.end())
+    return nullptr;
+  return iter->second;
+}
+
+//////////////////////////////////////////////////
+SkeletonClip::SkeletonClip(const SkeletonAnimation &_anim,
+    const std::vector<std::string> &_nodes)
+{
+  this->tracks.resize(_nodes.size());
+  for (unsigned int i = 0; i < _nodes.size(); ++i)
+  {
+    const NodeAnimation *nodeAnim = _anim.NodeAnimationByName(_nodes[i]);
+    if (!nodeAnim || nodeAnim->GetFrameCount() == 0)
+      continue;
+
+    Timeline timeline;
+    Track &track = this->tracks[i];
+    for (unsigned int k = 0; k < nodeAnim->GetFrameCount(); ++k)
+    {
+      auto keyFrame = nodeAnim->KeyFrame(k);
+      timeline.times.push_back(keyFrame.first);
+      track.frames.push_back(keyFrame.second);
+      track.positions.push_back(keyFrame.second.Translation());
+      track.rotations.push_back(keyFrame.second.Rotation());
+    }
+
+    // Share the timeline with other tracks that have the same key times
+    for (unsigned int t = 0; t < this->timelines.size(); ++t)
+    {
+      if (this->timelines[t].times == timeline.times)
+      {
+        track.timeline = t;
+        break;
+      }
+    }
+
+    if (track.timeline < 0)
+    {
+      track.timeline = this->timelines.size();
+      this->timelines.push_back(timeline);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int SkeletonClip::TrackCount() const
+{
+  return this->tracks.size();
+}
+
+//////////////////////////////////////////////////
+bool SkeletonClip::HasTrack(const unsigned int _track) const
+{
+  return _track < this->tracks.size() && this->tracks[_track].timeline >= 0;
+}
+
+//////////////////////////////////////////////////
+SkeletonClip::Sample SkeletonClip::SampleAt(const Timeline &_timeline,
+    const double _time, const bool _loop)
+{
+  Sample sample;
+  const std::vector<double> &times = _timeline.times;
+  const double length = times.back();
+
+  double time = _time;
+  if (time > length)
+  {
+    if (_loop && length > 0)
+    {
+      // Wrap into (0, length], like NodeAnimation::FrameAt
+      time = std::fmod(time, length);
+      if (time <= 0)
+        time += length;
+    }
+    else
+      time = length;
+  }
+
+  if (ignition::math::equal(time, length))
+  {
+    sample.key = times.size() - 1;
+    return sample;
+  }
+
+  auto next = std::upper_bound(times.begin(), times.end(), time);
+  if (next == times.end())
+  {
+    sample.key = times.size() - 1;
+    return sample;
+  }
+
+  sample.key = next - times.begin();
+  if (next == times.begin() || ignition::math::equal(*next, time))
+    return sample;
+
+  const double prevKey = *(next - 1);
+  sample.t = (time - prevKey) / (*next - prevKey);
+  sample.interpolate = true;
+  return sample;
+}
+
+//////////////////////////////////////////////////
+void SkeletonClip::PoseAt(const double _time, const bool _loop,
+    std::vector<ignition::math::Matrix4d> &_poses) const
+{
+  _poses.resize(this->tracks.size());
+
+  // Search each timeline once, for all the tracks that share it
+  std::vector<Sample> samples(this->timelines.size());
+  for (unsigned int t = 0; t < this->timelines.size(); ++t)
+    samples[t] = SampleAt(this->timelines[t], _time, _loop);
+
+  for (unsigned int i = 0; i < this->tracks.size(); ++i)
+  {
+    const Track &track = this->tracks[i];
+    if (track.timeline < 0)
+      continue;
+
+    const Sample &sample = samples[track.timeline];
+    if (!sample.interpolate)
+    {
+      _poses[i] = track.frames[sample.key];
+      continue;
+    }
+
+    const ignition::math::Vector3d &prevPos = track.positions[sample.key - 1];
+    const ignition::math::Vector3d &nextPos = track.positions[sample.key];
+    ignition::math::Vector3d pos(
+        prevPos.X() + ((nextPos.X() - prevPos.X()) * sample.t),
+        prevPos.Y() + ((nextPos.Y() - prevPos.Y()) * sample.t),
+        prevPos.Z() + ((nextPos.Z() - prevPos.Z()) * sample.t));
+
+    ignition::math::Quaterniond rot = ignition::math::Quaterniond::Slerp(
+        sample.t, track.rotations[sample.key - 1], track.rotations[sample.key],
+        true);
+
+    _poses[i] = ignition::math::Matrix4d(rot);
+    _poses[i].SetTranslation(pos);
+  }
+}
+
+//////////////////////////////////////////////////
+double SkeletonClip::TimeAtX(const double _x, const unsigned int _track,
+    const bool _loop) const
+{
+  GZ_ASSERT(this->HasTrack(_track), "Track has no key frames");
+
+  const Track &track = this->tracks[_track];
+  const std::vector<double> &times = this->timelines[track.timeline].times;
+
+  double x = std::max(_x, track.positions.front().X());
+  const double lastX = track.positions.back().X();
+  if (x > lastX)
+  {
+    if (_loop && lastX > 0)
+    {
+      x = std::fmod(x, lastX);
+      if (x <= 0)
+        x += lastX;
+    }
+    else
+      x = lastX;
+  }
+
+  // Same search as NodeAnimation::GetTimeAtX
+  unsigned int k = 0;
+  while (k + 1 < track.positions.size() && track.positions[k].X() < x)
+    ++k;
+
+  if (k == 0 || ignition::math::equal(track.positions[k].X(), x))
+    return times[k];
+
+  const double x1 = track.positions[k - 1].X();
+  const double x2 = track.positions[k].X();
+  return times[k - 1] + ((times[k] - times[k - 1]) * (x - x1) / (x2 - x1));
+}
@@ -20,9 +20,12 @@
 #include <map>
 #include <utility>
 #include <string>
+#include <vector>
 
 #include <ignition/math/Matrix4.hh>
 #include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
 
 #include "gazebo/util/system.hh"
 #include "gazebo/common/CommonTypes.hh"
@@ -209,6 +212,12 @@ namespace gazebo
       /// \return the duration in seconds
       public: double GetLength() const;
 
+      /// \brief Returns the animation of a node
+      /// \param[in] _node the name of the animation node
+      /// \return the node animation, or null if the node is not animated
+      public: const NodeAnimation *NodeAnimationByName(
+                  const std::string &_node) const;
+
       /// \brief the node name
       protected: std::string name;
 
@@ -218,6 +227,109 @@ namespace gazebo
       /// \brief a dictionary of node animations
       protected: std::map<std::string, NodeAnimation*> animations;
     };
+
+    /// \class SkeletonClip SkeletonAnimation.hh common/common.hh
+    /// \brief A skeleton animation compiled for fast sampling. Nodes are
+    /// addressed by index instead of by name, and key frames are stored in
+    /// flat arrays with their translations and rotations already extracted.
+    /// Nodes whose key frames are at the same times share the search for
+    /// the key frames around a sampling time.
+    ///
+    /// Sampling gives the same transformations as
+    /// SkeletonAnimation::PoseAt and SkeletonAnimation::PoseAtX. A clip
+    /// holds a copy of the key frames, and must be compiled again if the
+    /// animation changes.
+    class GZ_COMMON_VISIBLE SkeletonClip
+    {
+      /// \brief Constructor.
+      /// \param[in] _anim the animation to compile
+      /// \param[in] _nodes the names of the animation nodes, in the order
+      /// they are addressed in the clip. Names that are empty or not
+      /// animated give tracks without key frames.
+      public: SkeletonClip(const SkeletonAnimation &_anim,
+                  const std::vector<std::string> &_nodes);
+
+      /// \brief Returns the number of tracks, one per compiled node.
+      /// \return the count
+      public: unsigned int TrackCount() const;
+
+      /// \brief Returns whether a track has key frames.
+      /// \param[in] _track the track index
+      /// \return true if the track is animated
+      public: bool HasTrack(const unsigned int _track) const;
+
+      /// \brief Samples every track at a specific time, equivalent to
+      /// SkeletonAnimation::PoseAt.
+      /// \param[in] _time the time
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// \param[out] _poses the transformation of every track, resized to
+      /// TrackCount(). Tracks without key frames are left untouched.
+      public: void PoseAt(const double _time, const bool _loop,
+                  std::vector<ignition::math::Matrix4d> &_poses) const;
+
+      /// \brief Returns the time at which a track's translational value
+      /// along the X axis is equal to _x, clamped or wrapped like
+      /// SkeletonAnimation::PoseAtX. Sampling PoseAt at the returned time
+      /// is equivalent to SkeletonAnimation::PoseAtX.
+      /// \param[in] _x the value along x
+      /// \param[in] _track the track index, which must have key frames
+      /// \param[in] _loop when true, _x is divided by the last value
+      /// \return the time
+      public: double TimeAtX(const double _x, const unsigned int _track,
+                  const bool _loop) const;
+
+      /// \brief Key frame times shared by one or more tracks.
+      private: class Timeline
+      {
+        /// \brief Times of the key frames, in increasing order.
+        public: std::vector<double> times;
+      };
+
+      /// \brief Key frames of one node.
+      private: class Track
+      {
+        /// \brief Index of the timeline of the track, -1 if the track has
+        /// no key frames.
+        public: int timeline = -1;
+
+        /// \brief Key frame transformations.
+        public: std::vector<ignition::math::Matrix4d> frames;
+
+        /// \brief Translations of the key frames.
+        public: std::vector<ignition::math::Vector3d> positions;
+
+        /// \brief Rotations of the key frames.
+        public: std::vector<ignition::math::Quaterniond> rotations;
+      };
+
+      /// \brief Where a timeline is sampled.
+      private: class Sample
+      {
+        /// \brief Index of the key frame after the sampling time, or of
+        /// the key frame at the sampling time.
+        public: unsigned int key = 0;
+
+        /// \brief Interpolation factor from the previous key frame.
+        public: double t = 0.0;
+
+        /// \brief True to interpolate, false to use the key frame as is.
+        public: bool interpolate = false;
+      };
+
+      /// \brief Find where a timeline is sampled at a specific time.
+      /// \param[in] _timeline the timeline
+      /// \param[in] _time the time
+      /// \param[in] _loop when true, the time is divided by the duration
+      /// \return the sample
+      private: static Sample SampleAt(const Timeline &_timeline,
+                  const double _time, const bool _loop);
+
+      /// \brief All timelines.
+      private: std::vector<Timeline> timelines;
+
+      /// \brief All tracks.
+      private: std::vector<Track> tracks;
+    };
     /// \}
   }
 }
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/SkeletonAnimation.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SkeletonAnimationTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Check that two transformations are equal within a tolerance.
+/// \param[in] _a First transformation.
+/// \param[in] _b Second transformation.
+void ExpectNear(const ignition::math::Matrix4d &_a,
+    const ignition::math::Matrix4d &_b)
+{
+  for (unsigned int r = 0; r < 4; ++r)
+  {
+    for (unsigned int c = 0; c < 4; ++c)
+      EXPECT_NEAR(_a(r, c), _b(r, c), 1e-9);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(SkeletonAnimationTest, ClipMatchesPoseAt)
+{
+  common::SkeletonAnimation anim("walk");
+
+  // Two nodes share key times, the third has its own
+  for (unsigned int k = 0; k <= 10; ++k)
+  {
+    double time = k * 0.1;
+    anim.AddKeyFrame("hip", time, ignition::math::Pose3d(
+        k * 0.2, 0, 1, 0, 0, k * 0.3));
+    anim.AddKeyFrame("knee", time, ignition::math::Pose3d(
+        0, 0, -0.5, k * 0.15, 0, 0));
+  }
+  for (unsigned int k = 0; k <= 4; ++k)
+  {
+    anim.AddKeyFrame("head", k * 0.3, ignition::math::Pose3d(
+        0, 0, 0.3, 0, k * 0.1, 0));
+  }
+
+  std::vector<std::string> nodes = {"knee", "", "hip", "missing", "head"};
+  common::SkeletonClip clip(anim, nodes);
+  EXPECT_EQ(clip.TrackCount(), nodes.size());
+  EXPECT_TRUE(clip.HasTrack(0));
+  EXPECT_FALSE(clip.HasTrack(1));
+  EXPECT_TRUE(clip.HasTrack(2));
+  EXPECT_FALSE(clip.HasTrack(3));
+  EXPECT_TRUE(clip.HasTrack(4));
+  EXPECT_FALSE(clip.HasTrack(5));
+
+  std::vector<ignition::math::Matrix4d> poses;
+  for (double time : {0.0, 0.05, 0.1, 0.3333, 0.6, 0.95, 1.0, 1.2, 2.75})
+  {
+    for (bool loop : {true, false})
+    {
+      std::map<std::string, ignition::math::Matrix4d> frame =
+          anim.PoseAt(time, loop);
+      clip.PoseAt(time, loop, poses);
+      ASSERT_EQ(poses.size(), nodes.size());
+
+      for (unsigned int i = 0; i < nodes.size(); ++i)
+      {
+        if (clip.HasTrack(i))
+          ExpectNear(poses[i], frame[nodes[i]]);
+      }
+    }
+  }
+
+  // Sampling along X matches PoseAtX
+  for (double x : {0.0, 0.3, 1.1, 1.9, 2.0, 2.5})
+  {
+    std::map<std::string, ignition::math::Matrix4d> frame =
+        anim.PoseAtX(x, "hip");
+    clip.PoseAt(clip.TimeAtX(x, 2, true), true, poses);
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+      if (clip.HasTrack(i))
+        ExpectNear(poses[i], frame[nodes[i]]);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -345,6 +345,8 @@ void IncrementalPlot::Update()
   ignition::math::Vector2d lastPoint;
   for (auto &curve : this->dataPtr->curves)
   {
+    curve.second->SetResolution(this->canvas()->width());
+
     if (!curve.second->Active())
       continue;
 
@@ -14,7 +14,10 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
 #include <map>
+#include <vector>
 #include <ignition/math/Color.hh>
 
 #include "gazebo/common/Assert.hh"
@@ -45,25 +48,166 @@ namespace gazebo
           Colors[ColorGroupCount][ColorCount];
     };
 
-    /// \brief A class that manages curve data
-    class CurveData: public QwtArraySeriesData<QPointF>
+    /// \brief Bounds of a range of consecutive samples.
+    class SampleBlock
     {
+      /// \brief Start a block with a single sample.
+      /// \param[in] _point The sample.
+      /// \param[in] _index Index of the sample.
+      public: void Reset(const QPointF &_point, const uint64_t _index)
+              {
+                this->minX = this->maxX = _point.x();
+                this->minY = this->maxY = _point.y();
+                this->minYIndex = this->maxYIndex = _index;
+              }
+
+      /// \brief Add a sample to the block.
+      /// \param[in] _point The sample.
+      /// \param[in] _index Index of the sample.
+      public: void Merge(const QPointF &_point, const uint64_t _index)
+              {
+                this->minX = std::min(this->minX, _point.x());
+                this->maxX = std::max(this->maxX, _point.x());
+                if (_point.y() < this->minY)
+                {
+                  this->minY = _point.y();
+                  this->minYIndex = _index;
+                }
+                if (_point.y() > this->maxY)
+                {
+                  this->maxY = _point.y();
+                  this->maxYIndex = _index;
+                }
+              }
+
+      /// \brief Add the samples of another block.
+      /// \param[in] _block Block to add.
+      public: void Merge(const SampleBlock &_block)
+              {
+                this->minX = std::min(this->minX, _block.minX);
+                this->maxX = std::max(this->maxX, _block.maxX);
+                if (_block.minY < this->minY)
+                {
+                  this->minY = _block.minY;
+                  this->minYIndex = _block.minYIndex;
+                }
+                if (_block.maxY > this->maxY)
+                {
+                  this->maxY = _block.maxY;
+                  this->maxYIndex = _block.maxYIndex;
+                }
+              }
+
+      /// \brief Smallest x value.
+      public: double minX = 0;
+
+      /// \brief Largest x value.
+      public: double maxX = 0;
+
+      /// \brief Smallest y value.
+      public: double minY = 0;
+
+      /// \brief Largest y value.
+      public: double maxY = 0;
+
+      /// \brief Index of the sample with the smallest y value.
+      public: uint64_t minYIndex = 0;
+
+      /// \brief Index of the sample with the largest y value.
+      public: uint64_t maxYIndex = 0;
+    };
+
+    /// \brief Decimated samples of one pixel column of the plot.
+    class SampleColumn
+    {
+      /// \brief Index of the first sample in the column.
+      public: uint64_t first = 0;
+
+      /// \brief Index past the last sample in the column.
+      public: uint64_t end = 0;
+
+      /// \brief True if no more samples can fall in the column.
+      public: bool complete = false;
+
+      /// \brief First, lowest, highest and last samples, in order.
+      public: std::vector<QPointF> points;
+    };
+
+    /// \brief A class that manages curve data.
+    ///
+    /// Samples are kept in a ring buffer of fixed capacity, so that old
+    /// samples are overwritten in constant time. A pyramid of min/max
+    /// blocks over the ring lets the curve present Qwt with at most four
+    /// samples per pixel column of the visible x range: the first, lowest,
+    /// highest and last sample of the column. This draws the same pixels as
+    /// the full series while the drawing cost follows the plot width.
+    /// Samples are indexed by the number of samples added before them, so
+    /// that indices stay valid while the ring wraps around.
+    class CurveData: public QwtSeriesData<QPointF>
+    {
+      /// \brief Number of samples summarized by a block of the first
+      /// level of the pyramid. Each level groups this many blocks of the
+      /// level below.
+      public: static const uint64_t BlockSize = 64;
+
+      /// \brief Number of levels of the pyramid.
+      public: static const unsigned int LevelCount = 3;
+
+      /// \brief Constructor.
       public: CurveData()
-              {}
+              {
+                this->SetCapacity(11000);
+              }
+
+      // Documentation inherited
+      public: virtual size_t size() const
+              {
+                this->UpdateView();
+                return this->view.size();
+              }
+
+      // Documentation inherited
+      public: virtual QPointF sample(size_t _i) const
+              {
+                this->UpdateView();
+                return this->view[_i];
+              }
+
+      // Documentation inherited
+      public: virtual void setRectOfInterest(const QRectF &_rect)
+              {
+                if (_rect.left() != this->rectOfInterest.left() ||
+                    _rect.right() != this->rectOfInterest.right())
+                {
+                  this->viewDirty = true;
+                }
+                this->rectOfInterest = _rect;
+              }
 
       /// \brief Add a point to the sample.
       /// \return Bounding box of the sample.
       public: virtual QRectF boundingRect() const
               {
-                if (this->d_boundingRect.width() < 0.0)
-                  this->d_boundingRect = qwtBoundingRect(*this);
+                if (this->boundsDirty)
+                {
+                  this->boundsDirty = false;
+                  if (this->Count() == 0u)
+                    this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+                  else
+                  {
+                    SampleBlock bounds = this->Bounds(this->first, this->end);
+                    this->d_boundingRect = QRectF(
+                        QPointF(bounds.minX, bounds.minY),
+                        QPointF(bounds.maxX, bounds.maxY));
+                  }
+                }
 
                 // set a minimum bounding box height
                 // this prevents plot's auto scale to zoom in on near-zero
                 // floating point noise.
                 double minHeight = 1e-3;
                 double absHeight = std::fabs(this->d_boundingRect.height());
-                if (absHeight < minHeight)
+                if (this->Count() > 0u && absHeight < minHeight)
                 {
                   double halfMinHeight = minHeight * 0.5;
                   double mid = this->d_boundingRect.top() +
@@ -79,54 +223,298 @@ namespace gazebo
       /// \param[in] _point Point to add.
       public: inline void Add(const QPointF &_point)
               {
-                this->d_samples += _point;
+                const uint64_t index = this->end;
+                if (index > this->first && _point.x() < this->At(index - 1).x())
+                  this->monotonic = false;
 
-                if (this->d_samples.size() > maxSampleSize)
-                {
-                  // remove sample window
-                  // update bounding rect?
-                  this->d_samples.remove(0, windowSize);
-                }
+                if (this->samples.size() < this->capacity)
+                  this->samples.push_back(_point);
+                else
+                  this->samples[index % this->capacity] = _point;
+
+                ++this->end;
+                if (this->end - this->first > this->capacity)
+                  ++this->first;
 
-                if (this->d_samples.size() == 1)
+                uint64_t blockSize = 1;
+                for (auto &level : this->levels)
                 {
-                  // init bounding rect
-                  this->d_boundingRect.setTopLeft(_point);
-                  this->d_boundingRect.setBottomRight(_point);
-                  return;
+                  blockSize *= BlockSize;
+                  SampleBlock &block = level[(index / blockSize) % level.size()];
+                  if (index % blockSize == 0)
+                    block.Reset(_point, index);
+                  else
+                    block.Merge(_point, index);
                 }
 
-                // expand bounding rect
-                if (_point.x() < this->d_boundingRect.left())
-                  this->d_boundingRect.setLeft(_point.x());
-                else if (_point.x() > this->d_boundingRect.right())
-                  this->d_boundingRect.setRight(_point.x());
-                if (_point.y() < this->d_boundingRect.top())
-                  this->d_boundingRect.setTop(_point.y());
-                else if (_point.y() > this->d_boundingRect.bottom())
-                  this->d_boundingRect.setBottom(_point.y());
+                this->viewDirty = true;
+                this->boundsDirty = true;
               }
 
       /// \brief Clear the sample data.
       public: void Clear()
               {
-                this->d_samples.clear();
-                this->d_samples.squeeze();
-                this->d_boundingRect = QRectF(0.0, 0.0, -1.0, -1.0);
+                this->samples.clear();
+                this->samples.shrink_to_fit();
+                this->first = 0;
+                this->end = 0;
+                this->monotonic = true;
+                this->columns.clear();
+                this->viewDirty = true;
+                this->boundsDirty = true;
+              }
+
+      /// \brief Set the maximum number of samples. The oldest samples are
+      /// dropped when the capacity is reached.
+      /// \param[in] _capacity Maximum number of samples.
+      public: void SetCapacity(const size_t _capacity)
+              {
+                std::vector<QPointF> kept;
+                const uint64_t count = std::min<uint64_t>(this->Count(),
+                    _capacity);
+                for (uint64_t i = this->end - count; i < this->end; ++i)
+                  kept.push_back(this->At(i));
+
+                this->capacity = std::max<size_t>(_capacity, 1u);
+                this->levels.resize(LevelCount);
+                uint64_t blockSize = 1;
+                for (auto &level : this->levels)
+                {
+                  // Two more blocks than needed, for the partial blocks at
+                  // both ends of the ring.
+                  blockSize *= BlockSize;
+                  level.assign(this->capacity / blockSize + 2, SampleBlock());
+                }
+
+                this->Clear();
+                for (auto const &point : kept)
+                  this->Add(point);
+              }
+
+      /// \brief Get the maximum number of samples.
+      /// \return Capacity of the ring buffer.
+      public: size_t Capacity() const
+              {
+                return this->capacity;
+              }
+
+      /// \brief Set the number of pixel columns samples are decimated to.
+      /// \param[in] _resolution Number of columns.
+      public: void SetResolution(const unsigned int _resolution)
+              {
+                if (_resolution != this->resolution)
+                {
+                  this->resolution = std::max(_resolution, 1u);
+                  this->viewDirty = true;
+                }
               }
 
-      /// \brief Get the sample data.
-      /// \return A vector of same points.
-      public: QVector<QPointF> Samples() const
+      /// \brief Get the number of samples.
+      /// \return Number of samples.
+      public: uint64_t Count() const
               {
-                return this->d_samples;
+                return this->end - this->first;
               }
 
-      /// \brief maxium sample size of this curve.
-      private: int maxSampleSize = 11000;
+      /// \brief Get a sample by its position from the oldest sample.
+      /// \param[in] _i Position of the sample, less than Count().
+      /// \return The sample.
+      public: const QPointF &Sample(const uint64_t _i) const
+              {
+                return this->At(this->first + _i);
+              }
 
-      /// \brief Size of samples to remove when maxSampleSize is reached.
-      private: int windowSize = 1000;
+      /// \brief Get a sample by index.
+      /// \param[in] _index Index of the sample, in [first, end).
+      /// \return The sample.
+      private: const QPointF &At(const uint64_t _index) const
+               {
+                 return this->samples[_index % this->capacity];
+               }
+
+      /// \brief Get the bounds of a range of samples.
+      /// \param[in] _first Index of the first sample.
+      /// \param[in] _end Index past the last sample, greater than _first.
+      /// \return Bounds of the samples.
+      private: SampleBlock Bounds(const uint64_t _first,
+                   const uint64_t _end) const
+               {
+                 SampleBlock result;
+                 result.Reset(this->At(_first), _first);
+
+                 uint64_t i = _first + 1;
+                 while (i < _end)
+                 {
+                   // Use the largest block that starts at i and fits in the
+                   // range. Such a block holds no overwritten samples.
+                   bool merged = false;
+                   uint64_t blockSize = 1;
+                   for (unsigned int k = 0; k < LevelCount; ++k)
+                     blockSize *= BlockSize;
+                   for (int k = LevelCount - 1; k >= 0 && !merged; --k)
+                   {
+                     if (i % blockSize == 0 && i + blockSize <= _end)
+                     {
+                       const auto &level = this->levels[k];
+                       result.Merge(level[(i / blockSize) % level.size()]);
+                       i += blockSize;
+                       merged = true;
+                     }
+                     blockSize /= BlockSize;
+                   }
+
+                   if (!merged)
+                   {
+                     result.Merge(this->At(i), i);
+                     ++i;
+                   }
+                 }
+                 return result;
+               }
+
+      /// \brief Find the first sample whose x value is not less than a
+      /// value. Samples must be sorted by x.
+      /// \param[in] _x Value to search for.
+      /// \return Index of the sample, or end if there is none.
+      private: uint64_t LowerBound(const double _x) const
+               {
+                 uint64_t low = this->first;
+                 uint64_t high = this->end;
+                 while (low < high)
+                 {
+                   const uint64_t mid = low + (high - low) / 2;
+                   if (this->At(mid).x() < _x)
+                     low = mid + 1;
+                   else
+                     high = mid;
+                 }
+                 return low;
+               }
+
+      /// \brief Rebuild the samples handed to Qwt if samples were added or
+      /// the visible range changed. Columns are aligned to multiples of
+      /// their width, so that the columns that can no longer change are
+      /// reused while the plot scrolls.
+      private: void UpdateView() const
+               {
+                 if (!this->viewDirty)
+                   return;
+                 this->viewDirty = false;
+                 this->view.clear();
+
+                 const double left = this->rectOfInterest.left();
+                 const double right = this->rectOfInterest.right();
+                 const double width = (right - left) / this->resolution;
+
+                 // Series that are small, unsorted, or without a visible
+                 // range are handed over whole.
+                 if (!this->monotonic ||
+                     this->Count() <= 4u * this->resolution ||
+                     !(width > 0) || !std::isfinite(width))
+                 {
+                   this->columns.clear();
+                   for (uint64_t i = this->first; i < this->end; ++i)
+                     this->view.push_back(this->At(i));
+                   return;
+                 }
+
+                 if (width != this->columnWidth)
+                 {
+                   this->columns.clear();
+                   this->columnWidth = width;
+                 }
+
+                 const int64_t firstColumn =
+                     static_cast<int64_t>(std::floor(left / width));
+                 const int64_t lastColumn =
+                     static_cast<int64_t>(std::floor(right / width));
+                 this->columns.erase(this->columns.begin(),
+                     this->columns.lower_bound(firstColumn));
+                 this->columns.erase(
+                     this->columns.upper_bound(lastColumn),
+                     this->columns.end());
+
+                 // Continue the line from the sample left of the range.
+                 const uint64_t start = this->LowerBound(firstColumn * width);
+                 if (start > this->first)
+                   this->view.push_back(this->At(start - 1));
+
+                 uint64_t columnStart = start;
+                 for (int64_t c = firstColumn; c <= lastColumn; ++c)
+                 {
+                   SampleColumn &column = this->columns[c];
+                   if (!column.complete || column.first < this->first)
+                   {
+                     column.first = columnStart;
+                     column.end = this->LowerBound((c + 1) * width);
+                     column.complete = column.end < this->end;
+                     column.points.clear();
+
+                     if (column.end > column.first)
+                     {
+                       SampleBlock block =
+                           this->Bounds(column.first, column.end);
+                       uint64_t indices[4] = {column.first,
+                           std::min(block.minYIndex, block.maxYIndex),
+                           std::max(block.minYIndex, block.maxYIndex),
+                           column.end - 1};
+                       for (unsigned int i = 0; i < 4; ++i)
+                       {
+                         if (i == 0 || indices[i] != indices[i - 1])
+                           column.points.push_back(this->At(indices[i]));
+                       }
+                     }
+                   }
+                   columnStart = column.end;
+
+                   this->view.insert(this->view.end(), column.points.begin(),
+                       column.points.end());
+                 }
+
+                 // Continue the line to the sample right of the range.
+                 if (columnStart < this->end)
+                   this->view.push_back(this->At(columnStart));
+               }
+
+      /// \brief Ring buffer of samples.
+      private: std::vector<QPointF> samples;
+
+      /// \brief Maximum number of samples.
+      private: size_t capacity = 0;
+
+      /// \brief Index of the oldest sample.
+      private: uint64_t first = 0;
+
+      /// \brief Index past the newest sample.
+      private: uint64_t end = 0;
+
+      /// \brief True while the samples are sorted by x.
+      private: bool monotonic = true;
+
+      /// \brief Pyramid of sample bounds. Level k holds blocks of
+      /// BlockSize^(k+1) samples, in a ring indexed like the samples.
+      private: std::vector<std::vector<SampleBlock> > levels;
+
+      /// \brief Visible range of the plot.
+      private: QRectF rectOfInterest;
+
+      /// \brief Number of pixel columns to decimate to.
+      private: unsigned int resolution = 1024;
+
+      /// \brief Samples handed to Qwt.
+      private: mutable std::vector<QPointF> view;
+
+      /// \brief True if the view must be rebuilt.
+      private: mutable bool viewDirty = true;
+
+      /// \brief True if the bounding rect must be recomputed.
+      private: mutable bool boundsDirty = true;
+
+      /// \brief Decimated columns of the view, by column number.
+      private: mutable std::map<int64_t, SampleColumn> columns;
+
+      /// \brief Width of the columns in x units.
+      private: mutable double columnWidth = 0;
     };
 
 
@@ -342,7 +730,7 @@ void PlotCurve::SetAge(const unsigned int _age)
 /////////////////////////////////////////////////
 unsigned int PlotCurve::Size() const
 {
-  return static_cast<unsigned int>(this->dataPtr->curveData->samples().size());
+  return static_cast<unsigned int>(this->dataPtr->curveData->Count());
 }
 
 /////////////////////////////////////////////////
@@ -362,17 +750,48 @@ ignition::math::Vector2d PlotCurve::Max()
 /////////////////////////////////////////////////
 ignition::math::Vector2d PlotCurve::Point(const unsigned int _index) const
 {
-  if (_index >= static_cast<unsigned int>(
-      this->dataPtr->curveData->samples().size()))
+  if (_index >= this->dataPtr->curveData->Count())
   {
     return ignition::math::Vector2d(ignition::math::NAN_D,
         ignition::math::NAN_D);
   }
 
-  const QPointF &pt = this->dataPtr->curveData->samples()[_index];
+  const QPointF &pt = this->dataPtr->curveData->Sample(_index);
   return ignition::math::Vector2d(pt.x(), pt.y());
 }
 
+/////////////////////////////////////////////////
+std::vector<ignition::math::Vector2d> PlotCurve::Points() const
+{
+  std::vector<ignition::math::Vector2d> points;
+  const uint64_t count = this->dataPtr->curveData->Count();
+  points.reserve(count);
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    const QPointF &pt = this->dataPtr->curveData->Sample(i);
+    points.push_back(ignition::math::Vector2d(pt.x(), pt.y()));
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////
+void PlotCurve::SetCapacity(const unsigned int _capacity)
+{
+  this->dataPtr->curveData->SetCapacity(_capacity);
+}
+
+/////////////////////////////////////////////////
+unsigned int PlotCurve::Capacity() const
+{
+  return static_cast<unsigned int>(this->dataPtr->curveData->Capacity());
+}
+
+/////////////////////////////////////////////////
+void PlotCurve::SetResolution(const unsigned int _resolution)
+{
+  this->dataPtr->curveData->SetResolution(_resolution);
+}
+
 /////////////////////////////////////////////////
 QwtPlotCurve *PlotCurve::Curve()
 {
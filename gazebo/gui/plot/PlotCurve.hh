@@ -103,6 +103,21 @@ namespace gazebo
       /// \return Number of data points.
       public: unsigned int Size() const;
 
+      /// \brief Set the maximum number of points kept by the curve. Once
+      /// it is reached, every new point replaces the oldest one.
+      /// \param[in] _capacity Maximum number of points.
+      public: void SetCapacity(const unsigned int _capacity);
+
+      /// \brief Get the maximum number of points kept by the curve.
+      /// \return Maximum number of points.
+      public: unsigned int Capacity() const;
+
+      /// \brief Set the number of pixel columns the visible part of the
+      /// curve is drawn with. At most four points per column are drawn.
+      /// \param[in] _resolution Number of columns, usually the width of
+      /// the plot canvas.
+      public: void SetResolution(const unsigned int _resolution);
+
       /// \brief Get the min x and y values of this curve
       /// \return Point with min values
       public: ignition::math::Vector2d Min();
@@ -18,6 +18,7 @@
 #include "gazebo/gui/plot/PlottingTypes.hh"
 #include "gazebo/gui/plot/PlotCurve.hh"
 #include "gazebo/gui/plot/PlotCurve_TEST.hh"
+#include "gazebo/gui/plot/qwt_gazebo.h"
 
 /////////////////////////////////////////////////
 void PlotCurve_TEST::Curve()
@@ -133,5 +134,88 @@ void PlotCurve_TEST::AddPoint()
   delete plotCurve;
 }
 
+/////////////////////////////////////////////////
+void PlotCurve_TEST::Capacity()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world");
+
+  gazebo::gui::PlotCurve *plotCurve = new gazebo::gui::PlotCurve("curve01");
+  QVERIFY(plotCurve != nullptr);
+
+  plotCurve->SetCapacity(100);
+  QCOMPARE(plotCurve->Capacity(), 100u);
+
+  // fill the curve 3.5 times over
+  for (unsigned int i = 0; i < 350; ++i)
+    plotCurve->AddPoint(ignition::math::Vector2d(i, i % 7));
+
+  // only the newest points are kept, oldest first
+  QCOMPARE(plotCurve->Size(), 100u);
+  QCOMPARE(plotCurve->Point(0), ignition::math::Vector2d(250, 250 % 7));
+  QCOMPARE(plotCurve->Point(99), ignition::math::Vector2d(349, 349 % 7));
+  QCOMPARE(plotCurve->Min(), ignition::math::Vector2d(250, 0));
+  QCOMPARE(plotCurve->Max(), ignition::math::Vector2d(349, 6));
+
+  std::vector<ignition::math::Vector2d> points = plotCurve->Points();
+  QCOMPARE(static_cast<unsigned int>(points.size()), 100u);
+  QCOMPARE(points[50], plotCurve->Point(50));
+
+  // shrinking keeps the newest points
+  plotCurve->SetCapacity(10);
+  QCOMPARE(plotCurve->Size(), 10u);
+  QCOMPARE(plotCurve->Point(0), ignition::math::Vector2d(340, 340 % 7));
+
+  delete plotCurve;
+}
+
+/////////////////////////////////////////////////
+void PlotCurve_TEST::LevelOfDetail()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world");
+
+  gazebo::gui::PlotCurve *plotCurve = new gazebo::gui::PlotCurve("curve01");
+  QVERIFY(plotCurve != nullptr);
+
+  // an hour at 1 kHz, with a single spike
+  const unsigned int count = 3600000;
+  plotCurve->SetCapacity(count);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    double y = (i == 1234567) ? 100.0 : std::sin(i * 1e-3);
+    plotCurve->AddPoint(ignition::math::Vector2d(i * 1e-3, y));
+  }
+  QCOMPARE(plotCurve->Size(), count);
+  QCOMPARE(plotCurve->Max().Y(), 100.0);
+
+  // show the whole hour on 500 columns
+  const unsigned int resolution = 500;
+  plotCurve->SetResolution(resolution);
+  QwtSeriesData<QPointF> *data = plotCurve->Curve()->data();
+  data->setRectOfInterest(QRectF(0, -2, count * 1e-3, 104));
+
+  QVERIFY(data->size() <= 4u * (resolution + 1) + 2u);
+  QVERIFY(data->size() >= resolution);
+
+  // the spike and the sample ends are kept
+  bool spike = false;
+  for (size_t i = 0; i < data->size(); ++i)
+    spike = spike || ignition::math::equal(data->sample(i).y(), 100.0);
+  QVERIFY(spike);
+  QCOMPARE(data->sample(0).x(), 0.0);
+  QCOMPARE(data->sample(data->size() - 1).x(), (count - 1) * 1e-3);
+
+  // points are in increasing x order
+  for (size_t i = 1; i < data->size(); ++i)
+    QVERIFY(data->sample(i).x() >= data->sample(i - 1).x());
+
+  delete plotCurve;
+}
+
 // Generate a main function for the test
 QTEST_MAIN(PlotCurve_TEST)
@@ -32,5 +32,11 @@ class PlotCurve_TEST : public QTestFixture
 
   /// \brief Test adding points to the curve
   private slots: void AddPoint();
+
+  /// \brief Test that the oldest points are dropped at capacity
+  private slots: void Capacity();
+
+  /// \brief Test drawing a long curve with a few points per pixel column
+  private slots: void LevelOfDetail();
 };
 #endif
@@ -15,9 +15,14 @@
  *
 */
 
+#include <algorithm>
 #include <mutex>
+#include <utility>
+#include <vector>
 
+#include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/message.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/transport.hh"
@@ -68,6 +73,61 @@ namespace gazebo
       private: common::Time lastSimTime;
     };
 
+    /// \brief A plotted variable compiled against a message type: the
+    /// chain of fields leading to it, and how to turn the last field into
+    /// a number. Fields are resolved by name once, when the accessor is
+    /// compiled, instead of for every message.
+    class FieldAccessor
+    {
+      /// \brief Kind of value at the end of the field chain.
+      public: enum Leaf
+      {
+        /// \brief Number or boolean
+        SCALAR,
+
+        /// \brief msgs::Time, in seconds
+        TIME,
+
+        /// \brief Component of a msgs::Vector3d
+        VECTOR3_X,
+
+        /// \brief Component of a msgs::Vector3d
+        VECTOR3_Y,
+
+        /// \brief Component of a msgs::Vector3d
+        VECTOR3_Z,
+
+        /// \brief Euler angle of a msgs::Quaternion
+        ROLL,
+
+        /// \brief Euler angle of a msgs::Quaternion
+        PITCH,
+
+        /// \brief Euler angle of a msgs::Quaternion
+        YAW
+      };
+
+      /// \brief Compile a query against a message type.
+      /// \param[in] _descriptor Type of the topic messages.
+      /// \param[in] _query URI query, such as ?p=pose/position/x.
+      /// \return True if the query leads to a plottable field.
+      public: bool Compile(const google::protobuf::Descriptor *_descriptor,
+                  const std::string &_query);
+
+      /// \brief Read the value from a message.
+      /// \param[in] _msg Message of the compiled type.
+      /// \param[out] _value Value of the variable.
+      /// \return True on success.
+      public: bool Value(const google::protobuf::Message &_msg,
+                  double &_value) const;
+
+      /// \brief Fields from the top level message to the value.
+      public: std::vector<const google::protobuf::FieldDescriptor *> path;
+
+      /// \brief Kind of value.
+      public: Leaf leaf = SCALAR;
+    };
+
     /// \brief Helper class to update curves associated with a single topic
     class TopicCurve
     {
@@ -105,15 +165,15 @@ namespace gazebo
       /// \param[in] _msg Message data
       public: void OnTopicData(const std::string &_msg);
 
-      /// \brief Update the plot curve based on message
-      /// \param[in] _msg Message containing data to be added to the curve
-      /// \param[in] _index Index of token in the param path string
-      /// \param[in] _x X value. Only used if the topic data is not timestamped
-      /// \param[in] _curvesUpdates A list of curves and values to update
-      public: void UpdateCurve(google::protobuf::Message *_msg,
-                  const int _index, const double _x,
-                  std::vector<std::pair<TopicCurve::CurveVariableMapIt,
-                      ignition::math::Vector2d> > &_curvesUpdates);
+      /// \brief Compile the queries of all curves against the topic
+      /// message type. Must be called with the mutex locked.
+      private: void Compile();
+
+      /// \brief Check whether serialized data holds any of the top level
+      /// fields that are plotted, without parsing it.
+      /// \param[in] _data Serialized message.
+      /// \return False if none of the plotted fields is present.
+      private: bool HasPlottedFields(const std::string &_data) const;
 
       /// \brief Topic name
       private: std::string topic;
@@ -132,6 +192,23 @@ namespace gazebo
 
       /// \brief A map of param names to plot curves.
       private: std::map<std::string, CurveVariableSet> curves;
+
+      /// \brief Message the topic data is parsed into, reused for every
+      /// message.
+      private: boost::shared_ptr<google::protobuf::Message> msg;
+
+      /// \brief True if the compiled accessors match the curves.
+      private: bool compiled = false;
+
+      /// \brief Compiled accessors and the curves they update.
+      private: std::vector<std::pair<CurveVariableMapIt, FieldAccessor> >
+          accessors;
+
+      /// \brief Top level message field holding the message time, if any.
+      private: const google::protobuf::FieldDescriptor *timeField = nullptr;
+
+      /// \brief Sorted numbers of the top level fields that are plotted.
+      private: std::vector<int> fieldNumbers;
     };
 
     /// \brief Private data for the TopicCurveHandler class.
@@ -222,6 +299,8 @@ bool TopicCurve::AddCurve(const std::string &_name, PlotCurveWeakPtr _curve)
   common::URIQuery topicQuery = topicURI.Query();
   std::string topicQueryStr = topicQuery.Str();
 
+  this->compiled = false;
+
   auto it = this->curves.find(topicQueryStr);
   if (it == this->curves.end())
   {
@@ -255,6 +334,7 @@ bool TopicCurve::RemoveCurve(PlotCurveWeakPtr _curve)
     auto cIt = it->second.find(_curve);
     if (cIt != it->second.end())
     {
+      this->compiled = false;
       it->second.erase(cIt);
       if (it->second.empty())
       {
@@ -291,233 +371,272 @@ unsigned int TopicCurve::CurveCount() const
 }
 
 /////////////////////////////////////////////////
-void TopicCurve::OnTopicData(const std::string &_msg)
+bool FieldAccessor::Compile(const google::protobuf::Descriptor *_descriptor,
+    const std::string &_query)
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
-
-  if (this->curves.empty())
-    return;
-
-  auto msg = msgs::MsgFactory::NewMsg(this->msgType);
-  msg->ParseFromString(_msg);
-
-  // stores a list of curve iterators and their new values
-  std::vector<std::pair<TopicCurve::CurveVariableMapIt,
-      ignition::math::Vector2d> > curvesUpdates;
-
-  // nearest sim time - use this x value if the message is not timestamped
-  double x = TopicTime::Instance()->LastSimTime().Double();
+  this->path.clear();
 
-  // collect updates
-  this->UpdateCurve(msg.get(), 0, x, curvesUpdates);
+  // tokenize query, e.g. ?p=pose/position/x -> [?p, pose, position, x]
+  std::vector<std::string> queryTokens = common::split(_query, "=/");
 
-  // update curves!
-  for (auto &curveUpdate : curvesUpdates)
+  // skip ?p
+  const google::protobuf::Descriptor *descriptor = _descriptor;
+  for (unsigned int i = 1; i < queryTokens.size() && descriptor; ++i)
   {
-    for (auto &cIt : curveUpdate.first->second)
+    auto field = descriptor->FindFieldByName(queryTokens[i]);
+    if (!field || field->is_repeated())
+      return false;
+    this->path.push_back(field);
+
+    switch (field->type())
     {
-      auto curve = cIt.lock();
-      if (!curve)
-        continue;
+      case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+      case google::protobuf::FieldDescriptor::TYPE_FLOAT:
+      case google::protobuf::FieldDescriptor::TYPE_INT64:
+      case google::protobuf::FieldDescriptor::TYPE_UINT64:
+      case google::protobuf::FieldDescriptor::TYPE_INT32:
+      case google::protobuf::FieldDescriptor::TYPE_UINT32:
+      case google::protobuf::FieldDescriptor::TYPE_BOOL:
+      {
+        this->leaf = SCALAR;
+        return true;
+      }
+      case google::protobuf::FieldDescriptor::TYPE_MESSAGE:
+      {
+        const std::string &typeName = field->message_type()->name();
+        if (typeName == "Time")
+        {
+          this->leaf = TIME;
+          return true;
+        }
+        else if (typeName == "Vector3d")
+        {
+          // parse param to get x, y, or z at leaf of query
+          const char elem = _query.back();
+          if (elem == 'x')
+            this->leaf = VECTOR3_X;
+          else if (elem == 'y')
+            this->leaf = VECTOR3_Y;
+          else if (elem == 'z')
+            this->leaf = VECTOR3_Z;
+          else
+            return false;
+          return true;
+        }
+        else if (typeName == "Quaternion")
+        {
+          // parse query to get roll, pitch, or yaw at leaf of uri
+          if (_query.find("roll") != std::string::npos)
+            this->leaf = ROLL;
+          else if (_query.find("pitch") != std::string::npos)
+            this->leaf = PITCH;
+          else if (_query.find("yaw") != std::string::npos)
+            this->leaf = YAW;
+          else
+            return false;
+          return true;
+        }
 
-      curve->AddPoint(curveUpdate.second);
+        descriptor = field->message_type();
+        break;
+      }
+      default:
+      {
+        return false;
+      }
     }
   }
+
+  return false;
 }
 
 /////////////////////////////////////////////////
-void TopicCurve::UpdateCurve(google::protobuf::Message *_msg,
-    const int _index, const double x,
-    std::vector<std::pair<TopicCurve::CurveVariableMapIt,
-    ignition::math::Vector2d> > &_curvesUpdates)
+bool FieldAccessor::Value(const google::protobuf::Message &_msg,
+    double &_value) const
 {
-  if (!_msg)
+  const google::protobuf::Message *msg = &_msg;
+  for (unsigned int i = 0; i + 1 < this->path.size(); ++i)
+    msg = &msg->GetReflection()->GetMessage(*msg, this->path[i]);
+
+  auto field = this->path.back();
+  auto ref = msg->GetReflection();
+  switch (this->leaf)
   {
-    GZ_ASSERT(_msg,
-        "_msg pointer in TopicCurve::UpdateCurve should not be null");
+    case SCALAR:
+    {
+      switch (field->type())
+      {
+        case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
+          _value = ref->GetDouble(*msg, field);
+          return true;
+        case google::protobuf::FieldDescriptor::TYPE_FLOAT:
+          _value = ref->GetFloat(*msg, field);
+          return true;
+        case google::protobuf::FieldDescriptor::TYPE_INT64:
+          _value = ref->GetInt64(*msg, field);
+          return true;
+        case google::protobuf::FieldDescriptor::TYPE_UINT64:
+          _value = ref->GetUInt64(*msg, field);
+          return true;
+        case google::protobuf::FieldDescriptor::TYPE_INT32:
+          _value = ref->GetInt32(*msg, field);
+          return true;
+        case google::protobuf::FieldDescriptor::TYPE_UINT32:
+          _value = ref->GetUInt32(*msg, field);
+          return true;
+        case google::protobuf::FieldDescriptor::TYPE_BOOL:
+          _value = static_cast<int>(ref->GetBool(*msg, field));
+          return true;
+        default:
+          return false;
+      }
+    }
+    case TIME:
+    {
+      auto timeMsg =
+          dynamic_cast<const msgs::Time *>(&ref->GetMessage(*msg, field));
+      if (!timeMsg)
+        return false;
+      _value = msgs::Convert(*timeMsg).Double();
+      return true;
+    }
+    case VECTOR3_X:
+    case VECTOR3_Y:
+    case VECTOR3_Z:
+    {
+      auto vecMsg =
+          dynamic_cast<const msgs::Vector3d *>(&ref->GetMessage(*msg, field));
+      if (!vecMsg)
+        return false;
+      _value = msgs::ConvertIgn(*vecMsg)[this->leaf - VECTOR3_X];
+      return true;
+    }
+    case ROLL:
+    case PITCH:
+    case YAW:
+    {
+      auto quatMsg = dynamic_cast<const msgs::Quaternion *>(
+          &ref->GetMessage(*msg, field));
+      if (!quatMsg)
+        return false;
+      _value = msgs::ConvertIgn(*quatMsg).Euler()[this->leaf - ROLL];
+      return true;
+    }
   }
 
-  auto ref = _msg->GetReflection();
-  if (!ref)
-    return;
+  return false;
+}
 
-  auto descriptor = _msg->GetDescriptor();
-  if (!descriptor)
+/////////////////////////////////////////////////
+void TopicCurve::Compile()
+{
+  this->compiled = true;
+  this->accessors.clear();
+  this->fieldNumbers.clear();
+  this->timeField = nullptr;
+
+  if (!this->msg)
+    this->msg = msgs::MsgFactory::NewMsg(this->msgType);
+  if (!this->msg)
     return;
 
-  // x axis data
-  double xData = x;
+  auto descriptor = this->msg->GetDescriptor();
 
-  for (int i = 0; i < descriptor->field_count(); ++i)
+  // Check if message has timestamp and use it if it exists and is
+  // a top level msg field.
+  // TODO x axis is hardcoded to be the sim time for now. Once it is
+  // configurable, remove this logic for setting the x value
+  for (int i = 0; i < descriptor->field_count() && !this->timeField; ++i)
   {
     auto field = descriptor->field(i);
-    if (!field)
+    if ((field->name() == "stamp" || field->name() == "time") &&
+        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE &&
+        !field->is_repeated() && field->message_type()->name() == "Time")
+    {
+      this->timeField = field;
+    }
+  }
+
+  for (auto cIt = this->curves.begin(); cIt != this->curves.end(); ++cIt)
+  {
+    FieldAccessor accessor;
+    if (!accessor.Compile(descriptor, cIt->first))
       continue;
 
-    std::string fieldName = field->name();
+    this->fieldNumbers.push_back(accessor.path.front()->number());
+    this->accessors.push_back(std::make_pair(cIt, accessor));
+  }
 
-    // Check if message has timestamp and use it if it exists and is
-    // a top level msg field.
-    // TODO x axis is hardcoded to be the sim time for now. Once it is
-    // configurable, remove this logic for setting the x value
-    if (_index == 0 && (fieldName == "stamp" || fieldName == "time") &&
-        field->type() == google::protobuf::FieldDescriptor::TYPE_MESSAGE &&
-        !field->is_repeated())
+  std::sort(this->fieldNumbers.begin(), this->fieldNumbers.end());
+}
+
+/////////////////////////////////////////////////
+bool TopicCurve::HasPlottedFields(const std::string &_data) const
+{
+  using google::protobuf::internal::WireFormatLite;
+
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t *>(_data.data()),
+      static_cast<int>(_data.size()));
+
+  while (true)
+  {
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0)
+      return false;
+
+    if (std::binary_search(this->fieldNumbers.begin(),
+          this->fieldNumbers.end(), WireFormatLite::GetTagFieldNumber(tag)))
     {
-      auto valueMsg = ref->MutableMessage(_msg, field);
-      if (field->message_type()->name() == "Time")
-      {
-        msgs::Time *msg = dynamic_cast<msgs::Time *>(valueMsg);
-        if (msg)
-        {
-          common::Time time = msgs::Convert(*msg);
-          xData = time.Double();
-        }
-      }
+      return true;
     }
 
-    // loop through all the topic param name + curve pairs
-    for (auto cIt = this->curves.begin(); cIt != this->curves.end(); ++cIt)
-    {
-      // parse param to get field at current index
-      std::string topicField;
+    // Leave malformed data to the parser
+    if (!WireFormatLite::SkipField(&input, tag))
+      return true;
+  }
+}
 
-      std::string query = cIt->first;
+/////////////////////////////////////////////////
+void TopicCurve::OnTopicData(const std::string &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
 
-      // tokenize query, e.g. ?p=sim_time -> [?p, sim_time]
-      std::vector<std::string> queryTokens = common::split(query, "=/");
+  if (this->curves.empty())
+    return;
 
-      // skip ?p
-      unsigned int queryIndex = _index + 1;
+  if (!this->compiled)
+    this->Compile();
 
-      if (queryTokens.size() < 2 || queryTokens.size() <= queryIndex)
-        continue;
+  if (this->accessors.empty() || !this->HasPlottedFields(_msg))
+    return;
 
-      topicField = queryTokens[queryIndex];
+  this->msg->ParseFromString(_msg);
 
-      double data = 0;
-      bool addData = true;
-      if (topicField != fieldName)
-        continue;
+  // nearest sim time - use this x value if the message is not timestamped
+  double x = TopicTime::Instance()->LastSimTime().Double();
+  if (this->timeField)
+  {
+    auto timeMsg = dynamic_cast<const msgs::Time *>(
+        &this->msg->GetReflection()->GetMessage(*this->msg, this->timeField));
+    if (timeMsg)
+      x = msgs::Convert(*timeMsg).Double();
+  }
 
-      switch (field->type())
-      {
-        case google::protobuf::FieldDescriptor::TYPE_DOUBLE:
-        {
-          data = ref->GetDouble(*_msg, field);
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_FLOAT:
-        {
-          data = ref->GetFloat(*_msg, field);
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_INT64:
-        {
-          data = ref->GetInt64(*_msg, field);
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_UINT64:
-        {
-          data = ref->GetUInt64(*_msg, field);
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_INT32:
-        {
-          data = ref->GetInt32(*_msg, field);
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_UINT32:
-        {
-          data = ref->GetUInt32(*_msg, field);
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_BOOL:
-        {
-          data = static_cast<int>(ref->GetBool(*_msg, field));
-          break;
-        }
-        case google::protobuf::FieldDescriptor::TYPE_MESSAGE:
-        {
-          auto valueMsg = ref->MutableMessage(_msg, field);
-
-          if (field->message_type()->name() == "Time")
-          {
-            msgs::Time *msg = dynamic_cast<msgs::Time *>(valueMsg);
-
-            if (!msg)
-              continue;
-
-             common::Time time = msgs::Convert(*msg);
-             data = time.Double();
-          }
-          else if (field->message_type()->name() == "Vector3d")
-          {
-            msgs::Vector3d *msg = dynamic_cast<msgs::Vector3d *>(valueMsg);
-
-            if (!msg)
-              continue;
-
-            ignition::math::Vector3d vec = msgs::ConvertIgn(*msg);
-
-            // parse param to get x, y, or z at leaf of query
-            std::string elem = query.substr(query.size()-1);
-            if (elem == "x")
-            {
-              data = vec.X();
-            }
-            else if (elem == "y")
-            {
-              data = vec.Y();
-            }
-            else if (elem == "z")
-            {
-              data = vec.Z();
-            }
-            else
-              continue;
-          }
-          else if (field->message_type()->name() == "Quaternion")
-          {
-            msgs::Quaternion *msg =
-                dynamic_cast<msgs::Quaternion *>(valueMsg);
-
-            if (!msg)
-              continue;
-
-            ignition::math::Quaterniond quat = msgs::ConvertIgn(*msg);
-
-            // parse query to get roll, pitch, or yaw at leaf of uri
-            ignition::math::Vector3d rpy = quat.Euler();
-            if (query.find("roll") != std::string::npos)
-              data = rpy.X();
-            else if (query.find("pitch") != std::string::npos)
-              data = rpy.Y();
-            else if (query.find("yaw") != std::string::npos)
-              data = rpy.Z();
-            else
-              continue;
-          }
-          else
-          {
-            this->UpdateCurve(valueMsg, _index + 1, xData, _curvesUpdates);
-            addData = false;
-          }
-          break;
-        }
-        default:
-        {
-          continue;
-        }
-      // end switch
-      }
+  // update curves!
+  for (auto const &accessor : this->accessors)
+  {
+    double data = 0;
+    if (!accessor.second.Value(*this->msg, data))
+      continue;
 
-      // push to tmp list and update later
-      if (addData)
-      {
-        _curvesUpdates.push_back(
-            std::make_pair(cIt, ignition::math::Vector2d(xData, data)));
-      }
+    for (auto &cIt : accessor.first->second)
+    {
+      auto curve = cIt.lock();
+      if (!curve)
+        continue;
+
+      curve->AddPoint(ignition::math::Vector2d(x, data));
     }
   }
 }
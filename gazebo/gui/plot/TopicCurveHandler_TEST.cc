@@ -63,5 +63,59 @@ void TopicCurveHandler_TEST::AddRemoveCurve()
   QCOMPARE(handler.CurveCount(), 0u);
 }
 
+/////////////////////////////////////////////////
+void TopicCurveHandler_TEST::UpdateCurve()
+{
+  this->resMaxPercentChange = 5.0;
+  this->shareMaxPercentChange = 2.0;
+
+  this->Load("worlds/empty.world");
+
+  // advertise a topic so that its message type is known
+  gazebo::transport::NodePtr node(new gazebo::transport::Node());
+  node->Init();
+  gazebo::transport::PublisherPtr pub =
+      node->Advertise<gazebo::msgs::PosesStamped>("~/test_plot");
+  int sleep = 0;
+  while (gazebo::transport::getTopicMsgType(
+      "/gazebo/default/test_plot").empty() && sleep++ < 100)
+  {
+    gazebo::common::Time::MSleep(30);
+  }
+
+  gazebo::gui::TopicCurveHandler handler;
+  gazebo::gui::PlotCurvePtr timeCurve(new gazebo::gui::PlotCurve("time"));
+  gazebo::gui::PlotCurvePtr missingCurve(
+      new gazebo::gui::PlotCurve("missing"));
+  handler.AddCurve("/gazebo/default/test_plot?p=time", timeCurve);
+  handler.AddCurve("/gazebo/default/test_plot?p=no_such_field",
+      missingCurve);
+  QCOMPARE(handler.CurveCount(), 2u);
+  QVERIFY(pub->WaitForConnection(gazebo::common::Time(3, 0)));
+
+  const unsigned int msgCount = 5;
+  for (unsigned int i = 0; i < msgCount; ++i)
+  {
+    gazebo::msgs::PosesStamped msg;
+    gazebo::msgs::Set(msg.mutable_time(), gazebo::common::Time(i + 1, 0));
+    pub->Publish(msg);
+  }
+
+  sleep = 0;
+  while (timeCurve->Size() < msgCount && sleep++ < 100)
+  {
+    gazebo::common::Time::MSleep(30);
+    QCoreApplication::processEvents();
+  }
+
+  // the message time is the x value
+  QCOMPARE(timeCurve->Size(), msgCount);
+  for (unsigned int i = 0; i < msgCount; ++i)
+    QCOMPARE(timeCurve->Point(i), ignition::math::Vector2d(i + 1, i + 1));
+
+  // queries that don't resolve to a field are never updated
+  QCOMPARE(missingCurve->Size(), 0u);
+}
+
 // Generate a main function for the test
 QTEST_MAIN(TopicCurveHandler_TEST)
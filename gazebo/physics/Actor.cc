@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include <sstream>
 #include <limits>
 #include <algorithm>
@@ -35,6 +38,60 @@
 
 #include "gazebo/transport/Node.hh"
 
+/// \brief A skeleton animation compiled for the skin of an actor, with one
+/// track per skin bone, indexed by the bone's skeleton handle.
+class ActorClip
+{
+  /// \brief Constructor.
+  /// \param[in] _skeleton Skeleton of the skin.
+  /// \param[in] _anim Animation to compile.
+  /// \param[in] _skelMap Map from skin bone names to animation node names.
+  /// \param[in] _translationAligner BVH translation aligners, by animation
+  /// node name.
+  /// \param[in] _rotationAligner BVH rotation aligners, by animation node
+  /// name.
+  public: ActorClip(gazebo::common::Skeleton *_skeleton,
+              const gazebo::common::SkeletonAnimation &_anim,
+              const std::map<std::string, std::string> &_skelMap,
+              const std::map<std::string, ignition::math::Matrix4d>
+                  &_translationAligner,
+              const std::map<std::string, ignition::math::Matrix4d>
+                  &_rotationAligner)
+  {
+    std::vector<std::string> nodes(_skeleton->GetNumNodes());
+    this->translationAligners.resize(nodes.size(),
+        ignition::math::Matrix4d::Zero);
+    this->rotationAligners.resize(nodes.size(),
+        ignition::math::Matrix4d::Zero);
+
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+      auto it = _skelMap.find(_skeleton->GetNodeByHandle(i)->GetName());
+      if (it == _skelMap.end())
+        continue;
+      nodes[i] = it->second;
+
+      auto aligner = _translationAligner.find(nodes[i]);
+      if (aligner != _translationAligner.end())
+        this->translationAligners[i] = aligner->second;
+      aligner = _rotationAligner.find(nodes[i]);
+      if (aligner != _rotationAligner.end())
+        this->rotationAligners[i] = aligner->second;
+    }
+
+    this->clip.reset(new gazebo::common::SkeletonClip(_anim, nodes));
+  }
+
+  /// \brief The compiled animation.
+  public: std::unique_ptr<gazebo::common::SkeletonClip> clip;
+
+  /// \brief Translation to align each BVH bone to the skin.
+  public: std::vector<ignition::math::Matrix4d> translationAligners;
+
+  /// \brief Rotation to align each BVH bone to the skin.
+  public: std::vector<ignition::math::Matrix4d> rotationAligners;
+};
+
 /// \brief Private data for Actor class
 class gazebo::physics::ActorPrivate
 {
@@ -48,6 +105,31 @@ class gazebo::physics::ActorPrivate
   /// \brief Rotations to align BVH skeleton to DAE skin
   public: std::map<std::string, ignition::math::Matrix4d>
       rotationAligner;
+
+  /// \brief Skeleton animations compiled on first use, by animation name.
+  public: std::map<std::string, std::unique_ptr<ActorClip>> clips;
+
+  /// \brief Link of each bone, indexed by skeleton handle.
+  public: std::vector<LinkPtr> boneLinks;
+
+  /// \brief Animation to sample for the current frame.
+  public: ActorClip *frameClip = nullptr;
+
+  /// \brief True to sample the current frame along the root's X axis.
+  public: bool frameAlongX = false;
+
+  /// \brief True if the trajectory of the current frame is translated.
+  public: bool frameTranslated = false;
+
+  /// \brief Trajectory pose of the current frame.
+  public: ignition::math::Pose3d frameModelPose;
+
+  /// \brief Simulation time of the current frame.
+  public: double frameTime = 0.0;
+
+  /// \brief Transform of each bone in the current frame, indexed by
+  /// skeleton handle.
+  public: std::vector<ignition::math::Matrix4d> boneTransforms;
 };
 
 using namespace gazebo;
@@ -508,6 +590,7 @@ void Actor::LoadAnimation(sdf::ElementPtr _sdf)
   this->skelAnimation[animName] = skel->GetAnimation(0);
   this->interpolateX[animName] = _sdf->Get<bool>("interpolate_x");
   this->skelNodesMap[animName] = skelMap;
+  this->dataPtr->clips.erase(animName);
 }
 
 //////////////////////////////////////////////////
@@ -666,18 +749,50 @@ bool Actor::IsActive() const
 
 ///////////////////////////////////////////////////
 void Actor::Update()
+{
+  if (this->PrepareFrame())
+  {
+    this->SampleFrame();
+    this->ApplyFrame();
+  }
+}
+
+///////////////////////////////////////////////////
+void Actor::UpdateBatch(const Actor_V &_actors)
+{
+  std::vector<Actor *> pending;
+  for (auto const &actor : _actors)
+  {
+    if (actor->PrepareFrame())
+      pending.push_back(actor.get());
+  }
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, pending.size()),
+      [&pending](const tbb::blocked_range<size_t> &_r)
+  {
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+      pending[i]->SampleFrame();
+  });
+
+  // Setting link poses and publishing is kept serial
+  for (auto actor : pending)
+    actor->ApplyFrame();
+}
+
+///////////////////////////////////////////////////
+bool Actor::PrepareFrame()
 {
   if (!this->active)
-    return;
+    return false;
 
   if (this->skelAnimation.empty() && this->trajectories.empty())
-    return;
+    return false;
 
   common::Time currentTime = this->world->SimTime();
 
   // do not refresh animation faster than 30 Hz sim time
   if ((currentTime - this->prevFrameTime).Double() < (1.0 / 30.0))
-    return;
+    return false;
 
   // Get trajectory
   TrajectoryInfo *tinfo = nullptr;
@@ -688,13 +803,13 @@ void Actor::Update()
 
     // waiting for delayed start
     if (this->scriptTime < 0)
-      return;
+      return false;
 
     if (this->scriptTime >= this->scriptLength)
     {
       if (!this->loop)
       {
-        return;
+        return false;
       }
       else
       {
@@ -718,7 +833,7 @@ void Actor::Update()
     {
       gzerr << "Trajectory not found at time [" << this->scriptTime << "]"
           << std::endl;
-      return;
+      return false;
     }
 
     this->scriptTime = this->scriptTime - tinfo->startTime;
@@ -767,38 +882,53 @@ void Actor::Update()
   if (!skelAnim)
   {
     this->SetWorldPose(modelPose);
-    return;
+    return false;
   }
 
-  auto skelMap = this->skelNodesMap[tinfo->type];
-
-  std::map<std::string, ignition::math::Matrix4d> frame;
-  if (!this->customTrajectoryInfo)
+  auto &clip = this->dataPtr->clips[tinfo->type];
+  if (!clip)
   {
-    if (this->interpolateX[tinfo->type] &&
-          this->trajectories.find(tinfo->id) != this->trajectories.end())
-    {
-      frame = skelAnim->PoseAtX(this->pathLength,
-                skelMap[this->skeleton->GetRootNode()->GetName()]);
-    }
-    else
-    {
-      frame = skelAnim->PoseAt(this->scriptTime);
-    }
-  }
-  else
-  {
-    frame = skelAnim->PoseAt(this->scriptTime);
+    clip.reset(new ActorClip(this->skeleton, *skelAnim,
+        this->skelNodesMap[tinfo->type], this->dataPtr->translationAligner,
+        this->dataPtr->rotationAligner));
   }
 
+  this->dataPtr->frameClip = clip.get();
+  this->dataPtr->frameAlongX = !this->customTrajectoryInfo &&
+      this->interpolateX[tinfo->type] &&
+      this->trajectories.find(tinfo->id) != this->trajectories.end();
+  this->dataPtr->frameTranslated = tinfo->translated;
+  this->dataPtr->frameModelPose = modelPose;
+  this->dataPtr->frameTime = currentTime.Double();
+
   this->lastTraj = tinfo->id;
 
+  return true;
+}
+
+///////////////////////////////////////////////////
+void Actor::SampleFrame()
+{
+  const SkeletonClip &clip = *this->dataPtr->frameClip->clip;
+  const unsigned int rootHandle = this->skeleton->GetRootNode()->GetHandle();
+
+  double time = this->scriptTime;
+  if (this->dataPtr->frameAlongX && clip.HasTrack(rootHandle))
+    time = clip.TimeAtX(this->pathLength, rootHandle, true);
+
+  clip.PoseAt(time, true, this->dataPtr->boneTransforms);
+}
+
+///////////////////////////////////////////////////
+void Actor::ApplyFrame()
+{
+  const SkeletonClip &clip = *this->dataPtr->frameClip->clip;
+  const unsigned int rootHandle = this->skeleton->GetRootNode()->GetHandle();
+  const ignition::math::Pose3d &modelPose = this->dataPtr->frameModelPose;
+
   ignition::math::Matrix4d rootTrans = ignition::math::Matrix4d::Identity;
-  auto iter = frame.find(skelMap[this->skeleton->GetRootNode()->GetName()]);
-  if (iter != frame.end())
-  {
-    rootTrans = frame[skelMap[this->skeleton->GetRootNode()->GetName()]];
-  }
+  if (clip.HasTrack(rootHandle))
+    rootTrans = this->dataPtr->boneTransforms[rootHandle];
 
   ignition::math::Vector3d rootPos = rootTrans.Translation();
   ignition::math::Quaterniond rootRot = rootTrans.Rotation();
@@ -808,7 +938,7 @@ void Actor::Update()
     rootPos = ignition::math::Vector3d::Zero;
   }
 
-  if (tinfo->translated)
+  if (this->dataPtr->frameTranslated)
     rootPos.X() = 0.0;
   ignition::math::Pose3d actorPose;
 
@@ -839,20 +969,39 @@ void Actor::Update()
   // workaround for rotation bug
   rootM.SetTranslation(rootM.Translation() * this->skinScale);
 
-  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] = rootM;
+  this->dataPtr->boneTransforms[rootHandle] = rootM;
 
-  this->SetPose(frame, skelMap, currentTime.Double());
+  this->SetPose(this->dataPtr->frameTime);
 }
 
 //////////////////////////////////////////////////
-void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
-    std::map<std::string, std::string> _skelMap, const double _time)
+void Actor::SetPose(const double _time)
 {
+  const ActorClip &clip = *this->dataPtr->frameClip;
+  const unsigned int rootHandle = this->skeleton->GetRootNode()->GetHandle();
+  const unsigned int nodeCount = this->skeleton->GetNumNodes();
+
+  if (this->dataPtr->boneLinks.size() != nodeCount)
+  {
+    this->dataPtr->boneLinks.resize(nodeCount);
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+      this->dataPtr->boneLinks[i] = this->GetChildLink(
+          this->skeleton->GetNodeByHandle(i)->GetName());
+    }
+  }
+
+  // Only build the bone pose message if someone listens to it
+  const bool publish = this->bonePosePub &&
+      this->bonePosePub->HasConnections();
+
   msgs::PoseAnimation msg;
-  msg.set_model_name(this->visualName);
-  msg.set_model_id(this->visualId);
+  if (publish)
+  {
+    msg.set_model_name(this->visualName);
+    msg.set_model_id(this->visualId);
+  }
 
-  ignition::math::Matrix4d modelTrans(ignition::math::Matrix4d::Identity);
   ignition::math::Pose3d mainLinkPose;
 
   if (this->customTrajectoryInfo)
@@ -861,20 +1010,19 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
     mainLinkPose.Rot() = this->worldPose.Rot();
   }
 
-  for (unsigned int i = 0; i < this->skeleton->GetNumNodes(); ++i)
+  for (unsigned int i = 0; i < nodeCount; ++i)
   {
     SkeletonNode *bone = this->skeleton->GetNodeByHandle(i);
     SkeletonNode *parentBone = bone->GetParent();
     ignition::math::Matrix4d transform(ignition::math::Matrix4d::Identity);
 
-    if (_frame.find(_skelMap[bone->GetName()]) != _frame.end())
+    if (i == rootHandle || clip.clip->HasTrack(i))
     {
+      transform = this->dataPtr->boneTransforms[i];
+
       if (this->dataPtr->bvhFile)
       {
-        std::string tempStr(_skelMap[bone->GetName()]);
-        transform = _frame[tempStr];
-
-        if (bone->GetName() != this->skeleton->GetRootNode()->GetName())
+        if (i != rootHandle)
         {
           ignition::math::Vector3d bvhOffset = transform.Translation();
           ignition::math::Vector3d daeOffset = bone->Transform().Translation();
@@ -882,12 +1030,8 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
           transform.SetTranslation(daeOffset.Length() * bvhOffset.Normalize());
         }
 
-        transform = this->dataPtr->translationAligner[tempStr] * transform *
-            this->dataPtr->rotationAligner[tempStr];
-      }
-      else
-      {
-        transform = _frame[_skelMap[bone->GetName()]];
+        transform = clip.translationAligners[i] * transform *
+            clip.rotationAligners[i];
       }
     }
     else
@@ -895,7 +1039,7 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
       transform = bone->Transform();
     }
 
-    LinkPtr currentLink = this->GetChildLink(bone->GetName());
+    LinkPtr currentLink = this->dataPtr->boneLinks[i];
     ignition::math::Pose3d bonePose = transform.Pose();
     if (!bonePose.IsFinite())
     {
@@ -904,59 +1048,78 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
       bonePose.Correct();
     }
 
-    msgs::Pose *bone_pose = msg.add_pose();
-    bone_pose->set_name(bone->GetName());
+    msgs::Pose *bone_pose = nullptr;
+    if (publish)
+    {
+      bone_pose = msg.add_pose();
+      bone_pose->set_name(bone->GetName());
+    }
 
     if (!parentBone)
     {
-      bone_pose->mutable_position()->CopyFrom(
-          msgs::Convert(ignition::math::Vector3d()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
-          ignition::math::Quaterniond()));
+      if (bone_pose)
+      {
+        bone_pose->mutable_position()->CopyFrom(
+            msgs::Convert(ignition::math::Vector3d()));
+        bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(
+            ignition::math::Quaterniond()));
+      }
       if (!this->customTrajectoryInfo)
         mainLinkPose = bonePose;
     }
     else
     {
-      bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.Pos()));
-      bone_pose->mutable_orientation()->CopyFrom(msgs::Convert(bonePose.Rot()));
-      LinkPtr parentLink = this->GetChildLink(parentBone->GetName());
+      if (bone_pose)
+      {
+        bone_pose->mutable_position()->CopyFrom(msgs::Convert(bonePose.Pos()));
+        bone_pose->mutable_orientation()->CopyFrom(
+            msgs::Convert(bonePose.Rot()));
+      }
+      LinkPtr parentLink = this->dataPtr->boneLinks[parentBone->GetHandle()];
       auto parentPose = parentLink->WorldPose();
       ignition::math::Matrix4d parentTrans(parentPose);
       transform = parentTrans * transform;
     }
 
-    msgs::Pose *link_pose = msg.add_pose();
-    link_pose->set_name(currentLink->GetScopedName());
-    link_pose->set_id(currentLink->GetId());
-    ignition::math::Pose3d linkPose = transform.Pose() - mainLinkPose;
-    link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.Pos()));
-    link_pose->mutable_orientation()->CopyFrom(msgs::Convert(linkPose.Rot()));
+    if (publish)
+    {
+      msgs::Pose *link_pose = msg.add_pose();
+      link_pose->set_name(currentLink->GetScopedName());
+      link_pose->set_id(currentLink->GetId());
+      ignition::math::Pose3d linkPose = transform.Pose() - mainLinkPose;
+      link_pose->mutable_position()->CopyFrom(msgs::Convert(linkPose.Pos()));
+      link_pose->mutable_orientation()->CopyFrom(
+          msgs::Convert(linkPose.Rot()));
+    }
     currentLink->SetWorldPose(transform.Pose(), true, false);
   }
 
-  msgs::Time *stamp = msg.add_time();
-  stamp->CopyFrom(msgs::Convert(_time));
-
-  msgs::Pose *model_pose = msg.add_pose();
-  model_pose->set_name(this->GetScopedName());
-  model_pose->set_id(this->GetId());
-  if (!this->customTrajectoryInfo)
-  {
-    model_pose->mutable_position()->CopyFrom(msgs::Convert(mainLinkPose.Pos()));
-    model_pose->mutable_orientation()->CopyFrom(
-        msgs::Convert(mainLinkPose.Rot()));
-  }
-  else
+  if (publish)
   {
-    model_pose->mutable_position()->CopyFrom(
-        msgs::Convert(this->worldPose.Pos()));
-    model_pose->mutable_orientation()->CopyFrom(
-        msgs::Convert(this->worldPose.Rot()));
-  }
+    msgs::Time *stamp = msg.add_time();
+    stamp->CopyFrom(msgs::Convert(_time));
+
+    msgs::Pose *model_pose = msg.add_pose();
+    model_pose->set_name(this->GetScopedName());
+    model_pose->set_id(this->GetId());
+    if (!this->customTrajectoryInfo)
+    {
+      model_pose->mutable_position()->CopyFrom(
+          msgs::Convert(mainLinkPose.Pos()));
+      model_pose->mutable_orientation()->CopyFrom(
+          msgs::Convert(mainLinkPose.Rot()));
+    }
+    else
+    {
+      model_pose->mutable_position()->CopyFrom(
+          msgs::Convert(this->worldPose.Pos()));
+      model_pose->mutable_orientation()->CopyFrom(
+          msgs::Convert(this->worldPose.Rot()));
+    }
 
-  if (this->bonePosePub && this->bonePosePub->HasConnections())
     this->bonePosePub->Publish(msg);
+  }
+
   if (!this->customTrajectoryInfo)
     this->SetWorldPose(mainLinkPose, true, false);
 }
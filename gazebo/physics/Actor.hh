@@ -114,6 +114,12 @@ namespace gazebo
       /// \brief Update the actor
       public: void Update();
 
+      /// \brief Update a group of actors. This is equivalent to calling
+      /// Update on each of them, except that the skeleton animations of all
+      /// the actors are sampled in parallel.
+      /// \param[in] _actors Actors to update.
+      public: static void UpdateBatch(const Actor_V &_actors);
+
       /// \brief Finalize the actor
       public: virtual void Fini();
 
@@ -277,15 +283,26 @@ namespace gazebo
       /// \param[in] _sdf SDF element containing the trajectory script.
       private: void LoadScript(sdf::ElementPtr _sdf);
 
+      /// \brief Advance the script and the trajectory for a new frame, and
+      /// pick the skeleton animation to sample.
+      /// \return True if the frame needs the skeleton animation to be
+      /// sampled and applied, see SampleFrame and ApplyFrame.
+      private: bool PrepareFrame();
+
+      /// \brief Sample the skeleton animation picked by PrepareFrame into
+      /// the bone transforms of the frame. This only touches data owned by
+      /// the actor, so several actors can be sampled in parallel.
+      private: void SampleFrame();
+
+      /// \brief Apply the bone transforms sampled by SampleFrame to the
+      /// links of the actor.
+      private: void ApplyFrame();
+
       /// \brief Set the actor's pose. This sets the pose for each bone in the
-      /// skeleton and also the actor's pose in the world.
-      /// \param[in] _frame Each frame name and transform.
-      /// \param[in] _skelMap Map of bone relationships.
+      /// skeleton from the sampled bone transforms, and also the actor's pose
+      /// in the world.
       /// \param[in] _time Time over which to animate the set pose.
-      private: void SetPose(
-                   std::map<std::string, ignition::math::Matrix4d> _frame,
-                   std::map<std::string, std::string> _skelMap,
-                   const double _time);
+      private: void SetPose(const double _time);
 
       /// \brief Pointer to the actor's mesh.
       protected: const common::Mesh *mesh = nullptr;
@@ -175,7 +175,8 @@ void ContactManager::GetCustomPublishers(Collision *_collision1,
     {
       GZ_ASSERT(iter->second->publisher != NULL,
                 "ContactPublisher must have a valid publisher");
-      if (!_getOnlyConnected || iter->second->publisher->HasConnections())
+      if (!_getOnlyConnected || iter->second->publisher->HasConnections() ||
+          iter->second->connected.ConnectionCount() > 0)
       {
         _publishers.push_back(iter->second);
       }
@@ -295,8 +296,8 @@ void ContactManager::PublishContacts()
     return;
   }
 
-  // publish to default topic, ~/physics/contacts
-  if (!transport::getMinimalComms())
+  // publish to default topic, ~/physics/contacts, only if someone listens
+  if (!transport::getMinimalComms() && this->contactPub->HasConnections())
   {
     msgs::Contacts msg;
     for (unsigned int i = 0; i < this->contactIndex; ++i)
@@ -314,23 +315,41 @@ void ContactManager::PublishContacts()
 
   // publish to other custom topics
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  std::vector<const Contact *> view;
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
       iter != this->customContactPublishers.end(); ++iter)
   {
     ContactPublisher *contactPublisher = iter->second;
-    msgs::Contacts msg2;
-    for (unsigned int j = 0;
-        j < contactPublisher->contacts.size(); ++j)
+
+    // Hand the contacts to in-process subscribers as they are
+    if (contactPublisher->connected.ConnectionCount() > 0)
     {
-      if (contactPublisher->contacts[j]->count == 0)
-        continue;
+      view.clear();
+      for (auto const contact : contactPublisher->contacts)
+      {
+        if (contact->count > 0)
+          view.push_back(contact);
+      }
+      contactPublisher->connected(view);
+    }
 
-      msgs::Contact *contactMsg = msg2.add_contact();
-      contactPublisher->contacts[j]->FillMsg(*contactMsg);
+    // Only build a message for transport subscribers
+    if (contactPublisher->publisher->HasConnections())
+    {
+      msgs::Contacts msg2;
+      for (unsigned int j = 0;
+          j < contactPublisher->contacts.size(); ++j)
+      {
+        if (contactPublisher->contacts[j]->count == 0)
+          continue;
+
+        msgs::Contact *contactMsg = msg2.add_contact();
+        contactPublisher->contacts[j]->FillMsg(*contactMsg);
+      }
+      msgs::Set(msg2.mutable_time(), this->world->SimTime());
+      contactPublisher->publisher->Publish(msg2);
     }
-    msgs::Set(msg2.mutable_time(), this->world->SimTime());
-    contactPublisher->publisher->Publish(msg2);
     contactPublisher->contacts.clear();
   }
 }
@@ -424,6 +443,24 @@ std::string ContactManager::CreateFilter(const std::string &_name,
   return topic;
 }
 
+/////////////////////////////////////////////////
+event::ConnectionPtr ContactManager::ConnectContacts(const std::string &_name,
+    std::function<void (const std::vector<const Contact *> &)> _subscriber)
+{
+  std::string name = _name;
+  boost::replace_all(name, "::", "/");
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  auto iter = this->customContactPublishers.find(name);
+  if (iter == this->customContactPublishers.end())
+  {
+    gzerr << "Contact filter [" << _name << "] doesn't exist\n";
+    return event::ConnectionPtr();
+  }
+
+  return iter->second->connected.Connect(_subscriber);
+}
+
 /////////////////////////////////////////////////
 void ContactManager::RemoveFilter(const std::string &_name)
 {
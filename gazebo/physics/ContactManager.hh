@@ -18,6 +18,7 @@
 #ifndef GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 #define GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <map>
@@ -27,6 +28,7 @@
 #include <boost/unordered/unordered_map.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 
+#include "gazebo/common/Event.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -56,6 +58,11 @@ namespace gazebo
       /// \brief A list of contacts associated to the collisions.
       public: std::vector<Contact *> contacts;
 
+      /// \brief In-process subscribers to the contacts of this filter.
+      /// \sa ContactManager::ConnectContacts
+      public: event::EventT<void (const std::vector<const Contact *> &)>
+              connected;
+
       // Place ignition::transport objects at the end of this file to
       // guarantee they are destructed first.
 
@@ -191,6 +198,20 @@ namespace gazebo
                   const std::map<std::string, physics::CollisionPtr>
                   &_collisions);
 
+      /// \brief Connect to the contacts of a filter without going through
+      /// transport. Each step, PublishContacts calls the subscriber from the
+      /// physics thread with the contacts of the filtered collisions,
+      /// without converting them to messages. The contacts are only valid
+      /// during the call.
+      /// \param[in] _name Filter name, as given to CreateFilter.
+      /// \param[in] _subscriber Callback.
+      /// \return Connection, or nullptr if the filter doesn't exist. The
+      /// subscriber is disconnected when the connection is destroyed,
+      /// which must happen before the filter is removed.
+      public: event::ConnectionPtr ConnectContacts(const std::string &_name,
+                  std::function<void (const std::vector<const Contact *> &)>
+                  _subscriber);
+
       /// \brief Remove a contacts filter and the associated custom publisher
       /// param[in] _name Filter name.
       public: void RemoveFilter(const std::string &_name);
@@ -209,7 +230,7 @@ namespace gazebo
       /// \param[in] _collision1 the first collision object
       /// \param[in] _collision2 the second collision object
       /// \param[in] _getOnlyConnected return only publishers which currently
-      ///   have subscribers
+      ///   have transport or in-process subscribers
       /// \param[out] _publishers the resulting publishers.
       private: void GetCustomPublishers(Collision *_collision1,
                        Collision *_collision2, const bool _getOnlyConnected,
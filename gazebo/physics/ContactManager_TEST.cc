@@ -194,6 +194,63 @@ TEST_F(ContactManagerTest, NeverDropContacts)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, ConnectContacts)
+{
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ContactManager *manager = world->Physics()->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // Unknown filter
+  EXPECT_TRUE(manager->ConnectContacts("unknown",
+        [](const std::vector<const physics::Contact *> &) {}) == nullptr);
+
+  const std::string collisionName = "box::link::collision";
+  std::string topic = manager->CreateFilter("box_filter", collisionName);
+  EXPECT_FALSE(topic.empty());
+
+  unsigned int calls = 0;
+  unsigned int contactCount = 0;
+  event::ConnectionPtr connection = manager->ConnectContacts("box_filter",
+      [&](const std::vector<const physics::Contact *> &_contacts)
+      {
+        ++calls;
+        for (auto const contact : _contacts)
+        {
+          ASSERT_TRUE(contact != nullptr);
+          EXPECT_GT(contact->count, 0);
+          EXPECT_TRUE(
+              contact->collision1->GetScopedName() == collisionName ||
+              contact->collision2->GetScopedName() == collisionName);
+          ++contactCount;
+        }
+      });
+  ASSERT_TRUE(connection != nullptr);
+
+  // The in-process subscriber is called once per step, and the box rests
+  // on the ground
+  world->Step(10);
+  EXPECT_EQ(calls, 10u);
+  EXPECT_GT(contactCount, 0u);
+
+  // The filter keeps contacts of the box coming
+  physics::Collision *collision = boost::dynamic_pointer_cast<
+      physics::Collision>(world->BaseByName(collisionName)).get();
+  ASSERT_TRUE(collision != nullptr);
+  EXPECT_TRUE(manager->SubscribersConnected(collision, nullptr));
+
+  // Disconnected
+  connection.reset();
+  world->Step(10);
+  EXPECT_EQ(calls, 10u);
+
+  manager->RemoveFilter("box_filter");
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
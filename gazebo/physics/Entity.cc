@@ -153,6 +153,13 @@ void Entity::SetStatic(const bool &_s)
 
   for (iter = this->children.begin(); iter != this->children.end(); ++iter)
   {
+    // Links override SetStatic, so that the physics engine can follow
+    if ((*iter)->HasType(Base::LINK))
+    {
+      boost::static_pointer_cast<Link>(*iter)->SetStatic(_s);
+      continue;
+    }
+
     EntityPtr e = boost::dynamic_pointer_cast<Entity>(*iter);
     if (e)
       e->SetStatic(_s);
@@ -344,22 +351,7 @@ void Entity::SetWorldPoseModel(
         // Tell collisions that their current world pose is dirty (needs
         // updating). We set a dirty flag instead of directly updating the
         // value to improve performance.
-        for (Base_V::iterator iterC = (*iter)->children.begin();
-             iterC != (*iter)->children.end(); ++iterC)
-        {
-          if ((*iterC)->HasType(COLLISION))
-          {
-            CollisionPtr entityC =
-                boost::static_pointer_cast<Collision>(*iterC);
-            entityC->SetWorldPoseDirty();
-          }
-          else if ((*iterC)->HasType(LIGHT))
-          {
-            LightPtr entityC =
-                boost::static_pointer_cast<Light>(*iterC);
-            entityC->SetWorldPoseDirty();
-          }
-        }
+        entity->SetChildWorldPosesDirty();
       }
       else if (entity->HasType(MODEL))
       {
@@ -432,22 +424,34 @@ void Entity::SetWorldPoseDefault(const ignition::math::Pose3d &_pose,
     // Tell collisions that their current world pose is dirty (needs
     // updating). We set a dirty flag instead of directly updating the
     // value to improve performance.
-    for (auto &childPtr : this->children)
+    this->SetChildWorldPosesDirty();
+  }
+}
+
+//////////////////////////////////////////////////
+void Entity::SetChildWorldPosesDirty()
+{
+  for (auto &childPtr : this->children)
+  {
+    if (childPtr->HasType(COLLISION))
     {
-      if (childPtr->HasType(COLLISION))
-      {
-        CollisionPtr entityC = boost::static_pointer_cast<Collision>(childPtr);
-        entityC->SetWorldPoseDirty();
-      }
-      else if (childPtr->HasType(LIGHT))
-      {
-        LightPtr entityC = boost::static_pointer_cast<Light>(childPtr);
-        entityC->SetWorldPoseDirty();
-      }
+      CollisionPtr entityC = boost::static_pointer_cast<Collision>(childPtr);
+      entityC->SetWorldPoseDirty();
+    }
+    else if (childPtr->HasType(LIGHT))
+    {
+      LightPtr entityC = boost::static_pointer_cast<Light>(childPtr);
+      entityC->SetWorldPoseDirty();
     }
   }
 }
 
+//////////////////////////////////////////////////
+void Entity::SetDirtyWorldPose(const ignition::math::Pose3d &_pose)
+{
+  (*this.*setWorldPoseFunc)(_pose, false, false);
+}
+
 
 //////////////////////////////////////////////////
 //   The entity stores an initialRelativePose and dynamic worldPose
@@ -486,6 +490,8 @@ void Entity::SetWorldPose(const ignition::math::Pose3d &_pose,
     std::lock_guard<std::mutex> lock(this->GetWorld()->WorldPoseMutex());
     (*this.*setWorldPoseFunc)(_pose, _notify, _publish);
   }
+  this->GetWorld()->_AddPlaced(this);
+
   if (_publish)
     this->PublishPose();
 }
@@ -263,6 +263,12 @@ namespace gazebo
       private: void SetWorldPoseDefault(const ignition::math::Pose3d &_pose,
                    const bool _notify, const bool _publish);
 
+      /// \brief Write back a world pose computed by the physics engine.
+      /// This is SetWorldPose(_pose, false, false) without locking
+      /// World::WorldPoseMutex, which the caller must hold.
+      /// \param[in] _pose New pose for the entity.
+      private: void SetDirtyWorldPose(const ignition::math::Pose3d &_pose);
+
       /// \brief Called when a new pose message arrives.
       /// \param[in] _msg The message to set the pose from.
       private: void OnPoseMsg(ConstPosePtr &_msg);
@@ -311,6 +317,10 @@ namespace gazebo
       /// \brief Connection used to update an animation.
       protected: event::ConnectionPtr animationConnection;
 
+      /// \brief Tell the collisions and lights attached to this entity that
+      /// their world pose is dirty and must be recomputed.
+      protected: virtual void SetChildWorldPosesDirty();
+
       /// \brief The pose set by a physics engine.
       protected: ignition::math::Pose3d dirtyPose;
 
@@ -353,6 +363,10 @@ namespace gazebo
 
       /// \brief Ignition Pose publisher.
       private: ignition::transport::Node::Publisher posePubIgn;
+
+      /// Friend World so that it can write back poses set by the physics
+      /// engine, see SetDirtyWorldPose.
+      private: friend class World;
     };
     /// \}
   }
@@ -97,8 +97,9 @@ class gazebo::physics::LinkPrivate
   /// \brief Wind velocity.
   public: ignition::math::Vector3d windLinearVel;
 
-  /// \brief Update connection to calculate wind velocity.
-  public: event::ConnectionPtr updateConnection;
+  /// \brief True if the link is added to the wind, which computes its
+  /// wind velocity.
+  public: bool windEnabled = false;
 
   /// \brief All the attached batteries.
   public: std::vector<common::BatteryPtr> batteries;
@@ -344,7 +345,8 @@ void Link::Init()
 //////////////////////////////////////////////////
 void Link::Fini()
 {
-  this->dataPtr->updateConnection.reset();
+  if (this->dataPtr->windEnabled)
+    this->SetWindEnabled(false);
 
   this->dataPtr->attachedModels.clear();
   this->dataPtr->parentJoints.clear();
@@ -638,6 +640,12 @@ void Link::UpdateWind(const common::UpdateInfo & /*_info*/)
   this->dataPtr->windLinearVel = this->world->Wind().WorldLinearVel(this);
 }
 
+//////////////////////////////////////////////////
+void Link::SetWorldWindLinearVel(const ignition::math::Vector3d &_vel)
+{
+  this->dataPtr->windLinearVel = _vel;
+}
+
 /////////////////////////////////////////////////
 Joint_V Link::GetParentJoints() const
 {
@@ -842,9 +850,9 @@ void Link::SetWindMode(const bool _mode)
 {
   this->sdf->GetElement("enable_wind")->Set(_mode);
 
-  if (!this->WindMode() && this->dataPtr->updateConnection)
+  if (!this->WindMode() && this->dataPtr->windEnabled)
     this->SetWindEnabled(false);
-  else if (this->WindMode() && !this->dataPtr->updateConnection)
+  else if (this->WindMode() && !this->dataPtr->windEnabled)
     this->SetWindEnabled(true);
 }
 
@@ -853,12 +861,16 @@ void Link::SetWindEnabled(const bool _enable)
 {
   if (_enable)
   {
-    this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-        std::bind(&Link::UpdateWind, this, std::placeholders::_1));
+    // The wind computes the velocity of all its links at once, see
+    // Wind::Update.
+    this->world->Wind().AddLink(this);
+    this->dataPtr->windEnabled = true;
   }
   else
   {
-    this->dataPtr->updateConnection.reset();
+    if (this->dataPtr->windEnabled)
+      this->world->Wind().RemoveLink(this);
+    this->dataPtr->windEnabled = false;
     // Make sure wind velocity is null
     this->dataPtr->windLinearVel.Set(0, 0, 0);
   }
@@ -1918,6 +1930,23 @@ event::ConnectionPtr Link::ConnectEnabled(
   return this->dataPtr->enabledSignal.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+void Link::SetChildWorldPosesDirty()
+{
+  // The cached lists of collisions and lights are complete once the link is
+  // initialized.
+  if (!this->initialized)
+  {
+    Entity::SetChildWorldPosesDirty();
+    return;
+  }
+
+  for (auto const &collision : this->dataPtr->collisions)
+    collision->SetWorldPoseDirty();
+  for (auto const &light : this->dataPtr->lights)
+    light->SetWorldPoseDirty();
+}
+
 //////////////////////////////////////////////////
 void Link::LoadLight(sdf::ElementPtr _sdf)
 {
@@ -574,6 +574,11 @@ namespace gazebo
       /// \param[in] _info Update information.
       public: void UpdateWind(const common::UpdateInfo &_info);
 
+      /// \brief Set this link's wind velocity in the world coordinate
+      /// frame. Called by Wind::Update for the wind-enabled links.
+      /// \param[in] _vel Wind velocity.
+      public: void SetWorldWindLinearVel(const ignition::math::Vector3d &_vel);
+
       /// \brief Get a battery by name.
       /// \param[in] _name Name of the battery to get.
       /// \return Pointer to the battery, NULL if the name is invalid.
@@ -675,6 +680,9 @@ namespace gazebo
       /// \brief Register items in the introspection service.
       protected: virtual void RegisterIntrospectionItems() override;
 
+      // Documentation inherited.
+      protected: virtual void SetChildWorldPosesDirty() override;
+
       /// \brief Inertial properties.
       protected: InertialPtr inertial;
 
@@ -1108,6 +1108,11 @@ void Model::LoadPlugin(sdf::ElementPtr _sdf)
 
     ModelPtr myself = boost::static_pointer_cast<Model>(shared_from_this());
 
+    // Event connections made by the plugin are accounted to it
+    plugin->CreateUsage(this->GetScopedName() + "::" + pluginName,
+        this->GetWorld()->Name(), _sdf);
+    common::PluginOwner owner(plugin->Usage());
+
     try
     {
       plugin->Load(myself, _sdf);
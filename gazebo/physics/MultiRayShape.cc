@@ -166,6 +166,56 @@ int MultiRayShape::GetFiducial(unsigned int _index)
 
 //////////////////////////////////////////////////
 void MultiRayShape::Update()
+{
+  this->ResetRays();
+
+  // do actual collision checks
+  this->UpdateRays();
+
+  // for plugin
+  this->newLaserScans();
+}
+
+//////////////////////////////////////////////////
+void MultiRayShape::UpdateBatch(const std::vector<MultiRayShapePtr> &_shapes)
+{
+  MultiRayShapePtr first;
+  for (auto const &shape : _shapes)
+  {
+    if (!shape)
+      continue;
+    shape->ResetRays();
+    if (!first)
+      first = shape;
+  }
+
+  if (!first)
+    return;
+
+  // do actual collision checks
+  first->UpdateRaysBatch(_shapes);
+
+  // for plugin
+  for (auto const &shape : _shapes)
+  {
+    if (shape)
+      shape->newLaserScans();
+  }
+}
+
+//////////////////////////////////////////////////
+void MultiRayShape::UpdateRaysBatch(
+    const std::vector<MultiRayShapePtr> &_shapes)
+{
+  for (auto const &shape : _shapes)
+  {
+    if (shape)
+      shape->UpdateRays();
+  }
+}
+
+//////////////////////////////////////////////////
+void MultiRayShape::ResetRays()
 {
   // The measurable range is (max-min)
   double fullRange = this->GetMaxRange() - this->GetMinRange();
@@ -181,12 +231,6 @@ void MultiRayShape::Update()
     // Get the global points of the line
     this->rays[i]->Update();
   }
-
-  // do actual collision checks
-  this->UpdateRays();
-
-  // for plugin
-  this->newLaserScans();
 }
 
 //////////////////////////////////////////////////
@@ -127,6 +127,14 @@ namespace gazebo
       /// \brief Update the ray collisions.
       public: void Update();
 
+      /// \brief Update the ray collisions of several shapes at once. This
+      /// is equivalent to calling Update() on every shape, but lets the
+      /// physics engine share work between the shapes and spread the rays
+      /// over several threads. All shapes must belong to the same world.
+      /// \param[in] _shapes Shapes to update. Null entries are ignored.
+      public: static void UpdateBatch(
+                  const std::vector<MultiRayShapePtr> &_shapes);
+
       /// \TODO This function is not implemented.
       /// \brief Fill a message with this shape's values.
       /// \param[out] _msg Message that contains the shape's values.
@@ -179,6 +187,18 @@ namespace gazebo
       /// \sa RayCount()
       public: RayShapePtr Ray(const unsigned int _rayIndex) const;
 
+      /// \brief Do the collision checks of several shapes, including this
+      /// one. Called by UpdateBatch() after the rays of every shape have
+      /// been reset. The default implementation calls UpdateRays() on each
+      /// shape in turn.
+      /// \param[in] _shapes Shapes to update.
+      protected: virtual void UpdateRaysBatch(
+                     const std::vector<MultiRayShapePtr> &_shapes);
+
+      /// \brief Reset the length and retro value of every ray to the full
+      /// range, and update their global positions.
+      private: void ResetRays();
+
       /// \brief Ray data
       protected: std::vector<RayShapePtr> rays;
 
@@ -120,6 +120,18 @@ PhysicsEngine::~PhysicsEngine()
   this->Fini();
 }
 
+//////////////////////////////////////////////////
+bool PhysicsEngine::SaveState(std::string &/*_buffer*/) const
+{
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RestoreState(const std::string &/*_buffer*/)
+{
+  return false;
+}
+
 //////////////////////////////////////////////////
 CollisionPtr PhysicsEngine::CreateCollision(const std::string &_shapeType,
                                             const std::string &_linkName)
@@ -61,6 +61,21 @@ namespace gazebo
       /// \brief Rest the physics engine.
       public: virtual void Reset() {}
 
+      /// \brief Save the engine state that changes as the world steps,
+      /// such as body velocities and solver warm start data, into a
+      /// compact binary buffer. It is used by World::Checkpoint.
+      /// \param[out] _buffer Buffer that receives the state.
+      /// \return False if the engine does not support saving its state.
+      public: virtual bool SaveState(std::string &_buffer) const;
+
+      /// \brief Restore a state saved by SaveState, bit for bit. It is used
+      /// by World::Restore.
+      /// \param[in] _buffer Saved state.
+      /// \return False if the engine does not support restoring its state,
+      /// or if bodies or joints were added or removed since the state was
+      /// saved. The engine is not changed in that case.
+      public: virtual bool RestoreState(const std::string &_buffer);
+
       /// \brief Init the engine for threads.
       public: virtual void InitForThread() = 0;
 
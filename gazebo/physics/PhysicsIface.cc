@@ -96,6 +96,29 @@ bool physics::has_world(const std::string &_name)
   return false;
 }
 
+/////////////////////////////////////////////////
+std::vector<physics::WorldPtr> physics::create_world_batch(
+    sdf::ElementPtr _sdf, const unsigned int _count, const uint32_t _seed)
+{
+  std::vector<WorldPtr> worlds;
+  if (!_sdf)
+    return worlds;
+
+  const std::string name = _sdf->Get<std::string>("name");
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    sdf::ElementPtr worldElem = _sdf->Clone();
+    worldElem->GetAttribute("name")->Set(name + "_" + std::to_string(i));
+
+    WorldPtr world = create_world();
+    world->SetSeed(_seed + i);
+    load_world(world, worldElem);
+    worlds.push_back(world);
+  }
+
+  return worlds;
+}
+
 /////////////////////////////////////////////////
 void physics::load_worlds(sdf::ElementPtr _sdf)
 {
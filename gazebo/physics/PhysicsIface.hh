@@ -18,6 +18,7 @@
 #define _PHYSICSIFACE_HH_
 
 #include <string>
+#include <vector>
 #include <sdf/sdf.hh>
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -61,6 +62,19 @@ namespace gazebo
     GZ_PHYSICS_VISIBLE
     bool has_world(const std::string &_name = "");
 
+    /// \brief Create and load copies of a world, for batch simulation of
+    /// independent worlds in one process. The world description is parsed
+    /// once and cloned, and the meshes are loaded once for all the copies.
+    /// Copy i is named "<name>_<i>", so its topics live in their own
+    /// namespace, and its seed is _seed + i.
+    /// \param[in] _sdf SDF of the world to copy.
+    /// \param[in] _count Number of copies.
+    /// \param[in] _seed Random number seed of the first copy.
+    /// \return The copies, which are also in the list of worlds.
+    GZ_PHYSICS_VISIBLE
+    std::vector<WorldPtr> create_world_batch(sdf::ElementPtr _sdf,
+        const unsigned int _count, const uint32_t _seed);
+
     /// \brief Load world from sdf::Element pointer.
     /// \param[in] _world Pointer to a world.
     /// \param[in] _sdf SDF values to load from.
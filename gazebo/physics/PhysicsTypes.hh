@@ -51,13 +51,16 @@ namespace gazebo
     class UserCmd;
     class UserCmdManager;
     class PhysicsEngine;
+    class StepPacer;
     class Wind;
+    class WindField;
     class Atmosphere;
     class Mass;
     class Road;
     class Shape;
     class RayShape;
     class MultiRayShape;
+    class SpatialIndex;
     class Inertial;
     class SurfaceParams;
     class BoxShape;
@@ -72,6 +75,7 @@ namespace gazebo
     class LinkState;
     class JointState;
     class TrajectoryInfo;
+    class WorldCheckpoint;
 
     /// \def BasePtr
     /// \brief Boost shared pointer to a Base object
@@ -129,6 +133,14 @@ namespace gazebo
     /// \brief Shared pointer to a PresetManager object
     typedef boost::shared_ptr<PresetManager> PresetManagerPtr;
 
+    /// \def  SpatialIndexPtr
+    /// \brief Shared pointer to a SpatialIndex object
+    typedef std::shared_ptr<SpatialIndex> SpatialIndexPtr;
+
+    /// \def  WindFieldPtr
+    /// \brief Shared pointer to a WindField object
+    typedef std::shared_ptr<WindField> WindFieldPtr;
+
     /// \def  UserCmdPtr
     /// \brief Shared pointer to a UserCmd object
     typedef std::shared_ptr<UserCmd> UserCmdPtr;
@@ -137,6 +149,10 @@ namespace gazebo
     /// \brief Shared pointer to a UserCmdManager object
     typedef std::shared_ptr<UserCmdManager> UserCmdManagerPtr;
 
+    /// \def  WorldCheckpointPtr
+    /// \brief Shared pointer to a WorldCheckpoint object
+    typedef std::shared_ptr<WorldCheckpoint> WorldCheckpointPtr;
+
     /// \def ShapePtr
     /// \brief Boost shared pointer to a Shape object
     typedef boost::shared_ptr<Shape> ShapePtr;
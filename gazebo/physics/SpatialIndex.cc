@@ -0,0 +1,697 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Integer coordinates of a grid cell.
+    struct SpatialCell
+    {
+      /// \brief Equality operator.
+      /// \param[in] _other Other cell.
+      /// \return True if the cells are the same.
+      bool operator==(const SpatialCell &_other) const
+      {
+        return this->x == _other.x && this->y == _other.y &&
+          this->z == _other.z;
+      }
+
+      /// \brief X coordinate.
+      int64_t x;
+
+      /// \brief Y coordinate.
+      int64_t y;
+
+      /// \brief Z coordinate.
+      int64_t z;
+    };
+
+    /// \internal
+    /// \brief Hash of a grid cell.
+    struct SpatialCellHash
+    {
+      /// \brief Hash a cell.
+      /// \param[in] _cell Cell.
+      /// \return Hash value.
+      std::size_t operator()(const SpatialCell &_cell) const
+      {
+        std::size_t h = std::hash<int64_t>()(_cell.x);
+        h = h * 73856093u ^ std::hash<int64_t>()(_cell.y);
+        h = h * 19349663u ^ std::hash<int64_t>()(_cell.z);
+        return h;
+      }
+    };
+
+    /// \internal
+    /// \brief An indexed entity.
+    struct SpatialEntry
+    {
+      /// \brief The entity.
+      EntityPtr entity;
+
+      /// \brief World bounding box of the entity.
+      ignition::math::AxisAlignedBox box;
+
+      /// \brief Cell holding the center of the box.
+      SpatialCell cell;
+
+      /// \brief True if the box is too large for the grid.
+      bool oversized;
+    };
+
+    /// \internal
+    /// \brief Private data for SpatialIndex.
+    class SpatialIndexPrivate
+    {
+      /// \brief Get the cell holding a point.
+      /// \param[in] _point Point.
+      /// \return Cell.
+      public: SpatialCell Cell(const ignition::math::Vector3d &_point) const
+      {
+        return {static_cast<int64_t>(std::floor(_point.X() / this->cellSize)),
+                static_cast<int64_t>(std::floor(_point.Y() / this->cellSize)),
+                static_cast<int64_t>(std::floor(_point.Z() / this->cellSize))};
+      }
+
+      /// \brief Insert or move an entity. The mutex must be locked.
+      /// \param[in] _entity Entity.
+      /// \param[in] _box World bounding box of the entity.
+      public: void Update(const EntityPtr &_entity,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Remove an entity. The mutex must be locked.
+      /// \param[in] _id Id of the entity.
+      public: void Remove(const uint32_t _id);
+
+      /// \brief Get the ids of the entities whose box intersects a box.
+      /// The mutex must be locked.
+      /// \param[in] _box Box.
+      /// \param[in] _type Type of the entities.
+      /// \param[out] _ids Ids of the entities, unsorted.
+      public: void Intersecting(const ignition::math::AxisAlignedBox &_box,
+                  const Base::EntityType _type,
+                  std::vector<uint32_t> &_ids) const;
+
+      /// \brief Get entities from ids, sorted by id.
+      /// \param[in] _ids Ids.
+      /// \return Entities.
+      public: std::vector<EntityPtr> Sorted(std::vector<uint32_t> &_ids) const;
+
+      /// \brief Edge length of a cell.
+      public: double cellSize;
+
+      /// \brief The indexed entities, by id.
+      public: std::unordered_map<uint32_t, SpatialEntry> entries;
+
+      /// \brief Ids of the entities in each cell.
+      public: std::unordered_map<SpatialCell, std::vector<uint32_t>,
+              SpatialCellHash> cells;
+
+      /// \brief Ids of the entities too large for the grid.
+      public: std::vector<uint32_t> oversized;
+
+      /// \brief Box holding all the boxes of the grid. It only grows until
+      /// the index is cleared.
+      public: ignition::math::AxisAlignedBox extent;
+
+      /// \brief True if extent holds at least one box.
+      public: bool hasExtent = false;
+
+      /// \brief Incremented by every change of the index.
+      public: uint64_t version = 0;
+
+      /// \brief Protects the index. Queries take a shared lock.
+      public: mutable std::shared_mutex mutex;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a box is valid, i.e. its bounds are ordered.
+/// \param[in] _box Box.
+/// \return True if the box is valid.
+static bool validBox(const ignition::math::AxisAlignedBox &_box)
+{
+  return _box.Min().X() <= _box.Max().X() &&
+    _box.Min().Y() <= _box.Max().Y() &&
+    _box.Min().Z() <= _box.Max().Z();
+}
+
+/////////////////////////////////////////////////
+/// \brief Distance from a point to a box.
+/// \param[in] _point Point.
+/// \param[in] _box Box.
+/// \return Distance, zero if the point is in the box.
+static double boxDistance(const ignition::math::Vector3d &_point,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  ignition::math::Vector3d d;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    d[i] = std::max(0.0, std::max(_box.Min()[i] - _point[i],
+          _point[i] - _box.Max()[i]));
+  }
+  return d.Length();
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether two boxes overlap, including their faces.
+/// \param[in] _a First box.
+/// \param[in] _b Second box.
+/// \return True if the boxes overlap.
+static bool overlap(const ignition::math::AxisAlignedBox &_a,
+    const ignition::math::AxisAlignedBox &_b)
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (_a.Max()[i] < _b.Min()[i] || _b.Max()[i] < _a.Min()[i])
+      return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check whether a line segment crosses a box, with the slab test.
+/// \param[in] _start Start of the segment.
+/// \param[in] _end End of the segment.
+/// \param[in] _box Box.
+/// \return True if part of the segment is in the box.
+static bool segmentHits(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  double low = 0.0;
+  double high = 1.0;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double d = _end[i] - _start[i];
+    if (std::abs(d) < 1e-12)
+    {
+      if (_start[i] < _box.Min()[i] || _start[i] > _box.Max()[i])
+        return false;
+      continue;
+    }
+
+    double t0 = (_box.Min()[i] - _start[i]) / d;
+    double t1 = (_box.Max()[i] - _start[i]) / d;
+    if (t0 > t1)
+      std::swap(t0, t1);
+    low = std::max(low, t0);
+    high = std::min(high, t1);
+    if (low > high)
+      return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::Update(const EntityPtr &_entity,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  const uint32_t id = _entity->GetId();
+
+  // Entities without a valid box, e.g. models without collisions, can't
+  // be found by a query.
+  if (!validBox(_box))
+  {
+    this->Remove(id);
+    return;
+  }
+
+  const ignition::math::Vector3d size = _box.Max() - _box.Min();
+  const ignition::math::Vector3d center = _box.Min() + size * 0.5;
+  const bool oversized = !center.IsFinite() ||
+    size.Max() > this->cellSize;
+
+  auto iter = this->entries.find(id);
+  if (iter != this->entries.end())
+  {
+    SpatialEntry &entry = iter->second;
+    entry.entity = _entity;
+    if (entry.box == _box)
+      return;
+    entry.box = _box;
+    ++this->version;
+
+    // Most moves stay in the same cell
+    if (!oversized && !entry.oversized && entry.cell == this->Cell(center))
+    {
+      this->extent.Merge(_box);
+      return;
+    }
+
+    this->Remove(id);
+  }
+
+  SpatialEntry entry;
+  entry.entity = _entity;
+  entry.box = _box;
+  entry.oversized = oversized;
+  ++this->version;
+  entry.cell = {0, 0, 0};
+
+  if (oversized)
+  {
+    this->oversized.push_back(id);
+  }
+  else
+  {
+    entry.cell = this->Cell(center);
+    this->cells[entry.cell].push_back(id);
+
+    if (this->hasExtent)
+      this->extent.Merge(_box);
+    else
+      this->extent = _box;
+    this->hasExtent = true;
+  }
+
+  this->entries[id] = entry;
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::Remove(const uint32_t _id)
+{
+  auto iter = this->entries.find(_id);
+  if (iter == this->entries.end())
+    return;
+
+  ++this->version;
+  std::vector<uint32_t> *ids = &this->oversized;
+  auto cellIter = this->cells.end();
+  if (!iter->second.oversized)
+  {
+    cellIter = this->cells.find(iter->second.cell);
+    GZ_ASSERT(cellIter != this->cells.end(), "Indexed entity without cell");
+    ids = &cellIter->second;
+  }
+
+  auto idIter = std::find(ids->begin(), ids->end(), _id);
+  if (idIter != ids->end())
+  {
+    *idIter = ids->back();
+    ids->pop_back();
+  }
+
+  if (cellIter != this->cells.end() && ids->empty())
+    this->cells.erase(cellIter);
+
+  this->entries.erase(iter);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::Intersecting(
+    const ignition::math::AxisAlignedBox &_box, const Base::EntityType _type,
+    std::vector<uint32_t> &_ids) const
+{
+  auto test = [&](const uint32_t _id)
+  {
+    const SpatialEntry &entry = this->entries.at(_id);
+    if (entry.entity->HasType(_type) && overlap(entry.box, _box))
+      _ids.push_back(_id);
+  };
+
+  for (auto const id : this->oversized)
+    test(id);
+
+  if (this->cells.empty() || !validBox(_box))
+    return;
+
+  // A box in the grid is at most half a cell away from its cell
+  const ignition::math::Vector3d margin(this->cellSize * 0.5,
+      this->cellSize * 0.5, this->cellSize * 0.5);
+  ignition::math::Vector3d low = _box.Min() - margin;
+  ignition::math::Vector3d high = _box.Max() + margin;
+
+  // Don't look beyond the boxes of the grid
+  if (this->hasExtent)
+  {
+    low.Max(this->extent.Min() - margin);
+    high.Min(this->extent.Max() + margin);
+  }
+  if (low.X() > high.X() || low.Y() > high.Y() || low.Z() > high.Z())
+    return;
+
+  const SpatialCell lowCell = this->Cell(low);
+  const SpatialCell highCell = this->Cell(high);
+  const double range =
+    static_cast<double>(highCell.x - lowCell.x + 1) *
+    static_cast<double>(highCell.y - lowCell.y + 1) *
+    static_cast<double>(highCell.z - lowCell.z + 1);
+
+  auto inRange = [&](const SpatialCell &_cell)
+  {
+    return _cell.x >= lowCell.x && _cell.x <= highCell.x &&
+      _cell.y >= lowCell.y && _cell.y <= highCell.y &&
+      _cell.z >= lowCell.z && _cell.z <= highCell.z;
+  };
+
+  // Walk the occupied cells when there are fewer of them than cells in
+  // the range
+  if (range > static_cast<double>(this->cells.size()))
+  {
+    for (auto const &cell : this->cells)
+    {
+      if (!inRange(cell.first))
+        continue;
+      for (auto const id : cell.second)
+        test(id);
+    }
+    return;
+  }
+
+  SpatialCell cell;
+  for (cell.x = lowCell.x; cell.x <= highCell.x; ++cell.x)
+  {
+    for (cell.y = lowCell.y; cell.y <= highCell.y; ++cell.y)
+    {
+      for (cell.z = lowCell.z; cell.z <= highCell.z; ++cell.z)
+      {
+        auto iter = this->cells.find(cell);
+        if (iter == this->cells.end())
+          continue;
+        for (auto const id : iter->second)
+          test(id);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndexPrivate::Sorted(
+    std::vector<uint32_t> &_ids) const
+{
+  std::sort(_ids.begin(), _ids.end());
+
+  std::vector<EntityPtr> result;
+  result.reserve(_ids.size());
+  for (auto const id : _ids)
+    result.push_back(this->entries.at(id).entity);
+  return result;
+}
+
+/////////////////////////////////////////////////
+SpatialIndex::SpatialIndex(const double _cellSize)
+  : dataPtr(new SpatialIndexPrivate)
+{
+  this->dataPtr->cellSize = _cellSize > 0 ? _cellSize : 4.0;
+}
+
+/////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex()
+{
+}
+
+/////////////////////////////////////////////////
+double SpatialIndex::CellSize() const
+{
+  return this->dataPtr->cellSize;
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Update(const EntityPtr &_entity,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  if (!_entity)
+    return;
+
+  std::unique_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Update(_entity, _box);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Update(const std::vector<EntityPtr> &_entities,
+    const std::vector<ignition::math::AxisAlignedBox> &_boxes)
+{
+  GZ_ASSERT(_entities.size() == _boxes.size(),
+      "One box is needed per entity");
+
+  std::unique_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  for (std::size_t i = 0; i < _entities.size() && i < _boxes.size(); ++i)
+  {
+    if (_entities[i])
+      this->dataPtr->Update(_entities[i], _boxes[i]);
+  }
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Remove(const uint32_t _id)
+{
+  std::unique_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Remove(_id);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Clear()
+{
+  std::unique_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->entries.clear();
+  this->dataPtr->cells.clear();
+  this->dataPtr->oversized.clear();
+  this->dataPtr->extent = ignition::math::AxisAlignedBox();
+  this->dataPtr->hasExtent = false;
+  ++this->dataPtr->version;
+}
+
+/////////////////////////////////////////////////
+unsigned int SpatialIndex::Count() const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->entries.size();
+}
+
+/////////////////////////////////////////////////
+uint64_t SpatialIndex::Version() const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->version;
+}
+
+/////////////////////////////////////////////////
+bool SpatialIndex::Box(const uint32_t _id,
+    ignition::math::AxisAlignedBox &_box) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->entries.find(_id);
+  if (iter == this->dataPtr->entries.end())
+    return false;
+
+  _box = iter->second.box;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::Intersecting(
+    const ignition::math::AxisAlignedBox &_box,
+    const Base::EntityType _type) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+
+  std::vector<uint32_t> ids;
+  this->dataPtr->Intersecting(_box, _type, ids);
+  return this->dataPtr->Sorted(ids);
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::InSphere(
+    const ignition::math::Vector3d &_center, const double _radius,
+    const Base::EntityType _type) const
+{
+  const ignition::math::Vector3d r(_radius, _radius, _radius);
+
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+
+  std::vector<uint32_t> ids;
+  this->dataPtr->Intersecting(
+      ignition::math::AxisAlignedBox(_center - r, _center + r), _type, ids);
+
+  ids.erase(std::remove_if(ids.begin(), ids.end(),
+        [&](const uint32_t _id)
+        {
+          return boxDistance(_center, this->dataPtr->entries.at(_id).box) >
+            _radius;
+        }), ids.end());
+
+  return this->dataPtr->Sorted(ids);
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::InFrustum(
+    const ignition::math::Frustum &_frustum,
+    const Base::EntityType _type) const
+{
+  const ignition::math::AxisAlignedBox bounds = FrustumBox(_frustum);
+
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+
+  std::vector<uint32_t> ids;
+  this->dataPtr->Intersecting(bounds, _type, ids);
+
+  ids.erase(std::remove_if(ids.begin(), ids.end(),
+        [&](const uint32_t _id)
+        {
+          return !_frustum.Contains(this->dataPtr->entries.at(_id).box);
+        }), ids.end());
+
+  return this->dataPtr->Sorted(ids);
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::OnSegment(
+    const ignition::math::Line3d &_segment,
+    const Base::EntityType _type) const
+{
+  const ignition::math::Vector3d &start = _segment[0];
+  const ignition::math::Vector3d &end = _segment[1];
+  ignition::math::Vector3d low = start;
+  ignition::math::Vector3d high = start;
+  low.Min(end);
+  high.Max(end);
+
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+
+  std::vector<uint32_t> ids;
+  this->dataPtr->Intersecting(
+      ignition::math::AxisAlignedBox(low, high), _type, ids);
+
+  ids.erase(std::remove_if(ids.begin(), ids.end(),
+        [&](const uint32_t _id)
+        {
+          return !segmentHits(start, end, this->dataPtr->entries.at(_id).box);
+        }), ids.end());
+
+  return this->dataPtr->Sorted(ids);
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::Nearest(
+    const ignition::math::Vector3d &_point, const unsigned int _count,
+    const Base::EntityType _type) const
+{
+  std::vector<EntityPtr> result;
+  if (_count == 0)
+    return result;
+
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->mutex);
+
+  // Distance beyond which there is nothing more to find in the grid
+  double reach = 0;
+  if (this->dataPtr->hasExtent)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      reach += std::pow(std::max(
+            std::abs(_point[i] - this->dataPtr->extent.Min()[i]),
+            std::abs(_point[i] - this->dataPtr->extent.Max()[i])), 2);
+    }
+    reach = std::sqrt(reach);
+  }
+
+  // Grow a search sphere until it holds enough entities. Everything within
+  // the sphere overlaps its bounding box.
+  std::vector<std::pair<double, uint32_t>> found;
+  for (double radius = this->dataPtr->cellSize;
+       radius < reach && std::isfinite(radius); radius *= 2.0)
+  {
+    const ignition::math::Vector3d r(radius, radius, radius);
+    std::vector<uint32_t> ids;
+    this->dataPtr->Intersecting(
+        ignition::math::AxisAlignedBox(_point - r, _point + r), _type, ids);
+
+    found.clear();
+    for (auto const id : ids)
+    {
+      const double distance =
+        boxDistance(_point, this->dataPtr->entries.at(id).box);
+      if (distance <= radius)
+        found.push_back(std::make_pair(distance, id));
+    }
+
+    if (found.size() >= _count)
+      break;
+  }
+
+  // Not enough entities close by: rank all of them
+  if (found.size() < _count)
+  {
+    found.clear();
+    for (auto const &entry : this->dataPtr->entries)
+    {
+      if (entry.second.entity->HasType(_type))
+      {
+        found.push_back(std::make_pair(
+              boxDistance(_point, entry.second.box), entry.first));
+      }
+    }
+  }
+
+  std::sort(found.begin(), found.end());
+  for (unsigned int i = 0; i < found.size() && i < _count; ++i)
+    result.push_back(this->dataPtr->entries.at(found[i].second).entity);
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox SpatialIndex::FrustumBox(
+    const ignition::math::Frustum &_frustum)
+{
+  const double tanHalf = std::tan(_frustum.FOV().Radian() * 0.5);
+  const double aspect =
+    _frustum.AspectRatio() > 0 ? _frustum.AspectRatio() : 1.0;
+  const ignition::math::Pose3d &pose = _frustum.Pose();
+
+  ignition::math::Vector3d low(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  ignition::math::Vector3d high(ignition::math::LOW_D, ignition::math::LOW_D,
+      ignition::math::LOW_D);
+
+  for (const double distance : {_frustum.Near(), _frustum.Far()})
+  {
+    const double halfWidth = distance * tanHalf;
+    const double halfHeight = halfWidth / aspect;
+    for (const double y : {-halfWidth, halfWidth})
+    {
+      for (const double z : {-halfHeight, halfHeight})
+      {
+        const ignition::math::Vector3d corner =
+          pose.Pos() + pose.Rot().RotateVector({distance, y, z});
+        low.Min(corner);
+        high.Max(corner);
+      }
+    }
+  }
+
+  return ignition::math::AxisAlignedBox(low, high);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SPATIALINDEX_HH_
+#define GAZEBO_PHYSICS_SPATIALINDEX_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Line3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/Base.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class SpatialIndexPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SpatialIndex SpatialIndex.hh physics/physics.hh
+    /// \brief Index of the axis-aligned bounding boxes of entities, for
+    /// proximity queries.
+    ///
+    /// The index is a loose grid: each box is stored in the cell holding
+    /// its center, and boxes larger than a cell, such as ground planes, are
+    /// kept in a separate list that every query checks. Moving an entity
+    /// only touches its old and new cells.
+    ///
+    /// Queries can run from any thread while the index is updated; they
+    /// see the index either before or after each update. Results are
+    /// sorted by entity id, except for Nearest, which sorts by distance.
+    ///
+    /// The World keeps an index of its models and links, refreshed once
+    /// per step from the poses that changed. \sa World::SpatialIdx
+    class GZ_PHYSICS_VISIBLE SpatialIndex
+    {
+      /// \brief Constructor.
+      /// \param[in] _cellSize Edge length of the grid cells, in meters.
+      /// Boxes larger than this are kept out of the grid.
+      public: explicit SpatialIndex(const double _cellSize = 4.0);
+
+      /// \brief Destructor.
+      public: virtual ~SpatialIndex();
+
+      /// \brief Get the edge length of the grid cells.
+      /// \return Cell size in meters.
+      public: double CellSize() const;
+
+      /// \brief Insert an entity, or move it if it is already indexed.
+      /// \param[in] _entity Entity to index.
+      /// \param[in] _box World bounding box of the entity.
+      public: void Update(const EntityPtr &_entity,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Insert or move several entities under a single lock, so
+      /// queries see all the changes at once.
+      /// \param[in] _entities Entities to index.
+      /// \param[in] _boxes World bounding box of each entity.
+      public: void Update(const std::vector<EntityPtr> &_entities,
+                  const std::vector<ignition::math::AxisAlignedBox> &_boxes);
+
+      /// \brief Remove an entity.
+      /// \param[in] _id Id of the entity.
+      public: void Remove(const uint32_t _id);
+
+      /// \brief Remove all the entities.
+      public: void Clear();
+
+      /// \brief Get the number of indexed entities.
+      /// \return Number of entities.
+      public: unsigned int Count() const;
+
+      /// \brief Get a counter that changes every time an entity is added,
+      /// moved or removed. Results computed from the index can be reused
+      /// while it doesn't change.
+      /// \return The version of the index.
+      public: uint64_t Version() const;
+
+      /// \brief Get the bounding box an entity is indexed with.
+      /// \param[in] _id Id of the entity.
+      /// \param[out] _box Bounding box.
+      /// \return False if the entity isn't indexed.
+      public: bool Box(const uint32_t _id,
+                  ignition::math::AxisAlignedBox &_box) const;
+
+      /// \brief Get the entities whose box intersects a box.
+      /// \param[in] _box Box to test.
+      /// \param[in] _type Only return entities of this type, e.g.
+      /// Base::MODEL or Base::LINK. Base::ENTITY returns all of them.
+      /// \return Entities sorted by id.
+      public: std::vector<EntityPtr> Intersecting(
+                  const ignition::math::AxisAlignedBox &_box,
+                  const Base::EntityType _type = Base::ENTITY) const;
+
+      /// \brief Get the entities whose box is within a distance of a point.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[in] _type Only return entities of this type.
+      /// \return Entities sorted by id.
+      public: std::vector<EntityPtr> InSphere(
+                  const ignition::math::Vector3d &_center,
+                  const double _radius,
+                  const Base::EntityType _type = Base::ENTITY) const;
+
+      /// \brief Get the entities whose box is contained in a frustum, with
+      /// the same test as ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Frustum, looking along its +X axis.
+      /// \param[in] _type Only return entities of this type.
+      /// \return Entities sorted by id.
+      public: std::vector<EntityPtr> InFrustum(
+                  const ignition::math::Frustum &_frustum,
+                  const Base::EntityType _type = Base::ENTITY) const;
+
+      /// \brief Get the entities whose box is crossed by a line segment.
+      /// \param[in] _segment Segment.
+      /// \param[in] _type Only return entities of this type.
+      /// \return Entities sorted by id.
+      public: std::vector<EntityPtr> OnSegment(
+                  const ignition::math::Line3d &_segment,
+                  const Base::EntityType _type = Base::ENTITY) const;
+
+      /// \brief Get the entities closest to a point, by distance from the
+      /// point to their box.
+      /// \param[in] _point Point.
+      /// \param[in] _count Maximum number of entities.
+      /// \param[in] _type Only return entities of this type.
+      /// \return Up to _count entities, closest first.
+      public: std::vector<EntityPtr> Nearest(
+                  const ignition::math::Vector3d &_point,
+                  const unsigned int _count,
+                  const Base::EntityType _type = Base::ENTITY) const;
+
+      /// \brief Get the bounding box of a frustum.
+      /// \param[in] _frustum Frustum, looking along its +X axis.
+      /// \return Box holding the eight corners of the frustum.
+      public: static ignition::math::AxisAlignedBox FrustumBox(
+                  const ignition::math::Frustum &_frustum);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SpatialIndexPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class SpatialIndexTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the names of entities.
+/// \param[in] _entities Entities.
+/// \return Sorted names.
+std::vector<std::string> Names(const std::vector<physics::EntityPtr> &_entities)
+{
+  std::vector<std::string> names;
+  for (auto const &entity : _entities)
+    names.push_back(entity->GetScopedName());
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Queries)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // A row of unit boxes along X, resting on the ground
+  for (int i = 0; i < 10; ++i)
+  {
+    SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(i * 3.0, 0, 0.5));
+  }
+
+  physics::SpatialIndexPtr index = world->SpatialIdx();
+  ASSERT_TRUE(index != nullptr);
+
+  // Ground plane, and a model and a link per box
+  EXPECT_EQ(index->Count(), 22u);
+
+  // The ground plane is in every query that reaches the ground
+  auto models = index->InSphere(ignition::math::Vector3d(3, 0, 0.5), 0.6,
+      physics::Base::MODEL);
+  EXPECT_EQ(Names(models),
+      std::vector<std::string>({"box_1", "ground_plane"}));
+
+  auto links = index->InSphere(ignition::math::Vector3d(3, 0, 2.0), 1.6,
+      physics::Base::LINK);
+  EXPECT_EQ(Names(links), std::vector<std::string>({"box_1::link"}));
+
+  // Boxes are found across cells
+  models = index->Intersecting(ignition::math::AxisAlignedBox(
+        ignition::math::Vector3d(5.6, -1, 0.2),
+        ignition::math::Vector3d(12.4, 1, 0.8)), physics::Base::MODEL);
+  EXPECT_EQ(Names(models), std::vector<std::string>(
+        {"box_2", "box_3", "box_4"}));
+
+  // Nearest boxes to a point above the row, closest first. The ground is
+  // further away.
+  auto nearest = index->Nearest(ignition::math::Vector3d(20, 0, 10), 3,
+      physics::Base::LINK);
+  ASSERT_EQ(nearest.size(), 3u);
+  EXPECT_EQ(nearest[0]->GetScopedName(), "box_7::link");
+  EXPECT_EQ(nearest[1]->GetScopedName(), "box_6::link");
+  EXPECT_EQ(nearest[2]->GetScopedName(), "box_8::link");
+
+  // Far away from the boxes, the search grows until it finds one
+  nearest = index->Nearest(ignition::math::Vector3d(-500, 0, 0.5), 2,
+      physics::Base::LINK);
+  ASSERT_EQ(nearest.size(), 2u);
+  EXPECT_EQ(nearest[0]->GetScopedName(), "ground_plane::link");
+  EXPECT_EQ(nearest[1]->GetScopedName(), "box_0::link");
+
+  // A segment along the row crosses the boxes it reaches, and passes
+  // over the ground
+  links = index->OnSegment(ignition::math::Line3d(
+        ignition::math::Vector3d(-1, 0, 0.5),
+        ignition::math::Vector3d(7, 0, 0.5)), physics::Base::LINK);
+  EXPECT_EQ(Names(links), std::vector<std::string>(
+        {"box_0::link", "box_1::link", "box_2::link"}));
+  links = index->OnSegment(ignition::math::Line3d(
+        ignition::math::Vector3d(-1, 0, 2),
+        ignition::math::Vector3d(30, 0, 2)), physics::Base::LINK);
+  EXPECT_TRUE(links.empty());
+
+  // A segment going down to the ground, between two boxes
+  links = index->OnSegment(ignition::math::Line3d(
+        ignition::math::Vector3d(1.5, 0, 3),
+        ignition::math::Vector3d(1.5, 0, -1)), physics::Base::LINK);
+  EXPECT_EQ(Names(links), std::vector<std::string>({"ground_plane::link"}));
+
+  // A frustum looking along the row
+  ignition::math::Frustum frustum;
+  frustum.SetNear(0.1);
+  frustum.SetFar(10.0);
+  frustum.SetFOV(IGN_DTOR(60));
+  frustum.SetAspectRatio(1.0);
+  frustum.SetPose(ignition::math::Pose3d(-1, 0, 0.5, 0, 0, 0));
+  models = index->InFrustum(frustum, physics::Base::MODEL);
+  auto names = Names(models);
+  EXPECT_NE(std::find(names.begin(), names.end(), "box_1"), names.end());
+  EXPECT_EQ(std::find(names.begin(), names.end(), "box_5"), names.end());
+
+  // Same result as testing every model
+  std::vector<std::string> expected;
+  for (auto const &model : world->Models())
+  {
+    if (frustum.Contains(model->BoundingBox()))
+      expected.push_back(model->GetScopedName());
+  }
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(Names(models), expected);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SpatialIndexTest, Refresh)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::SpatialIndexPtr index = world->SpatialIdx();
+  ASSERT_TRUE(index != nullptr);
+  EXPECT_EQ(index->Count(), 2u);
+
+  // Added models show up after the next step
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  world->Step(1);
+  EXPECT_EQ(index->Count(), 4u);
+
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  // Moved models are found at their new place after the next step
+  const uint64_t version = index->Version();
+  box->SetWorldPose(ignition::math::Pose3d(40, 40, 0.5, 0, 0, 0));
+  world->Step(1);
+  EXPECT_GT(index->Version(), version);
+
+  auto models = index->InSphere(ignition::math::Vector3d(40, 40, 0.5), 1.0,
+      physics::Base::MODEL);
+  EXPECT_EQ(Names(models), std::vector<std::string>({"box", "ground_plane"}));
+  models = index->InSphere(ignition::math::Vector3d(0, 0, 0.5), 1.0,
+      physics::Base::MODEL);
+  EXPECT_EQ(Names(models), std::vector<std::string>({"ground_plane"}));
+
+  ignition::math::AxisAlignedBox box1;
+  ASSERT_TRUE(index->Box(box->GetId(), box1));
+  EXPECT_NEAR(box1.Center().X(), 40, 1e-3);
+
+  // Removed models are gone after the next step
+  world->RemoveModel("box");
+  world->Step(1);
+  EXPECT_EQ(index->Count(), 2u);
+  EXPECT_FALSE(index->Box(box->GetId(), box1));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/StepPacer.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Monotonic clock of the deadlines.
+    using PacerClock = std::chrono::steady_clock;
+
+    /// \brief Number of steps the jitter is computed over.
+    static const std::size_t kJitterSamples = 1000;
+
+    /// \brief Number of new steps before the percentiles of FillMsg are
+    /// computed again.
+    static const std::size_t kJitterRefresh = 100;
+
+    /// \internal
+    /// \brief Private data for the StepPacer class
+    class StepPacerPrivate
+    {
+      /// \brief Record the start of a step.
+      /// \param[in] _start Start of the step.
+      public: void Record(const PacerClock::time_point &_start);
+
+      /// \brief Compute a percentile of the jitter.
+      /// \param[in] _percentile Percentile, between 0 and 100.
+      /// \return Jitter in seconds.
+      public: double Percentile(const double _percentile) const;
+
+      /// \brief True if enabled.
+      public: bool enabled = false;
+
+      /// \brief Part of the wait spent spinning.
+      public: PacerClock::duration spinTime = std::chrono::microseconds(200);
+
+      /// \brief Maximum number of catch-up steps.
+      public: unsigned int maxCatchUp = 10;
+
+      /// \brief True to restart the schedule on the next step.
+      public: bool restart = true;
+
+      /// \brief Period of the schedule, in seconds.
+      public: double period = 0;
+
+      /// \brief Deadline of the next step.
+      public: PacerClock::time_point deadline;
+
+      /// \brief Start of the previous step.
+      public: PacerClock::time_point prevStart;
+
+      /// \brief True if prevStart is a step of the current schedule.
+      public: bool hasPrev = false;
+
+      /// \brief Jitter of the last steps, in seconds, used as a ring.
+      public: std::vector<double> jitter;
+
+      /// \brief Next sample of the ring to overwrite.
+      public: std::size_t nextSample = 0;
+
+      /// \brief Number of steps recorded since the percentiles were
+      /// computed.
+      public: mutable std::size_t newSamples = 0;
+
+      /// \brief Percentiles of the last FillMsg: 50, 90, 99 and 100.
+      public: mutable double percentiles[4] = {0, 0, 0, 0};
+
+      /// \brief Number of overruns.
+      public: uint64_t overruns = 0;
+
+      /// \brief Number of skipped steps.
+      public: uint64_t skipped = 0;
+
+      /// \brief Protects the settings and the statistics.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+void StepPacerPrivate::Record(const PacerClock::time_point &_start)
+{
+  if (this->hasPrev)
+  {
+    const double interval =
+        std::chrono::duration<double>(_start - this->prevStart).count();
+    const double sample = std::abs(interval - this->period);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->jitter.size() < kJitterSamples)
+      this->jitter.push_back(sample);
+    else
+      this->jitter[this->nextSample] = sample;
+    this->nextSample = (this->nextSample + 1) % kJitterSamples;
+    ++this->newSamples;
+  }
+  this->prevStart = _start;
+  this->hasPrev = true;
+}
+
+/////////////////////////////////////////////////
+double StepPacerPrivate::Percentile(const double _percentile) const
+{
+  if (this->jitter.empty())
+    return 0;
+
+  std::vector<double> sorted(this->jitter);
+  const double rank = ignition::math::clamp(_percentile, 0.0, 100.0) / 100.0;
+  const std::size_t n = static_cast<std::size_t>(
+      std::round(rank * (sorted.size() - 1)));
+  std::nth_element(sorted.begin(), sorted.begin() + n, sorted.end());
+  return sorted[n];
+}
+
+/////////////////////////////////////////////////
+StepPacer::StepPacer()
+  : dataPtr(new StepPacerPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+StepPacer::~StepPacer()
+{
+}
+
+/////////////////////////////////////////////////
+bool StepPacer::Enabled() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->enabled;
+}
+
+/////////////////////////////////////////////////
+void StepPacer::SetEnabled(const bool _enable)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_enable && !this->dataPtr->enabled)
+    this->dataPtr->restart = true;
+  this->dataPtr->enabled = _enable;
+}
+
+/////////////////////////////////////////////////
+common::Time StepPacer::SpinTime() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      this->dataPtr->spinTime).count();
+  return common::Time(static_cast<int32_t>(ns / common::Time::nsInSec),
+      static_cast<int32_t>(ns % common::Time::nsInSec));
+}
+
+/////////////////////////////////////////////////
+void StepPacer::SetSpinTime(const common::Time &_time)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_time < common::Time::Zero)
+    this->dataPtr->spinTime = PacerClock::duration::zero();
+  else
+  {
+    this->dataPtr->spinTime = std::chrono::seconds(_time.sec) +
+        std::chrono::nanoseconds(_time.nsec);
+  }
+}
+
+/////////////////////////////////////////////////
+unsigned int StepPacer::MaxCatchUp() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxCatchUp;
+}
+
+/////////////////////////////////////////////////
+void StepPacer::SetMaxCatchUp(const unsigned int _steps)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxCatchUp = _steps;
+}
+
+/////////////////////////////////////////////////
+void StepPacer::Wait(const double _period)
+{
+  PacerClock::duration spinTime;
+  unsigned int maxCatchUp;
+  bool restart;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    spinTime = this->dataPtr->spinTime;
+    maxCatchUp = this->dataPtr->maxCatchUp;
+    restart = this->dataPtr->restart;
+    this->dataPtr->restart = false;
+  }
+
+  PacerClock::time_point now = PacerClock::now();
+  if (!(_period > 0))
+  {
+    // Not paced, restart the schedule once there is a period again
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->restart = true;
+    return;
+  }
+
+  const PacerClock::duration period =
+      std::chrono::duration_cast<PacerClock::duration>(
+        std::chrono::duration<double>(_period));
+
+  // The first step of a schedule is due now
+  if (restart || _period != this->dataPtr->period)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      this->dataPtr->period = _period;
+    }
+    this->dataPtr->deadline = now;
+    this->dataPtr->hasPrev = false;
+  }
+
+  PacerClock::time_point &deadline = this->dataPtr->deadline;
+  if (now > deadline)
+  {
+    // Late. Run now, and skip the deadlines beyond the catch-up limit,
+    // which keeps the phase of the schedule.
+    const uint64_t missed = static_cast<uint64_t>((now - deadline) / period);
+    uint64_t skip = 0;
+    if (missed > maxCatchUp)
+    {
+      skip = missed - maxCatchUp;
+      deadline += period * static_cast<PacerClock::rep>(skip);
+    }
+
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    ++this->dataPtr->overruns;
+    this->dataPtr->skipped += skip;
+  }
+  else
+  {
+    // Sleep through most of the wait, and spin through the rest
+    if (deadline - now > spinTime)
+      std::this_thread::sleep_until(deadline - spinTime);
+    while ((now = PacerClock::now()) < deadline)
+      std::this_thread::yield();
+  }
+
+  this->dataPtr->Record(now);
+  deadline += period;
+}
+
+/////////////////////////////////////////////////
+void StepPacer::Reset()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->restart = true;
+  this->dataPtr->jitter.clear();
+  this->dataPtr->nextSample = 0;
+  this->dataPtr->newSamples = 0;
+  for (double &p : this->dataPtr->percentiles)
+    p = 0;
+  this->dataPtr->overruns = 0;
+  this->dataPtr->skipped = 0;
+}
+
+/////////////////////////////////////////////////
+uint64_t StepPacer::Overruns() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->overruns;
+}
+
+/////////////////////////////////////////////////
+uint64_t StepPacer::Skipped() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->skipped;
+}
+
+/////////////////////////////////////////////////
+common::Time StepPacer::Jitter(const double _percentile) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return common::Time(this->dataPtr->Percentile(_percentile));
+}
+
+/////////////////////////////////////////////////
+void StepPacer::FillMsg(msgs::StepTiming &_msg) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  // Sorting the samples at every step would cost more than the pacing
+  // saves at high rates, so the percentiles are refreshed periodically.
+  double *p = this->dataPtr->percentiles;
+  if (this->dataPtr->newSamples >= kJitterRefresh ||
+      (this->dataPtr->newSamples > 0 && p[3] == 0))
+  {
+    p[0] = this->dataPtr->Percentile(50);
+    p[1] = this->dataPtr->Percentile(90);
+    p[2] = this->dataPtr->Percentile(99);
+    p[3] = this->dataPtr->Percentile(100);
+    this->dataPtr->newSamples = 0;
+  }
+
+  _msg.set_period(this->dataPtr->period);
+  _msg.set_overruns(this->dataPtr->overruns);
+  _msg.set_skipped(this->dataPtr->skipped);
+  _msg.set_samples(static_cast<uint32_t>(this->dataPtr->jitter.size()));
+  _msg.set_jitter_p50(p[0]);
+  _msg.set_jitter_p90(p[1]);
+  _msg.set_jitter_p99(p[2]);
+  _msg.set_jitter_max(p[3]);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_STEPPACER_HH_
+#define GAZEBO_PHYSICS_STEPPACER_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class StepPacerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class StepPacer StepPacer.hh physics/physics.hh
+    /// \brief Paces the steps of a world to absolute deadlines of a
+    /// monotonic clock.
+    ///
+    /// Step n is due at start + n * period, so the timing errors of one
+    /// step don't carry over to the next ones. The pacer sleeps until
+    /// shortly before the deadline, then spins for the last part of the
+    /// wait, which the operating system can't sleep through accurately.
+    ///
+    /// A step that starts after its deadline is an overrun. The following
+    /// steps run without waiting until the schedule is caught up, for at
+    /// most MaxCatchUp steps; the deadlines beyond that are skipped, so
+    /// that simulated time lags behind instead of running in a burst.
+    ///
+    /// Enabled with World::Pacer, or with custom elements of <physics>:
+    ///
+    ///     <gz:deadline_pacing>true</gz:deadline_pacing>
+    ///     <gz:spin_time>0.0002</gz:spin_time>
+    ///     <gz:max_catch_up>0</gz:max_catch_up>
+    class GZ_PHYSICS_VISIBLE StepPacer
+    {
+      /// \brief Constructor. The pacer is disabled.
+      public: StepPacer();
+
+      /// \brief Destructor.
+      public: virtual ~StepPacer();
+
+      /// \brief Check whether the world is paced by this pacer, instead of
+      /// the relative sleeps of World::Step.
+      /// \return True if enabled.
+      public: bool Enabled() const;
+
+      /// \brief Enable the pacer. The schedule restarts on the next step.
+      /// \param[in] _enable True to enable.
+      public: void SetEnabled(const bool _enable);
+
+      /// \brief Get the part of the wait spent spinning instead of
+      /// sleeping.
+      /// \return Spin time.
+      public: common::Time SpinTime() const;
+
+      /// \brief Set the part of the wait spent spinning instead of
+      /// sleeping. The default is 200 microseconds; zero never spins.
+      /// \param[in] _time Spin time.
+      public: void SetSpinTime(const common::Time &_time);
+
+      /// \brief Get the number of late steps run without waiting after an
+      /// overrun.
+      /// \return Maximum number of catch-up steps.
+      public: unsigned int MaxCatchUp() const;
+
+      /// \brief Set the number of late steps run without waiting after an
+      /// overrun. Zero skips every late step, which keeps the period
+      /// between steps at the cost of simulated time lagging behind. The
+      /// default is 10.
+      /// \param[in] _steps Maximum number of catch-up steps.
+      public: void SetMaxCatchUp(const unsigned int _steps);
+
+      /// \brief Wait for the deadline of the next step.
+      /// \param[in] _period Time between steps, in seconds. Zero or less
+      /// doesn't wait. The schedule restarts when the period changes.
+      public: void Wait(const double _period);
+
+      /// \brief Restart the schedule and clear the statistics.
+      public: void Reset();
+
+      /// \brief Get the number of steps that started after their deadline.
+      /// \return Number of overruns.
+      public: uint64_t Overruns() const;
+
+      /// \brief Get the number of steps skipped after overruns.
+      /// \return Number of skipped steps.
+      public: uint64_t Skipped() const;
+
+      /// \brief Get a percentile of the step period jitter, which is the
+      /// absolute difference between the time between two steps and the
+      /// period, over the last steps.
+      /// \param[in] _percentile Percentile, between 0 and 100.
+      /// \return Jitter, zero if there are no steps yet.
+      public: common::Time Jitter(const double _percentile) const;
+
+      /// \brief Fill a message with the statistics.
+      /// \param[out] _msg Message to fill.
+      public: void FillMsg(msgs::StepTiming &_msg) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StepPacerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "gazebo/physics/StepPacer.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class StepPacer_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(StepPacer_TEST, Settings)
+{
+  physics::StepPacer pacer;
+  EXPECT_FALSE(pacer.Enabled());
+  EXPECT_EQ(pacer.SpinTime(), common::Time(0, 200000));
+  EXPECT_EQ(pacer.MaxCatchUp(), 10u);
+
+  pacer.SetEnabled(true);
+  pacer.SetSpinTime(common::Time(0, 50000));
+  pacer.SetMaxCatchUp(0);
+  EXPECT_TRUE(pacer.Enabled());
+  EXPECT_EQ(pacer.SpinTime(), common::Time(0, 50000));
+  EXPECT_EQ(pacer.MaxCatchUp(), 0u);
+
+  // Nothing recorded yet
+  EXPECT_EQ(pacer.Overruns(), 0u);
+  EXPECT_EQ(pacer.Skipped(), 0u);
+  EXPECT_EQ(pacer.Jitter(50), common::Time::Zero);
+}
+
+/////////////////////////////////////////////////
+TEST_F(StepPacer_TEST, Deadlines)
+{
+  physics::StepPacer pacer;
+  pacer.SetEnabled(true);
+
+  // The first step is due at once, the others one period apart
+  const double period = 0.005;
+  const int steps = 40;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < steps; ++i)
+    pacer.Wait(period);
+  const double elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  EXPECT_GE(elapsed, (steps - 1) * period);
+
+  msgs::StepTiming msg;
+  pacer.FillMsg(msg);
+  EXPECT_DOUBLE_EQ(msg.period(), period);
+  EXPECT_EQ(msg.samples(), static_cast<uint32_t>(steps - 1));
+  EXPECT_LE(msg.jitter_p50(), msg.jitter_p90());
+  EXPECT_LE(msg.jitter_p90(), msg.jitter_p99());
+  EXPECT_LE(msg.jitter_p99(), msg.jitter_max());
+  EXPECT_EQ(pacer.Jitter(100), common::Time(msg.jitter_max()));
+
+  pacer.Reset();
+  EXPECT_EQ(pacer.Overruns(), 0u);
+  pacer.FillMsg(msg);
+  EXPECT_EQ(msg.samples(), 0u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(StepPacer_TEST, Overrun)
+{
+  physics::StepPacer pacer;
+  pacer.SetEnabled(true);
+  pacer.SetMaxCatchUp(2);
+
+  const double period = 0.005;
+  pacer.Wait(period);
+
+  // A step of about ten periods
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  pacer.Wait(period);
+  EXPECT_EQ(pacer.Overruns(), 1u);
+  EXPECT_GE(pacer.Skipped(), 6u);
+
+  // Catching up doesn't wait, up to the limit
+  const uint64_t skipped = pacer.Skipped();
+  auto start = std::chrono::steady_clock::now();
+  pacer.Wait(period);
+  pacer.Wait(period);
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+      std::chrono::milliseconds(5));
+  EXPECT_EQ(pacer.Skipped(), skipped);
+
+  // Changing the period restarts the schedule
+  pacer.Wait(period * 2);
+  pacer.Wait(period * 2);
+  EXPECT_EQ(pacer.Skipped(), skipped);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,8 +17,12 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
+#include <cstdlib>
+
 #include "gazebo/transport/transport.hh"
 
+#include "gazebo/physics/Light.hh"
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/WorldState.hh"
 
@@ -28,6 +32,109 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Default memory budget of the undo and redo history in MB.
+static const size_t kDefaultMemoryBudgetMB = 256;
+
+/////////////////////////////////////////////////
+/// \brief Estimate the memory held by a model state.
+/// \param[in] _state Model state.
+/// \return Size in bytes.
+static size_t StateSize(const ModelState &_state)
+{
+  size_t size = sizeof(ModelState) + _state.GetName().size();
+
+  for (auto const &linkState : _state.GetLinkStates())
+  {
+    size += sizeof(LinkState) + linkState.first.size() +
+        linkState.second.GetCollisionStateCount() * sizeof(CollisionState);
+  }
+
+  for (auto const &jointState : _state.GetJointStates())
+  {
+    size += sizeof(JointState) + jointState.first.size() +
+        jointState.second.GetAngleCount() * sizeof(double);
+  }
+
+  for (auto const &nestedState : _state.NestedModelStates())
+    size += StateSize(nestedState.second);
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the memory held by a world state.
+/// \param[in] _state World state.
+/// \return Size in bytes.
+static size_t StateSize(const WorldState &_state)
+{
+  size_t size = sizeof(WorldState);
+
+  for (auto const &modelState : _state.GetModelStates())
+    size += StateSize(modelState.second);
+
+  size += _state.LightStateCount() * sizeof(LightState);
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the name of the top level model or light which contains an
+/// entity.
+/// \param[in] _world Pointer to the world.
+/// \param[in] _name Scoped name of a model, link or light.
+/// \return Name of the top level entity, or an empty string if not found.
+static std::string TopLevelName(const WorldPtr &_world,
+    const std::string &_name)
+{
+  LightPtr light = _world->LightByName(_name);
+  if (light)
+    return light->GetName();
+
+  EntityPtr entity = _world->EntityByName(_name);
+  if (!entity)
+    return "";
+
+  ModelPtr model = entity->GetParentModel();
+  while (model && model->GetParent() &&
+         model->GetParent()->HasType(Base::MODEL))
+  {
+    model = boost::dynamic_pointer_cast<Model>(model->GetParent());
+  }
+
+  return model ? model->GetName() : "";
+}
+
+/////////////////////////////////////////////////
+/// \brief Record the state of the entities modified by a command.
+/// \param[in] _cmd Private data of the command.
+/// \param[out] _state Recorded state.
+static void RecordState(const UserCmdPrivate &_cmd, WorldState &_state)
+{
+  if (_cmd.wholeWorld)
+    _state = WorldState(_cmd.world);
+  else
+    _state.LoadEntities(_cmd.world, _cmd.entities);
+}
+
+/////////////////////////////////////////////////
+/// \brief Reset the physics states of the entities modified by a command.
+/// \param[in] _cmd Private data of the command.
+static void ResetPhysicsStates(const UserCmdPrivate &_cmd)
+{
+  if (_cmd.wholeWorld)
+  {
+    _cmd.world->ResetPhysicsStates();
+    return;
+  }
+
+  for (auto const &entityName : _cmd.entities)
+  {
+    ModelPtr model = _cmd.world->ModelByName(entityName);
+    if (model)
+      model->ResetPhysicsStates();
+  }
+}
+
 
 /////////////////////////////////////////////////
 UserCmd::UserCmd(const unsigned int _id,
@@ -45,6 +152,25 @@ UserCmd::UserCmd(const unsigned int _id,
   this->dataPtr->startState = WorldState(this->dataPtr->world);
 }
 
+/////////////////////////////////////////////////
+UserCmd::UserCmd(const unsigned int _id,
+                 physics::WorldPtr _world,
+                 const std::string &_description,
+                 const msgs::UserCmd::Type &_type,
+                 const std::set<std::string> &_entities)
+  : dataPtr(new UserCmdPrivate())
+{
+  this->dataPtr->id = _id;
+  this->dataPtr->world = _world;
+  this->dataPtr->description = _description;
+  this->dataPtr->type = _type;
+  this->dataPtr->wholeWorld = false;
+  this->dataPtr->entities = _entities;
+
+  // Record current state of the modified entities
+  RecordState(*this->dataPtr, this->dataPtr->startState);
+}
+
 /////////////////////////////////////////////////
 UserCmd::~UserCmd()
 {
@@ -60,10 +186,10 @@ UserCmd::~UserCmd()
 void UserCmd::Undo()
 {
   // Record / override the state for redo
-  this->dataPtr->endState = WorldState(this->dataPtr->world);
+  RecordState(*this->dataPtr, this->dataPtr->endState);
 
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
+  // Reset physics states of the modified entities
+  ResetPhysicsStates(*this->dataPtr);
 
   // Set state to the moment the command was executed
   this->dataPtr->world->SetState(this->dataPtr->startState);
@@ -72,8 +198,8 @@ void UserCmd::Undo()
 /////////////////////////////////////////////////
 void UserCmd::Redo()
 {
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
+  // Reset physics states of the modified entities
+  ResetPhysicsStates(*this->dataPtr);
 
   // Set state to the moment undo was triggered
   this->dataPtr->world->SetState(this->dataPtr->endState);
@@ -97,6 +223,14 @@ msgs::UserCmd::Type UserCmd::Type() const
   return this->dataPtr->type;
 }
 
+/////////////////////////////////////////////////
+size_t UserCmd::MemoryUsage() const
+{
+  return sizeof(UserCmdPrivate) + this->dataPtr->description.size() +
+      StateSize(this->dataPtr->startState) +
+      StateSize(this->dataPtr->endState);
+}
+
 /////////////////////////////////////////////////
 UserCmdManager::UserCmdManager(const WorldPtr _world)
   : dataPtr(new UserCmdManagerPrivate())
@@ -125,6 +259,22 @@ UserCmdManager::UserCmdManager(const WorldPtr _world)
       this->dataPtr->node->Advertise<msgs::Light>("~/light/modify");
 
   this->dataPtr->idCounter = 0;
+
+  this->dataPtr->memoryBudget = kDefaultMemoryBudgetMB * 1024 * 1024;
+  const char *budgetEnv = std::getenv("GAZEBO_UNDO_MEMORY_MB");
+  if (budgetEnv)
+  {
+    try
+    {
+      this->dataPtr->memoryBudget = std::stoul(budgetEnv) * 1024 * 1024;
+    }
+    catch(...)
+    {
+      gzerr << "Invalid GAZEBO_UNDO_MEMORY_MB [" << budgetEnv
+            << "], using the default of " << kDefaultMemoryBudgetMB
+            << " MB." << std::endl;
+    }
+  }
 }
 
 /////////////////////////////////////////////////
@@ -160,9 +310,59 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
   // Generate unique id
   unsigned int id = this->dataPtr->idCounter++;
 
+  // Find the entities modified by the command. World control commands may
+  // modify anything, except for resetting the time.
+  bool wholeWorld = false;
+  std::set<std::string> entities;
+  switch (_msg->type())
+  {
+    case msgs::UserCmd::MOVING:
+    case msgs::UserCmd::SCALING:
+    {
+      for (int i = 0; i < _msg->model_size(); ++i)
+      {
+        entities.insert(
+            TopLevelName(this->dataPtr->world, _msg->model(i).name()));
+      }
+      for (int i = 0; i < _msg->light_size(); ++i)
+      {
+        entities.insert(
+            TopLevelName(this->dataPtr->world, _msg->light(i).name()));
+      }
+      break;
+    }
+    case msgs::UserCmd::WRENCH:
+    {
+      entities.insert(
+          TopLevelName(this->dataPtr->world, _msg->entity_name()));
+      break;
+    }
+    case msgs::UserCmd::WORLD_CONTROL:
+    {
+      wholeWorld = !(_msg->world_control().has_reset() &&
+          _msg->world_control().reset().time_only());
+      break;
+    }
+    default:
+    {
+      wholeWorld = true;
+      break;
+    }
+  }
+  entities.erase("");
+
   // Create command
-  UserCmdPtr cmd(new UserCmd(id, this->dataPtr->world, _msg->description(),
-      _msg->type()));
+  UserCmdPtr cmd;
+  if (wholeWorld)
+  {
+    cmd.reset(new UserCmd(id, this->dataPtr->world, _msg->description(),
+        _msg->type()));
+  }
+  else
+  {
+    cmd.reset(new UserCmd(id, this->dataPtr->world, _msg->description(),
+        _msg->type(), entities));
+  }
 
   // Forward message after we've saved the current state
   switch (_msg->type())
@@ -226,6 +426,8 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
   // Clear redo list
   this->dataPtr->redoCmds.clear();
 
+  this->EnforceMemoryBudget();
+
   // Publish stats
   this->PublishCurrentStats();
 }
@@ -328,9 +530,60 @@ void UserCmdManager::OnUndoRedoMsg(ConstUndoRedoPtr &_msg)
     }
   }
 
+  // Undo records new states, so the history may have grown
+  this->EnforceMemoryBudget();
+
   this->PublishCurrentStats();
 }
 
+/////////////////////////////////////////////////
+void UserCmdManager::SetMemoryBudget(const size_t _bytes)
+{
+  this->dataPtr->memoryBudget = _bytes;
+  this->EnforceMemoryBudget();
+}
+
+/////////////////////////////////////////////////
+size_t UserCmdManager::MemoryBudget() const
+{
+  return this->dataPtr->memoryBudget;
+}
+
+/////////////////////////////////////////////////
+size_t UserCmdManager::MemoryUsage() const
+{
+  size_t usage = 0;
+  for (auto const &cmd : this->dataPtr->undoCmds)
+    usage += cmd->MemoryUsage();
+  for (auto const &cmd : this->dataPtr->redoCmds)
+    usage += cmd->MemoryUsage();
+  return usage;
+}
+
+/////////////////////////////////////////////////
+void UserCmdManager::EnforceMemoryBudget()
+{
+  size_t usage = this->MemoryUsage();
+  while (usage > this->dataPtr->memoryBudget &&
+         this->dataPtr->undoCmds.size() + this->dataPtr->redoCmds.size() > 1)
+  {
+    // Drop the command furthest away from the current state: the oldest
+    // undo command, then the last redo command.
+    UserCmdPtr cmd;
+    if (!this->dataPtr->undoCmds.empty())
+    {
+      cmd = this->dataPtr->undoCmds.front();
+      this->dataPtr->undoCmds.erase(this->dataPtr->undoCmds.begin());
+    }
+    else
+    {
+      cmd = this->dataPtr->redoCmds.front();
+      this->dataPtr->redoCmds.erase(this->dataPtr->redoCmds.begin());
+    }
+    usage -= cmd->MemoryUsage();
+  }
+}
+
 /////////////////////////////////////////////////
 void UserCmdManager::PublishCurrentStats()
 {
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_USERCMDMANAGER_HH_
 #define GAZEBO_PHYSICS_USERCMDMANAGER_HH_
 
+#include <set>
 #include <string>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -45,6 +46,22 @@ namespace gazebo
                       const std::string &_description,
                       const msgs::UserCmd::Type &_type);
 
+      /// \brief Constructor for a command which only modifies a few
+      /// entities. Only the state of those entities is recorded, and only
+      /// those entities are restored on undo and redo.
+      /// \param[in] _id Unique ID for this command
+      /// \param[in] _world Pointer to the world
+      /// \param[in] _description Description for the command, such as
+      /// "Rotate box", "Delete sphere", etc.
+      /// \param[in] _type Type of command, such as MOVING, DELETING, etc.
+      /// \param[in] _entities Names of the top level models and lights
+      /// modified by the command.
+      public: UserCmd(const unsigned int _id,
+                      physics::WorldPtr _world,
+                      const std::string &_description,
+                      const msgs::UserCmd::Type &_type,
+                      const std::set<std::string> &_entities);
+
       /// \brief Destructor
       public: virtual ~UserCmd();
 
@@ -66,6 +83,11 @@ namespace gazebo
       /// \return Command type
       public: msgs::UserCmd::Type Type() const;
 
+      /// \brief Return an estimate of the memory held by the states
+      /// recorded for this command.
+      /// \return Size in bytes.
+      public: size_t MemoryUsage() const;
+
       /// \internal
       /// \brief Pointer to private data.
       protected: UserCmdPrivate *dataPtr;
@@ -83,6 +105,24 @@ namespace gazebo
       /// \brief Destructor.
       public: virtual ~UserCmdManager();
 
+      /// \brief Set the maximum memory held by the undo and redo history.
+      /// When the history grows past the budget, the oldest commands are
+      /// dropped. At least one command is always kept.
+      /// \param[in] _bytes Budget in bytes.
+      /// \sa MemoryBudget()
+      public: void SetMemoryBudget(const size_t _bytes);
+
+      /// \brief Get the maximum memory held by the undo and redo history.
+      /// Defaults to GAZEBO_UNDO_MEMORY_MB megabytes if that environment
+      /// variable is set, and 256 MB otherwise.
+      /// \return Budget in bytes.
+      public: size_t MemoryBudget() const;
+
+      /// \brief Get an estimate of the memory held by the undo and redo
+      /// history.
+      /// \return Size in bytes.
+      public: size_t MemoryUsage() const;
+
       /// \brief Callback when a UserCmd message is received, notifying that
       /// a new command has been executed by a user.
       /// \param[in] _msg Incoming message
@@ -96,6 +136,10 @@ namespace gazebo
       /// \brief Publish a message about current user command statistics.
       private: void PublishCurrentStats();
 
+      /// \brief Drop the oldest commands until the history fits in the
+      /// memory budget.
+      private: void EnforceMemoryBudget();
+
       /// \internal
       /// \brief Pointer to private data.
       private: UserCmdManagerPrivate *dataPtr;
@@ -17,6 +17,7 @@
 #ifndef _GAZEBO_USER_CMD_MANAGER_PRIVATE_HH_
 #define _GAZEBO_USER_CMD_MANAGER_PRIVATE_HH_
 
+#include <set>
 #include <string>
 #include <vector>
 #include <sdf/sdf.hh>
@@ -38,13 +39,23 @@ namespace gazebo
       /// \brief Pointer to the world.
       public: WorldPtr world;
 
-      /// \brief Whole world state the moment the user command was executed.
+      /// \brief World state the moment the user command was executed.
+      /// Holds only the modified entities unless wholeWorld is true.
       public: WorldState startState;
 
-      /// \brief Whole world state for the most recent time the user has
-      /// triggered undo for this command.
+      /// \brief World state for the most recent time the user has
+      /// triggered undo for this command. Holds only the modified entities
+      /// unless wholeWorld is true.
       public: WorldState endState;
 
+      /// \brief True if the command may modify any entity, so that the
+      /// state of the whole world must be recorded.
+      public: bool wholeWorld = true;
+
+      /// \brief Top level models and lights modified by the command, used
+      /// when wholeWorld is false.
+      public: std::set<std::string> entities;
+
       /// \brief Unique ID identifying this command in the server.
       public: unsigned int id;
 
@@ -93,6 +104,9 @@ namespace gazebo
 
       /// \brief List of commands which can be redone.
       public: std::vector<UserCmdPtr> redoCmds;
+
+      /// \brief Maximum memory held by the undo and redo lists, in bytes.
+      public: size_t memoryBudget;
     };
   }
 }
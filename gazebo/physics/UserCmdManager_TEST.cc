@@ -15,6 +15,11 @@
  *
 */
 
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/test/ServerFixture.hh"
@@ -61,6 +66,216 @@ TEST_F(UserCmdManagerTest, CreateCmd)
   manager = NULL;
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, SparseUndoRedo)
+{
+  // Load a world
+  Load("worlds/shapes.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  auto box = world->ModelByName("box");
+  ASSERT_TRUE(box != NULL);
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_TRUE(sphere != NULL);
+
+  auto boxInitialPose = box->WorldPose();
+  auto sphereInitialPose = sphere->WorldPose();
+
+  // Commands which only record the box, and the whole world
+  physics::UserCmd boxCmd(0, world, "Move box", msgs::UserCmd::MOVING,
+      {"box"});
+  physics::UserCmd worldCmd(1, world, "Move all", msgs::UserCmd::MOVING);
+  EXPECT_LT(boxCmd.MemoryUsage(), worldCmd.MemoryUsage());
+
+  // Move both models
+  ignition::math::Pose3d boxFinalPose(10, 20, 0.5, 0, 0, 0);
+  ignition::math::Pose3d sphereFinalPose(-10, -20, 0.5, 0, 0, 0);
+  box->SetWorldPose(boxFinalPose);
+  sphere->SetWorldPose(sphereFinalPose);
+
+  // Undo only restores the box
+  boxCmd.Undo();
+  EXPECT_EQ(box->WorldPose(), boxInitialPose);
+  EXPECT_EQ(sphere->WorldPose(), sphereFinalPose);
+
+  // Redo moves the box back to where it was when undo was triggered
+  boxCmd.Redo();
+  EXPECT_EQ(box->WorldPose(), boxFinalPose);
+  EXPECT_EQ(sphere->WorldPose(), sphereFinalPose);
+
+  // The whole world command restores both models
+  worldCmd.Undo();
+  EXPECT_EQ(box->WorldPose(), boxInitialPose);
+  EXPECT_EQ(sphere->WorldPose(), sphereInitialPose);
+}
+
+/////////////////////////////////////////////////
+std::mutex g_statsMutex;
+std::vector<msgs::UserCmdStats> g_stats;
+
+/////////////////////////////////////////////////
+void OnUserCmdStats(ConstUserCmdStatsPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_statsMutex);
+  g_stats.push_back(*_msg);
+}
+
+/////////////////////////////////////////////////
+// Wait for stats which match a predicate. The world's own manager also
+// publishes stats, so the predicate picks the ones of the test manager.
+bool WaitForStats(std::function<bool(const msgs::UserCmdStats &)> _match,
+    msgs::UserCmdStats &_stats)
+{
+  for (int i = 0; i < 500; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_statsMutex);
+      for (auto const &stats : g_stats)
+      {
+        if (_match(stats))
+        {
+          _stats = stats;
+          return true;
+        }
+      }
+    }
+    common::Time::MSleep(10);
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+// Wait for a model to reach a pose.
+bool WaitForPose(physics::ModelPtr _model,
+    const ignition::math::Pose3d &_pose)
+{
+  for (int i = 0; i < 500; ++i)
+  {
+    if (_model->WorldPose() == _pose)
+      return true;
+    common::Time::MSleep(10);
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, MemoryBudget)
+{
+  // Load a world
+  Load("worlds/shapes.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  auto box = world->ModelByName("box");
+  ASSERT_TRUE(box != NULL);
+
+  physics::UserCmdManager manager(world);
+  EXPECT_GT(manager.MemoryBudget(), 0u);
+  EXPECT_EQ(manager.MemoryUsage(), 0u);
+
+  manager.SetMemoryBudget(1024);
+  EXPECT_EQ(manager.MemoryBudget(), 1024u);
+
+  // Leave room for 3 commands which only record the box
+  size_t cmdUsage;
+  {
+    physics::UserCmd cmd(0, world, "Move box 0", msgs::UserCmd::MOVING,
+        {"box"});
+    cmdUsage = cmd.MemoryUsage();
+  }
+  const size_t budget = cmdUsage * 3 + cmdUsage / 2;
+  manager.SetMemoryBudget(budget);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  auto userCmdPub = node->Advertise<msgs::UserCmd>("~/user_cmd");
+  auto undoRedoPub = node->Advertise<msgs::UndoRedo>("~/undo_redo");
+  auto statsSub = node->Subscribe("~/user_cmd_stats", &OnUserCmdStats);
+
+  // Move the box a few times, waiting for each move before the next
+  // command records the box state.
+  const unsigned int cmdCount = 8;
+  std::vector<ignition::math::Pose3d> poses = {box->WorldPose()};
+  for (unsigned int i = 0; i < cmdCount; ++i)
+  {
+    ignition::math::Pose3d pose(i + 1.0, 2.0, 0.5, 0, 0, 0);
+
+    msgs::UserCmd msg;
+    msg.set_description("Move box " + std::to_string(i));
+    msg.set_type(msgs::UserCmd::MOVING);
+    msgs::Model *modelMsg = msg.add_model();
+    modelMsg->set_name("box");
+    msgs::Set(modelMsg->mutable_pose(), pose);
+    userCmdPub->Publish(msg);
+
+    ASSERT_TRUE(WaitForPose(box, pose));
+    poses.push_back(pose);
+  }
+
+  // The oldest commands were evicted, and the latest ones kept
+  msgs::UserCmdStats stats;
+  ASSERT_TRUE(WaitForStats([&](const msgs::UserCmdStats &_stats)
+      {
+        return _stats.undo_cmd_count() < cmdCount &&
+            _stats.undo_cmd_size() > 0 &&
+            _stats.undo_cmd(_stats.undo_cmd_size() - 1).description() ==
+            "Move box " + std::to_string(cmdCount - 1);
+      }, stats));
+  EXPECT_EQ(stats.undo_cmd_count(), 3u);
+  EXPECT_EQ(stats.redo_cmd_count(), 0u);
+  ASSERT_EQ(stats.undo_cmd_size(), 3);
+  for (int i = 0; i < stats.undo_cmd_size(); ++i)
+  {
+    EXPECT_EQ(stats.undo_cmd(i).description(),
+        "Move box " + std::to_string(cmdCount - 3 + i));
+  }
+  EXPECT_LE(manager.MemoryUsage(), manager.MemoryBudget());
+
+  // Undo the latest kept command
+  {
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    g_stats.clear();
+  }
+  msgs::UndoRedo undoMsg;
+  undoMsg.set_undo(true);
+  undoRedoPub->Publish(undoMsg);
+
+  EXPECT_TRUE(WaitForPose(box, poses[cmdCount - 1]));
+  ASSERT_TRUE(WaitForStats([&](const msgs::UserCmdStats &_stats)
+      {
+        return _stats.undo_cmd_count() < cmdCount - 1 &&
+            _stats.redo_cmd_count() == 1u;
+      }, stats));
+  ASSERT_EQ(stats.redo_cmd_size(), 1);
+  EXPECT_EQ(stats.redo_cmd(0).description(),
+      "Move box " + std::to_string(cmdCount - 1));
+  EXPECT_GE(stats.undo_cmd_count(), 1u);
+  EXPECT_LE(manager.MemoryUsage(), manager.MemoryBudget());
+
+  // Redo moves the box back
+  {
+    std::lock_guard<std::mutex> lock(g_statsMutex);
+    g_stats.clear();
+  }
+  msgs::UndoRedo redoMsg;
+  redoMsg.set_undo(false);
+  undoRedoPub->Publish(redoMsg);
+
+  EXPECT_TRUE(WaitForPose(box, poses[cmdCount]));
+  ASSERT_TRUE(WaitForStats([&](const msgs::UserCmdStats &_stats)
+      {
+        return _stats.undo_cmd_count() < cmdCount &&
+            _stats.redo_cmd_count() == 0u &&
+            _stats.undo_cmd_size() > 0 &&
+            _stats.undo_cmd(_stats.undo_cmd_size() - 1).description() ==
+            "Move box " + std::to_string(cmdCount - 1);
+      }, stats));
+  EXPECT_LE(manager.MemoryUsage(), manager.MemoryBudget());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
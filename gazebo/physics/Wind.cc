@@ -15,18 +15,25 @@
  *
 */
 
+#include <algorithm>
 #include <functional>
+#include <mutex>
+#include <vector>
 #include <boost/lexical_cast.hpp>
 #include <sdf/sdf.hh>
 
 #include <ignition/math/Vector3.hh>
 
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/Link.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/WindField.hh"
 #include "gazebo/physics/World.hh"
 
 namespace gazebo
@@ -57,6 +64,30 @@ namespace gazebo
       public: std::function< ignition::math::Vector3d (
                   const Wind *, const Entity *)> linearVelFunc;
 
+      /// \brief True if linearVelFunc was set by the user.
+      public: bool customFunc = false;
+
+      /// \brief Field added to the linear velocity, may be null.
+      public: WindFieldPtr field;
+
+      /// \brief File the field was loaded from.
+      public: std::string fieldFilename;
+
+      /// \brief Links whose wind is computed by Update.
+      public: std::vector<Link *> links;
+
+      /// \brief Copy of the links used during Update.
+      public: std::vector<Link *> updateLinks;
+
+      /// \brief Positions of the links, for the field.
+      public: std::vector<ignition::math::Vector3d> positions;
+
+      /// \brief Field velocity at the positions.
+      public: std::vector<ignition::math::Vector3d> velocities;
+
+      /// \brief Protects the field and the links.
+      public: mutable std::mutex mutex;
+
       // Transport is declared last.
       /// \brief Node for communication.
       public: transport::NodePtr node;
@@ -95,6 +126,7 @@ Wind::Wind(World &_world, sdf::ElementPtr _sdf)
 
   this->SetLinearVelFunc(std::bind(&Wind::LinearVelDefault, this,
         std::placeholders::_1, std::placeholders::_2));
+  this->dataPtr->customFunc = false;
 }
 
 //////////////////////////////////////////////////
@@ -109,9 +141,14 @@ Wind::~Wind()
 
 //////////////////////////////////////////////////
 ignition::math::Vector3d Wind::LinearVelDefault(
-    const Wind *_wind, const Entity */*_entity*/)
+    const Wind *_wind, const Entity *_entity)
 {
-  return _wind->LinearVel();
+  WindFieldPtr field = _wind->Field();
+  if (!field || !_entity)
+    return _wind->LinearVel();
+
+  return _wind->LinearVel() + field->Velocity(_entity->WorldPose().Pos(),
+      this->dataPtr->world.SimTime().Double());
 }
 
 //////////////////////////////////////////////////
@@ -200,6 +237,37 @@ void Wind::Load(sdf::ElementPtr _sdf)
 {
   if (_sdf && _sdf->HasElement("linear_velocity"))
     this->SetLinearVel(_sdf->Get<ignition::math::Vector3d>("linear_velocity"));
+
+  if (!_sdf)
+    return;
+
+  // The field is not part of the <wind> schema, so it is read from a custom
+  // element, such as <gz:field>model://wind/cfd.gzwf</gz:field>.
+  for (sdf::ElementPtr elem = _sdf->GetFirstElement(); elem;
+       elem = elem->GetNextElement())
+  {
+    const std::string name = elem->GetName();
+    const std::string suffix = ":field";
+    if (name.size() <= suffix.size() ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+    {
+      continue;
+    }
+
+    const std::string filename = common::find_file(elem->Get<std::string>());
+    if (filename == this->dataPtr->fieldFilename)
+      continue;
+
+    WindFieldPtr field(new WindField());
+    if (filename.empty() || !field->Load(filename))
+    {
+      gzerr << "Unable to load wind field [" << elem->Get<std::string>()
+            << "]\n";
+      continue;
+    }
+    this->SetField(field);
+    this->dataPtr->fieldFilename = filename;
+  }
 }
 
 /////////////////////////////////////////////////
@@ -239,4 +307,83 @@ void Wind::SetLinearVelFunc(std::function< ignition::math::Vector3d (
     const Wind *, const Entity *_entity) > _linearVelFunc)
 {
   this->dataPtr->linearVelFunc = _linearVelFunc;
+  this->dataPtr->customFunc = true;
+}
+
+/////////////////////////////////////////////////
+void Wind::SetField(WindFieldPtr _field)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->field = _field;
+  this->dataPtr->fieldFilename.clear();
+}
+
+/////////////////////////////////////////////////
+WindFieldPtr Wind::Field() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->field;
+}
+
+/////////////////////////////////////////////////
+void Wind::AddLink(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &links = this->dataPtr->links;
+  if (std::find(links.begin(), links.end(), _link) == links.end())
+    links.push_back(_link);
+}
+
+/////////////////////////////////////////////////
+void Wind::RemoveLink(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &links = this->dataPtr->links;
+  auto iter = std::find(links.begin(), links.end(), _link);
+  if (iter != links.end())
+  {
+    *iter = links.back();
+    links.pop_back();
+  }
+}
+
+/////////////////////////////////////////////////
+void Wind::Update(const common::UpdateInfo &_info)
+{
+  // Work on a copy, so that the velocity function may use the wind.
+  WindFieldPtr field;
+  bool customFunc;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->updateLinks = this->dataPtr->links;
+    field = this->dataPtr->field;
+    customFunc = this->dataPtr->customFunc;
+  }
+
+  const auto &links = this->dataPtr->updateLinks;
+  if (links.empty())
+    return;
+
+  if (!field || customFunc)
+  {
+    for (auto link : links)
+      link->SetWorldWindLinearVel(this->WorldLinearVel(link));
+    return;
+  }
+
+  // Sample the field at all the links at once.
+  auto &positions = this->dataPtr->positions;
+  positions.resize(links.size());
+  for (size_t i = 0; i < links.size(); ++i)
+    positions[i] = links[i]->WorldPose().Pos();
+
+  field->Velocities(positions, _info.simTime.Double(),
+      this->dataPtr->velocities);
+
+  const ignition::math::Vector3d &linearVel = this->LinearVel();
+  for (size_t i = 0; i < links.size(); ++i)
+  {
+    links[i]->SetWorldWindLinearVel(
+        linearVel + this->dataPtr->velocities[i]);
+  }
 }
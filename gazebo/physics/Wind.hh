@@ -22,6 +22,7 @@
 #include <memory>
 #include <boost/any.hpp>
 
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/util/system.hh"
@@ -38,6 +39,15 @@ namespace gazebo
 
     /// \class Wind Wind.hh physics/physics.hh
     /// \brief Base class for wind.
+    ///
+    /// The wind velocity is the global linear velocity, plus the velocity
+    /// of a WindField if one is set. A field is loaded from the file given
+    /// by a custom element of <wind>, such as
+    /// <gz:field>model://wind/cfd.gzwf</gz:field>.
+    ///
+    /// The wind of all wind-enabled links is computed once per step by
+    /// Update. Without a custom velocity function, the field is sampled at
+    /// all the links in a single pass.
     class GZ_PHYSICS_VISIBLE Wind
     {
       /// \brief Default constructor.
@@ -114,7 +124,31 @@ namespace gazebo
       public: void SetLinearVelFunc(std::function< ignition::math::Vector3d (
           const Wind *_wind, const Entity *_entity) > _linearVelFunc);
 
-      /// \brief Get the global wind velocity, ignoring the entity.
+      /// \brief Set the wind field added to the global velocity.
+      /// \param[in] _field The field, null to remove it.
+      public: void SetField(WindFieldPtr _field);
+
+      /// \brief Get the wind field added to the global velocity.
+      /// \return The field, null if there is none.
+      public: WindFieldPtr Field() const;
+
+      /// \brief Add a link whose wind is computed by Update. Called by
+      /// Link::SetWindEnabled.
+      /// \param[in] _link The link, which must be removed before it is
+      /// destroyed.
+      public: void AddLink(Link *_link);
+
+      /// \brief Remove a link added with AddLink.
+      /// \param[in] _link The link.
+      public: void RemoveLink(Link *_link);
+
+      /// \brief Compute the wind of every link added with AddLink. Called
+      /// by the world before the world update begin event.
+      /// \param[in] _info Update information.
+      public: void Update(const common::UpdateInfo &_info);
+
+      /// \brief Get the wind velocity at an entity location, which is the
+      /// global velocity plus the velocity of the field if there is one.
       /// \param[in] _wind Reference to the wind.
       /// \param[in] _entity Pointer to an entity at which location the wind
       /// velocity is to be calculated.
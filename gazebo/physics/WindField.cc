@@ -0,0 +1,469 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/WindField.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Header of a wind field file.
+    struct WindFieldHeader
+    {
+      /// \brief "GZWF".
+      char magic[4];
+
+      /// \brief Format version.
+      uint32_t version;
+
+      /// \brief Number of grid points along each axis.
+      uint32_t size[3];
+
+      /// \brief Number of time frames.
+      uint32_t frames;
+
+      /// \brief Position of the first grid point.
+      double origin[3];
+
+      /// \brief Distance between grid points.
+      double spacing[3];
+
+      /// \brief Time between frames.
+      double period;
+
+      /// \brief 1 to loop over the frames.
+      uint32_t loop;
+
+      /// \brief Unused.
+      uint32_t reserved;
+    };
+
+    /// \internal
+    /// \brief Private data for WindField.
+    class WindFieldPrivate
+    {
+      /// \brief Release the velocities.
+      public: void Reset()
+      {
+#ifndef _WIN32
+        if (this->map)
+          munmap(this->map, this->mapSize);
+#endif
+        this->map = nullptr;
+        this->mapSize = 0;
+        this->buffer.clear();
+        this->data = nullptr;
+      }
+
+      /// \brief Compute the strides from the header.
+      public: void UpdateStrides()
+      {
+        const uint32_t *n = this->header.size;
+        this->stride[0] = n[0] > 1 ? 3 : 0;
+        this->stride[1] = n[1] > 1 ? 3u * n[0] : 0;
+        this->stride[2] = n[2] > 1 ? 3u * n[0] * n[1] : 0;
+        this->stride[3] = 3u * n[0] * n[1] * n[2];
+      }
+
+      /// \brief Find the frames around a time.
+      /// \param[in] _time Simulation time.
+      /// \param[out] _f0 First frame.
+      /// \param[out] _f1 Second frame.
+      /// \param[out] _w Weight of the second frame.
+      public: void Frames(const double _time, unsigned int &_f0,
+                  unsigned int &_f1, double &_w) const;
+
+      /// \brief Interpolate between the grid points around a point, in two
+      /// frames.
+      /// \param[in] _f0 Offset of the first frame.
+      /// \param[in] _f1 Offset of the second frame.
+      /// \param[in] _wt Weight of the second frame.
+      /// \param[in] _cell Offset of the grid point below the point.
+      /// \param[in] _wx Weight of the next grid point along X.
+      /// \param[in] _wy Weight of the next grid point along Y.
+      /// \param[in] _wz Weight of the next grid point along Z.
+      /// \return Velocity.
+      public: ignition::math::Vector3d Sample(const std::size_t _f0,
+                  const std::size_t _f1, const double _wt,
+                  const std::size_t _cell, const double _wx,
+                  const double _wy, const double _wz) const;
+
+      /// \brief File header, or the grid set with SetGrid.
+      public: WindFieldHeader header;
+
+      /// \brief Velocities, three floats per grid point and frame.
+      public: const float *data = nullptr;
+
+      /// \brief Velocities set with SetGrid, or read on platforms without
+      /// mmap.
+      public: std::vector<float> buffer;
+
+      /// \brief Mapped file.
+      public: void *map = nullptr;
+
+      /// \brief Size of the mapped file.
+      public: std::size_t mapSize = 0;
+
+      /// \brief Offset between grid points along X, Y and Z, and between
+      /// frames, in floats. Zero along axes with a single grid point.
+      public: std::size_t stride[4] = {0, 0, 0, 0};
+    };
+  }
+}
+
+static_assert(sizeof(WindFieldHeader) == 88,
+    "The wind field header must match the file format");
+
+/// \brief Magic number of wind field files.
+static const char kWindFieldMagic[4] = {'G', 'Z', 'W', 'F'};
+
+/////////////////////////////////////////////////
+/// \brief Check a header, and get the number of velocity floats it needs.
+/// \param[in] _header Header.
+/// \param[out] _count Number of floats.
+/// \return True if the header is valid.
+static bool validHeader(const WindFieldHeader &_header, std::size_t &_count)
+{
+  if (std::memcmp(_header.magic, kWindFieldMagic, 4) != 0 ||
+      _header.version != 1u || _header.frames == 0)
+  {
+    return false;
+  }
+
+  _count = 3u * _header.frames;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (_header.size[i] == 0 || !std::isfinite(_header.origin[i]) ||
+        !(_header.spacing[i] > 0))
+    {
+      return false;
+    }
+    _count *= _header.size[i];
+  }
+  return std::isfinite(_header.period);
+}
+
+/////////////////////////////////////////////////
+void WindFieldPrivate::Frames(const double _time, unsigned int &_f0,
+    unsigned int &_f1, double &_w) const
+{
+  const unsigned int frames = this->header.frames;
+  _f0 = 0;
+  _f1 = 0;
+  _w = 0;
+  if (frames < 2 || !(this->header.period > 0) || !std::isfinite(_time))
+    return;
+
+  double t = _time / this->header.period;
+  if (this->header.loop)
+  {
+    t = std::fmod(t, static_cast<double>(frames));
+    if (t < 0)
+      t += frames;
+    _f0 = std::min(static_cast<unsigned int>(t), frames - 1);
+    _f1 = (_f0 + 1) % frames;
+  }
+  else
+  {
+    t = ignition::math::clamp(t, 0.0, static_cast<double>(frames - 1));
+    _f0 = std::min(static_cast<unsigned int>(t), frames - 2);
+    _f1 = _f0 + 1;
+  }
+  _w = t - _f0;
+}
+
+/////////////////////////////////////////////////
+ignition::math::Vector3d WindFieldPrivate::Sample(const std::size_t _f0,
+    const std::size_t _f1, const double _wt, const std::size_t _cell,
+    const double _wx, const double _wy, const double _wz) const
+{
+  const std::size_t sx = this->stride[0];
+  const std::size_t sy = this->stride[1];
+  const std::size_t sz = this->stride[2];
+
+  // Weights of the eight corners, with the time weights folded in
+  const double wx[2] = {1.0 - _wx, _wx};
+  const double wy[2] = {1.0 - _wy, _wy};
+  const double wz[2] = {1.0 - _wz, _wz};
+  const double wt[2] = {1.0 - _wt, _wt};
+  const std::size_t frame[2] = {_f0, _f1};
+
+  double v[3] = {0, 0, 0};
+  for (unsigned int f = 0; f < 2; ++f)
+  {
+    const float *base = this->data + frame[f] + _cell;
+    for (unsigned int k = 0; k < 2; ++k)
+    {
+      for (unsigned int j = 0; j < 2; ++j)
+      {
+        const double w = wt[f] * wz[k] * wy[j];
+        const float *p = base + k * sz + j * sy;
+        for (unsigned int c = 0; c < 3; ++c)
+          v[c] += w * (wx[0] * p[c] + wx[1] * p[sx + c]);
+      }
+    }
+  }
+  return ignition::math::Vector3d(v[0], v[1], v[2]);
+}
+
+/////////////////////////////////////////////////
+WindField::WindField()
+  : dataPtr(new WindFieldPrivate)
+{
+  std::memset(&this->dataPtr->header, 0, sizeof(WindFieldHeader));
+}
+
+/////////////////////////////////////////////////
+WindField::~WindField()
+{
+  this->dataPtr->Reset();
+}
+
+/////////////////////////////////////////////////
+bool WindField::Load(const std::string &_filename)
+{
+  WindFieldHeader header;
+  std::size_t count = 0;
+  {
+    std::ifstream in(_filename, std::ios::binary);
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        !validHeader(header, count))
+    {
+      gzerr << "Invalid wind field file [" << _filename << "]\n";
+      return false;
+    }
+  }
+  const std::size_t size = sizeof(header) + count * sizeof(float);
+
+  this->dataPtr->Reset();
+  this->dataPtr->header = header;
+
+#ifndef _WIN32
+  int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= size)
+    {
+      void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED)
+      {
+        this->dataPtr->map = addr;
+        this->dataPtr->mapSize = size;
+        this->dataPtr->data = reinterpret_cast<const float *>(
+            static_cast<const char *>(addr) + sizeof(header));
+      }
+    }
+    close(fd);
+  }
+#endif
+
+  if (!this->dataPtr->data)
+  {
+    std::ifstream in(_filename, std::ios::binary);
+    in.seekg(sizeof(header));
+    this->dataPtr->buffer.resize(count);
+    if (!in.read(reinterpret_cast<char *>(this->dataPtr->buffer.data()),
+          count * sizeof(float)))
+    {
+      gzerr << "Wind field file [" << _filename << "] is truncated\n";
+      this->dataPtr->Reset();
+      std::memset(&this->dataPtr->header, 0, sizeof(WindFieldHeader));
+      return false;
+    }
+    this->dataPtr->data = this->dataPtr->buffer.data();
+  }
+
+  this->dataPtr->UpdateStrides();
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WindField::Save(const std::string &_filename) const
+{
+  if (this->Empty())
+    return false;
+
+  std::size_t count = 0;
+  validHeader(this->dataPtr->header, count);
+
+  std::ofstream out(_filename, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(&this->dataPtr->header),
+      sizeof(WindFieldHeader));
+  out.write(reinterpret_cast<const char *>(this->dataPtr->data),
+      count * sizeof(float));
+  return out.good();
+}
+
+/////////////////////////////////////////////////
+bool WindField::SetGrid(const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_spacing, const unsigned int _sizeX,
+    const unsigned int _sizeY, const unsigned int _sizeZ,
+    const unsigned int _frames, const double _period, const bool _loop,
+    const std::vector<ignition::math::Vector3d> &_velocities)
+{
+  WindFieldHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kWindFieldMagic, 4);
+  header.version = 1;
+  header.size[0] = _sizeX;
+  header.size[1] = _sizeY;
+  header.size[2] = _sizeZ;
+  header.frames = _frames;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    header.origin[i] = _origin[i];
+    header.spacing[i] = _spacing[i];
+  }
+  header.period = _period;
+  header.loop = _loop ? 1 : 0;
+
+  std::size_t count = 0;
+  if (!validHeader(header, count) || _velocities.size() * 3 != count)
+  {
+    gzerr << "Wind field grid doesn't match its " << _velocities.size()
+          << " velocities\n";
+    return false;
+  }
+
+  this->dataPtr->Reset();
+  this->dataPtr->header = header;
+  this->dataPtr->buffer.resize(count);
+  for (std::size_t i = 0; i < _velocities.size(); ++i)
+  {
+    for (unsigned int c = 0; c < 3; ++c)
+      this->dataPtr->buffer[i * 3 + c] = static_cast<float>(_velocities[i][c]);
+  }
+  this->dataPtr->data = this->dataPtr->buffer.data();
+
+  this->dataPtr->UpdateStrides();
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WindField::Empty() const
+{
+  return this->dataPtr->data == nullptr;
+}
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox WindField::Bounds() const
+{
+  if (this->Empty())
+    return ignition::math::AxisAlignedBox();
+
+  const WindFieldHeader &h = this->dataPtr->header;
+  const ignition::math::Vector3d origin(h.origin[0], h.origin[1],
+      h.origin[2]);
+  return ignition::math::AxisAlignedBox(origin, origin +
+      ignition::math::Vector3d((h.size[0] - 1) * h.spacing[0],
+        (h.size[1] - 1) * h.spacing[1], (h.size[2] - 1) * h.spacing[2]));
+}
+
+/////////////////////////////////////////////////
+unsigned int WindField::Frames() const
+{
+  return this->dataPtr->header.frames;
+}
+
+/////////////////////////////////////////////////
+double WindField::Period() const
+{
+  return this->dataPtr->header.period;
+}
+
+/////////////////////////////////////////////////
+bool WindField::Loop() const
+{
+  return this->dataPtr->header.loop != 0;
+}
+
+/////////////////////////////////////////////////
+ignition::math::Vector3d WindField::Velocity(
+    const ignition::math::Vector3d &_pos, const double _time) const
+{
+  std::vector<ignition::math::Vector3d> vel;
+  this->Velocities({_pos}, _time, vel);
+  return vel[0];
+}
+
+/////////////////////////////////////////////////
+void WindField::Velocities(const std::vector<ignition::math::Vector3d> &_pos,
+    const double _time, std::vector<ignition::math::Vector3d> &_vel) const
+{
+  const std::size_t n = _pos.size();
+  _vel.assign(n, ignition::math::Vector3d::Zero);
+  if (this->Empty() || n == 0)
+    return;
+
+  const WindFieldHeader &h = this->dataPtr->header;
+
+  unsigned int f0, f1;
+  double wt;
+  this->dataPtr->Frames(_time, f0, f1, wt);
+  const std::size_t frame0 = f0 * this->dataPtr->stride[3];
+  const std::size_t frame1 = f1 * this->dataPtr->stride[3];
+
+  // Grid cell and weight of each point, one axis at a time over all the
+  // points. These loops are plain arithmetic that the compiler vectorizes;
+  // the interpolation below then reads the grid points.
+  std::vector<std::size_t> cell(n, 0);
+  std::vector<double> weight(3 * n);
+  for (unsigned int a = 0; a < 3; ++a)
+  {
+    const double origin = h.origin[a];
+    const double inv = 1.0 / h.spacing[a];
+    const double last = h.size[a] - 1.0;
+    const double lastCell = std::max(0.0, last - 1.0);
+    const std::size_t stride = a == 0 ? 3u : (a == 1 ? 3u * h.size[0] :
+        3u * h.size[0] * h.size[1]);
+    double *w = weight.data() + a * n;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const double p = std::isfinite(_pos[i][a]) ? _pos[i][a] : origin;
+      const double u = std::min(std::max((p - origin) * inv, 0.0), last);
+      const double c = std::min(std::floor(u), lastCell);
+      w[i] = u - c;
+      cell[i] += static_cast<std::size_t>(c) * stride;
+    }
+  }
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    _vel[i] = this->dataPtr->Sample(frame0, frame1, wt, cell[i],
+        weight[i], weight[n + i], weight[2 * n + i]);
+  }
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WINDFIELD_HH_
+#define GAZEBO_PHYSICS_WINDFIELD_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class WindFieldPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WindField WindField.hh physics/physics.hh
+    /// \brief Wind velocity sampled on a regular 3D grid, with one grid per
+    /// time frame, such as the output of a CFD simulation.
+    ///
+    /// The velocity at a point is interpolated trilinearly within a frame
+    /// and linearly between frames. Points outside of the grid take the
+    /// velocity of the closest point of the grid. After the last frame the
+    /// field either loops back to the first frame or holds the last one.
+    ///
+    /// Fields are stored in a binary file, which is memory-mapped so that
+    /// only the frames in use are read from disk. The file holds a header
+    /// followed by the velocities:
+    ///
+    ///     char     magic[4]     "GZWF"
+    ///     uint32   version      1
+    ///     uint32   size[3]      Number of grid points along X, Y and Z
+    ///     uint32   frames       Number of time frames
+    ///     double   origin[3]    Position of the first grid point (m)
+    ///     double   spacing[3]   Distance between grid points (m)
+    ///     double   period       Time between frames (s)
+    ///     uint32   loop         1 to loop over the frames
+    ///     uint32   reserved     0
+    ///     float    velocity[frames][size[2]][size[1]][size[0]][3]
+    ///
+    /// Values are in the byte order of the host. \sa Wind::SetField
+    class GZ_PHYSICS_VISIBLE WindField
+    {
+      /// \brief Constructor. The field is empty until a grid is set or
+      /// loaded.
+      public: WindField();
+
+      /// \brief Destructor.
+      public: virtual ~WindField();
+
+      /// \brief Load a field from a file.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the file can't be read or isn't a valid field.
+      public: bool Load(const std::string &_filename);
+
+      /// \brief Save the field to a file.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the file can't be written or the field is empty.
+      public: bool Save(const std::string &_filename) const;
+
+      /// \brief Set the grid and the velocities of the field.
+      /// \param[in] _origin Position of the first grid point.
+      /// \param[in] _spacing Distance between grid points along each axis.
+      /// \param[in] _sizeX Number of grid points along X.
+      /// \param[in] _sizeY Number of grid points along Y.
+      /// \param[in] _sizeZ Number of grid points along Z.
+      /// \param[in] _frames Number of time frames.
+      /// \param[in] _period Time between frames, in seconds.
+      /// \param[in] _loop True to loop over the frames.
+      /// \param[in] _velocities Velocity of each grid point, X fastest,
+      /// then Y, Z and time.
+      /// \return False if the sizes don't match.
+      public: bool SetGrid(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_spacing,
+                  const unsigned int _sizeX, const unsigned int _sizeY,
+                  const unsigned int _sizeZ, const unsigned int _frames,
+                  const double _period, const bool _loop,
+                  const std::vector<ignition::math::Vector3d> &_velocities);
+
+      /// \brief Check whether the field holds a grid.
+      /// \return True if the field is empty.
+      public: bool Empty() const;
+
+      /// \brief Get the box holding the grid points.
+      /// \return Bounds of the grid.
+      public: ignition::math::AxisAlignedBox Bounds() const;
+
+      /// \brief Get the number of time frames.
+      /// \return Number of frames.
+      public: unsigned int Frames() const;
+
+      /// \brief Get the time between frames.
+      /// \return Period in seconds.
+      public: double Period() const;
+
+      /// \brief Check whether the field loops over its frames.
+      /// \return True if it loops.
+      public: bool Loop() const;
+
+      /// \brief Get the wind velocity at a point.
+      /// \param[in] _pos World position.
+      /// \param[in] _time Simulation time, in seconds.
+      /// \return Velocity, zero if the field is empty.
+      public: ignition::math::Vector3d Velocity(
+                  const ignition::math::Vector3d &_pos,
+                  const double _time) const;
+
+      /// \brief Get the wind velocity at many points at once.
+      /// \param[in] _pos World positions.
+      /// \param[in] _time Simulation time, in seconds.
+      /// \param[out] _vel Velocity at each position.
+      public: void Velocities(
+                  const std::vector<ignition::math::Vector3d> &_pos,
+                  const double _time,
+                  std::vector<ignition::math::Vector3d> &_vel) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WindFieldPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/physics/WindField.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class WindField_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief A 2x2x1 grid with two frames. The velocity at grid point (x, y)
+/// is (x, y, 0) in the first frame and twice that in the second.
+/// \param[in] _loop True to loop over the frames.
+/// \param[out] _field The field.
+void MakeField(const bool _loop, physics::WindField &_field)
+{
+  std::vector<ignition::math::Vector3d> vel;
+  for (int f = 1; f <= 2; ++f)
+  {
+    for (int y = 0; y < 2; ++y)
+    {
+      for (int x = 0; x < 2; ++x)
+        vel.push_back(ignition::math::Vector3d(x * f, y * f, 0));
+    }
+  }
+  EXPECT_TRUE(_field.SetGrid(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::One, 2, 2, 1, 2, 1.0, _loop, vel));
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindField_TEST, SetGrid)
+{
+  physics::WindField field;
+  EXPECT_TRUE(field.Empty());
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d::One, 0),
+      ignition::math::Vector3d::Zero);
+
+  // Wrong number of velocities
+  EXPECT_FALSE(field.SetGrid(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::One, 2, 2, 1, 2, 1.0, false,
+      std::vector<ignition::math::Vector3d>(3)));
+  EXPECT_TRUE(field.Empty());
+
+  MakeField(false, field);
+  EXPECT_FALSE(field.Empty());
+  EXPECT_EQ(field.Frames(), 2u);
+  EXPECT_DOUBLE_EQ(field.Period(), 1.0);
+  EXPECT_FALSE(field.Loop());
+  EXPECT_EQ(field.Bounds().Min(), ignition::math::Vector3d::Zero);
+  EXPECT_EQ(field.Bounds().Max(), ignition::math::Vector3d(1, 1, 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindField_TEST, Interpolation)
+{
+  physics::WindField field;
+  MakeField(false, field);
+
+  // Grid points and the middle of the cell
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(1, 0, 0), 0),
+      ignition::math::Vector3d(1, 0, 0));
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(1, 1, 0), 0),
+      ignition::math::Vector3d(1, 1, 0));
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(0.5, 0.5, 0), 0),
+      ignition::math::Vector3d(0.5, 0.5, 0));
+
+  // Outside of the grid, including along the single point axis
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(5, -3, 2), 0),
+      ignition::math::Vector3d(1, 0, 0));
+
+  // Between frames, and after the last one
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(1, 1, 0), 0.5),
+      ignition::math::Vector3d(1.5, 1.5, 0));
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(1, 1, 0), 10),
+      ignition::math::Vector3d(2, 2, 0));
+
+  // Looping goes back to the first frame
+  MakeField(true, field);
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(1, 1, 0), 1.5),
+      ignition::math::Vector3d(1.5, 1.5, 0));
+  EXPECT_EQ(field.Velocity(ignition::math::Vector3d(1, 1, 0), 2),
+      ignition::math::Vector3d(1, 1, 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindField_TEST, Velocities)
+{
+  physics::WindField field;
+  MakeField(true, field);
+
+  std::vector<ignition::math::Vector3d> pos;
+  for (int i = 0; i < 37; ++i)
+    pos.push_back(ignition::math::Vector3d(i * 0.07 - 0.5, i * 0.03, i));
+
+  for (double t : {0.0, 0.3, 1.7, 4.2})
+  {
+    std::vector<ignition::math::Vector3d> vel;
+    field.Velocities(pos, t, vel);
+    ASSERT_EQ(vel.size(), pos.size());
+    for (size_t i = 0; i < pos.size(); ++i)
+      EXPECT_EQ(vel[i], field.Velocity(pos[i], t));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindField_TEST, SaveLoad)
+{
+  physics::WindField field;
+  EXPECT_FALSE(field.Save("/nonexistent/wind.gzwf"));
+  MakeField(true, field);
+
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("wind_%%%%%%.gzwf");
+  ASSERT_TRUE(field.Save(path.string()));
+
+  {
+    physics::WindField loaded;
+    ASSERT_TRUE(loaded.Load(path.string()));
+    EXPECT_EQ(loaded.Frames(), field.Frames());
+    EXPECT_DOUBLE_EQ(loaded.Period(), field.Period());
+    EXPECT_EQ(loaded.Loop(), field.Loop());
+    EXPECT_EQ(loaded.Bounds(), field.Bounds());
+    for (double t : {0.0, 0.5, 1.5})
+    {
+      const ignition::math::Vector3d pos(0.25, 0.75, 0);
+      EXPECT_EQ(loaded.Velocity(pos, t), field.Velocity(pos, t));
+    }
+  }
+
+  boost::filesystem::remove(path);
+
+  physics::WindField missing;
+  EXPECT_FALSE(missing.Load(path.string()));
+  EXPECT_TRUE(missing.Empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 */
 #include <memory>
 
+#include "gazebo/physics/WindField.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
 
@@ -221,6 +222,47 @@ TEST_F(WindTest, WindSetLinearVelFunc)
   WindSetLinearVelFunc();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WindTest, WindField)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(2, 0, 0.5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != NULL);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != NULL);
+  link->SetWindMode(true);
+
+  // A uniform field along X, added to the global velocity
+  physics::WindFieldPtr field(new physics::WindField());
+  ASSERT_TRUE(field->SetGrid(ignition::math::Vector3d::Zero,
+      ignition::math::Vector3d::One, 1, 1, 1, 1, 1.0, false,
+      {ignition::math::Vector3d(3, 0, 0)}));
+
+  physics::Wind &wind = world->Wind();
+  wind.SetLinearVel(ignition::math::Vector3d(0, 1, 0));
+  wind.SetField(field);
+  EXPECT_EQ(wind.Field(), field);
+
+  world->Step(1);
+  EXPECT_EQ(link->WorldWindLinearVel(), ignition::math::Vector3d(3, 1, 0));
+  EXPECT_EQ(wind.WorldLinearVel(link.get()), link->WorldWindLinearVel());
+
+  // Without the field
+  wind.SetField(physics::WindFieldPtr());
+  world->Step(1);
+  EXPECT_EQ(link->WorldWindLinearVel(), ignition::math::Vector3d(0, 1, 0));
+
+  // Disabled links have no wind
+  link->SetWindMode(false);
+  world->Step(1);
+  EXPECT_EQ(link->WorldWindLinearVel(), ignition::math::Vector3d::Zero);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
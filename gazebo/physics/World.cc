@@ -22,10 +22,12 @@
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
 #include <deque>
 #include <list>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -43,6 +45,7 @@
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/Subscriber.hh"
+#include "gazebo/transport/TopicManager.hh"
 
 #include "gazebo/util/LogPlay.hh"
 
@@ -76,6 +79,9 @@
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Actor.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+#include "gazebo/physics/StepPacer.hh"
+#include "gazebo/physics/WorldCheckpoint.hh"
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
@@ -146,12 +152,14 @@ World::World(const std::string &_name)
   this->dataPtr->enableAtmosphere = true;
 
   this->dataPtr->sleepOffset = common::Time(0);
+  this->dataPtr->pacer.reset(new StepPacer());
 
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
   this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
   this->dataPtr->logLastStatePlayedSimTime = common::Time(0);
   this->dataPtr->logLastStatePlayedRealTime = common::Time(0);
   this->dataPtr->logPlayRealTimeFactor = 0.0;
+  this->dataPtr->seed = ignition::math::Rand::Seed();
 
   this->dataPtr->connections.push_back(
      event::Events::ConnectStep(std::bind(&World::OnStep, this)));
@@ -260,6 +268,11 @@ void World::Load(sdf::ElementPtr _sdf)
   this->dataPtr->statPub =
     this->dataPtr->node->Advertise<msgs::WorldStatistics>(
         "~/world_stats", 100, 5);
+  this->dataPtr->transportStatsPub =
+    this->dataPtr->node->Advertise<msgs::TransportStats>(
+        "~/transport/stats");
+  this->dataPtr->pluginStatsPub =
+    this->dataPtr->node->Advertise<msgs::PluginStats>("~/plugins/stats");
   this->dataPtr->modelPub = this->dataPtr->node->Advertise<msgs::Model>(
       "~/model/info");
   this->dataPtr->lightPub = this->dataPtr->node->Advertise<msgs::Light>(
@@ -288,6 +301,30 @@ void World::Load(sdf::ElementPtr _sdf)
 
   this->dataPtr->physicsEngine->Load(physicsElem);
 
+  // Deadline pacing is not part of the <physics> schema, so it is read from
+  // custom elements, such as <gz:deadline_pacing>true</gz:deadline_pacing>.
+  for (sdf::ElementPtr elem = physicsElem->GetFirstElement(); elem;
+       elem = elem->GetNextElement())
+  {
+    const std::string name = elem->GetName();
+    const std::size_t colon = name.find(':');
+    if (colon == std::string::npos)
+      continue;
+
+    const std::string key = name.substr(colon + 1);
+    if (key == "deadline_pacing")
+      this->dataPtr->pacer->SetEnabled(elem->Get<bool>());
+    else if (key == "spin_time")
+      this->dataPtr->pacer->SetSpinTime(common::Time(elem->Get<double>()));
+    else if (key == "max_catch_up")
+      this->dataPtr->pacer->SetMaxCatchUp(elem->Get<unsigned int>());
+  }
+
+  // The engines seed themselves with ignition::math::Rand, so only a
+  // world given its own seed, like the worlds of a batch, needs to set it
+  if (this->dataPtr->seed != ignition::math::Rand::Seed())
+    this->dataPtr->physicsEngine->SetSeed(this->dataPtr->seed);
+
   // This should come before loading of entities
   sdf::ElementPtr windElem = this->dataPtr->sdf->GetElement("wind");
 
@@ -531,6 +568,7 @@ void World::RunLoop()
     this->dataPtr->pauseStartTime = this->dataPtr->startTime;
 
   this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+  this->dataPtr->pacer->Reset();
 
   // Get the first state
   this->dataPtr->prevStates[0] = WorldState(shared_from_this());
@@ -684,30 +722,44 @@ void World::Step()
   DIAG_TIMER_LAP("World::Step", "publishWorldStats");
 
   double updatePeriod = this->dataPtr->physicsEngine->GetUpdatePeriod();
-  // sleep here to get the correct update rate
-  common::Time tmpTime = common::Time::GetWallTime();
-  common::Time sleepTime = this->dataPtr->prevStepWallTime +
-    common::Time(updatePeriod) - tmpTime - this->dataPtr->sleepOffset;
 
-  common::Time actualSleep;
-  if (sleepTime > 0)
+  bool stepNow = true;
+  if (this->dataPtr->pacer->Enabled())
   {
-    common::Time::Sleep(sleepTime);
-    actualSleep = common::Time::GetWallTime() - tmpTime;
+    // Wait for the absolute deadline of this step
+    this->dataPtr->pacer->Wait(updatePeriod);
+
+    DIAG_TIMER_LAP("World::Step", "pacer");
   }
   else
-    sleepTime = 0;
+  {
+    // sleep here to get the correct update rate
+    common::Time tmpTime = common::Time::GetWallTime();
+    common::Time sleepTime = this->dataPtr->prevStepWallTime +
+      common::Time(updatePeriod) - tmpTime - this->dataPtr->sleepOffset;
+
+    common::Time actualSleep;
+    if (sleepTime > 0)
+    {
+      common::Time::Sleep(sleepTime);
+      actualSleep = common::Time::GetWallTime() - tmpTime;
+    }
+    else
+      sleepTime = 0;
+
+    // exponentially avg out
+    this->dataPtr->sleepOffset = (actualSleep - sleepTime) * 0.01 +
+                        this->dataPtr->sleepOffset * 0.99;
 
-  // exponentially avg out
-  this->dataPtr->sleepOffset = (actualSleep - sleepTime) * 0.01 +
-                      this->dataPtr->sleepOffset * 0.99;
+    DIAG_TIMER_LAP("World::Step", "sleepOffset");
 
-  DIAG_TIMER_LAP("World::Step", "sleepOffset");
+    // throttling update rate, with sleepOffset as tolerance
+    // the tolerance is needed as the sleep time is not exact
+    stepNow = common::Time::GetWallTime() - this->dataPtr->prevStepWallTime +
+        this->dataPtr->sleepOffset >= common::Time(updatePeriod);
+  }
 
-  // throttling update rate, with sleepOffset as tolerance
-  // the tolerance is needed as the sleep time is not exact
-  if (common::Time::GetWallTime() - this->dataPtr->prevStepWallTime +
-      this->dataPtr->sleepOffset >= common::Time(updatePeriod))
+  if (stepNow)
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
 
@@ -794,6 +846,10 @@ void World::Update()
 
   this->dataPtr->updateInfo.simTime = this->SimTime();
   this->dataPtr->updateInfo.realTime = this->RealTime();
+
+  // Compute the wind of this world's links before the plugins run.
+  this->dataPtr->wind->Update(this->dataPtr->updateInfo);
+
   event::Events::worldUpdateBegin(this->dataPtr->updateInfo);
 
   DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
@@ -846,9 +902,39 @@ void World::Update()
       boost::recursive_mutex::scoped_lock plock(
           *this->Physics()->GetPhysicsUpdateMutex());
 
-      for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+      // Write back all the poses under a single lock
       {
-        dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
+        std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+        for (auto const &record : this->dataPtr->dirtyPoses)
+          record.entity->SetDirtyWorldPose(record.pose);
+      }
+
+      // Then queue each moved model for publication once. Links of the
+      // same model are usually reported next to each other.
+      {
+        std::lock_guard<std::recursive_mutex> lock(
+            this->dataPtr->receiveMutex);
+        Base *lastParent = nullptr;
+        for (auto const &record : this->dataPtr->dirtyPoses)
+        {
+          Base *parent = record.entity->GetParent().get();
+          if (parent && parent == lastParent)
+            continue;
+          lastParent = parent;
+
+          ModelPtr model = record.entity->GetParentModel();
+          if (model)
+            this->dataPtr->publishModelPoses.insert(model);
+        }
+      }
+
+      if (this->dataPtr->spatialIndexEnabled)
+      {
+        std::vector<Entity *> moved;
+        moved.reserve(this->dataPtr->dirtyPoses.size());
+        for (auto const &record : this->dataPtr->dirtyPoses)
+          moved.push_back(record.entity);
+        this->UpdateSpatialIndex(moved);
       }
 
       this->dataPtr->dirtyPoses.clear();
@@ -856,6 +942,12 @@ void World::Update()
 
     DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
   }
+  else if (this->dataPtr->spatialIndexEnabled)
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *this->Physics()->GetPhysicsUpdateMutex());
+    this->UpdateSpatialIndex({});
+  }
 
   // Only update state information if logging data.
   if (util::LogRecord::Instance()->Running())
@@ -899,6 +991,8 @@ void World::Fini()
     this->dataPtr->guiPub.reset();
     this->dataPtr->responsePub.reset();
     this->dataPtr->statPub.reset();
+    this->dataPtr->transportStatsPub.reset();
+    this->dataPtr->pluginStatsPub.reset();
     this->dataPtr->modelPub.reset();
     this->dataPtr->lightPub.reset();
     this->dataPtr->lightFactoryPub.reset();
@@ -1037,6 +1131,12 @@ Wind &World::Wind() const
   return *this->dataPtr->wind;
 }
 
+//////////////////////////////////////////////////
+StepPacer &World::Pacer() const
+{
+  return *this->dataPtr->pacer;
+}
+
 //////////////////////////////////////////////////
 Atmosphere &World::Atmosphere() const
 {
@@ -1162,6 +1262,7 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->spatialIndexRebuild = true;
   return model;
 }
 
@@ -1217,6 +1318,7 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->spatialIndexRebuild = true;
 
   return actor;
 }
@@ -1361,6 +1463,7 @@ void World::Reset()
       plugin->Reset();
     }
     this->dataPtr->physicsEngine->Reset();
+    this->dataPtr->spatialIndexRebuild = true;
 
     // Signal a reset has occurred
     event::Events::worldReset();
@@ -1369,12 +1472,239 @@ void World::Reset()
   this->SetPaused(currentlyPaused);
 }
 
+//////////////////////////////////////////////////
+/// \brief Append a model, its links and its nested models to the entities
+/// of a checkpoint.
+/// \param[in] _model The model.
+/// \param[out] _entities The entities of the checkpoint.
+static void AddCheckpointEntities(const ModelPtr &_model,
+    std::vector<EntityPtr> &_entities)
+{
+  if (_model->IsStatic())
+    return;
+
+  _entities.push_back(_model);
+  for (auto const &link : _model->GetLinks())
+  {
+    if (!link->IsStatic())
+      _entities.push_back(link);
+  }
+
+  for (auto const &nested : _model->NestedModels())
+    AddCheckpointEntities(nested, _entities);
+}
+
+//////////////////////////////////////////////////
+WorldCheckpointPtr World::Checkpoint()
+{
+  std::lock_guard<std::recursive_mutex> lk(this->dataPtr->worldUpdateMutex);
+
+  WorldCheckpointPtr checkpoint(new WorldCheckpoint);
+  if (!this->dataPtr->physicsEngine ||
+      !this->dataPtr->physicsEngine->SaveState(checkpoint->engineState))
+  {
+    return WorldCheckpointPtr();
+  }
+
+  checkpoint->world = this;
+  checkpoint->simTime = this->dataPtr->simTime;
+  checkpoint->iterations = this->dataPtr->iterations;
+
+  std::vector<EntityPtr> entities;
+  for (auto const &model : this->dataPtr->models)
+    AddCheckpointEntities(model, entities);
+
+  checkpoint->entities.reserve(entities.size());
+  checkpoint->poses.reserve(entities.size());
+  for (auto const &entity : entities)
+  {
+    checkpoint->entities.push_back(entity);
+    checkpoint->poses.push_back(entity->worldPose);
+  }
+
+  return checkpoint;
+}
+
+//////////////////////////////////////////////////
+bool World::Restore(const WorldCheckpointPtr &_checkpoint)
+{
+  if (!_checkpoint || _checkpoint->world != this)
+    return false;
+
+  std::lock_guard<std::recursive_mutex> lk(this->dataPtr->worldUpdateMutex);
+
+  // Check that every entity still exists before changing anything. The
+  // engine checks its own bodies and joints.
+  std::vector<EntityPtr> entities;
+  entities.reserve(_checkpoint->entities.size());
+  for (auto const &weak : _checkpoint->entities)
+  {
+    EntityPtr entity = weak.lock();
+    if (!entity)
+      return false;
+    entities.push_back(entity);
+  }
+
+  boost::recursive_mutex::scoped_lock plock(
+      *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+
+  if (!this->dataPtr->physicsEngine->RestoreState(_checkpoint->engineState))
+    return false;
+
+  // Write the poses back as they were, without going through
+  // SetWorldPose, which would push them to the engine and lose bits.
+  for (std::size_t i = 0; i < entities.size(); ++i)
+  {
+    entities[i]->worldPose = _checkpoint->poses[i];
+    if (entities[i]->HasType(Base::LINK))
+      entities[i]->SetChildWorldPosesDirty();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->setWorldPoseMutex);
+    this->dataPtr->dirtyPoses.clear();
+  }
+
+  this->dataPtr->simTime = _checkpoint->simTime;
+  this->dataPtr->iterations = _checkpoint->iterations;
+  this->dataPtr->spatialIndexRebuild = true;
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 void World::OnStep()
 {
   this->dataPtr->stepInc = 1;
 }
 
+//////////////////////////////////////////////////
+SpatialIndexPtr World::SpatialIdx()
+{
+  SpatialIndexPtr index;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->spatialIndexMutex);
+    if (!this->dataPtr->spatialIndex)
+    {
+      this->dataPtr->spatialIndex.reset(new SpatialIndex());
+      this->dataPtr->spatialIndexRebuild = true;
+    }
+    index = this->dataPtr->spatialIndex;
+  }
+
+  // Fill the index now, so it is usable before the next step. This also
+  // picks up models added or placed while the world is paused.
+  bool placed;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->placedMutex);
+    placed = !this->dataPtr->placedEntities.empty();
+  }
+  if (this->dataPtr->spatialIndexRebuild || placed)
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *this->dataPtr->physicsEngine->GetPhysicsUpdateMutex());
+    this->UpdateSpatialIndex({});
+  }
+  this->dataPtr->spatialIndexEnabled = true;
+
+  return index;
+}
+
+//////////////////////////////////////////////////
+/// \brief Append a model, its nested models and its links to a list.
+/// \param[in] _model The model.
+/// \param[out] _entities The list.
+static void AddIndexEntities(const ModelPtr &_model,
+    std::vector<EntityPtr> &_entities)
+{
+  _entities.push_back(_model);
+  for (auto const &link : _model->GetLinks())
+    _entities.push_back(link);
+  for (auto const &nested : _model->NestedModels())
+    AddIndexEntities(nested, _entities);
+}
+
+//////////////////////////////////////////////////
+void World::UpdateSpatialIndex(const std::vector<Entity *> &_moved)
+{
+  SpatialIndexPtr index = this->dataPtr->spatialIndex;
+  if (!index)
+    return;
+
+  std::vector<EntityPtr> entities;
+
+  // Entities placed with Entity::SetWorldPose don't go through the dirty
+  // poses of the physics engine. A placed model carries its links and
+  // nested models along.
+  std::vector<EntityPtr> placed;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->placedMutex);
+    for (auto const &weak : this->dataPtr->placedEntities)
+    {
+      BasePtr base = weak.lock();
+      if (!base)
+        continue;
+      if (base->HasType(Base::MODEL))
+        AddIndexEntities(boost::static_pointer_cast<Model>(base), placed);
+      else if (base->HasType(Base::LINK))
+        placed.push_back(boost::static_pointer_cast<Entity>(base));
+    }
+    this->dataPtr->placedEntities.clear();
+  }
+
+  if (this->dataPtr->spatialIndexRebuild.exchange(false))
+  {
+    index->Clear();
+    for (auto const &model : this->dataPtr->models)
+      AddIndexEntities(model, entities);
+  }
+  else
+  {
+    // A moved link also moves the boxes of the models holding it
+    std::unordered_set<uint32_t> seen;
+    auto addWithParents = [&](BasePtr _base)
+    {
+      while (_base &&
+          (_base->HasType(Base::LINK) || _base->HasType(Base::MODEL)))
+      {
+        if (!seen.insert(_base->GetId()).second)
+          break;
+        entities.push_back(boost::static_pointer_cast<Entity>(_base));
+        _base = _base->GetParent();
+      }
+    };
+    for (auto const entity : _moved)
+      addWithParents(entity->shared_from_this());
+    for (auto const &entity : placed)
+      addWithParents(entity);
+  }
+
+  if (entities.empty())
+    return;
+
+  // Compute the boxes outside of the index lock, then swap them in at once
+  std::vector<ignition::math::AxisAlignedBox> boxes;
+  boxes.reserve(entities.size());
+  for (auto const &entity : entities)
+    boxes.push_back(entity->BoundingBox());
+
+  index->Update(entities, boxes);
+}
+
+//////////////////////////////////////////////////
+void World::SetSeed(const uint32_t _seed)
+{
+  this->dataPtr->seed = _seed;
+  if (this->dataPtr->physicsEngine)
+    this->dataPtr->physicsEngine->SetSeed(_seed);
+}
+
+//////////////////////////////////////////////////
+uint32_t World::Seed() const
+{
+  return this->dataPtr->seed;
+}
+
 //////////////////////////////////////////////////
 void World::PrintEntityTree()
 {
@@ -1640,9 +1970,20 @@ void World::BuildSceneMsg(msgs::Scene &_scene, BasePtr _entity)
 //////////////////////////////////////////////////
 void World::ModelUpdateSingleLoop()
 {
-  // Update all the models
+  // Update all the models. Actors are updated as a batch, so that their
+  // skeleton animations are sampled in parallel.
+  Actor_V actors;
   for (unsigned int i = 0; i < this->dataPtr->rootElement->GetChildCount(); ++i)
-    this->dataPtr->rootElement->GetChild(i)->Update();
+  {
+    BasePtr child = this->dataPtr->rootElement->GetChild(i);
+    if (child->HasType(Base::ACTOR))
+      actors.push_back(boost::static_pointer_cast<Actor>(child));
+    else
+      child->Update();
+  }
+
+  if (!actors.empty())
+    Actor::UpdateBatch(actors);
 }
 
 
@@ -1689,6 +2030,10 @@ void World::LoadPlugin(const std::string &_filename,
             << "Plugin filename[" << _filename << "] name[" << _name << "]\n";
       return;
     }
+    // Event connections made by the plugin are accounted to it
+    plugin->CreateUsage(this->Name() + "::" + _name, this->Name(), _sdf);
+    common::PluginOwner owner(plugin->Usage());
+
     plugin->Load(shared_from_this(), _sdf);
     this->dataPtr->plugins.push_back(plugin);
 
@@ -2838,9 +3183,70 @@ void World::PublishWorldStats()
         logStats);
   }
 
+  if (this->dataPtr->pacer->Enabled())
+  {
+    this->dataPtr->pacer->FillMsg(
+        *this->dataPtr->worldStatsMsg.mutable_step_timing());
+  }
+
   if (this->dataPtr->statPub && this->dataPtr->statPub->HasConnections())
     this->dataPtr->statPub->Publish(this->dataPtr->worldStatsMsg);
   this->dataPtr->prevStatTime = common::Time::GetWallTime();
+
+  // Transport statistics are collected from every topic, so only do it
+  // once per second, and only when somebody listens.
+  if (this->dataPtr->transportStatsPub &&
+      this->dataPtr->prevStatTime - this->dataPtr->prevTransportStatTime >=
+      common::Time(1, 0) &&
+      this->dataPtr->transportStatsPub->HasConnections())
+  {
+    transport::TopicManager::Instance()->Stats(
+        this->dataPtr->transportStatsMsg);
+    this->dataPtr->transportStatsPub->Publish(
+        this->dataPtr->transportStatsMsg);
+    this->dataPtr->prevTransportStatTime = this->dataPtr->prevStatTime;
+  }
+
+  // Plugin callbacks are only timed while somebody listens, or while they
+  // have a budget.
+  if (this->dataPtr->pluginStatsPub &&
+      this->dataPtr->prevStatTime - this->dataPtr->prevPluginStatTime >=
+      common::Time(1, 0))
+  {
+    const bool listened = this->dataPtr->pluginStatsPub->HasConnections();
+    common::PluginUsage::SetProfiled(this->Name(), listened);
+    if (listened)
+      this->PublishPluginStats();
+    this->dataPtr->prevPluginStatTime = this->dataPtr->prevStatTime;
+  }
+}
+
+//////////////////////////////////////////////////
+void World::PublishPluginStats()
+{
+  msgs::PluginStats &msg = this->dataPtr->pluginStatsMsg;
+  msgs::Set(msg.mutable_stamp(), this->dataPtr->prevStatTime);
+  msg.clear_plugin();
+
+  common::PluginUsage::WorldUsage(this->Name(), this->dataPtr->pluginUsage);
+  for (auto const &usage : this->dataPtr->pluginUsage)
+  {
+    msgs::PluginStats::Plugin *pluginMsg = msg.add_plugin();
+    pluginMsg->set_name(usage->Name());
+    pluginMsg->set_calls(usage->Calls());
+    pluginMsg->set_wall_time(usage->WallTime());
+    pluginMsg->set_cpu_time(usage->CpuTime());
+    pluginMsg->set_max_wall_time(usage->MaxWallTime());
+    if (usage->Budget() > 0)
+    {
+      pluginMsg->set_budget(usage->Budget());
+      pluginMsg->set_over_budget(usage->OverBudget());
+      pluginMsg->set_skipped(usage->Skipped());
+    }
+  }
+  this->dataPtr->pluginUsage.clear();
+
+  this->dataPtr->pluginStatsPub->Publish(msg);
 }
 
 //////////////////////////////////////////////////
@@ -2983,17 +3389,14 @@ void World::RemoveModel(const std::string &_name)
 
   // Remove all the dirty poses from the delete entity.
   {
-    for (auto entity = this->dataPtr->dirtyPoses.begin();
-             entity != this->dataPtr->dirtyPoses.end(); ++entity)
-    {
-      if ((*entity)->GetName() == _name ||
-         ((*entity)->GetParent() && (*entity)->GetParent()->GetName() == _name))
-      {
-        this->dataPtr->dirtyPoses.erase(entity++);
-      }
-      else
-        ++entity;
-    }
+    auto &dirtyPoses = this->dataPtr->dirtyPoses;
+    dirtyPoses.erase(std::remove_if(dirtyPoses.begin(), dirtyPoses.end(),
+        [&_name](const DirtyPoseRecord &_record)
+        {
+          return _record.entity->GetName() == _name ||
+              (_record.entity->GetParent() &&
+               _record.entity->GetParent()->GetName() == _name);
+        }), dirtyPoses.end());
   }
 
   // Remove from SDF
@@ -3032,6 +3435,7 @@ void World::RemoveModel(const std::string &_name)
       {
         this->dataPtr->models.erase(model);
         this->dataPtr->rootElement->RemoveChild(_name);
+        this->dataPtr->spatialIndexRebuild = true;
         break;
       }
     }
@@ -3177,7 +3581,20 @@ void World::SetAtmosphereEnabled(const bool _enable)
 void World::_AddDirty(Entity *_entity)
 {
   GZ_ASSERT(_entity != nullptr, "_entity is nullptr");
-  this->dataPtr->dirtyPoses.push_back(_entity);
+  this->dataPtr->dirtyPoses.push_back({_entity, _entity->DirtyPose()});
+}
+
+/////////////////////////////////////////////////
+void World::_AddPlaced(Entity *_entity)
+{
+  GZ_ASSERT(_entity != nullptr, "_entity is nullptr");
+
+  // The index isn't maintained before it is requested
+  if (!this->dataPtr->spatialIndexEnabled)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->placedMutex);
+  this->dataPtr->placedEntities.push_back(_entity->shared_from_this());
 }
 
 /////////////////////////////////////////////////
@@ -155,6 +155,11 @@ namespace gazebo
       /// \return Reference to the wind.
       public: physics::Wind &Wind() const;
 
+      /// \brief Get the pacer of the steps, which replaces the relative
+      /// sleeps between steps with absolute deadlines when enabled.
+      /// \return Reference to the pacer.
+      public: StepPacer &Pacer() const;
+
       /// \brief Return the spherical coordinates converter.
       /// \return Pointer to the spherical coordinates converter.
       public: common::SphericalCoordinatesPtr SphericalCoords() const;
@@ -214,6 +219,51 @@ namespace gazebo
       /// \brief Reset time and model poses, configurations in simulation.
       public: void Reset();
 
+      /// \brief Save the simulation time, the poses of the moving models
+      /// and links, and the full state of the physics engine in memory.
+      /// Restoring the checkpoint with Restore makes the following steps
+      /// bit-identical to the steps that followed the checkpoint, which is
+      /// much faster than SetState for repeated rollouts. Plugin state and
+      /// the ignition::math::Rand generator are not saved.
+      /// \return The checkpoint, or nullptr if the physics engine does not
+      /// support checkpoints.
+      /// \sa Restore
+      public: WorldCheckpointPtr Checkpoint();
+
+      /// \brief Restore a checkpoint created by Checkpoint.
+      /// \param[in] _checkpoint The checkpoint to restore.
+      /// \return False if the checkpoint was created by another world, or
+      /// if models, links or joints were added or removed since it was
+      /// created. The world is not changed in that case.
+      /// \sa Checkpoint
+      public: bool Restore(const WorldCheckpointPtr &_checkpoint);
+
+      /// \brief Set the random number seed of this world, and of its
+      /// physics engine. With ODE, the seed is kept per world, so the
+      /// engine's random sequence does not depend on the other worlds of
+      /// the process. Worlds that share a process still share the
+      /// ignition::math::Rand generator, so plugins that need a per-world
+      /// random sequence should seed their own generator from Seed().
+      /// \param[in] _seed The seed.
+      /// \sa Seed
+      public: void SetSeed(const uint32_t _seed);
+
+      /// \brief Get the random number seed of this world. It defaults to
+      /// the seed of ignition::math::Rand when the world is created.
+      /// \return The seed.
+      /// \sa SetSeed
+      public: uint32_t Seed() const;
+
+      /// \brief Get the index of the bounding boxes of the models, nested
+      /// models and links of this world, for proximity queries such as
+      /// the models in a frustum or near a point. The index is refreshed
+      /// once per step from the poses that changed, and can be queried
+      /// from any thread. It is only maintained once this function has
+      /// been called. Models added or removed since the last step are
+      /// applied by this function.
+      /// \return The spatial index.
+      public: SpatialIndexPtr SpatialIdx();
+
       /// \brief Print Entity tree.
       /// Prints alls the entities to stdout.
       public: void PrintEntityTree();
@@ -431,13 +481,21 @@ namespace gazebo
       public: void ResetPhysicsStates();
 
       /// \internal
-      /// \brief Inform the World that an Entity has moved. The Entity
-      /// is added to a list that will be processed by the World.
+      /// \brief Inform the World that an Entity has moved. The Entity and
+      /// its Entity::DirtyPose are added to a list that will be processed
+      /// by the World.
       /// Only a physics engine implementation should call this function.
       /// If you are unsure whether you should use this function, do not.
       /// \param[in] _entity Entity that has moved.
       public: void _AddDirty(Entity *_entity);
 
+      /// \brief Inform the World that an Entity was placed with
+      /// Entity::SetWorldPose, so the spatial index picks up its new
+      /// bounding box, and those of the entities it carries.
+      /// Only Entity should call this function.
+      /// \param[in] _entity Entity that was placed.
+      public: void _AddPlaced(Entity *_entity);
+
       /// \brief Get whether sensors have been initialized.
       /// \return True if sensors have been initialized.
       public: bool SensorsInitialized() const;
@@ -516,6 +574,10 @@ namespace gazebo
       /// \brief Update the world.
       private: void Update();
 
+      /// \brief Bring the spatial index up to date, after a step.
+      /// \param[in] _moved Entities whose pose changed during the step.
+      private: void UpdateSpatialIndex(const std::vector<Entity *> &_moved);
+
       /// \brief Pause callback.
       /// \param[in] _p True if paused.
       private: void OnPause(bool _p);
@@ -609,6 +671,9 @@ namespace gazebo
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
+      /// \brief Publish the plugin stats message.
+      private: void PublishPluginStats();
+
       /// \brief Thread function for logging state data.
       private: void LogWorker();
 
@@ -650,12 +715,6 @@ namespace gazebo
       /// \internal
       /// \brief Private data pointer.
       private: std::unique_ptr<WorldPrivate> dataPtr;
-
-      /// Friend DARTLink so that it has access to dataPtr->dirtyPoses
-      private: friend class DARTLink;
-
-      /// Friend SimbodyPhysics so that it has access to dataPtr->dirtyPoses
-      private: friend class SimbodyPhysics;
     };
     /// \}
   }
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/physics/WorldCheckpoint.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+common::Time WorldCheckpoint::SimTime() const
+{
+  return this->simTime;
+}
+
+//////////////////////////////////////////////////
+uint64_t WorldCheckpoint::Iterations() const
+{
+  return this->iterations;
+}
+
+//////////////////////////////////////////////////
+std::size_t WorldCheckpoint::Size() const
+{
+  return this->engineState.size() +
+    this->entities.size() * sizeof(boost::weak_ptr<Entity>) +
+    this->poses.size() * sizeof(ignition::math::Pose3d);
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WORLDCHECKPOINT_HH_
+#define GAZEBO_PHYSICS_WORLDCHECKPOINT_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/weak_ptr.hpp>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WorldCheckpoint WorldCheckpoint.hh physics/physics.hh
+    /// \brief In-memory snapshot of a world, created by World::Checkpoint
+    /// and applied by World::Restore.
+    ///
+    /// Unlike WorldState, a checkpoint holds the raw state of the physics
+    /// engine, including the data that WorldState leaves out such as
+    /// solver warm start values and auto-disable counters, so that a
+    /// restored world steps exactly as the original did. A checkpoint is
+    /// only valid for the world that created it, while no model, link or
+    /// joint is added or removed.
+    class GZ_PHYSICS_VISIBLE WorldCheckpoint
+    {
+      /// \brief Get the simulation time of the checkpoint.
+      /// \return Simulation time.
+      public: common::Time SimTime() const;
+
+      /// \brief Get the iteration count of the checkpoint.
+      /// \return Number of iterations.
+      public: uint64_t Iterations() const;
+
+      /// \brief Get the memory used by the saved state.
+      /// \return Size in bytes.
+      public: std::size_t Size() const;
+
+      /// \brief World that created the checkpoint. It is only compared,
+      /// never dereferenced.
+      private: const World *world = nullptr;
+
+      /// \brief Simulation time.
+      private: common::Time simTime;
+
+      /// \brief Number of iterations.
+      private: uint64_t iterations = 0;
+
+      /// \brief State saved by PhysicsEngine::SaveState.
+      private: std::string engineState;
+
+      /// \brief The models and links that can move.
+      private: std::vector<boost::weak_ptr<Entity>> entities;
+
+      /// \brief World pose of each entity.
+      private: std::vector<ignition::math::Pose3d> poses;
+
+      /// \brief Only the world creates and restores checkpoints.
+      private: friend class World;
+    };
+    /// \}
+  }
+}
+#endif
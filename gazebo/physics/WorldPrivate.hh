@@ -46,6 +46,17 @@ namespace gazebo
 {
   namespace physics
   {
+    /// \brief A world pose computed by the physics engine, waiting to be
+    /// written back to its entity in World::Update.
+    class DirtyPoseRecord
+    {
+      /// \brief The entity that moved.
+      public: Entity *entity;
+
+      /// \brief New world pose of the entity.
+      public: ignition::math::Pose3d pose;
+    };
+
     /// \brief Private data class for World.
     class WorldPrivate
     {
@@ -101,6 +112,12 @@ namespace gazebo
       /// \brief Publisher for world statistics messages.
       public: transport::PublisherPtr statPub;
 
+      /// \brief Publisher for transport statistics messages.
+      public: transport::PublisherPtr transportStatsPub;
+
+      /// \brief Publisher for plugin statistics messages.
+      public: transport::PublisherPtr pluginStatsPub;
+
       /// \brief Publisher for request response messages.
       public: transport::PublisherPtr responsePub;
 
@@ -152,6 +169,12 @@ namespace gazebo
       /// \brief Outgoing world statistics message.
       public: msgs::WorldStatistics worldStatsMsg;
 
+      /// \brief Outgoing transport statistics message.
+      public: msgs::TransportStats transportStatsMsg;
+
+      /// \brief Outgoing plugin statistics message.
+      public: msgs::PluginStats pluginStatsMsg;
+
       /// \brief Outgoing scene message.
       public: msgs::Scene sceneMsg;
 
@@ -161,6 +184,16 @@ namespace gazebo
       /// \brief Last time a world statistics message was sent.
       public: common::Time prevStatTime;
 
+      /// \brief Last time a transport statistics message was sent.
+      public: common::Time prevTransportStatTime;
+
+      /// \brief Last time a plugin statistics message was sent.
+      public: common::Time prevPluginStatTime;
+
+      /// \brief Usage of the plugins, reused between plugin statistics
+      /// messages.
+      public: std::vector<common::PluginUsagePtr> pluginUsage;
+
       /// \brief Time at which pause started.
       public: common::Time pauseStartTime;
 
@@ -253,6 +286,9 @@ namespace gazebo
       /// \brief sleep timing error offset due to clock wake up latency
       public: common::Time sleepOffset;
 
+      /// \brief Paces the steps to absolute deadlines, when enabled.
+      public: std::unique_ptr<StepPacer> pacer;
+
       /// \brief Last time incoming messages were processed.
       public: common::Time prevProcessMsgsTime;
 
@@ -338,10 +374,10 @@ namespace gazebo
       /// ::ProcessFactoryMsgs functions.
       public: std::mutex factoryDeleteMutex;
 
-      /// \brief when physics engine makes an update and changes a link pose,
-      /// this flag is set to trigger Entity::SetWorldPose on the
-      /// physics::Link in World::Update.
-      public: std::list<Entity*> dirtyPoses;
+      /// \brief When the physics engine makes an update and changes a link
+      /// pose, the link and its new pose are appended here, and written back
+      /// in one pass in World::Update. The storage is reused between steps.
+      public: std::vector<DirtyPoseRecord> dirtyPoses;
 
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
@@ -382,6 +418,31 @@ namespace gazebo
 
       /// \brief SDF World DOM object
       public: std::unique_ptr<sdf::World> worldSDFDom;
+
+      /// \brief Random number seed of this world.
+      public: uint32_t seed = 0;
+
+      /// \brief Index of the bounding boxes of the models and links.
+      public: SpatialIndexPtr spatialIndex;
+
+      /// \brief True once the spatial index has been requested. The index
+      /// isn't maintained before that.
+      public: std::atomic<bool> spatialIndexEnabled{false};
+
+      /// \brief True when the spatial index must be rebuilt, because
+      /// models were added or removed, or the world was reset.
+      public: std::atomic<bool> spatialIndexRebuild{true};
+
+      /// \brief Mutex to protect the creation of the spatial index.
+      public: std::mutex spatialIndexMutex;
+
+      /// \brief Entities placed with Entity::SetWorldPose since the last
+      /// update of the spatial index, such as actors, kinematic models,
+      /// teleported models and log playback.
+      public: std::vector<boost::weak_ptr<Base>> placedEntities;
+
+      /// \brief Mutex to protect placedEntities.
+      public: std::mutex placedMutex;
     };
   }
 }
@@ -157,6 +157,40 @@ void WorldState::Load(const WorldPtr _world)
   }
 }
 
+/////////////////////////////////////////////////
+void WorldState::LoadEntities(const WorldPtr _world,
+    const std::set<std::string> &_names)
+{
+  this->world = _world;
+  this->name = _world->Name();
+  this->wallTime = common::Time::GetWallTime();
+  this->simTime = _world->SimTime();
+  this->realTime = _world->RealTime();
+  this->iterations = _world->Iterations();
+  this->insertions.clear();
+  this->deletions.clear();
+  this->modelStates.clear();
+  this->lightStates.clear();
+
+  for (auto const &entityName : _names)
+  {
+    ModelPtr model = _world->ModelByName(entityName);
+    if (model)
+    {
+      this->modelStates[model->GetName()].Load(model, this->realTime,
+          this->simTime, this->iterations);
+      continue;
+    }
+
+    LightPtr light = _world->LightByName(entityName);
+    if (light)
+    {
+      this->lightStates[light->GetName()].Load(light, this->realTime,
+          this->simTime, this->iterations);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 void WorldState::Load(const sdf::ElementPtr _elem)
 {
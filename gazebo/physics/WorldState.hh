@@ -21,6 +21,7 @@
 #ifndef GAZEBO_PHYSICS_WORLDSTATE_HH_
 #define GAZEBO_PHYSICS_WORLDSTATE_HH_
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -78,6 +79,17 @@ namespace gazebo
       public: void LoadWithFilter(const WorldPtr _world,
           const std::string &_filter);
 
+      /// \brief Load the state of a few entities from a World pointer.
+      ///
+      /// Only the listed top level models and lights are recorded, along
+      /// with the world's time. Setting the resulting state on the world
+      /// leaves all other entities untouched.
+      /// \param[in] _world Pointer to a world
+      /// \param[in] _names Names of top level models and lights. Names
+      /// that are not found in the world are ignored.
+      public: void LoadEntities(const WorldPtr _world,
+          const std::set<std::string> &_names);
+
       /// \brief Load state from SDF element.
       ///
       /// Set a WorldState from an SDF element containing WorldState info.
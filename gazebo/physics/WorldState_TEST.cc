@@ -113,6 +113,27 @@ TEST_F(WorldStateTest, WorldConstructor)
       ignition::math::Pose3d(0, 0, 10, 0, 0, 0));
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldStateTest, LoadEntities)
+{
+  // Load a world
+  this->Load("worlds/shapes.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  // Only the listed entities are recorded, unknown names are ignored
+  physics::WorldState worldState;
+  worldState.LoadEntities(world, {"box", "sun", "not_a_model"});
+
+  EXPECT_EQ(worldState.GetModelStateCount(), 1u);
+  EXPECT_TRUE(worldState.HasModelState("box"));
+  EXPECT_FALSE(worldState.HasModelState("sphere"));
+  EXPECT_EQ(worldState.LightStateCount(), 1u);
+  EXPECT_TRUE(worldState.HasLightState("sun"));
+  EXPECT_EQ(worldState.GetSimTime(), world->SimTime());
+  EXPECT_EQ(worldState.GetIterations(), world->Iterations());
+}
+
 //////////////////////////////////////////////////
 TEST_F(WorldStateTest, FillSDF)
 {
@@ -15,8 +15,15 @@
  *
 */
 
-#include "gazebo/physics/PhysicsTypes.hh"
-#include "gazebo/physics/World.hh"
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/physics/physics.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "test/util.hh"
 
@@ -24,6 +31,47 @@ using namespace gazebo;
 
 class WorldTest : public ServerFixture {};
 
+/// \brief Names in the pose messages published by the world, by sim time.
+static std::map<common::Time, std::set<std::string>> g_poseNames;
+
+/// \brief Protects g_poseNames.
+static std::mutex g_poseMutex;
+
+//////////////////////////////////////////////////
+/// \brief Record the names in a pose message published by the world.
+/// \param[in] _msg Pose message.
+static void OnPoseInfo(ConstPosesStampedPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_poseMutex);
+  auto &names = g_poseNames[msgs::Convert(_msg->time())];
+  for (int i = 0; i < _msg->pose_size(); ++i)
+    names.insert(_msg->pose(i).name());
+}
+
+//////////////////////////////////////////////////
+/// \brief Wait for the pose message published at a sim time.
+/// \param[in] _time Sim time of the message.
+/// \param[out] _names Names in the message.
+/// \return True if the message arrived.
+static bool WaitForPoses(const common::Time &_time,
+    std::set<std::string> &_names)
+{
+  for (int i = 0; i < 50; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_poseMutex);
+      auto iter = g_poseNames.find(_time);
+      if (iter != g_poseNames.end())
+      {
+        _names = iter->second;
+        return true;
+      }
+    }
+    common::Time::MSleep(100);
+  }
+  return false;
+}
+
 //////////////////////////////////////////////////
 /// \brief Test the factory message's allow_renaming flag and unique model name
 /// generation.
@@ -216,6 +264,303 @@ TEST_F(WorldTest, Stop)
   EXPECT_TRUE(world->Running());
 }
 
+//////////////////////////////////////////////////
+/// \brief Test that restoring a checkpoint replays the same steps, bit for
+/// bit.
+TEST_F(WorldTest, Checkpoint)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Boxes that fall onto each other and tumble
+  for (int i = 0; i < 3; ++i)
+  {
+    SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(0.3 * i, 0.2 * i, 0.5 + 1.2 * i),
+        ignition::math::Vector3d(0.1 * i, 0.2, 0));
+  }
+  world->Step(50);
+
+  physics::WorldCheckpointPtr checkpoint = world->Checkpoint();
+  ASSERT_TRUE(checkpoint != nullptr);
+  EXPECT_EQ(checkpoint->SimTime(), world->SimTime());
+  EXPECT_EQ(checkpoint->Iterations(), world->Iterations());
+  EXPECT_GT(checkpoint->Size(), 0u);
+
+  auto record = [&world]()
+  {
+    std::vector<double> values;
+    for (auto const &model : world->Models())
+    {
+      for (auto const &link : model->GetLinks())
+      {
+        auto pose = link->WorldPose();
+        auto vel = link->WorldLinearVel();
+        auto angVel = link->WorldAngularVel();
+        for (double v : {pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+                         pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(),
+                         pose.Rot().Z(), vel.X(), vel.Y(), vel.Z(),
+                         angVel.X(), angVel.Y(), angVel.Z()})
+        {
+          values.push_back(v);
+        }
+      }
+    }
+    return values;
+  };
+
+  const common::Time simTime = world->SimTime();
+  const std::vector<double> start = record();
+  world->Step(500);
+  const std::vector<double> end = record();
+  EXPECT_NE(start, end);
+
+  for (int run = 0; run < 2; ++run)
+  {
+    EXPECT_TRUE(world->Restore(checkpoint));
+    EXPECT_EQ(world->SimTime(), simTime);
+    EXPECT_EQ(record(), start);
+
+    world->Step(500);
+    EXPECT_EQ(record(), end);
+  }
+
+  // A checkpoint is no longer valid once a model is removed
+  world->RemoveModel("box_0");
+  EXPECT_FALSE(world->Restore(checkpoint));
+  EXPECT_FALSE(world->Restore(physics::WorldCheckpointPtr()));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Batch)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  EXPECT_EQ(world->Seed(), ignition::math::Rand::Seed());
+
+  // Copies of the loaded world description
+  auto worlds = physics::create_world_batch(world->SDF(), 3, 100);
+  ASSERT_EQ(worlds.size(), 3u);
+  for (unsigned int i = 0; i < worlds.size(); ++i)
+  {
+    EXPECT_EQ(worlds[i]->Name(), "default_" + std::to_string(i));
+    EXPECT_EQ(worlds[i]->Seed(), 100u + i);
+    EXPECT_EQ(physics::get_world(worlds[i]->Name()), worlds[i]);
+    EXPECT_EQ(worlds[i]->ModelCount(), world->ModelCount());
+  }
+
+  // The original world is untouched
+  EXPECT_EQ(world->Name(), "default");
+  EXPECT_EQ(physics::get_world(), world);
+
+  EXPECT_TRUE(physics::create_world_batch(nullptr, 3, 0).empty());
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that restoring a world leaves the trajectory of another
+/// world of the process unchanged, even while that world steps.
+TEST_F(WorldTest, CheckpointIsolation)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(0.3 * i, 0.2 * i, 0.5 + 1.2 * i),
+        ignition::math::Vector3d(0.1 * i, 0.2, 0));
+  }
+
+  auto worlds = physics::create_world_batch(world->SDF(), 2, 100);
+  ASSERT_EQ(worlds.size(), 2u);
+  for (auto const &batchWorld : worlds)
+  {
+    physics::init_world(batchWorld, nullptr);
+    physics::pause_world(batchWorld, true);
+    physics::run_world(batchWorld);
+  }
+  physics::WorldPtr restored = worlds[0];
+  physics::WorldPtr other = worlds[1];
+
+  auto record = [](physics::WorldPtr _world)
+  {
+    std::vector<double> values;
+    for (auto const &model : _world->Models())
+    {
+      for (auto const &link : model->GetLinks())
+      {
+        auto pose = link->WorldPose();
+        auto vel = link->WorldLinearVel();
+        for (double v : {pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+                         pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(),
+                         pose.Rot().Z(), vel.X(), vel.Y(), vel.Z()})
+        {
+          values.push_back(v);
+        }
+      }
+    }
+    return values;
+  };
+
+  restored->Step(50);
+  physics::WorldCheckpointPtr checkpoint = restored->Checkpoint();
+  ASSERT_TRUE(checkpoint != nullptr);
+  physics::WorldCheckpointPtr otherCheckpoint = other->Checkpoint();
+  ASSERT_TRUE(otherCheckpoint != nullptr);
+
+  // Trajectory of the other world on its own
+  const int samples = 20;
+  std::vector<std::vector<double>> reference;
+  for (int i = 0; i < samples; ++i)
+  {
+    other->Step(25);
+    reference.push_back(record(other));
+  }
+
+  // The same trajectory, while the first world is restored over and over
+  EXPECT_TRUE(other->Restore(otherCheckpoint));
+  std::vector<std::vector<double>> trajectory;
+  std::thread stepper([&]()
+  {
+    for (int i = 0; i < samples; ++i)
+    {
+      other->Step(25);
+      trajectory.push_back(record(other));
+    }
+  });
+  for (int i = 0; i < samples; ++i)
+  {
+    EXPECT_TRUE(restored->Restore(checkpoint));
+    restored->Step(25);
+  }
+  stepper.join();
+
+  EXPECT_EQ(trajectory, reference);
+}
+
+//////////////////////////////////////////////////
+/// \brief Test that the poses computed by the physics engine are written
+/// back in one pass with the same result as setting the world pose of each
+/// moved link, and that every moved model is published.
+TEST_F(WorldTest, DirtyPoseWriteBack)
+{
+  this->Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Models of free links with offset collisions, and a static box
+  const unsigned int modelCount = 3;
+  const unsigned int linkCount = 3;
+  for (unsigned int m = 0; m < modelCount; ++m)
+  {
+    std::ostringstream sdf;
+    sdf << "<sdf version='" << SDF_VERSION << "'>"
+        << "<model name='model_" << m << "'>"
+        << "<pose>0 " << 3 * m << " 2 0 0 " << 0.3 * m << "</pose>";
+    for (unsigned int l = 0; l < linkCount; ++l)
+    {
+      sdf << "<link name='link_" << l << "'>"
+          << "  <pose>" << 2 * l << " 0 " << 0.5 * l << " 0.1 0 0</pose>"
+          << "  <collision name='collision'>"
+          << "    <pose>0.1 0.2 0.3 0 0 0.5</pose>"
+          << "    <geometry><box><size>0.5 0.5 0.5</size></box></geometry>"
+          << "  </collision>"
+          << "</link>";
+    }
+    sdf << "</model>"
+        << "</sdf>";
+    SpawnSDF(sdf.str());
+  }
+  SpawnBox("static_box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(10, 10, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  std::vector<physics::ModelPtr> models;
+  for (unsigned int m = 0; m < modelCount; ++m)
+  {
+    physics::ModelPtr model = world->ModelByName("model_" + std::to_string(m));
+    ASSERT_TRUE(model != nullptr);
+    ASSERT_EQ(model->GetLinks().size(), linkCount);
+    models.push_back(model);
+  }
+
+  // Step until the pose publisher is connected
+  transport::SubscriberPtr sub = this->node->Subscribe("~/pose/info",
+      &OnPoseInfo);
+  std::set<std::string> names;
+  bool connected = false;
+  for (int i = 0; i < 20 && !connected; ++i)
+  {
+    world->Step(1);
+    connected = WaitForPoses(world->SimTime(), names);
+  }
+  ASSERT_TRUE(connected);
+
+  // Stay under the publishing rate cap of the pose topic
+  common::Time::MSleep(100);
+  world->Step(1);
+  ASSERT_TRUE(WaitForPoses(world->SimTime(), names));
+
+  // Each moved model is published with all of its links, and the static
+  // box isn't
+  for (auto const &model : models)
+  {
+    EXPECT_EQ(names.count(model->GetScopedName()), 1u);
+    for (auto const &link : model->GetLinks())
+      EXPECT_EQ(names.count(link->GetScopedName()), 1u);
+  }
+  EXPECT_EQ(names.count("static_box"), 0u);
+
+  // The links are at the pose computed by the physics engine, and their
+  // collisions follow
+  std::vector<ignition::math::Pose3d> modelPoses;
+  std::vector<ignition::math::Pose3d> linkPoses;
+  std::vector<ignition::math::Pose3d> collisionPoses;
+  for (auto const &model : models)
+  {
+    modelPoses.push_back(model->WorldPose());
+    for (auto const &link : model->GetLinks())
+    {
+      EXPECT_EQ(link->WorldPose(), link->DirtyPose());
+      linkPoses.push_back(link->WorldPose());
+
+      physics::CollisionPtr collision = link->GetCollision("collision");
+      ASSERT_TRUE(collision != nullptr);
+      const ignition::math::Pose3d expected =
+          collision->RelativePose() + link->WorldPose();
+      EXPECT_NEAR(collision->WorldPose().Pos().Distance(expected.Pos()), 0,
+          1e-9);
+      EXPECT_NEAR((collision->WorldPose().Rot().Inverse() * expected.Rot())
+          .Euler().Length(), 0, 1e-9);
+      collisionPoses.push_back(collision->WorldPose());
+    }
+  }
+
+  // Setting the world pose of each link, as the world used to, leaves
+  // everything unchanged
+  for (auto const &model : models)
+  {
+    for (auto const &link : model->GetLinks())
+      link->SetWorldPose(link->DirtyPose(), false);
+  }
+
+  unsigned int l = 0;
+  for (unsigned int m = 0; m < models.size(); ++m)
+  {
+    EXPECT_EQ(models[m]->WorldPose(), modelPoses[m]);
+    for (auto const &link : models[m]->GetLinks())
+    {
+      EXPECT_EQ(link->WorldPose(), linkPoses[l]);
+      EXPECT_EQ(link->GetCollision("collision")->WorldPose(),
+          collisionPoses[l]);
+      ++l;
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -19,6 +19,10 @@
 #include <string>
 
 #include <ignition/math/Rand.hh>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_scheduler_init.h>
 
 #include "gazebo/physics/bullet/BulletTypes.hh"
 #include "gazebo/physics/bullet/BulletLink.hh"
@@ -127,6 +131,71 @@ struct CollisionFilter : public btOverlapFilterCallback
     }
 };
 
+#ifdef LIBBULLET_VERSION_GT_287
+//////////////////////////////////////////////////
+// Runs the parallel loops of the multithreaded dynamics world on the TBB
+// worker threads shared with the rest of gazebo, instead of the thread
+// pool that Bullet would otherwise create.
+struct TbbTaskScheduler : public btITaskScheduler
+{
+  TbbTaskScheduler()
+    : btITaskScheduler("gazebo_tbb"),
+      numThreads(std::min(tbb::task_scheduler_init::default_num_threads(),
+                          BT_MAX_THREAD_COUNT))
+  {
+  }
+
+  virtual int getMaxNumThreads() const
+  {
+    return BT_MAX_THREAD_COUNT;
+  }
+
+  virtual int getNumThreads() const
+  {
+    return this->numThreads;
+  }
+
+  // The TBB workers are shared, so this only changes the number of
+  // solvers that Bullet allocates.
+  virtual void setNumThreads(int _numThreads)
+  {
+    this->numThreads = std::max(1, std::min(_numThreads, BT_MAX_THREAD_COUNT));
+  }
+
+  virtual void parallelFor(int _begin, int _end, int _grainSize,
+      const btIParallelForBody &_body)
+  {
+    btPushThreadsAreRunning();
+    tbb::parallel_for(tbb::blocked_range<int>(_begin, _end, _grainSize),
+        [&_body](const tbb::blocked_range<int> &_r)
+        {
+          _body.forLoop(_r.begin(), _r.end());
+        }, tbb::simple_partitioner());
+    btPopThreadsAreRunning();
+  }
+
+  virtual btScalar parallelSum(int _begin, int _end, int _grainSize,
+      const btIParallelSumBody &_body)
+  {
+    btPushThreadsAreRunning();
+    btScalar sum = tbb::parallel_reduce(
+        tbb::blocked_range<int>(_begin, _end, _grainSize), btScalar(0),
+        [&_body](const tbb::blocked_range<int> &_r, btScalar _sum)
+        {
+          return _sum + _body.sumLoop(_r.begin(), _r.end());
+        },
+        [](btScalar _a, btScalar _b)
+        {
+          return _a + _b;
+        }, tbb::simple_partitioner());
+    btPopThreadsAreRunning();
+    return sum;
+  }
+
+  int numThreads;
+};
+#endif
+
 //////////////////////////////////////////////////
 // Gets the contact information in the current state of
 // the world, updates the contact manager and
@@ -266,9 +335,6 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Default setup for memory and collisions
   this->collisionConfig = new btDefaultCollisionConfiguration();
 
-  // Default collision dispatcher, a multi-threaded dispatcher may be available
-  this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
-
   // Broadphase collision detection uses axis-aligned bounding boxes (AABB)
   // to detect pairs of objects that may be in contact.
   // The narrow-phase collision detection evaluates each pair generated by the
@@ -281,34 +347,81 @@ BulletPhysics::BulletPhysics(WorldPtr _world)
   // Here we are using btDbvtBroadphase.
   this->broadPhase = new btDbvtBroadphase();
 
-  // Create btSequentialImpulseConstraintSolver, the default constraint solver.
-  // Note that a multi-threaded solver may be available.
-  this->solver = new btSequentialImpulseConstraintSolver;
-
-  // Create a btDiscreteDynamicsWorld, which is used for discrete rigid bodies.
-  // An alternative is btSoftRigidDynamicsWorld, which handles both soft and
-  // rigid bodies.
-  this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
-      this->broadPhase, this->solver, this->collisionConfig);
-
   btOverlapFilterCallback *filterCallback = new CollisionFilter();
-  btOverlappingPairCache* pairCache = this->dynamicsWorld->getPairCache();
+  btOverlappingPairCache* pairCache =
+      this->broadPhase->getOverlappingPairCache();
   GZ_ASSERT(pairCache != nullptr,
       "Bullet broadphase overlapping pair cache is null");
   pairCache->setOverlapFilterCallback(filterCallback);
 
+  this->dispatcher = nullptr;
+  this->solver = nullptr;
+  this->dynamicsWorld = nullptr;
+  this->CreateDynamicsWorld(false);
+
   // TODO: Enable this to do custom contact setting
   gContactAddedCallback = ContactCallback;
   gContactProcessedCallback = ContactProcessed;
 
-  this->dynamicsWorld->setInternalTickCallback(
-      InternalTickCallback, static_cast<void *>(this));
-
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(ignition::math::Rand::Seed());
+}
+
+//////////////////////////////////////////////////
+bool BulletPhysics::CreateDynamicsWorld(const bool _multithreaded)
+{
+  // Delete in reverse-order of creation
+  delete this->dynamicsWorld;
+  delete this->solverMt;
+  delete this->solver;
+  delete this->dispatcher;
+  this->solverMt = nullptr;
+
+  this->multithreaded = false;
+#ifdef LIBBULLET_VERSION_GT_287
+  if (_multithreaded)
+  {
+    static TbbTaskScheduler taskScheduler;
+    if (btGetTaskScheduler() != &taskScheduler)
+      btSetTaskScheduler(&taskScheduler);
+
+    // The dispatcher runs the narrowphase of the overlapping pairs in
+    // parallel. The simulation islands are solved in parallel by a pool of
+    // solvers, one per thread, and the islands that are too large to be
+    // worth splitting go to solverMt, which parallelizes their constraints.
+    this->dispatcher = new btCollisionDispatcherMt(this->collisionConfig);
+    btConstraintSolverPoolMt *solverPool =
+        new btConstraintSolverPoolMt(taskScheduler.getNumThreads());
+    this->solver = solverPool;
+    this->solverMt = new btSequentialImpulseConstraintSolverMt();
+    this->dynamicsWorld = new btDiscreteDynamicsWorldMt(this->dispatcher,
+        this->broadPhase, solverPool, this->solverMt, this->collisionConfig);
+    this->multithreaded = true;
+  }
+  else
+#endif
+  {
+    // Default collision dispatcher
+    this->dispatcher = new btCollisionDispatcher(this->collisionConfig);
+
+    // Create btSequentialImpulseConstraintSolver, the default constraint
+    // solver.
+    this->solver = new btSequentialImpulseConstraintSolver;
+
+    // Create a btDiscreteDynamicsWorld, which is used for discrete rigid
+    // bodies. An alternative is btSoftRigidDynamicsWorld, which handles both
+    // soft and rigid bodies.
+    this->dynamicsWorld = new btDiscreteDynamicsWorld(this->dispatcher,
+        this->broadPhase, this->solver, this->collisionConfig);
+  }
 
-  btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
+  this->dynamicsWorld->setInternalTickCallback(
+      InternalTickCallback, static_cast<void *>(this));
+
+  btGImpactCollisionAlgorithm::registerAlgorithm(this->dispatcher);
+
+  return this->multithreaded == _multithreaded;
 }
 
 //////////////////////////////////////////////////
@@ -324,6 +437,28 @@ void BulletPhysics::Load(sdf::ElementPtr _sdf)
 
   sdf::ElementPtr bulletElem = this->sdf->GetElement("bullet");
 
+  // The multithreaded world is not part of the <bullet> schema, so it is
+  // read from a custom element, such as
+  // <gz:multithreaded>true</gz:multithreaded>. Load runs before any link
+  // is added, so the dynamics world can still be replaced.
+  for (sdf::ElementPtr elem = bulletElem->GetFirstElement(); elem;
+       elem = elem->GetNextElement())
+  {
+    const std::string name = elem->GetName();
+    const std::string suffix = ":multithreaded";
+    if (name.size() > suffix.size() &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+    {
+      const bool enable = elem->Get<bool>();
+      if (enable != this->multithreaded &&
+          !this->CreateDynamicsWorld(enable))
+      {
+        gzwarn << "The multithreaded Bullet dynamics world requires "
+               << "Bullet 2.88 or later, using the single-threaded world.\n";
+      }
+    }
+  }
+
   auto g = this->world->Gravity();
   // ODEPhysics checks this, so we will too.
   if (g == ignition::math::Vector3d::Zero)
@@ -524,6 +659,10 @@ void BulletPhysics::Fini()
     delete this->dynamicsWorld;
   this->dynamicsWorld = nullptr;
 
+  if (this->solverMt)
+    delete this->solverMt;
+  this->solverMt = nullptr;
+
   if (this->solver)
     delete this->solver;
   this->solver = nullptr;
@@ -707,6 +846,8 @@ bool BulletPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->sdf->GetElement("max_contacts")->Get<int>();
   else if (_key == "min_step_size")
     _value = bulletElem->GetElement("solver")->Get<double>("min_step_size");
+  else if (_key == "multithreaded")
+    _value = this->multithreaded;
   else
   {
     return PhysicsEngine::GetParam(_key, _value);
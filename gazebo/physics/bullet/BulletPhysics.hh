@@ -172,12 +172,29 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSORPGSIters(unsigned int iters);
 
+      /// \brief Create the dispatcher, the constraint solver and the
+      /// dynamics world, deleting the previous ones. The broadphase and
+      /// the collision configuration are kept.
+      /// \param[in] _multithreaded True to create the task-parallel world,
+      /// which dispatches the narrowphase and solves the simulation islands
+      /// on the TBB worker threads. It requires Bullet 2.88 or later.
+      /// \return False if _multithreaded was requested but is not supported,
+      /// in which case the single-threaded world is created.
+      private: bool CreateDynamicsWorld(const bool _multithreaded);
+
       private: btBroadphaseInterface *broadPhase;
       private: btDefaultCollisionConfiguration *collisionConfig;
       private: btCollisionDispatcher *dispatcher;
-      private: btSequentialImpulseConstraintSolver *solver;
+      private: btConstraintSolver *solver;
       private: btDiscreteDynamicsWorld *dynamicsWorld;
 
+      /// \brief Solver that distributes the simulation islands to the
+      /// pool held by solver, only used by the multithreaded world.
+      private: btConstraintSolver *solverMt = nullptr;
+
+      /// \brief True if the multithreaded dynamics world is used.
+      private: bool multithreaded = false;
+
       private: common::Time lastUpdateTime;
 
       /// \brief The type of the solver.
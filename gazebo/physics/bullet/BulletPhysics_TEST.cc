@@ -16,8 +16,13 @@
 */
 
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
 #include <string>
 
+#include <boost/filesystem.hpp>
+#include <ignition/math/Rand.hh>
+
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/bullet/BulletPhysics.hh"
@@ -267,6 +272,110 @@ TEST_F(BulletPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Test that the dynamics world is single-threaded unless requested
+TEST_F(BulletPhysics_TEST, SingleThreadedByDefault)
+{
+  Load("worlds/empty.world", true, "bullet");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  boost::any value;
+  EXPECT_TRUE(physics->GetParam("multithreaded", value));
+  EXPECT_FALSE(boost::any_cast<bool>(value));
+}
+
+/////////////////////////////////////////////////
+/// Test that <gz:multithreaded> selects the task-parallel dynamics world,
+/// and that it steps like the single-threaded world.
+TEST_F(BulletPhysics_TEST, Multithreaded)
+{
+  // Boxes dropped on the ground, alone and in a stack, so that the world
+  // has several simulation islands
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?><sdf version='1.6'><world name='default'>"
+      << "<physics type='bullet'><max_step_size>0.001</max_step_size>"
+      << "<bullet><gz:multithreaded>true</gz:multithreaded></bullet>"
+      << "</physics>"
+      << "<model name='ground'><static>true</static><link name='link'>"
+      << "<collision name='c'><geometry><plane><normal>0 0 1</normal>"
+      << "<size>100 100</size></plane></geometry></collision></link>"
+      << "</model>";
+  for (int i = 0; i < 6; ++i)
+  {
+    const ignition::math::Vector3d pos(i < 3 ? 2.0 * i : 8.0, 0,
+        i < 3 ? 1.0 + 0.3 * i : 0.5 + 1.1 * (i - 3));
+    sdf << "<model name='box_" << i << "'><pose>" << pos << " 0 0 0</pose>"
+        << "<link name='link'><inertial><mass>1</mass></inertial>"
+        << "<collision name='c'><geometry><box><size>1 1 1</size></box>"
+        << "</geometry></collision></link></model>";
+  }
+  sdf << "</world></sdf>";
+
+  boost::filesystem::path worldFile =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_bullet_multithreaded_%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << sdf.str();
+  }
+  Load(worldFile.string(), true, "bullet");
+  boost::filesystem::remove(worldFile);
+
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  boost::any value;
+  EXPECT_TRUE(world->Physics()->GetParam("multithreaded", value));
+#ifdef LIBBULLET_VERSION_GT_287
+  EXPECT_TRUE(boost::any_cast<bool>(value));
+#else
+  // The task-parallel world needs Bullet 2.88 or later
+  EXPECT_FALSE(boost::any_cast<bool>(value));
+#endif
+
+  // A copy of the world without the flag
+  sdf::ElementPtr singleSDF = world->SDF()->Clone();
+  sdf::ElementPtr bulletElem =
+      singleSDF->GetElement("physics")->GetElement("bullet");
+  ASSERT_TRUE(bulletElem->HasElement("gz:multithreaded"));
+  bulletElem->GetElement("gz:multithreaded")->Set(false);
+
+  auto worlds = create_world_batch(singleSDF, 1,
+      ignition::math::Rand::Seed());
+  ASSERT_EQ(worlds.size(), 1u);
+  WorldPtr single = worlds[0];
+  init_world(single, nullptr);
+  pause_world(single, true);
+  run_world(single);
+  EXPECT_TRUE(single->Physics()->GetParam("multithreaded", value));
+  EXPECT_FALSE(boost::any_cast<bool>(value));
+
+  world->Step(1500);
+  single->Step(1500);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    const std::string name = "box_" + std::to_string(i);
+    ModelPtr model = world->ModelByName(name);
+    ModelPtr reference = single->ModelByName(name);
+    ASSERT_TRUE(model != nullptr);
+    ASSERT_TRUE(reference != nullptr);
+
+    // Resting on the ground or on each other
+    EXPECT_GT(model->WorldPose().Pos().Z(), 0.4) << name;
+    EXPECT_NEAR(model->WorldPose().Pos().X(),
+        reference->WorldPose().Pos().X(), 5e-3) << name;
+    EXPECT_NEAR(model->WorldPose().Pos().Y(),
+        reference->WorldPose().Pos().Y(), 5e-3) << name;
+    EXPECT_NEAR(model->WorldPose().Pos().Z(),
+        reference->WorldPose().Pos().Z(), 5e-3) << name;
+  }
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
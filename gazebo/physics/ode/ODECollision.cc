@@ -24,6 +24,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 
+#include "gazebo/physics/World.hh"
 #include "gazebo/physics/ode/ODESurfaceParams.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODELink.hh"
@@ -43,6 +44,12 @@ ODECollision::ODECollision(LinkPtr _link)
   this->SetSpaceId(
       boost::static_pointer_cast<ODELink>(this->link)->GetSpaceId());
 
+  if (this->GetWorld())
+  {
+    this->odePhysics = boost::dynamic_pointer_cast<ODEPhysics>(
+        this->GetWorld()->Physics());
+  }
+
   this->surface.reset(new ODESurfaceParams());
 }
 
@@ -50,7 +57,11 @@ ODECollision::ODECollision(LinkPtr _link)
 ODECollision::~ODECollision()
 {
   if (this->collisionId)
+  {
+    if (ODEPhysicsPtr ode = this->odePhysics.lock())
+      ode->DirtyRaySnapshot();
     dGeomDestroy(this->collisionId);
+  }
   this->collisionId = nullptr;
 
   this->Fini();
@@ -101,6 +112,12 @@ void ODECollision::OnPoseChange()
     this->OnPoseChangeGlobal();
   else if (this->collisionId && this->placeable)
     this->OnPoseChangeRelative();
+
+  if (this->collisionId)
+  {
+    if (ODEPhysicsPtr ode = this->odePhysics.lock())
+      ode->DirtyRaySnapshot();
+  }
 }
 
 //////////////////////////////////////////////////
@@ -130,6 +147,9 @@ void ODECollision::SetCollision(dGeomID _collisionId, bool _placeable)
   }
 
   dGeomSetData(this->collisionId, this);
+
+  if (ODEPhysicsPtr ode = this->odePhysics.lock())
+    ode->DirtyRaySnapshot();
 }
 
 //////////////////////////////////////////////////
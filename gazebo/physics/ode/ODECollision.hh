@@ -22,6 +22,8 @@
 #ifndef _ODECOLLISION_HH_
 #define _ODECOLLISION_HH_
 
+#include <boost/weak_ptr.hpp>
+
 #include "gazebo/physics/ode/ode_inc.h"
 
 #include "gazebo/physics/PhysicsTypes.hh"
@@ -107,6 +109,11 @@ namespace gazebo
 
       /// \brief Function used to set the pose of the ODE object.
       private: void (ODECollision::*onPoseChangeFunc)();
+
+      /// \brief Physics engine, told when the geom is created, moved or
+      /// destroyed so that it doesn't cast rays against a stale snapshot.
+      /// Weak, since the geom can outlive the engine.
+      private: boost::weak_ptr<ODEPhysics> odePhysics;
     };
     /// \}
   }
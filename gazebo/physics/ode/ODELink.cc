@@ -264,6 +264,10 @@ void ODELink::OnPoseChange()
 
   // Set the rotation of the ODE link
   dBodySetQuaternion(this->linkId, q);
+
+  // The geoms of the link moved outside of a physics update
+  if (this->odePhysics)
+    this->odePhysics->DirtyRaySnapshot();
 }
 
 //////////////////////////////////////////////////
@@ -698,6 +702,18 @@ ignition::math::Vector3d ODELink::WorldTorque() const
   return this->torque;
 }
 
+//////////////////////////////////////////////////
+void ODELink::SetStatic(const bool &_static)
+{
+  Link::SetStatic(_static);
+
+  // The links of a model share its space, which follows the model like
+  // it does in ODEPhysics::CreateLink.
+  ModelPtr model = this->GetModel();
+  if (this->odePhysics && this->spaceId && model)
+    this->odePhysics->SetSpaceStatic(this->spaceId, model->IsStatic());
+}
+
 //////////////////////////////////////////////////
 dSpaceID ODELink::GetSpaceId() const
 {
@@ -162,6 +162,10 @@ namespace gazebo
       /// \return ODE link id
       public: dBodyID GetODEId() const;
 
+      // Documentation inherited
+      public: virtual void SetStatic(const bool &_static);
+      using Link::SetStatic;
+
       /// \brief Get the ID of the collision space this link is in.
       /// \return The collision space ID for the link.
       public: dSpaceID GetSpaceId() const;
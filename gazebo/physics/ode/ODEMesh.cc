@@ -14,6 +14,12 @@
  * limitations under the License.
  *
 */
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string_view>
+#include <tuple>
+
 #include "gazebo/common/Mesh.hh"
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
@@ -25,20 +31,79 @@
 using namespace gazebo;
 using namespace physics;
 
+/// \brief Key of the shared mesh data: the vertex and index counts, and a
+/// hash of the scaled vertices and the indices. The data itself is compared
+/// on a match, so meshes that are freed and reallocated at the same address
+/// never share stale data.
+typedef std::tuple<unsigned int, unsigned int, size_t> ODEMeshKey;
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Scaled vertices and indices of a mesh, and the ODE trimesh
+    /// data built from them. The data is read-only once built, so it can be
+    /// used by collisions of several worlds stepping in parallel.
+    class ODEMeshData
+    {
+      /// \brief Destructor.
+      public: ~ODEMeshData()
+      {
+        if (this->odeData)
+          dGeomTriMeshDataDestroy(this->odeData);
+        delete [] this->vertices;
+        delete [] this->indices;
+      }
+
+      /// \brief Key of the data in g_odeMeshData.
+      public: ODEMeshKey key;
+
+      /// \brief False if the data isn't in g_odeMeshData, because other
+      /// data with the same key was there first.
+      public: bool registered = false;
+
+      /// \brief Array of vertex values.
+      public: float *vertices = nullptr;
+
+      /// \brief Array of index values.
+      public: int *indices = nullptr;
+
+      /// \brief ODE trimesh data.
+      public: dTriMeshDataID odeData = nullptr;
+    };
+  }
+}
+
+/// \brief Mutex that protects g_odeMeshData, and the copies of the shared
+/// pointers to its data.
+static std::mutex g_odeMeshDataMutex;
+
+/// \brief Mesh data of the process, shared by the meshes with the same
+/// scaled vertices and indices.
+static std::map<ODEMeshKey, std::weak_ptr<ODEMeshData>> g_odeMeshData;
+
+/////////////////////////////////////////////////
+/// \brief Release a reference to shared mesh data, and remove the data from
+/// g_odeMeshData with its last reference. Must be called with
+/// g_odeMeshDataMutex locked.
+/// \param[in,out] _data Reference to release.
+static void releaseMeshData(std::shared_ptr<ODEMeshData> &_data)
+{
+  if (_data && _data.use_count() == 1 && _data->registered)
+    g_odeMeshData.erase(_data->key);
+  _data.reset();
+}
+
 //////////////////////////////////////////////////
 ODEMesh::ODEMesh()
 {
-  this->odeData = nullptr;
-  this->vertices = nullptr;
-  this->indices = nullptr;
 }
 
 //////////////////////////////////////////////////
 ODEMesh::~ODEMesh()
 {
-  delete [] this->vertices;
-  delete [] this->indices;
-  dGeomTriMeshDataDestroy(this->odeData);
+  std::lock_guard<std::mutex> lock(g_odeMeshDataMutex);
+  releaseMeshData(this->data);
 }
 
 //////////////////////////////////////////////////
@@ -89,15 +154,13 @@ void ODEMesh::Init(const common::SubMesh *_subMesh, ODECollisionPtr _collision,
   unsigned int numVertices = _subMesh->GetVertexCount();
   unsigned int numIndices = _subMesh->GetIndexCount();
 
-  this->vertices = nullptr;
-  this->indices = nullptr;
-
-  // Get all the vertex and index data
-  _subMesh->FillArrays(&this->vertices, &this->indices);
-
   this->collisionId = _collision->GetCollisionId();
 
-  this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  this->CreateMesh(numVertices, numIndices,
+      [_subMesh](float **_vertices, int **_indices)
+      {
+        _subMesh->FillArrays(_vertices, _indices);
+      }, _collision, _scale);
 }
 
 //////////////////////////////////////////////////
@@ -110,47 +173,96 @@ void ODEMesh::Init(const common::Mesh *_mesh, ODECollisionPtr _collision,
   unsigned int numVertices = _mesh->GetVertexCount();
   unsigned int numIndices = _mesh->GetIndexCount();
 
-  this->vertices = nullptr;
-  this->indices = nullptr;
-
-  // Get all the vertex and index data
-  _mesh->FillArrays(&this->vertices, &this->indices);
-
   this->collisionId = _collision->GetCollisionId();
-  this->CreateMesh(numVertices, numIndices, _collision, _scale);
+  this->CreateMesh(numVertices, numIndices,
+      [_mesh](float **_vertices, int **_indices)
+      {
+        _mesh->FillArrays(_vertices, _indices);
+      }, _collision, _scale);
 }
 
 //////////////////////////////////////////////////
 void ODEMesh::CreateMesh(unsigned int _numVertices, unsigned int _numIndices,
+    const std::function<void(float **, int **)> &_fill,
     ODECollisionPtr _collision, const ignition::math::Vector3d &_scale)
 {
-  /// This will hold the vertex data of the triangle mesh
-  if (this->odeData == nullptr)
-    this->odeData = dGeomTriMeshDataCreate();
+  // Get all the vertex and index data
+  float *vertices = nullptr;
+  int *indices = nullptr;
+  _fill(&vertices, &indices);
 
   // Scale the vertex data
   for (unsigned int j = 0;  j < _numVertices; j++)
   {
-    this->vertices[j*3+0] = this->vertices[j*3+0] * _scale.X();
-    this->vertices[j*3+1] = this->vertices[j*3+1] * _scale.Y();
-    this->vertices[j*3+2] = this->vertices[j*3+2] * _scale.Z();
+    vertices[j*3+0] = vertices[j*3+0] * _scale.X();
+    vertices[j*3+1] = vertices[j*3+1] * _scale.Y();
+    vertices[j*3+2] = vertices[j*3+2] * _scale.Z();
   }
 
-  // Build the ODE triangle mesh
-  dGeomTriMeshDataBuildSingle(this->odeData,
-      this->vertices, 3*sizeof(this->vertices[0]), _numVertices,
-      this->indices, _numIndices, 3*sizeof(this->indices[0]));
+  const size_t vertexBytes = _numVertices * 3 * sizeof(vertices[0]);
+  const size_t indexBytes = _numIndices * sizeof(indices[0]);
+  const std::hash<std::string_view> hash;
+  const size_t vertexHash = hash(std::string_view(
+        reinterpret_cast<const char *>(vertices), vertexBytes));
+  const size_t indexHash = hash(std::string_view(
+        reinterpret_cast<const char *>(indices), indexBytes));
+  const ODEMeshKey key(_numVertices, _numIndices,
+      vertexHash ^ (indexHash + 0x9e3779b9 + (vertexHash << 6) +
+        (vertexHash >> 2)));
+
+  // Building the trimesh data, and its bounding volume tree, is the
+  // expensive part, so it is done once for all the worlds of the process.
+  std::lock_guard<std::mutex> lock(g_odeMeshDataMutex);
+  std::shared_ptr<ODEMeshData> shared = g_odeMeshData[key].lock();
+  bool registered = !shared;
+  if (shared && (memcmp(shared->vertices, vertices, vertexBytes) != 0 ||
+        memcmp(shared->indices, indices, indexBytes) != 0))
+  {
+    // Different data with the same hash, which this mesh doesn't share
+    shared.reset();
+  }
+
+  if (shared)
+  {
+    delete [] vertices;
+    delete [] indices;
+  }
+  else
+  {
+    shared.reset(new ODEMeshData);
+    shared->key = key;
+    shared->registered = registered;
+    shared->vertices = vertices;
+    shared->indices = indices;
+
+    // Build the ODE triangle mesh
+    shared->odeData = dGeomTriMeshDataCreate();
+    dGeomTriMeshDataBuildSingle(shared->odeData,
+        shared->vertices, 3*sizeof(shared->vertices[0]), _numVertices,
+        shared->indices, _numIndices, 3*sizeof(shared->indices[0]));
+
+    if (registered)
+      g_odeMeshData[key] = shared;
+  }
 
   if (_collision->GetCollisionId() == nullptr)
   {
     _collision->SetSpaceId(dSimpleSpaceCreate(_collision->GetSpaceId()));
     _collision->SetCollision(dCreateTriMesh(_collision->GetSpaceId(),
-          this->odeData, 0, 0, 0), true);
+          shared->odeData, 0, 0, 0), true);
   }
   else
   {
-    dGeomTriMeshSetData(_collision->GetCollisionId(), this->odeData);
+    dGeomTriMeshSetData(_collision->GetCollisionId(), shared->odeData);
+  }
+
+  // The collision no longer uses the previous data
+  if (this->data != shared)
+  {
+    releaseMeshData(this->data);
+    this->data = shared;
   }
+  shared.reset();
 
   memset(this->transform, 0, 32*sizeof(dReal));
   this->transformIndex = 0;
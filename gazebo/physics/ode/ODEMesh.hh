@@ -18,6 +18,8 @@
 #ifndef GAZEBO_PHYSICS_ODE_ODEMESH_HH_
 #define GAZEBO_PHYSICS_ODE_ODEMESH_HH_
 
+#include <functional>
+#include <memory>
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/physics/ode/ODETypes.hh"
@@ -29,10 +31,16 @@ namespace gazebo
 {
   namespace physics
   {
+    class ODEMeshData;
+
     /// \addtogroup gazebo_physics_ode
     /// \{
 
     /// \brief Triangle mesh helper class.
+    ///
+    /// The triangle mesh data, with its bounding volume tree, is built once
+    /// and shared by every collision of every world in the process that has
+    /// the same scaled vertices and indices.
     class GZ_PHYSICS_VISIBLE ODEMesh
     {
       /// \brief Constructor.
@@ -63,9 +71,14 @@ namespace gazebo
       /// \brief Helper function to create the collision shape.
       /// \param[in] _numVertices Number of vertices.
       /// \param[in] _numIndices Number of indices.
+      /// \param[in] _fill Function that allocates and fills the vertex and
+      /// index arrays. The arrays are freed if the data is already shared.
       /// \param[in] _collision Pointer to the collision object.
+      /// \param[in] _scale Scaling factor.
       private: void CreateMesh(unsigned int _numVertices,
-                   unsigned int _numIndices, ODECollisionPtr _collision,
+                   unsigned int _numIndices,
+                   const std::function<void(float **, int **)> &_fill,
+                   ODECollisionPtr _collision,
                    const ignition::math::Vector3d &_scale);
 
       /// \brief Transform matrix.
@@ -74,14 +87,9 @@ namespace gazebo
       /// \brief Transform matrix index.
       private: int transformIndex;
 
-      /// \brief Array of vertex values.
-      private: float *vertices;
-
-      /// \brief Array of index values.
-      private: int *indices;
-
-      /// \brief ODE trimesh data.
-      private: dTriMeshDataID odeData;
+      /// \brief Vertices, indices and ODE trimesh data, shared with the
+      /// other meshes that have the same scaled vertices and indices.
+      private: std::shared_ptr<ODEMeshData> data;
 
       /// \brief The collision id that this mesh is attached to.
       private: dGeomID collisionId;
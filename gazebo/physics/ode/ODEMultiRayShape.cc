@@ -14,6 +14,13 @@
  * limitations under the License.
  *
  */
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Exception.hh"
 
@@ -23,11 +30,53 @@
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODERayShape.hh"
+#include "gazebo/physics/ode/ODERaySnapshot.hh"
 #include "gazebo/physics/ode/ODEMultiRayShape.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+/// \brief A ray to cast against a snapshot.
+class RayJob
+{
+  /// \brief The ray.
+  public: RayShape *ray;
+
+  /// \brief Start of the ray in world coordinates.
+  public: ignition::math::Vector3d start;
+
+  /// \brief End of the ray in world coordinates.
+  public: ignition::math::Vector3d end;
+
+  /// \brief Geoms near the parent shape of the ray.
+  public: const std::vector<unsigned int> *candidates;
+
+  /// \brief Closest hit.
+  public: ODERayHit hit;
+};
+
+class RayCast_TBB
+{
+  public: RayCast_TBB(const ODERaySnapshot *_snapshot,
+              std::vector<RayJob> *_jobs) :
+    snapshot(_snapshot), jobs(_jobs)
+  {
+  }
+
+  public: void operator() (const tbb::blocked_range<size_t> &_r) const
+  {
+    dGeomID rayId = ODERaySnapshot::ThreadRay();
+    for (size_t i = _r.begin(); i != _r.end(); i++)
+    {
+      RayJob &job = (*this->jobs)[i];
+      this->snapshot->Cast(rayId, job.start, job.end, *job.candidates,
+          true, job.hit);
+    }
+  }
+
+  private: const ODERaySnapshot *snapshot;
+  private: std::vector<RayJob> *jobs;
+};
 
 //////////////////////////////////////////////////
 ODEMultiRayShape::ODEMultiRayShape(CollisionPtr _parent)
@@ -82,6 +131,12 @@ ODEMultiRayShape::~ODEMultiRayShape()
 //////////////////////////////////////////////////
 void ODEMultiRayShape::UpdateRays()
 {
+  if (this->defaultUpdate)
+  {
+    CastRays({this});
+    return;
+  }
+
   ODEPhysicsPtr ode = boost::dynamic_pointer_cast<ODEPhysics>(
       this->GetWorld()->Physics());
 
@@ -100,6 +155,102 @@ void ODEMultiRayShape::UpdateRays()
   }
 }
 
+//////////////////////////////////////////////////
+void ODEMultiRayShape::UpdateRaysBatch(
+    const std::vector<MultiRayShapePtr> &_shapes)
+{
+  std::vector<ODEMultiRayShape *> shapes;
+  for (auto const &shape : _shapes)
+  {
+    ODEMultiRayShape *odeShape =
+        dynamic_cast<ODEMultiRayShape *>(shape.get());
+    if (odeShape && odeShape->defaultUpdate)
+      shapes.push_back(odeShape);
+    else if (shape)
+      shape->UpdateRays();
+  }
+
+  CastRays(shapes);
+}
+
+//////////////////////////////////////////////////
+void ODEMultiRayShape::CastRays(const std::vector<ODEMultiRayShape *> &_shapes)
+{
+  if (_shapes.empty())
+    return;
+
+  ODEPhysicsPtr ode = boost::dynamic_pointer_cast<ODEPhysics>(
+      _shapes.front()->GetWorld()->Physics());
+
+  if (ode == nullptr)
+    gzthrow("Invalid physics engine. Must use ODE.");
+
+  // The physics engine stays locked for the whole batch, so that geoms
+  // can't move or disappear while the rays are cast against the snapshot.
+  boost::recursive_mutex::scoped_lock lock(*ode->GetPhysicsUpdateMutex());
+
+  ODERaySnapshotPtr snapshot = ode->RaySnapshot();
+
+  // Prune the geoms once per shape, using the bounds of all its rays.
+  std::vector<std::vector<unsigned int> > candidates(_shapes.size());
+  std::vector<RayJob> jobs;
+  for (unsigned int s = 0; s < _shapes.size(); ++s)
+  {
+    ignition::math::Vector3d min(ignition::math::MAX_D,
+        ignition::math::MAX_D, ignition::math::MAX_D);
+    ignition::math::Vector3d max(ignition::math::LOW_D,
+        ignition::math::LOW_D, ignition::math::LOW_D);
+
+    const size_t firstJob = jobs.size();
+    for (auto const &ray : _shapes[s]->rays)
+    {
+      if (ignition::math::equal(ray->GetLength(), 0.0))
+        continue;
+
+      RayJob job;
+      job.ray = ray.get();
+      ray->GlobalPoints(job.start, job.end);
+      job.candidates = &candidates[s];
+      jobs.push_back(job);
+
+      min.Min(job.start);
+      min.Min(job.end);
+      max.Max(job.start);
+      max.Max(job.end);
+    }
+
+    if (jobs.size() > firstJob)
+    {
+      snapshot->Overlapping(ignition::math::AxisAlignedBox(min, max),
+          candidates[s]);
+    }
+  }
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, jobs.size(), 64),
+      RayCast_TBB(snapshot.get(), &jobs));
+
+  // Heightfields and transforms can only be collided from one thread.
+  if (snapshot->HasSerialGeoms())
+  {
+    dGeomID rayId = ODERaySnapshot::ThreadRay();
+    for (auto &job : jobs)
+    {
+      snapshot->Cast(rayId, job.start, job.end, *job.candidates, false,
+          job.hit);
+    }
+  }
+
+  for (auto const &job : jobs)
+  {
+    if (job.hit.collision && job.hit.depth < job.ray->GetLength())
+    {
+      job.ray->SetLength(job.hit.depth);
+      job.ray->SetRetro(job.hit.collision->GetLaserRetro());
+      job.ray->SetCollisionName(job.hit.collision->GetScopedName());
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 void ODEMultiRayShape::UpdateCallback(void *_data, dGeomID _o1, dGeomID _o2)
 {
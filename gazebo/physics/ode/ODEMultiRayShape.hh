@@ -17,6 +17,8 @@
 #ifndef GAZEBO_PHYSICS_ODE_ODEMULTIRAYSHAPE_HH_
 #define GAZEBO_PHYSICS_ODE_ODEMULTIRAYSHAPE_HH_
 
+#include <vector>
+
 #include "gazebo/physics/MultiRayShape.hh"
 #include "gazebo/util/system.hh"
 
@@ -44,6 +46,17 @@ namespace gazebo
       // Documentation inherited.
       public: virtual void UpdateRays();
 
+      // Documentation inherited.
+      protected: virtual void UpdateRaysBatch(
+                     const std::vector<MultiRayShapePtr> &_shapes);
+
+      /// \brief Cast the rays of several shapes in parallel against a
+      /// snapshot of the world space, and store the closest hit of every
+      /// ray.
+      /// \param[in] _shapes Shapes attached to collisions.
+      private: static void CastRays(
+                   const std::vector<ODEMultiRayShape *> &_shapes);
+
       /// \brief Ray-intersection callback.
       /// \param[in] _data Pointer to user data.
       /// \param[in] _o1 First geom to check for collisions.
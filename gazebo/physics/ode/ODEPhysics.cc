@@ -21,11 +21,13 @@
 #include <sdf/sdf.hh>
 
 #include <algorithm>
+#include <cmath>
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -129,6 +131,100 @@ extern "C" void dMessageQuiet(int, const char *, va_list)
 {
 }
 
+namespace
+{
+  /// \brief Statistics of the bounding boxes of the geoms of a space,
+  /// used to tune its broadphase. Geoms with infinite boxes, such as
+  /// planes, are ignored.
+  class SpaceBoxes
+  {
+    /// \brief Constructor.
+    /// \param[in] _spaceId Space whose direct children are measured.
+    public: explicit SpaceBoxes(dSpaceID _spaceId)
+    {
+      const int count = dSpaceGetNumGeoms(_spaceId);
+      for (int i = 0; i < count; ++i)
+      {
+        dReal aabb[6];
+        dGeomGetAABB(dSpaceGetGeom(_spaceId, i), aabb);
+
+        bool finite = true;
+        for (unsigned int j = 0; j < 6; ++j)
+          finite = finite && std::isfinite(aabb[j]);
+        if (!finite)
+          continue;
+
+        ignition::math::Vector3d boxMin(aabb[0], aabb[2], aabb[4]);
+        ignition::math::Vector3d boxMax(aabb[1], aabb[3], aabb[5]);
+        if (this->sizes.empty())
+        {
+          this->min = boxMin;
+          this->max = boxMax;
+        }
+        else
+        {
+          this->min.Min(boxMin);
+          this->max.Max(boxMax);
+        }
+        this->sizes.push_back((boxMax - boxMin).Max());
+      }
+      std::sort(this->sizes.begin(), this->sizes.end());
+    }
+
+    /// \brief Get a percentile of the box sizes.
+    /// \param[in] _fraction Percentile in [0, 1].
+    /// \return Largest edge of the box at that percentile, at least 1 mm.
+    public: double Size(const double _fraction) const
+    {
+      if (this->sizes.empty())
+        return 1.0;
+      const size_t index = std::min(this->sizes.size() - 1,
+          static_cast<size_t>(_fraction * this->sizes.size()));
+      return std::max(this->sizes[index], 1e-3);
+    }
+
+    /// \brief Minimum corner of all boxes.
+    public: ignition::math::Vector3d min;
+
+    /// \brief Maximum corner of all boxes.
+    public: ignition::math::Vector3d max;
+
+    /// \brief Largest edge of every box, sorted.
+    public: std::vector<double> sizes;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Create a quadtree space over the x-y extent of a set of boxes,
+  /// with leaf cells about twice the median box size.
+  /// \param[in] _parentId Parent of the new space.
+  /// \param[in] _boxes Boxes to cover.
+  /// \return The new space.
+  dSpaceID CreateQuadTree(dSpaceID _parentId, const SpaceBoxes &_boxes)
+  {
+    // Leave room for moving geoms; geoms outside of the tree are kept in
+    // its root block.
+    const ignition::math::Vector3d center = (_boxes.min + _boxes.max) * 0.5;
+    const ignition::math::Vector3d half =
+        (_boxes.max - _boxes.min) * 0.5 * 1.25 +
+        ignition::math::Vector3d::One * _boxes.Size(0.5);
+
+    // Each level halves the cells, and each level has 4 times the blocks
+    // of its parent, so the depth is capped to bound memory use.
+    const double rootSize = 2.0 * std::max(half.X(), half.Y());
+    const int depth = ignition::math::clamp(static_cast<int>(std::ceil(
+        std::log2(rootSize / (2.0 * _boxes.Size(0.5))))) + 1, 1, 7);
+
+    dVector3 c;
+    dVector3 e;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      c[i] = center[i];
+      e[i] = half[i];
+    }
+    return dQuadTreeSpaceCreate(_parentId, c, e, depth);
+  }
+}
+
 //////////////////////////////////////////////////
 ODEPhysics::ODEPhysics(WorldPtr _world)
     : PhysicsEngine(_world), dataPtr(new ODEPhysicsPrivate)
@@ -140,11 +236,13 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
   dInitODE2(0);
 
   dAllocateODEDataForThread(dAllocateMaskAll);
+  this->dataPtr->rayThreadObserver.reset(new ODERayThreadObserver);
 
   this->dataPtr->worldId = dWorldCreate();
 
   this->dataPtr->spaceId = dHashSpaceCreate(0);
   dHashSpaceSetLevels(this->dataPtr->spaceId, -2, 8);
+  this->dataPtr->staticSpaceId = dSimpleSpaceCreate(this->dataPtr->spaceId);
 
   this->dataPtr->contactGroup = dJointGroupCreate(0);
 
@@ -233,6 +331,25 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
   this->SetStepType(this->dataPtr->stepType);
   if (this->dataPtr->physicsStepFunc == nullptr)
     gzthrow(std::string("Invalid step type[") + this->dataPtr->stepType);
+
+  // The broadphase is not part of the <ode> schema, so it is read from
+  // custom elements, such as <gz:broadphase>sap</gz:broadphase> and
+  // <gz:hash_autotune>true</gz:hash_autotune>.
+  for (sdf::ElementPtr elem = odeElem->GetFirstElement(); elem;
+       elem = elem->GetNextElement())
+  {
+    const std::string name = elem->GetName();
+    auto hasSuffix = [&name](const std::string &_suffix)
+    {
+      return name.size() > _suffix.size() && name.compare(
+          name.size() - _suffix.size(), _suffix.size(), _suffix) == 0;
+    };
+
+    if (hasSuffix(":broadphase"))
+      this->SetBroadphase(elem->Get<std::string>());
+    else if (hasSuffix(":hash_autotune"))
+      this->SetParam("hash_autotune", elem->Get<bool>());
+  }
 }
 
 /////////////////////////////////////////////////
@@ -371,8 +488,14 @@ void ODEPhysics::UpdateCollision()
   // Reset the contact count
   this->contactManager->ResetCount();
 
+  common::Timer broadphaseTimer;
+  broadphaseTimer.Start();
+  this->dataPtr->broadphasePairs = 0;
+  this->TuneBroadphase();
+
   // Do collision detection; this will add contacts to the contact group
   dSpaceCollide(this->dataPtr->spaceId, this, CollisionCallback);
+  this->dataPtr->broadphaseTime = broadphaseTimer.GetElapsed();
   DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
 
   // Generate non-trimesh collisions.
@@ -448,6 +571,9 @@ void ODEPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void ODEPhysics::Fini()
 {
+  this->dataPtr->raySnapshot.reset();
+  this->dataPtr->rayThreadObserver.reset();
+  ODERaySnapshot::ReleaseThreadRay();
   dCloseODE();
 
   if (this->dataPtr->contactGroup)
@@ -462,6 +588,13 @@ void ODEPhysics::Fini()
   }
   this->dataPtr->jointFeedbacks.clear();
 
+  if (this->dataPtr->staticSpaceId)
+  {
+    dSpaceSetCleanup(this->dataPtr->staticSpaceId, 0);
+    dSpaceDestroy(this->dataPtr->staticSpaceId);
+  }
+  this->dataPtr->staticSpaceId = nullptr;
+
   if (this->dataPtr->spaceId)
   {
     dSpaceSetCleanup(this->dataPtr->spaceId, 0);
@@ -483,6 +616,33 @@ void ODEPhysics::Reset()
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
   // Very important to clear out the contact group
   dJointGroupEmpty(this->dataPtr->contactGroup);
+  this->dataPtr->raySnapshot.reset();
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::SaveState(std::string &_buffer) const
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  _buffer.resize(dWorldGetStateSize(this->dataPtr->worldId));
+  dWorldSaveState(this->dataPtr->worldId, &_buffer[0]);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::RestoreState(const std::string &_buffer)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (!dWorldRestoreState(this->dataPtr->worldId, _buffer.data(),
+        _buffer.size()))
+  {
+    return false;
+  }
+
+  // The contacts of the current state are found again by the next
+  // collision pass.
+  dJointGroupEmpty(this->dataPtr->contactGroup);
+  this->dataPtr->raySnapshot.reset();
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -494,9 +654,14 @@ LinkPtr ODEPhysics::CreateLink(ModelPtr _parent)
   std::map<std::string, dSpaceID>::iterator iter;
   iter = this->dataPtr->spaces.find(_parent->GetName());
 
+  // Static models never move, so they are kept apart from the moving
+  // ones.
   if (iter == this->dataPtr->spaces.end())
-    this->dataPtr->spaces[_parent->GetName()] =
-      dSimpleSpaceCreate(this->dataPtr->spaceId);
+  {
+    this->dataPtr->spaces[_parent->GetName()] = dSimpleSpaceCreate(
+        _parent->IsStatic() ? this->dataPtr->staticSpaceId :
+        this->dataPtr->spaceId);
+  }
 
   ODELinkPtr link(new ODELink(_parent));
 
@@ -506,6 +671,30 @@ LinkPtr ODEPhysics::CreateLink(ModelPtr _parent)
   return link;
 }
 
+//////////////////////////////////////////////////
+void ODEPhysics::SetSpaceStatic(dSpaceID _spaceId, const bool _static)
+{
+  if (!_spaceId || !this->dataPtr->staticSpaceId)
+    return;
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  // Only the spaces made by CreateLink are moved; they are direct children
+  // of either space.
+  dSpaceID parent = dGeomGetSpace((dGeomID)_spaceId);
+  dSpaceID target = _static ? this->dataPtr->staticSpaceId :
+      this->dataPtr->spaceId;
+  if (parent == target || (parent != this->dataPtr->spaceId &&
+      parent != this->dataPtr->staticSpaceId))
+  {
+    return;
+  }
+
+  dSpaceRemove(parent, (dGeomID)_spaceId);
+  dSpaceAdd(target, (dGeomID)_spaceId);
+  this->dataPtr->raySnapshot.reset();
+}
+
 //////////////////////////////////////////////////
 CollisionPtr ODEPhysics::CreateCollision(const std::string &_type,
                                          LinkPtr _body)
@@ -901,6 +1090,34 @@ dSpaceID ODEPhysics::GetSpaceId() const
   return this->dataPtr->spaceId;
 }
 
+//////////////////////////////////////////////////
+ODERaySnapshotPtr ODEPhysics::RaySnapshot()
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  // Geoms can be added, moved or removed without advancing the iteration
+  // count, for example by World::RemoveModel after an update, or while the
+  // world is paused. Each of those bumps the generation.
+  const uint64_t iteration = this->world->Iterations();
+  const uint64_t generation = this->dataPtr->geomGeneration;
+  if (!this->dataPtr->raySnapshot ||
+      this->dataPtr->raySnapshot->Iteration() != iteration ||
+      this->dataPtr->raySnapshotGeneration != generation)
+  {
+    this->dataPtr->raySnapshot.reset(
+        new ODERaySnapshot(this->dataPtr->spaceId, iteration));
+    this->dataPtr->raySnapshotGeneration = generation;
+  }
+
+  return this->dataPtr->raySnapshot;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::DirtyRaySnapshot()
+{
+  ++this->dataPtr->geomGeneration;
+}
+
 //////////////////////////////////////////////////
 std::string ODEPhysics::GetStepType() const
 {
@@ -953,6 +1170,8 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
   }
   else
   {
+    ++self->dataPtr->broadphasePairs;
+
     ODECollision *collision1 = nullptr;
     ODECollision *collision2 = nullptr;
 
@@ -997,6 +1216,131 @@ void ODEPhysics::CollisionCallback(void *_data, dGeomID _o1, dGeomID _o2)
 }
 
 
+//////////////////////////////////////////////////
+bool ODEPhysics::SetBroadphase(const std::string &_type)
+{
+  if (_type != "hash" && _type != "sap" && _type != "quadtree" &&
+      _type != "simple")
+  {
+    gzerr << "Invalid broadphase[" << _type << "], expected one of "
+          << "hash, sap, quadtree or simple" << std::endl;
+    return false;
+  }
+
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  if (_type != this->dataPtr->broadphase)
+  {
+    this->dataPtr->broadphase = _type;
+    this->dataPtr->tunedGeomCount = -1;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::TuneBroadphase()
+{
+  // Static geoms don't move, so the static space only needs to follow
+  // additions and removals.
+  const int staticCount = dSpaceGetNumGeoms(this->dataPtr->staticSpaceId);
+  if (staticCount != this->dataPtr->tunedStaticCount)
+  {
+    SpaceBoxes boxes(this->dataPtr->staticSpaceId);
+    if (boxes.sizes.empty())
+    {
+      if (dSpaceGetClass(this->dataPtr->staticSpaceId) != dSimpleSpaceClass)
+      {
+        this->ReplaceSpace(this->dataPtr->staticSpaceId,
+            dSimpleSpaceCreate(this->dataPtr->spaceId));
+      }
+    }
+    else
+    {
+      this->ReplaceSpace(this->dataPtr->staticSpaceId,
+          CreateQuadTree(this->dataPtr->spaceId, boxes));
+    }
+    this->dataPtr->tunedStaticCount = staticCount;
+  }
+
+  // Hash levels are cheap to change, so with hash_autotune they follow
+  // every change in the number of geoms. Otherwise they keep the fixed
+  // levels gazebo always used. The other spaces are rebuilt when the
+  // number of geoms has doubled or halved since they were tuned.
+  const int count = dSpaceGetNumGeoms(this->dataPtr->spaceId);
+  const int tuned = this->dataPtr->tunedGeomCount;
+  const std::string &type = this->dataPtr->broadphase;
+  const bool hashAutoTune = this->dataPtr->hashAutoTune;
+  if (tuned >= 0 && (count == tuned || (type == "hash" && !hashAutoTune) ||
+      (type != "hash" && count < 2 * tuned && 2 * count > tuned)))
+  {
+    return;
+  }
+  this->dataPtr->tunedGeomCount = count;
+
+  if (type == "hash")
+  {
+    if (dSpaceGetClass(this->dataPtr->spaceId) != dHashSpaceClass)
+      this->ReplaceSpace(this->dataPtr->spaceId, dHashSpaceCreate(0));
+
+    if (!hashAutoTune)
+    {
+      dHashSpaceSetLevels(this->dataPtr->spaceId, -2, 8);
+      return;
+    }
+
+    // Cells range from the size of the small geoms to that of the largest
+    // one, so that every geom is hashed into a few cells of one level.
+    SpaceBoxes boxes(this->dataPtr->spaceId);
+    const int minLevel = ignition::math::clamp(
+        static_cast<int>(std::floor(std::log2(boxes.Size(0.1)))), -10, 20);
+    const int maxLevel = ignition::math::clamp(
+        static_cast<int>(std::ceil(std::log2(boxes.Size(1.0)))),
+        minLevel, 20);
+    dHashSpaceSetLevels(this->dataPtr->spaceId, minLevel, maxLevel);
+    return;
+  }
+
+  SpaceBoxes boxes(this->dataPtr->spaceId);
+  if (type == "sap")
+  {
+    // Prune along the axis with the widest spread first.
+    ignition::math::Vector3d spread = boxes.max - boxes.min;
+    int axes[3] = {0, 1, 2};
+    std::sort(axes, axes + 3, [&spread](const int _a, const int _b)
+        {
+          return spread[_a] > spread[_b];
+        });
+    this->ReplaceSpace(this->dataPtr->spaceId, dSweepAndPruneSpaceCreate(0,
+        axes[0] | (axes[1] << 2) | (axes[2] << 4)));
+  }
+  else if (type == "quadtree")
+  {
+    this->ReplaceSpace(this->dataPtr->spaceId, CreateQuadTree(0, boxes));
+  }
+  else if (dSpaceGetClass(this->dataPtr->spaceId) != dSimpleSpaceClass)
+  {
+    this->ReplaceSpace(this->dataPtr->spaceId, dSimpleSpaceCreate(0));
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::ReplaceSpace(dSpaceID &_spaceId, dSpaceID _newSpaceId)
+{
+  std::vector<dGeomID> geoms(dSpaceGetNumGeoms(_spaceId));
+  for (unsigned int i = 0; i < geoms.size(); ++i)
+    geoms[i] = dSpaceGetGeom(_spaceId, i);
+
+  for (auto const geomId : geoms)
+  {
+    dSpaceRemove(_spaceId, geomId);
+    dSpaceAdd(_newSpaceId, geomId);
+  }
+
+  dSpaceSetCleanup(_spaceId, 0);
+  dSpaceDestroy(_spaceId);
+  _spaceId = _newSpaceId;
+  this->dataPtr->raySnapshot.reset();
+}
+
 //////////////////////////////////////////////////
 void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
                          dContactGeom *_contactCollisions)
@@ -1402,7 +1746,14 @@ void ODEPhysics::DebugPrint() const
 /////////////////////////////////////////////////
 void ODEPhysics::SetSeed(uint32_t _seed)
 {
-  dRandSetSeed(_seed);
+  // The seed belongs to the ODE world, so the worlds of a batch don't race
+  // on ODE's global seed.
+  dWorldSetRandSeed(this->dataPtr->worldId, _seed);
+
+  // The world that uses the process seed also seeds ODE's global
+  // generator, which the solvers outside of quickstep still draw from.
+  if (_seed == ignition::math::Rand::Seed())
+    dRandSetSeed(_seed);
 }
 
 //////////////////////////////////////////////////
@@ -1543,6 +1894,20 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       }
       dWorldSetIslandThreads(this->dataPtr->worldId, value);
     }
+    else if (_key == "broadphase")
+    {
+      return this->SetBroadphase(any_cast<std::string>(_value));
+    }
+    else if (_key == "hash_autotune")
+    {
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      const bool autoTune = any_cast<bool>(_value);
+      if (autoTune != this->dataPtr->hashAutoTune)
+      {
+        this->dataPtr->hashAutoTune = autoTune;
+        this->dataPtr->tunedGeomCount = -1;
+      }
+    }
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = any_cast<bool>(_value);
@@ -1652,6 +2017,14 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
+  else if (_key == "broadphase")
+    _value = this->dataPtr->broadphase;
+  else if (_key == "hash_autotune")
+    _value = this->dataPtr->hashAutoTune;
+  else if (_key == "broadphase_pairs")
+    _value = static_cast<int>(this->dataPtr->broadphasePairs);
+  else if (_key == "broadphase_time")
+    _value = this->dataPtr->broadphaseTime.Double();
   else if (_key == "world_step_solver")
     _value = this->GetWorldStepSolverType();
   else
@@ -26,6 +26,7 @@
 
 #include "gazebo/physics/ode/ode_inc.h"
 #include "gazebo/physics/ode/ODETypes.hh"
+#include "gazebo/physics/ode/ODERaySnapshot.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Contact.hh"
 #include "gazebo/physics/Shape.hh"
@@ -108,6 +109,12 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Reset();
 
+      // Documentation inherited
+      public: virtual bool SaveState(std::string &_buffer) const;
+
+      // Documentation inherited
+      public: virtual bool RestoreState(const std::string &_buffer);
+
       // Documentation inherited
       public: virtual void InitForThread();
 
@@ -228,10 +235,31 @@ namespace gazebo
       /// \return The space id for the world.
       public: dSpaceID GetSpaceId() const;
 
+      /// \brief Move the collision space of a model between the world space
+      /// and the static space, after the model was made static or not.
+      /// \param[in] _spaceId Collision space of the model.
+      /// \param[in] _static True if the model is static.
+      public: void SetSpaceStatic(dSpaceID _spaceId, const bool _static);
+
       /// \brief Get the world id.
       /// \return The world id.
       public: dWorldID GetWorldId();
 
+      /// \brief Get a snapshot of the geoms in the world space, for casting
+      /// many rays in parallel. The snapshot is built on the first call of
+      /// each world iteration and shared by all callers in that iteration,
+      /// until a geom is created, moved or destroyed outside of a physics
+      /// update, see DirtyRaySnapshot.
+      /// The physics update mutex must be locked while calling this
+      /// function and while using the snapshot.
+      /// \return Snapshot of the world space.
+      public: ODERaySnapshotPtr RaySnapshot();
+
+      /// \brief Tell the physics engine that a geom was created, moved or
+      /// destroyed outside of a physics update. The next call to RaySnapshot
+      /// builds a new snapshot. Can be called from any thread.
+      public: void DirtyRaySnapshot();
+
       /// \brief Convert an ODE mass to Inertial.
       /// \param[out] _intertial Pointer to an Inertial object.
       /// \param[in] _odeMass Pointer to an ODE mass that will be converted.
@@ -315,6 +343,22 @@ namespace gazebo
       private: void AddCollider(ODECollision *_collision1,
                                 ODECollision *_collision2);
 
+      /// \brief Select the broadphase of the top-level space. The space is
+      /// rebuilt and tuned on the next collision update.
+      /// \param[in] _type One of hash, sap, quadtree or simple.
+      /// \return False if the type is unknown.
+      private: bool SetBroadphase(const std::string &_type);
+
+      /// \brief Tune the top-level space to the bounding boxes of its
+      /// geoms when the number of geoms has changed, and rebuild the
+      /// static space when static geoms were added or removed.
+      private: void TuneBroadphase();
+
+      /// \brief Replace a space by a new one, moving all of its geoms.
+      /// \param[in,out] _spaceId Space to replace, set to _newSpaceId.
+      /// \param[in] _newSpaceId The new space.
+      private: void ReplaceSpace(dSpaceID &_spaceId, dSpaceID _newSpaceId);
+
       /// \internal
       /// \brief Private data pointer.
       private: ODEPhysicsPrivate *dataPtr;
@@ -18,12 +18,16 @@
 #ifndef _ODEPHYSICS_PRIVATE_HH_
 #define _ODEPHYSICS_PRIVATE_HH_
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ode/ODERaySnapshot.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 
 namespace gazebo
@@ -53,6 +57,35 @@ namespace gazebo
       /// \brief Top-level space for all sub-spaces/collisions
       public: dSpaceID spaceId;
 
+      /// \brief Space for the collisions of static models. It is a child
+      /// of the top-level space, so that static geoms are only tested
+      /// against moving geoms. It is rebuilt only when static geoms are
+      /// added or removed.
+      public: dSpaceID staticSpaceId;
+
+      /// \brief Broadphase of the top-level space: hash, sap, quadtree or
+      /// simple.
+      public: std::string broadphase = "hash";
+
+      /// \brief True to tune the levels of the hash space to the geoms.
+      /// Otherwise the levels are fixed to -2 and 8.
+      public: bool hashAutoTune = false;
+
+      /// \brief Number of geoms in the top-level space when the
+      /// broadphase was last tuned, or -1 to tune on the next step.
+      public: int tunedGeomCount = -1;
+
+      /// \brief Number of geoms in the static space when it was last
+      /// rebuilt, or -1 to rebuild on the next step.
+      public: int tunedStaticCount = -1;
+
+      /// \brief Number of geom pairs reported by the broadphase in the
+      /// last step.
+      public: unsigned int broadphasePairs = 0;
+
+      /// \brief Wall time spent in the broadphase in the last step.
+      public: common::Time broadphaseTime;
+
       /// \brief Collision attributes
       public: dJointGroupID contactGroup;
 
@@ -92,6 +125,21 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Geoms of the world space, for batched ray casts. Rebuilt
+      /// once per world iteration, or when geomGeneration changes.
+      public: ODERaySnapshotPtr raySnapshot;
+
+      /// \brief Bumped each time a geom is created, moved or destroyed
+      /// outside of a physics update.
+      public: std::atomic<uint64_t> geomGeneration{0};
+
+      /// \brief Value of geomGeneration when raySnapshot was built.
+      public: uint64_t raySnapshotGeneration = 0;
+
+      /// \brief Releases the ODE data of the threads that cast rays
+      /// against raySnapshot.
+      public: std::unique_ptr<ODERayThreadObserver> rayThreadObserver;
     };
   }
 }
@@ -16,6 +16,10 @@
 */
 
 #include <gtest/gtest.h>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Rand.hh>
 
 #include "gazebo/physics/physics.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
@@ -490,6 +494,215 @@ TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Test that every broadphase finds the same contacts, with static geoms
+/// kept in their own space.
+TEST_F(ODEPhysics_TEST, Broadphase)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+
+  EXPECT_EQ(boost::any_cast<std::string>(odePhysics->GetParam("broadphase")),
+      "hash");
+  EXPECT_FALSE(odePhysics->SetParam("broadphase", std::string("octree")));
+
+  // A static shelf with a box resting on it, and a box on the ground
+  SpawnBox("shelf", ignition::math::Vector3d(2, 2, 1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("box_on_shelf", ignition::math::Vector3d(0.2, 0.2, 0.2),
+      ignition::math::Vector3d(0, 0, 1.1));
+  SpawnBox("box_on_ground", ignition::math::Vector3d(0.2, 0.2, 0.2),
+      ignition::math::Vector3d(5, 0, 0.1));
+
+  ModelPtr onShelf = world->ModelByName("box_on_shelf");
+  ModelPtr onGround = world->ModelByName("box_on_ground");
+  ASSERT_TRUE(onShelf != nullptr);
+  ASSERT_TRUE(onGround != nullptr);
+
+  for (auto const &type : {"hash", "sap", "quadtree", "simple"})
+  {
+    EXPECT_TRUE(odePhysics->SetParam("broadphase", std::string(type)));
+    EXPECT_EQ(boost::any_cast<std::string>(
+          odePhysics->GetParam("broadphase")), type);
+
+    world->Step(200);
+
+    EXPECT_NEAR(onShelf->WorldPose().Pos().Z(), 1.1, 0.01) << type;
+    EXPECT_NEAR(onGround->WorldPose().Pos().Z(), 0.1, 0.01) << type;
+
+    // Both boxes touch a static geom, and the shelf never collides with
+    // the ground.
+    EXPECT_GE(boost::any_cast<int>(
+          odePhysics->GetParam("broadphase_pairs")), 2) << type;
+    EXPECT_GE(boost::any_cast<double>(
+          odePhysics->GetParam("broadphase_time")), 0.0) << type;
+  }
+
+  // The hash levels are fixed unless tuning is requested
+  EXPECT_FALSE(boost::any_cast<bool>(odePhysics->GetParam("hash_autotune")));
+  EXPECT_TRUE(odePhysics->SetParam("broadphase", std::string("hash")));
+  world->Step(1);
+  int minLevel = 0;
+  int maxLevel = 0;
+  dHashSpaceGetLevels(odePhysics->GetSpaceId(), &minLevel, &maxLevel);
+  EXPECT_EQ(minLevel, -2);
+  EXPECT_EQ(maxLevel, 8);
+
+  // The largest geom is the 2 m shelf
+  EXPECT_TRUE(odePhysics->SetParam("hash_autotune", true));
+  EXPECT_TRUE(boost::any_cast<bool>(odePhysics->GetParam("hash_autotune")));
+  world->Step(1);
+  dHashSpaceGetLevels(odePhysics->GetSpaceId(), &minLevel, &maxLevel);
+  EXPECT_LE(minLevel, maxLevel);
+  EXPECT_LT(maxLevel, 8);
+  EXPECT_NEAR(onShelf->WorldPose().Pos().Z(), 1.1, 0.01);
+}
+
+/////////////////////////////////////////////////
+/// Test that the worlds of a batch keep their own ODE random seed, and
+/// leave ODE's global seed alone, while the world that uses the process
+/// seed also seeds ODE's global generator.
+TEST_F(ODEPhysics_TEST, WorldSeed)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto worlds = create_world_batch(world->SDF(), 2, 100);
+  ASSERT_EQ(worlds.size(), 2u);
+  const unsigned long globalSeed = dRandGetSeed();
+
+  std::vector<dWorldID> odeWorlds;
+  for (auto const &batchWorld : worlds)
+  {
+    ODEPhysicsPtr odePhysics =
+        boost::dynamic_pointer_cast<ODEPhysics>(batchWorld->Physics());
+    ASSERT_TRUE(odePhysics != nullptr);
+    odeWorlds.push_back(odePhysics->GetWorldId());
+  }
+
+  EXPECT_EQ(dWorldGetRandSeed(odeWorlds[0]), 100u);
+  EXPECT_EQ(dWorldGetRandSeed(odeWorlds[1]), 101u);
+
+  worlds[0]->SetSeed(7);
+  EXPECT_EQ(dWorldGetRandSeed(odeWorlds[0]), 7u);
+  EXPECT_EQ(dWorldGetRandSeed(odeWorlds[1]), 101u);
+  EXPECT_EQ(dRandGetSeed(), globalSeed);
+
+  // The default world follows the process seed, as with --seed
+  dRandSetSeed(globalSeed + 1);
+  world->SetSeed(ignition::math::Rand::Seed());
+  EXPECT_EQ(dRandGetSeed(), ignition::math::Rand::Seed());
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+  EXPECT_EQ(dWorldGetRandSeed(odePhysics->GetWorldId()),
+      ignition::math::Rand::Seed());
+  EXPECT_EQ(dWorldGetRandSeed(odeWorlds[0]), 7u);
+  EXPECT_EQ(dWorldGetRandSeed(odeWorlds[1]), 101u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Cast a ray against a snapshot.
+/// \param[in] _snapshot Snapshot to cast against.
+/// \param[in] _start Start of the ray.
+/// \param[in] _end End of the ray.
+/// \return Closest hit.
+static ODERayHit CastRay(const ODERaySnapshotPtr &_snapshot,
+    const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end)
+{
+  std::vector<unsigned int> candidates;
+  _snapshot->Overlapping(ignition::math::AxisAlignedBox(
+        _start, _end), candidates);
+
+  ODERayHit hit;
+  dGeomID rayId = ODERaySnapshot::ThreadRay();
+  _snapshot->Cast(rayId, _start, _end, candidates, true, hit);
+  _snapshot->Cast(rayId, _start, _end, candidates, false, hit);
+  return hit;
+}
+
+/////////////////////////////////////////////////
+/// Test that a ray snapshot is rebuilt within an iteration when a model is
+/// moved or deleted, so that rays never hit stale or freed geoms.
+TEST_F(ODEPhysics_TEST, RaySnapshotGeneration)
+{
+  Load("worlds/empty.world", true, "ode");
+  WorldPtr world = get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  ODEPhysicsPtr odePhysics =
+      boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  ASSERT_TRUE(odePhysics != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  // A ray straight down, that stops short of the ground plane
+  const ignition::math::Vector3d start(0, 0, 5);
+  const ignition::math::Vector3d end(0, 0, 0.2);
+  const uint64_t iterations = world->Iterations();
+
+  ODERaySnapshotPtr snapshot;
+  size_t geomCount;
+  {
+    boost::recursive_mutex::scoped_lock lock(
+        *odePhysics->GetPhysicsUpdateMutex());
+    snapshot = odePhysics->RaySnapshot();
+    geomCount = snapshot->GeomCount();
+
+    // Reused while nothing changes
+    EXPECT_EQ(odePhysics->RaySnapshot(), snapshot);
+
+    ODERayHit hit = CastRay(snapshot, start, end);
+    ASSERT_TRUE(hit.collision != nullptr);
+    EXPECT_EQ(hit.collision->GetModel(), box);
+    EXPECT_NEAR(hit.depth, 4.0, 1e-6);
+  }
+
+  // Teleport the box up
+  box->SetWorldPose(ignition::math::Pose3d(0, 0, 1.5, 0, 0, 0));
+  {
+    boost::recursive_mutex::scoped_lock lock(
+        *odePhysics->GetPhysicsUpdateMutex());
+    ODERaySnapshotPtr moved = odePhysics->RaySnapshot();
+    EXPECT_NE(moved, snapshot);
+    EXPECT_EQ(moved->GeomCount(), geomCount);
+
+    ODERayHit hit = CastRay(moved, start, end);
+    ASSERT_TRUE(hit.collision != nullptr);
+    EXPECT_NEAR(hit.depth, 3.0, 1e-6);
+    snapshot = moved;
+  }
+
+  // Delete the box, and cast again
+  box.reset();
+  world->RemoveModel("box");
+  EXPECT_TRUE(world->ModelByName("box") == nullptr);
+  {
+    boost::recursive_mutex::scoped_lock lock(
+        *odePhysics->GetPhysicsUpdateMutex());
+    ODERaySnapshotPtr removed = odePhysics->RaySnapshot();
+    EXPECT_NE(removed, snapshot);
+    EXPECT_LT(removed->GeomCount(), geomCount);
+
+    ODERayHit hit = CastRay(removed, start, end);
+    EXPECT_TRUE(hit.collision == nullptr);
+  }
+
+  // All of the above happened within one iteration
+  EXPECT_EQ(world->Iterations(), iterations);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/ode/ODECollision.hh"
+#include "gazebo/physics/ode/ODERaySnapshot.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+namespace
+{
+  /// \brief Ray geom owned by one thread.
+  class ThreadRayGeom
+  {
+    /// \brief Constructor. Allocates the ODE data of the calling thread,
+    /// which holds the trimesh collider caches.
+    public: ThreadRayGeom()
+    {
+      dAllocateODEDataForThread(dAllocateMaskAll);
+      this->geomId = dCreateRay(0, 1.0);
+      dGeomSetCategoryBits(this->geomId, GZ_SENSOR_COLLIDE);
+      dGeomSetCollideBits(this->geomId, ~GZ_SENSOR_COLLIDE);
+      dGeomRaySetParams(this->geomId, 0, 0);
+      dGeomRaySetClosestHit(this->geomId, 1);
+    }
+
+    /// \brief Destructor.
+    public: ~ThreadRayGeom()
+    {
+      dGeomDestroy(this->geomId);
+    }
+
+    /// \brief The ray geom.
+    public: dGeomID geomId;
+  };
+
+  /////////////////////////////////////////////////
+  /// \brief Slab test of a segment against a box.
+  /// \param[in] _start Segment start.
+  /// \param[in] _invDir Inverse of the segment direction, not normalized.
+  /// \param[in] _box Box to test.
+  /// \return True if the segment touches the box.
+  bool SegmentHitsBox(const ignition::math::Vector3d &_start,
+      const ignition::math::Vector3d &_invDir,
+      const ignition::math::AxisAlignedBox &_box)
+  {
+    double tMin = 0.0;
+    double tMax = 1.0;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      double t1 = (_box.Min()[i] - _start[i]) * _invDir[i];
+      double t2 = (_box.Max()[i] - _start[i]) * _invDir[i];
+      if (t1 > t2)
+        std::swap(t1, t2);
+      // NaN appears for a zero direction on a box face; treat as a hit.
+      if (t1 == t1)
+        tMin = std::max(tMin, t1);
+      if (t2 == t2)
+        tMax = std::min(tMax, t2);
+      if (tMin > tMax)
+        return false;
+    }
+    return true;
+  }
+}
+
+//////////////////////////////////////////////////
+ODERaySnapshot::ODERaySnapshot(dSpaceID _spaceId, const uint64_t _iteration)
+  : iteration(_iteration)
+{
+  this->AddSpace(_spaceId);
+}
+
+//////////////////////////////////////////////////
+ODERaySnapshot::~ODERaySnapshot()
+{
+}
+
+//////////////////////////////////////////////////
+void ODERaySnapshot::AddSpace(dSpaceID _spaceId)
+{
+  const int count = dSpaceGetNumGeoms(_spaceId);
+  for (int i = 0; i < count; ++i)
+  {
+    dGeomID geomId = dSpaceGetGeom(_spaceId, i);
+
+    if (dGeomIsSpace(geomId))
+    {
+      this->AddSpace(reinterpret_cast<dSpaceID>(geomId));
+      continue;
+    }
+
+    // Skip disabled geoms, and geoms that a sensor ray would not collide
+    // with.
+    if (!dGeomIsEnabled(geomId) ||
+        dGeomGetClass(geomId) == dRayClass ||
+        ((dGeomGetCategoryBits(geomId) & ~GZ_SENSOR_COLLIDE) == 0 &&
+         (dGeomGetCollideBits(geomId) & GZ_SENSOR_COLLIDE) == 0))
+    {
+      continue;
+    }
+
+    const int geomClass = dGeomGetClass(geomId);
+    ODECollision *collision = nullptr;
+    if (geomClass == dGeomTransformClass)
+    {
+      collision = static_cast<ODECollision *>(
+          dGeomGetData(dGeomTransformGetGeom(geomId)));
+    }
+    else
+      collision = static_cast<ODECollision *>(dGeomGetData(geomId));
+
+    if (!collision)
+      continue;
+
+    // Computing the bounding box also brings the cached pose of the geom
+    // up to date, after which dCollide only reads from it.
+    dReal aabb[6];
+    dGeomGetAABB(geomId, aabb);
+
+    Entry entry;
+    entry.geomId = geomId;
+    entry.collision = collision;
+    entry.box = ignition::math::AxisAlignedBox(
+        ignition::math::Vector3d(aabb[0], aabb[2], aabb[4]),
+        ignition::math::Vector3d(aabb[1], aabb[3], aabb[5]));
+    entry.threadSafe = geomClass != dHeightfieldClass &&
+        geomClass != dGeomTransformClass;
+
+    this->hasSerialGeoms = this->hasSerialGeoms || !entry.threadSafe;
+    this->entries.push_back(entry);
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t ODERaySnapshot::Iteration() const
+{
+  return this->iteration;
+}
+
+//////////////////////////////////////////////////
+size_t ODERaySnapshot::GeomCount() const
+{
+  return this->entries.size();
+}
+
+//////////////////////////////////////////////////
+bool ODERaySnapshot::HasSerialGeoms() const
+{
+  return this->hasSerialGeoms;
+}
+
+//////////////////////////////////////////////////
+void ODERaySnapshot::Overlapping(const ignition::math::AxisAlignedBox &_box,
+    std::vector<unsigned int> &_candidates) const
+{
+  _candidates.clear();
+  for (unsigned int i = 0; i < this->entries.size(); ++i)
+  {
+    if (this->entries[i].box.Intersects(_box))
+      _candidates.push_back(i);
+  }
+}
+
+//////////////////////////////////////////////////
+void ODERaySnapshot::Cast(dGeomID _rayId,
+    const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end,
+    const std::vector<unsigned int> &_candidates,
+    const bool _threadSafe, ODERayHit &_hit) const
+{
+  ignition::math::Vector3d dir = _end - _start;
+  const double length = dir.Length();
+  if (length <= 0)
+    return;
+
+  const ignition::math::Vector3d invDir(1.0 / dir.X(), 1.0 / dir.Y(),
+      1.0 / dir.Z());
+  dir /= length;
+
+  dGeomRaySet(_rayId, _start.X(), _start.Y(), _start.Z(),
+      dir.X(), dir.Y(), dir.Z());
+  dGeomRaySetLength(_rayId, length);
+
+  dContactGeom contact;
+  for (auto const index : _candidates)
+  {
+    const Entry &entry = this->entries[index];
+    if (entry.threadSafe != _threadSafe ||
+        !SegmentHitsBox(_start, invDir, entry.box))
+    {
+      continue;
+    }
+
+    if (dCollide(_rayId, entry.geomId, 1, &contact, sizeof(contact)) > 0 &&
+        (!_hit.collision || contact.depth < _hit.depth))
+    {
+      _hit.depth = contact.depth;
+      _hit.collision = entry.collision;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Ray geom of the calling thread, created on first use.
+static thread_local std::unique_ptr<ThreadRayGeom> g_threadRay;
+
+//////////////////////////////////////////////////
+dGeomID ODERaySnapshot::ThreadRay()
+{
+  if (!g_threadRay)
+    g_threadRay.reset(new ThreadRayGeom);
+  return g_threadRay->geomId;
+}
+
+//////////////////////////////////////////////////
+void ODERaySnapshot::ReleaseThreadRay()
+{
+  if (!g_threadRay)
+    return;
+
+  g_threadRay.reset();
+  dCleanupODEAllDataForThread();
+}
+
+//////////////////////////////////////////////////
+ODERayThreadObserver::ODERayThreadObserver()
+{
+  this->observe(true);
+}
+
+//////////////////////////////////////////////////
+ODERayThreadObserver::~ODERayThreadObserver()
+{
+  this->observe(false);
+}
+
+//////////////////////////////////////////////////
+void ODERayThreadObserver::on_scheduler_exit(bool /*_isWorker*/)
+{
+  ODERaySnapshot::ReleaseThreadRay();
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODERAYSNAPSHOT_HH_
+#define GAZEBO_PHYSICS_ODE_ODERAYSNAPSHOT_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <tbb/task_scheduler_observer.h>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/physics/ode/ODETypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics_ode
+    /// \{
+
+    /// \brief Closest hit of a ray against a snapshot.
+    class GZ_PHYSICS_VISIBLE ODERayHit
+    {
+      /// \brief Distance from the ray start to the hit.
+      public: double depth = 0;
+
+      /// \brief Collision that was hit, null for no hit.
+      public: ODECollision *collision = nullptr;
+    };
+
+    /// \class ODERaySnapshot ODERaySnapshot.hh physics/physics.hh
+    /// \brief A flat, read-only list of the geoms in an ODE space and their
+    /// axis aligned bounding boxes, used to cast many rays in parallel.
+    ///
+    /// The snapshot is built while holding the physics update mutex, which
+    /// also brings every geom's cached pose and bounding box up to date.
+    /// As long as the mutex stays locked, rays can then be collided
+    /// against the geoms from several threads with dCollide, each thread
+    /// using its own ray geom. Heightfield and transform geoms keep scratch
+    /// state inside the geom during collision; they are kept apart and
+    /// must be tested from a single thread.
+    class GZ_PHYSICS_VISIBLE ODERaySnapshot
+    {
+      /// \brief Build a snapshot of all the geoms in a space, recursing
+      /// into sub-spaces. The physics update mutex must be locked.
+      /// \param[in] _spaceId Top level space.
+      /// \param[in] _iteration World iteration the snapshot is taken at.
+      public: ODERaySnapshot(dSpaceID _spaceId, const uint64_t _iteration);
+
+      /// \brief Destructor.
+      public: virtual ~ODERaySnapshot();
+
+      /// \brief Get the world iteration at which the snapshot was taken.
+      /// \return World iteration.
+      public: uint64_t Iteration() const;
+
+      /// \brief Get the number of geoms in the snapshot.
+      /// \return Number of geoms.
+      public: size_t GeomCount() const;
+
+      /// \brief Find the geoms whose bounding box overlaps a box. Use this
+      /// to prune the geoms once for a group of rays with a common origin.
+      /// \param[in] _box Box to test.
+      /// \param[out] _candidates Indices of overlapping geoms.
+      public: void Overlapping(const ignition::math::AxisAlignedBox &_box,
+                  std::vector<unsigned int> &_candidates) const;
+
+      /// \brief Find the closest hit of a ray against a subset of the
+      /// geoms.
+      /// \param[in] _rayId A ray geom owned by the calling thread. Its
+      /// position, direction and length are set by this function.
+      /// \param[in] _start Start of the ray in world coordinates.
+      /// \param[in] _end End of the ray in world coordinates.
+      /// \param[in] _candidates Indices of geoms to test, see Overlapping.
+      /// \param[in] _threadSafe True to test only the geoms that are safe to
+      /// collide concurrently, false to test only the others.
+      /// \param[in,out] _hit Closest hit. Only replaced by closer hits.
+      public: void Cast(dGeomID _rayId,
+                  const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end,
+                  const std::vector<unsigned int> &_candidates,
+                  const bool _threadSafe, ODERayHit &_hit) const;
+
+      /// \brief Does the snapshot contain geoms that are not safe to
+      /// collide concurrently?
+      /// \return True if a serial pass is required.
+      public: bool HasSerialGeoms() const;
+
+      /// \brief Get a ray geom owned by the calling thread. The geom is
+      /// created on first use, and belongs to no space.
+      /// \return Ray geom of the calling thread.
+      public: static dGeomID ThreadRay();
+
+      /// \brief Destroy the ray geom of the calling thread, if any, and
+      /// release the ODE data allocated for the thread when it was created.
+      public: static void ReleaseThreadRay();
+
+      /// \brief Add the geoms of a space to the snapshot.
+      /// \param[in] _spaceId Space to add.
+      private: void AddSpace(dSpaceID _spaceId);
+
+      /// \brief A geom and its bounding box.
+      private: class Entry
+      {
+        /// \brief The geom.
+        public: dGeomID geomId;
+
+        /// \brief Collision attached to the geom.
+        public: ODECollision *collision;
+
+        /// \brief Bounding box of the geom.
+        public: ignition::math::AxisAlignedBox box;
+
+        /// \brief True if the geom can be collided concurrently.
+        public: bool threadSafe;
+      };
+
+      /// \brief All geoms.
+      private: std::vector<Entry> entries;
+
+      /// \brief World iteration of the snapshot.
+      private: uint64_t iteration;
+
+      /// \brief True if any entry is not thread safe.
+      private: bool hasSerialGeoms = false;
+    };
+
+    /// \brief Shared pointer to a const ODERaySnapshot.
+    typedef std::shared_ptr<const ODERaySnapshot> ODERaySnapshotPtr;
+
+    /// \class ODERayThreadObserver ODERaySnapshot.hh physics/physics.hh
+    /// \brief Releases the ray geom and the ODE data of the TBB threads that
+    /// cast rays against a snapshot, when they leave the task scheduler.
+    class GZ_PHYSICS_VISIBLE ODERayThreadObserver
+      : public tbb::task_scheduler_observer
+    {
+      /// \brief Constructor. Starts observing.
+      public: ODERayThreadObserver();
+
+      /// \brief Destructor. Stops observing.
+      public: virtual ~ODERayThreadObserver();
+
+      // Documentation inherited
+      public: virtual void on_scheduler_exit(bool _isWorker) override;
+    };
+
+    /// \}
+  }
+}
+#endif
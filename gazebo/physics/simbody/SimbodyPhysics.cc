@@ -688,7 +688,7 @@ void SimbodyPhysics::UpdatePhysics()
       auto pose = SimbodyPhysics::Transform2PoseIgn(
         simbodyLink->masterMobod.getBodyTransform(s));
       simbodyLink->SetDirtyPose(pose);
-      this->world->dataPtr->dirtyPoses.push_back(
+      this->world->_AddDirty(
         boost::static_pointer_cast<Entity>(*lx).get());
     }
 
@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "gazebo/msgs/msgs.hh"
 
@@ -94,10 +95,10 @@ namespace gazebo
       /// to publish all contacts generated within a timestep onto
       /// Gazebo topic ~/physics/contacts.
       ///
-      /// Each ContactSensor subscribes to the Gazebo ~/physics/contacts topic,
-      /// retrieves all contact pairs in a time step and filters them wthin
-      /// ContactSensor::OnContacts against <collision> body name
-      /// specified by the ContactSensor SDF.
+      /// Each ContactSensor creates a contact filter for the <collision>
+      /// bodies specified by the ContactSensor SDF, and gets the contacts of
+      /// the filter directly from the ContactManager in
+      /// ContactSensor::OnContacts, once per time step.
       /// All collision pairs between ContactSensor <collision> body and
       /// other bodies in the world are stored in an array inside
       /// contacts.proto.
@@ -133,8 +134,11 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
-      /// \brief Callback for contact messages from the physics engine.
-      private: void OnContacts(ConstContactsPtr &_msg);
+      /// \brief Callback for the contacts of a step from the contact
+      /// manager, called from the physics thread.
+      /// \param[in] _contacts Contacts of the monitored collisions.
+      private: void OnContacts(
+                   const std::vector<const physics::Contact *> &_contacts);
 
       /// \internal
       /// \brief Private data pointer
@@ -25,6 +25,7 @@
 
 #include "gazebo/sensors/GpsSensorPrivate.hh"
 #include "gazebo/sensors/GpsSensor.hh"
+#include "gazebo/sensors/SensorStream.hh"
 
 using namespace gazebo;
 using namespace sensors;
@@ -102,11 +103,18 @@ void GpsSensor::Load(const std::string &_worldName)
       NoiseFactory::NewNoiseModel(
           velElem->GetElement("vertical")->GetElement("noise"));
   }
+
+  this->dataPtr->stream = SensorStream::Join(this->world, this->sdf,
+      this->Id(), this->ScopedName());
 }
 
 /////////////////////////////////////////////////
 void GpsSensor::Fini()
 {
+  if (this->dataPtr->stream)
+    this->dataPtr->stream->Leave(this->Id());
+  this->dataPtr->stream.reset();
+
   Sensor::Fini();
   this->dataPtr->parentLink.reset();
   this->dataPtr->sphericalCoordinates.reset();
@@ -180,7 +188,19 @@ bool GpsSensor::UpdateImpl(const bool /*_force*/)
   msgs::Set(this->dataPtr->lastGpsMsg.mutable_time(),
       this->lastMeasurementTime);
 
-  if (this->dataPtr->gpsPub)
+  // In the stream, the sensor's own topic is only for its subscribers
+  if (this->dataPtr->stream)
+  {
+    const msgs::GPS &msg = this->dataPtr->lastGpsMsg;
+    this->dataPtr->stream->AddGps(this->Id(), this->lastMeasurementTime,
+        ignition::math::Vector3d(
+          msg.latitude_deg(), msg.longitude_deg(), msg.altitude()),
+        ignition::math::Vector3d(
+          msg.velocity_east(), msg.velocity_north(), msg.velocity_up()));
+    if (this->dataPtr->gpsPub && this->dataPtr->gpsPub->HasConnections())
+      this->dataPtr->gpsPub->Publish(msg);
+  }
+  else if (this->dataPtr->gpsPub)
     this->dataPtr->gpsPub->Publish(this->dataPtr->lastGpsMsg);
 
   return true;
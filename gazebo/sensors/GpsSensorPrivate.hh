@@ -22,6 +22,7 @@
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/common/CommonTypes.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/sensors/SensorTypes.hh"
 
 namespace gazebo
 {
@@ -34,6 +35,9 @@ namespace gazebo
       /// \brief GPS data publisher.
       public: transport::PublisherPtr gpsPub;
 
+      /// \brief Aggregated stream of the world, if the sensor joined it.
+      public: SensorStreamPtr stream;
+
       /// \brief Topic name for GPS data publisher.
       public: std::string topicName;
 
@@ -26,6 +26,7 @@
 
 #include "gazebo/sensors/Noise.hh"
 #include "gazebo/sensors/SensorFactory.hh"
+#include "gazebo/sensors/SensorStream.hh"
 #include "gazebo/sensors/ImuSensorPrivate.hh"
 #include "gazebo/sensors/ImuSensor.hh"
 
@@ -213,6 +214,9 @@ void ImuSensor::Load(const std::string &_worldName)
   // given the imu frame is offset from link frame, and link is rotating
   this->dataPtr->lastImuWorldLinearVel =
       this->dataPtr->parentEntity->WorldLinearVel(this->pose.Pos());
+
+  this->dataPtr->stream = SensorStream::Join(this->world, this->sdf,
+      this->Id(), this->ScopedName());
 }
 
 //////////////////////////////////////////////////
@@ -230,6 +234,10 @@ void ImuSensor::Fini()
     this->dataPtr->linkDataSub.reset();
   }
 
+  if (this->dataPtr->stream)
+    this->dataPtr->stream->Leave(this->Id());
+  this->dataPtr->stream.reset();
+
   if (this->dataPtr->parentEntity)
     this->dataPtr->parentEntity->SetPublishData(false);
   this->dataPtr->parentEntity.reset();
@@ -431,8 +439,18 @@ bool ImuSensor::UpdateImpl(const bool /*_force*/)
       }
     }
 
+    // In the stream, the sensor's own topic is only for its subscribers
+    if (this->dataPtr->stream)
+    {
+      this->dataPtr->stream->AddImu(this->Id(), timestamp,
+          msgs::ConvertIgn(this->dataPtr->imuMsg.orientation()),
+          msgs::ConvertIgn(this->dataPtr->imuMsg.angular_velocity()),
+          msgs::ConvertIgn(this->dataPtr->imuMsg.linear_acceleration()));
+      if (this->dataPtr->pub && this->dataPtr->pub->HasConnections())
+        this->dataPtr->pub->Publish(this->dataPtr->imuMsg);
+    }
     // Publish the message
-    if (this->dataPtr->pub)
+    else if (this->dataPtr->pub)
       this->dataPtr->pub->Publish(this->dataPtr->imuMsg);
   }
 
@@ -23,6 +23,7 @@
 #include <ignition/math/Pose3.hh>
 
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
@@ -50,6 +51,9 @@ namespace gazebo
       /// \brief Imu data publisher
       public: transport::PublisherPtr pub;
 
+      /// \brief Aggregated stream of the world, if the sensor joined it.
+      public: SensorStreamPtr stream;
+
       /// \brief Subscriber to link data published by parent entity
       public: transport::SubscriberPtr linkDataSub;
 
@@ -19,6 +19,7 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Model.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/LogicalCameraSensorPrivate.hh"
@@ -57,6 +58,8 @@ void LogicalCameraSensor::Load(const std::string &_worldName,
   // Store parent model's name for use in the UpdateImpl function.
   this->dataPtr->modelName =
     this->dataPtr->parentLink->GetModel()->GetScopedName();
+
+  this->dataPtr->index = this->world->SpatialIdx();
 }
 
 //////////////////////////////////////////////////
@@ -111,28 +114,23 @@ void LogicalCameraSensor::Fini()
 
 //////////////////////////////////////////////////
 void LogicalCameraSensorPrivate::AddVisibleModels(
-    ignition::math::Pose3d &_myPose, const physics::Model_V &_models)
+    const ignition::math::Pose3d &_myPose)
 {
-  for (auto const &model : _models)
+  // The index holds nested models too, so they are found even if the
+  // frustum does not contain their parent model.
+  for (auto const &model :
+       this->index->InFrustum(this->frustum, physics::Base::MODEL))
   {
     auto const &scopedName = model->GetScopedName();
-    auto const aabb = model->BoundingBox();
-
-    if (this->modelName != scopedName && this->frustum.Contains(aabb))
-    {
-      // Add new model msg
-      msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
-
-      // Set the name and pose reported by the sensor.
-      modelMsg->set_name(scopedName);
-      msgs::Set(modelMsg->mutable_pose(),
-          model->WorldPose() - _myPose);
-    }
-    // Check nested models
-    // Note, the model AABB does not necessarily contain the nested model
-    // so nested models must be searched even if the frustum does not contain
-    // the parent model.
-    AddVisibleModels(_myPose, model->NestedModels());
+    if (this->modelName == scopedName)
+      continue;
+
+    // Add new model msg
+    msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
+
+    // Set the name and pose reported by the sensor.
+    modelMsg->set_name(scopedName);
+    msgs::Set(modelMsg->mutable_pose(), model->WorldPose() - _myPose);
   }
 }
 
@@ -155,8 +153,10 @@ bool LogicalCameraSensor::UpdateImpl(const bool _force)
     // Set the camera's pose in the message.
     msgs::Set(this->dataPtr->msg.mutable_pose(), myPose);
 
-    // Recursively check if models and nested models are in the frustum.
-    this->dataPtr->AddVisibleModels(myPose, this->world->Models());
+    // Check if models and nested models are in the frustum. Getting the
+    // index applies the models placed since the last world step.
+    this->dataPtr->index = this->world->SpatialIdx();
+    this->dataPtr->AddVisibleModels(myPose);
 
     // Send the message.
     this->dataPtr->pub->Publish(this->dataPtr->msg);
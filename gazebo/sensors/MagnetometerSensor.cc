@@ -25,6 +25,7 @@
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/MagnetometerSensorPrivate.hh"
 #include "gazebo/sensors/MagnetometerSensor.hh"
+#include "gazebo/sensors/SensorStream.hh"
 
 using namespace gazebo;
 using namespace sensors;
@@ -109,11 +110,18 @@ void MagnetometerSensor::Load(const std::string &_worldName)
             magElem->GetElement("z")->GetElement("noise"));
     }
   }
+
+  this->dataPtr->stream = SensorStream::Join(this->world, this->sdf,
+      this->Id(), this->ScopedName());
 }
 
 /////////////////////////////////////////////////
 void MagnetometerSensor::Fini()
 {
+  if (this->dataPtr->stream)
+    this->dataPtr->stream->Leave(this->Id());
+  this->dataPtr->stream.reset();
+
   Sensor::Fini();
   this->dataPtr->parentLink.reset();
 }
@@ -170,10 +178,19 @@ bool MagnetometerSensor::UpdateImpl(const bool /*_force*/)
   }
 
   // Save the time of the measurement
-  msgs::Set(this->dataPtr->magMsg.mutable_time(), this->world->SimTime());
+  const common::Time simTime = this->world->SimTime();
+  msgs::Set(this->dataPtr->magMsg.mutable_time(), simTime);
 
+  // In the stream, the sensor's own topic is only for its subscribers
+  if (this->dataPtr->stream)
+  {
+    this->dataPtr->stream->AddMagnetometer(this->Id(), simTime,
+        msgs::ConvertIgn(this->dataPtr->magMsg.field_tesla()));
+    if (this->dataPtr->magPub && this->dataPtr->magPub->HasConnections())
+      this->dataPtr->magPub->Publish(this->dataPtr->magMsg);
+  }
   // Publish the message if needed
-  if (this->dataPtr->magPub)
+  else if (this->dataPtr->magPub)
     this->dataPtr->magPub->Publish(this->dataPtr->magMsg);
 
   return true;
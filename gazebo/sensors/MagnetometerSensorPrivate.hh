@@ -21,6 +21,7 @@
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/msgs/msgs.hh"
 
 namespace gazebo
@@ -37,6 +38,9 @@ namespace gazebo
       /// \brief Magnetometer data publisher.
       public: transport::PublisherPtr magPub;
 
+      /// \brief Aggregated stream of the world, if the sensor joined it.
+      public: SensorStreamPtr stream;
+
       /// \brief Parent link of this sensor.
       public: physics::LinkPtr parentLink;
 
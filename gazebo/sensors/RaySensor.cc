@@ -342,12 +342,35 @@ int RaySensor::Fiducial(const unsigned int _index) const
 //////////////////////////////////////////////////
 bool RaySensor::UpdateImpl(const bool /*_force*/)
 {
+  const common::Time simTime = this->world->SimTime();
+
+  // A batch made for this time casts the rays of all its sensors when the
+  // first of them updates.
+  std::shared_ptr<RaySensorBatch> batch;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    batch.swap(this->dataPtr->batch);
+  }
+  if (!batch || batch->simTime != simTime)
+  {
+    batch.reset(new RaySensorBatch);
+    batch->shapes.push_back(this->dataPtr->laserShape);
+    batch->simTime = simTime;
+  }
+
   // do the collision checks
   // this eventually call OnNewScans, so move mutex lock behind it in case
   // need to move mutex lock after this? or make the OnNewLaserScan connection
   // call somewhere else?
-  this->dataPtr->laserShape->Update();
-  this->lastMeasurementTime = this->world->SimTime();
+  {
+    std::lock_guard<std::mutex> lock(batch->mutex);
+    if (!batch->cast)
+    {
+      physics::MultiRayShape::UpdateBatch(batch->shapes);
+      batch->cast = true;
+    }
+  }
+  this->lastMeasurementTime = simTime;
 
   // moving this behind laserShape update
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
@@ -515,3 +538,33 @@ physics::MultiRayShapePtr RaySensor::LaserShape() const
 {
   return this->dataPtr->laserShape;
 }
+
+//////////////////////////////////////////////////
+void RaySensor::ShareBatch(const Sensor_V &_sensors)
+{
+  std::vector<RaySensor *> raySensors;
+  for (auto const &sensor : _sensors)
+  {
+    RaySensor *raySensor = dynamic_cast<RaySensor *>(sensor.get());
+    if (raySensor && raySensor->dataPtr->laserShape &&
+        (raySensors.empty() || raySensor->world == raySensors[0]->world))
+    {
+      raySensors.push_back(raySensor);
+    }
+  }
+
+  // A single sensor casts its own rays
+  if (raySensors.size() < 2)
+    return;
+
+  std::shared_ptr<RaySensorBatch> batch(new RaySensorBatch);
+  batch->simTime = raySensors[0]->world->SimTime();
+  for (auto const raySensor : raySensors)
+    batch->shapes.push_back(raySensor->dataPtr->laserShape);
+
+  for (auto const raySensor : raySensors)
+  {
+    std::lock_guard<std::mutex> lock(raySensor->dataPtr->mutex);
+    raySensor->dataPtr->batch = batch;
+  }
+}
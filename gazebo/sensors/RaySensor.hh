@@ -167,6 +167,17 @@ namespace gazebo
       // Documentation inherited
       public: virtual bool IsActive() const;
 
+      /// \brief Cast the rays of several ray sensors in one batch. The
+      /// first of the sensors to update at the current simulation time
+      /// casts the rays of all of them with
+      /// physics::MultiRayShape::UpdateBatch(), and the others reuse the
+      /// result. The sensor manager calls this for the sensors that are
+      /// due at the same time.
+      /// \param[in] _sensors Sensors about to be updated. Sensors that are
+      /// not ray sensors, or that belong to another world than the first
+      /// ray sensor, are ignored.
+      public: static void ShareBatch(const Sensor_V &_sensors);
+
       /// \internal
       /// \brief Private data pointer.
       private: std::unique_ptr<RaySensorPrivate> dataPtr;
@@ -17,8 +17,11 @@
 #ifndef _GAZEBO_SENSORS_RAYSENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_RAYSENSOR_PRIVATE_HH_
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -27,6 +30,23 @@ namespace gazebo
 {
   namespace sensors
   {
+    /// \internal
+    /// \brief Ray sensors whose rays are cast together.
+    class RaySensorBatch
+    {
+      /// \brief Laser shapes of the sensors.
+      public: std::vector<physics::MultiRayShapePtr> shapes;
+
+      /// \brief Simulation time the batch was made for.
+      public: common::Time simTime;
+
+      /// \brief True once the rays have been cast.
+      public: bool cast = false;
+
+      /// \brief Protects cast, so the rays are cast once.
+      public: std::mutex mutex;
+    };
+
     /// \internal
     /// \brief Ray sensor private data.
     class RaySensorPrivate
@@ -48,6 +68,9 @@ namespace gazebo
 
       /// \brief Laser message.
       public: msgs::LaserScanStamped laserMsg;
+
+      /// \brief Batch this sensor was added to by ShareBatch(), if any.
+      public: std::shared_ptr<RaySensorBatch> batch;
     };
   }
 }
@@ -15,6 +15,9 @@
  *
 */
 
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <ignition/math/Helpers.hh>
 #include <sdf/sdf.hh>
@@ -198,6 +201,94 @@ TEST_F(RaySensor_TEST, LaserScanResolution)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that ray sensors updated in one batch measure the same ranges
+/// as ray sensors updated one at a time
+TEST_F(RaySensor_TEST, BatchMatchesSerial)
+{
+  Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Boxes and a sphere around the origin, for the sensors to see
+  SpawnBox("box_01", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(2, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("box_02", ignition::math::Vector3d(0.5, 2, 1),
+      ignition::math::Vector3d(0, 3, 0.5), ignition::math::Vector3d(0, 0, 0.4),
+      true);
+  SpawnSphere("sphere_01", ignition::math::Vector3d(-2.5, -1, 0.5),
+      ignition::math::Vector3d::Zero, true, true);
+
+  sensors::Sensor_V raySensors;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    std::string modelName = "ray_model_" + std::to_string(i);
+    std::string raySensorName = "ray_sensor_" + std::to_string(i);
+    SpawnRaySensor(modelName, raySensorName,
+        ignition::math::Vector3d(0.2 * i, -0.1 * i, 0.4),
+        ignition::math::Vector3d(0, 0, 1.5 * i),
+        -2.0, 2.0, -0.3, 0.3, 0.08, 10, 0.01, 120, 4);
+
+    sensors::RaySensorPtr sensor =
+      std::dynamic_pointer_cast<sensors::RaySensor>(
+          sensors::get_sensor(raySensorName));
+    ASSERT_TRUE(sensor != nullptr);
+    sensor->SetActive(false);
+    raySensors.push_back(sensor);
+  }
+
+  // Reference: every shape casts its own rays
+  std::vector<std::vector<double>> serialShapeRanges;
+  std::vector<std::vector<double>> serialRanges;
+  unsigned int hits = 0;
+  for (auto const &s : raySensors)
+  {
+    sensors::RaySensorPtr sensor =
+      std::static_pointer_cast<sensors::RaySensor>(s);
+    physics::MultiRayShapePtr shape = sensor->LaserShape();
+    shape->Update();
+
+    std::vector<double> shapeRanges;
+    unsigned int rayCount = sensor->RayCount() * sensor->VerticalRayCount();
+    for (unsigned int i = 0; i < rayCount; ++i)
+    {
+      shapeRanges.push_back(shape->GetRange(i));
+      if (shapeRanges.back() < sensor->RangeMax())
+        ++hits;
+    }
+    serialShapeRanges.push_back(shapeRanges);
+
+    sensor->Update(true);
+    std::vector<double> ranges;
+    sensor->Ranges(ranges);
+    serialRanges.push_back(ranges);
+  }
+  EXPECT_GT(hits, 0u);
+
+  // Batch: the first sensor to update casts the rays of all of them
+  sensors::RaySensor::ShareBatch(raySensors);
+  for (unsigned int s = 0; s < raySensors.size(); ++s)
+  {
+    sensors::RaySensorPtr sensor =
+      std::static_pointer_cast<sensors::RaySensor>(raySensors[s]);
+    sensor->Update(true);
+
+    physics::MultiRayShapePtr shape = sensor->LaserShape();
+    ASSERT_EQ(serialShapeRanges[s].size(),
+        static_cast<size_t>(sensor->RayCount() * sensor->VerticalRayCount()));
+    for (unsigned int i = 0; i < serialShapeRanges[s].size(); ++i)
+      EXPECT_DOUBLE_EQ(shape->GetRange(i), serialShapeRanges[s][i]);
+
+    std::vector<double> ranges;
+    sensor->Ranges(ranges);
+    ASSERT_EQ(ranges.size(), serialRanges[s].size());
+    for (unsigned int i = 0; i < ranges.size(); ++i)
+      EXPECT_DOUBLE_EQ(ranges[i], serialRanges[s][i]);
+  }
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
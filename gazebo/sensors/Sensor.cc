@@ -395,6 +395,15 @@ common::Time Sensor::LastUpdateTime() const
   return this->lastUpdateTime;
 }
 
+//////////////////////////////////////////////////
+common::Time Sensor::NextUpdateTime() const
+{
+  // Matches the check of Sensor::Update
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutexLastUpdateTime);
+  return this->lastUpdateTime + this->updatePeriod -
+      this->dataPtr->updateDelay;
+}
+
 //////////////////////////////////////////////////
 common::Time Sensor::LastMeasurementTime() const
 {
@@ -134,6 +134,12 @@ namespace gazebo
       /// \return Time of last measurement.
       public: common::Time LastMeasurementTime() const;
 
+      /// \brief Get the earliest simulation time at which Update will
+      /// update the sensor, unless forced. This accounts for the delay the
+      /// sensor is catching up on.
+      /// \return Time of the next update.
+      public: common::Time NextUpdateTime() const;
+
       /// \brief Return true if user requests the sensor to be visualized
       ///        via tag:  <visualize>true</visualize> in SDF.
       /// \return True if visualized, false if not.
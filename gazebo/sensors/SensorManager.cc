@@ -16,12 +16,15 @@
 */
 #include <functional>
 #include <boost/bind.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Time.hh"
 
 #include "gazebo/physics/PhysicsIface.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/sensors/RaySensor.hh"
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/sensors/SensorsIface.hh"
 #include "gazebo/sensors/SensorFactory.hh"
@@ -205,6 +208,32 @@ void SensorManager::ResetLastUpdateTimes()
   }
 }
 
+//////////////////////////////////////////////////
+uint64_t SensorManager::SensorOverruns(const std::string &_name) const
+{
+  SensorPtr sensor = this->GetSensor(_name);
+  if (!sensor)
+    return 0;
+
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+  uint64_t overruns = 0;
+  for (auto const &container : this->sensorContainers)
+    overruns += container->scheduler.Overruns(sensor->Id());
+  return overruns;
+}
+
+//////////////////////////////////////////////////
+void SensorManager::SetParallelUpdates(const bool _parallel)
+{
+  this->sensorContainers[sensors::OTHER]->parallel = _parallel;
+}
+
+//////////////////////////////////////////////////
+bool SensorManager::ParallelUpdates() const
+{
+  return this->sensorContainers[sensors::OTHER]->parallel;
+}
+
 //////////////////////////////////////////////////
 void SensorManager::Init()
 {
@@ -457,6 +486,7 @@ void SensorManager::SensorContainer::Fini()
 
   // Remove all the sensors from the current sensor vector.
   this->sensors.clear();
+  this->scheduler.Clear();
 
   this->initialized = false;
 }
@@ -513,39 +543,11 @@ void SensorManager::SensorContainer::RunLoop()
   // Release engine pointer, we don't need it in the loop
   engine.reset();
 
-  common::Time sleepTime, startTime, eventTime, diffTime;
-  double maxUpdateRate = 0;
+  common::Time simTime, lastSimTime, nextTime, diffTime;
 
   boost::mutex tmpMutex;
   boost::mutex::scoped_lock lock2(tmpMutex);
 
-  // Wait for a sensor to be added.
-  // Use a while loop since world resets will notify the runCondition.
-  while (this->sensors.empty())
-  {
-    this->runCondition.wait(lock2);
-    if (this->stop)
-      return;
-  }
-
-  {
-    boost::recursive_mutex::scoped_lock lock(this->mutex);
-
-    // Get the minimum update rate from the sensors.
-    for (Sensor_V::iterator iter = this->sensors.begin();
-        iter != this->sensors.end() && !this->stop; ++iter)
-    {
-      GZ_ASSERT((*iter) != nullptr, "Sensor is null");
-      maxUpdateRate = std::max((*iter)->UpdateRate(), maxUpdateRate);
-    }
-  }
-
-  // Calculate an appropriate sleep time.
-  if (maxUpdateRate > 0)
-    sleepTime.Set(1.0 / (maxUpdateRate));
-  else
-    sleepTime.Set(0, 1e6);
-
   while (!this->stop)
   {
     // If all the sensors get deleted, wait here.
@@ -558,17 +560,21 @@ void SensorManager::SensorContainer::RunLoop()
     }
 
     // Get the start time of the update.
-    startTime = world->SimTime();
+    simTime = world->SimTime();
+
+    // Time went back without a reset, for example when seeking in a log.
+    // Start over, otherwise the sensors would wait for their old update
+    // times.
+    if (simTime < lastSimTime)
+      this->ResetLastUpdateTimes();
+    lastSimTime = simTime;
 
-    this->Update(false);
+    this->UpdateDue(simTime);
 
     // Compute the time it took to update the sensors.
     // It's possible that the world time was reset during the Update. This
     // would case a negative diffTime. Instead, just use a event time of zero
-    diffTime = std::max(common::Time::Zero, world->SimTime() - startTime);
-
-    // Set the default sleep time
-    eventTime = std::max(common::Time::Zero, sleepTime - diffTime);
+    diffTime = std::max(common::Time::Zero, world->SimTime() - simTime);
 
     // Make sure update time is reasonable.
     // During log playback, time can jump forward an arbitrary amount.
@@ -580,19 +586,17 @@ void SensorManager::SensorContainer::RunLoop()
         << "This warning can be ignored during log playback" << std::endl;
     }
 
-    // Make sure eventTime is not negative.
-    if (eventTime < common::Time::Zero)
-    {
-      gzerr << "Time to next sensor update is negative." << std::endl;
+    // Wake up when the next sensor is due. Sensors added or removed
+    // meanwhile notify the runCondition.
+    if (!this->scheduler.NextDue(nextTime))
       continue;
-    }
 
     boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
 
     // Add an event to trigger when the appropriate simulation time has been
     // reached.
-    SensorManager::Instance()->simTimeEventHandler->AddRelativeEvent(
-        eventTime, &this->runCondition);
+    SensorManager::Instance()->simTimeEventHandler->AddEvent(
+        nextTime, &this->runCondition);
 
     // This if statement helps prevent deadlock on osx during teardown.
     if (!this->stop)
@@ -602,6 +606,38 @@ void SensorManager::SensorContainer::RunLoop()
   }
 }
 
+//////////////////////////////////////////////////
+void SensorManager::SensorContainer::UpdateDue(const common::Time &_simTime)
+{
+  boost::recursive_mutex::scoped_lock lock(this->mutex);
+
+  // Only the sensors whose update time has arrived
+  Sensor_V due;
+  this->scheduler.PopDue(_simTime, due);
+  if (due.empty())
+    return;
+
+  // Ray sensors due together cast their rays in one pass
+  RaySensor::ShareBatch(due);
+
+  if (this->parallel && due.size() > 1)
+  {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, due.size(), 1),
+        [&](const tbb::blocked_range<size_t> &_r)
+    {
+      for (size_t i = _r.begin(); i != _r.end(); ++i)
+        due[i]->Update(false);
+    });
+  }
+  else
+  {
+    for (auto &sensor : due)
+      sensor->Update(false);
+  }
+
+  this->scheduler.Requeue(due, _simTime);
+}
+
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::Update(bool _force)
 {
@@ -654,6 +690,8 @@ void SensorManager::SensorContainer::AddSensor(SensorPtr _sensor)
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
     this->sensors.push_back(_sensor);
+    this->scheduler.Add(_sensor, physics::has_world() ?
+        physics::get_world()->SimTime() : common::Time::Zero);
   }
 
   // Tell the run loop that we have received a sensor
@@ -676,6 +714,7 @@ bool SensorManager::SensorContainer::RemoveSensor(const std::string &_name)
 
     if ((*iter)->ScopedName() == _name)
     {
+      this->scheduler.Remove((*iter)->Id());
       (*iter)->Fini();
       this->sensors.erase(iter);
       removed = true;
@@ -699,6 +738,7 @@ void SensorManager::SensorContainer::ResetLastUpdateTimes()
     GZ_ASSERT((*iter) != nullptr, "Sensor is null");
     (*iter)->ResetLastUpdateTime();
   }
+  this->scheduler.Reset();
 
   // Tell the run loop that world time has been reset.
   this->runCondition.notify_one();
@@ -719,6 +759,7 @@ void SensorManager::SensorContainer::RemoveSensors()
   }
 
   this->sensors.clear();
+  this->scheduler.Clear();
 }
 
 //////////////////////////////////////////////////
@@ -748,13 +789,6 @@ SimTimeEventHandler::SimTimeEventHandler()
 /////////////////////////////////////////////////
 SimTimeEventHandler::~SimTimeEventHandler()
 {
-  // Cleanup the events.
-  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
-       iter != this->events.end(); ++iter)
-  {
-    GZ_ASSERT(*iter != nullptr, "SimTimeEvent is null");
-    delete *iter;
-  }
   this->events.clear();
 }
 
@@ -762,18 +796,20 @@ SimTimeEventHandler::~SimTimeEventHandler()
 void SimTimeEventHandler::AddRelativeEvent(const common::Time &_time,
                                            boost::condition_variable *_var)
 {
-  boost::mutex::scoped_lock lock(this->mutex);
-
   physics::WorldPtr world = physics::get_world();
   GZ_ASSERT(world != nullptr, "World pointer is null");
 
-  // Create the new event.
-  SimTimeEvent *event = new SimTimeEvent;
-  event->time = world->SimTime() + _time;
-  event->condition = _var;
+  this->AddEvent(world->SimTime() + _time, _var);
+}
 
-  // Add the event to the list.
-  this->events.push_back(event);
+/////////////////////////////////////////////////
+void SimTimeEventHandler::AddEvent(const common::Time &_time,
+                                   boost::condition_variable *_var)
+{
+  GZ_ASSERT(_var != nullptr, "Condition is null");
+
+  boost::mutex::scoped_lock lock(this->mutex);
+  this->events.emplace(_time, _var);
 }
 
 /////////////////////////////////////////////////
@@ -782,24 +818,13 @@ void SimTimeEventHandler::OnUpdate(const common::UpdateInfo &_info)
   boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
   boost::mutex::scoped_lock lock(this->mutex);
 
-  // Iterate over all the events.
-  for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
-      iter != this->events.end();)
+  // The events are ordered by time, so only the ones with a time less
+  // than or equal to simulation time are visited.
+  auto iter = this->events.begin();
+  for (; iter != this->events.end() && iter->first <= _info.simTime; ++iter)
   {
-    GZ_ASSERT(*iter != nullptr, "SimTimeEvent is null");
-
-    // Find events that have a time less than or equal to simulation
-    // time.
-    if ((*iter)->time <= _info.simTime)
-    {
-      // Notify the event by triggering its condition.
-      (*iter)->condition->notify_all();
-
-      // Remove the event.
-      delete *iter;
-      this->events.erase(iter++);
-    }
-    else
-      ++iter;
+    // Notify the event by triggering its condition.
+    iter->second->notify_all();
   }
+  this->events.erase(this->events.begin(), iter);
 }
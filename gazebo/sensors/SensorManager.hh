@@ -18,6 +18,7 @@
 #define _GAZEBO_SENSORMANAGER_HH_
 
 #include <boost/thread.hpp>
+#include <atomic>
 #include <string>
 #include <vector>
 #include <list>
@@ -29,6 +30,7 @@
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/common/UpdateInfo.hh"
+#include "gazebo/sensors/SensorScheduler.hh"
 #include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/util/system.hh"
 
@@ -70,6 +72,13 @@ namespace gazebo
       public: void AddRelativeEvent(const common::Time &_time,
                   boost::condition_variable *_var);
 
+      /// \brief Add a new event to the handler.
+      /// \param[in] _time Simulation time of the new event.
+      /// \param[in] _var Condition to notify when the time has been
+      /// reached.
+      public: void AddEvent(const common::Time &_time,
+                  boost::condition_variable *_var);
+
       /// \brief Called when the world is updated.
       /// \param[in] _info Update timing information.
       private: void OnUpdate(const common::UpdateInfo &_info);
@@ -77,8 +86,8 @@ namespace gazebo
       /// \brief Mutex to mantain thread safety.
       private: boost::mutex mutex;
 
-      /// \brief The list of events to handle.
-      private: std::list<SimTimeEvent*> events;
+      /// \brief The events to handle, ordered by time.
+      private: std::multimap<common::Time, boost::condition_variable *> events;
 
       /// \brief Connect to the World::UpdateBegin event.
       private: event::ConnectionPtr updateConnection;
@@ -173,6 +182,26 @@ namespace gazebo
       /// \brief Reset last update times in all sensors.
       public: void ResetLastUpdateTimes();
 
+      /// \brief Get the number of times a sensor missed an update because
+      /// it was updated a full period or more late. Rendering sensors,
+      /// which are updated by SensorManager::Update, aren't counted.
+      /// \param[in] _name Name of the sensor.
+      /// \return Number of overruns.
+      public: uint64_t SensorOverruns(const std::string &_name) const;
+
+      /// \brief Set whether the non-rendering, non-ray sensors due at the
+      /// same time are updated in parallel. Off by default, so sensors are
+      /// updated one at a time in the order they are due. Only turn on if
+      /// the sensor plugins of different sensors don't share state without
+      /// locking.
+      /// \param[in] _parallel True to update in parallel.
+      public: void SetParallelUpdates(const bool _parallel);
+
+      /// \brief Get whether sensors due at the same time are updated in
+      /// parallel.
+      /// \return True if in parallel.
+      public: bool ParallelUpdates() const;
+
       /// \brief Add a new sensor to a sensor container.
       /// \param[in] _sensor Pointer to a sensor to add.
       private: void AddSensor(SensorPtr _sensor);
@@ -212,6 +241,11 @@ namespace gazebo
                  /// even if they are not active.
                  public: virtual void Update(bool _force = false);
 
+                 /// \brief Update the sensors whose update time has
+                 /// arrived, in parallel if enabled.
+                 /// \param[in] _simTime Simulation time.
+                 public: void UpdateDue(const common::Time &_simTime);
+
                  /// \brief Add a new sensor to this container.
                  /// \param[in] _sensor Pointer to a sensor to add.
                  public: void AddSensor(SensorPtr _sensor);
@@ -242,6 +276,12 @@ namespace gazebo
                  /// \brief The set of sensors to maintain.
                  public: Sensor_V sensors;
 
+                 /// \brief The sensors ordered by their next update time.
+                 public: SensorScheduler scheduler;
+
+                 /// \brief True to update the due sensors in parallel.
+                 public: std::atomic<bool> parallel{false};
+
                  /// \brief Flag to inidicate when to stop the runThread.
                  private: bool stop;
 
@@ -36,6 +36,13 @@ TEST_F(SensorManager_TEST, InitEmpty)
   sensors::Sensor_V sensors = mgr->GetSensors();
   size_t size = 0;
   EXPECT_EQ(sensors.size(), size);
+
+  // Parallel updates are opt-in
+  EXPECT_FALSE(mgr->ParallelUpdates());
+  mgr->SetParallelUpdates(true);
+  EXPECT_TRUE(mgr->ParallelUpdates());
+  mgr->SetParallelUpdates(false);
+  EXPECT_FALSE(mgr->ParallelUpdates());
 }
 
 /////////////////////////////////////////////////
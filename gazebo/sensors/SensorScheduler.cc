@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/sensors/Sensor.hh"
+#include "gazebo/sensors/SensorScheduler.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \brief Period of the sensors without an update rate.
+    static const common::Time kDefaultPeriod(0, 1000000);
+
+    /// \brief A queued sensor.
+    class ScheduledSensor
+    {
+      /// \brief Update time.
+      public: common::Time due;
+
+      /// \brief Order of insertion, which breaks ties between equal update
+      /// times.
+      public: uint64_t seq;
+
+      /// \brief The sensor.
+      public: SensorPtr sensor;
+    };
+
+    /// \internal
+    /// \brief Private data for the SensorScheduler class
+    class SensorSchedulerPrivate
+    {
+      /// \brief Queue a sensor.
+      /// \param[in] _sensor The sensor.
+      /// \param[in] _due Update time.
+      public: void Push(SensorPtr _sensor, const common::Time &_due);
+
+      /// \brief Heap order, earliest update time on top.
+      /// \param[in] _a First sensor.
+      /// \param[in] _b Second sensor.
+      /// \return True if _a is due after _b.
+      public: static bool Later(const ScheduledSensor &_a,
+                  const ScheduledSensor &_b);
+
+      /// \brief Queued sensors, as a heap.
+      public: std::vector<ScheduledSensor> heap;
+
+      /// \brief Next insertion order.
+      public: uint64_t seq = 0;
+
+      /// \brief Number of overruns, by sensor id.
+      public: std::map<uint32_t, uint64_t> overruns;
+
+      /// \brief Protects the queue and the overruns.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace sensors;
+
+/////////////////////////////////////////////////
+/// \brief Get the period of a sensor.
+/// \param[in] _sensor The sensor.
+/// \return Update period.
+static common::Time period(const SensorPtr &_sensor)
+{
+  const double rate = _sensor->UpdateRate();
+  if (rate > 0)
+    return common::Time(1.0 / rate);
+  return kDefaultPeriod;
+}
+
+/////////////////////////////////////////////////
+void SensorSchedulerPrivate::Push(SensorPtr _sensor, const common::Time &_due)
+{
+  this->heap.push_back(ScheduledSensor{_due, this->seq++, _sensor});
+  std::push_heap(this->heap.begin(), this->heap.end(),
+      SensorSchedulerPrivate::Later);
+}
+
+/////////////////////////////////////////////////
+bool SensorSchedulerPrivate::Later(const ScheduledSensor &_a,
+    const ScheduledSensor &_b)
+{
+  if (_a.due != _b.due)
+    return _a.due > _b.due;
+  return _a.seq > _b.seq;
+}
+
+/////////////////////////////////////////////////
+SensorScheduler::SensorScheduler()
+  : dataPtr(new SensorSchedulerPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+SensorScheduler::~SensorScheduler()
+{
+}
+
+/////////////////////////////////////////////////
+void SensorScheduler::Add(SensorPtr _sensor, const common::Time &_time)
+{
+  GZ_ASSERT(_sensor != nullptr, "Sensor is null");
+
+  // A sensor that was never updated is due at zero, which is long past for
+  // a sensor added to a running simulation
+  const common::Time due = std::max(_sensor->NextUpdateTime(), _time);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->overruns[_sensor->Id()] = 0;
+  this->dataPtr->Push(_sensor, due);
+}
+
+/////////////////////////////////////////////////
+bool SensorScheduler::Remove(const uint32_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->overruns.erase(_id);
+
+  auto &heap = this->dataPtr->heap;
+  auto end = std::remove_if(heap.begin(), heap.end(),
+      [_id](const ScheduledSensor &_s) { return _s.sensor->Id() == _id; });
+  if (end == heap.end())
+    return false;
+
+  heap.erase(end, heap.end());
+  std::make_heap(heap.begin(), heap.end(), SensorSchedulerPrivate::Later);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SensorScheduler::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->heap.clear();
+  this->dataPtr->overruns.clear();
+}
+
+/////////////////////////////////////////////////
+void SensorScheduler::Reset()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto &scheduled : this->dataPtr->heap)
+    scheduled.due = scheduled.sensor->NextUpdateTime();
+  std::make_heap(this->dataPtr->heap.begin(), this->dataPtr->heap.end(),
+      SensorSchedulerPrivate::Later);
+}
+
+/////////////////////////////////////////////////
+size_t SensorScheduler::Size() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->heap.size();
+}
+
+/////////////////////////////////////////////////
+bool SensorScheduler::NextDue(common::Time &_time) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->heap.empty())
+    return false;
+
+  _time = this->dataPtr->heap.front().due;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SensorScheduler::PopDue(const common::Time &_time, Sensor_V &_due)
+{
+  _due.clear();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &heap = this->dataPtr->heap;
+  while (!heap.empty() && heap.front().due <= _time)
+  {
+    std::pop_heap(heap.begin(), heap.end(), SensorSchedulerPrivate::Later);
+    const ScheduledSensor &scheduled = heap.back();
+
+    if (_time - scheduled.due >= period(scheduled.sensor))
+      ++this->dataPtr->overruns[scheduled.sensor->Id()];
+
+    _due.push_back(scheduled.sensor);
+    heap.pop_back();
+  }
+}
+
+/////////////////////////////////////////////////
+void SensorScheduler::Requeue(const Sensor_V &_sensors,
+    const common::Time &_time)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (const auto &sensor : _sensors)
+  {
+    common::Time due = sensor->NextUpdateTime();
+    if (due <= _time)
+      due = _time + period(sensor);
+    this->dataPtr->Push(sensor, due);
+  }
+}
+
+/////////////////////////////////////////////////
+uint64_t SensorScheduler::Overruns(const uint32_t _id) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->overruns.find(_id);
+  return iter == this->dataPtr->overruns.end() ? 0 : iter->second;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_SENSORSCHEDULER_HH_
+#define GAZEBO_SENSORS_SENSORSCHEDULER_HH_
+
+#include <cstdint>
+#include <memory>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/sensors/SensorTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class SensorSchedulerPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class SensorScheduler SensorScheduler.hh sensors/sensors.hh
+    /// \brief Queue of sensors ordered by the simulation time of their next
+    /// update.
+    ///
+    /// PopDue takes the sensors whose update time has arrived, without
+    /// looking at the others, and Requeue puts them back at the time
+    /// Sensor::NextUpdateTime gives once they are updated. A sensor without
+    /// an update rate is due every millisecond. A sensor popped a full
+    /// period or more after its update time has overrun: it missed at
+    /// least one update.
+    class GZ_SENSORS_VISIBLE SensorScheduler
+    {
+      /// \brief Constructor.
+      public: SensorScheduler();
+
+      /// \brief Destructor.
+      public: virtual ~SensorScheduler();
+
+      /// \brief Add a sensor, due at its next update time, or at the
+      /// current time if that has passed. A sensor added after startup
+      /// therefore isn't counted as overrun on its first update.
+      /// \param[in] _sensor The sensor.
+      /// \param[in] _time Current simulation time.
+      public: void Add(SensorPtr _sensor,
+                  const common::Time &_time = common::Time::Zero);
+
+      /// \brief Remove a sensor.
+      /// \param[in] _id Id of the sensor.
+      /// \return True if the sensor was queued.
+      public: bool Remove(const uint32_t _id);
+
+      /// \brief Remove all the sensors.
+      public: void Clear();
+
+      /// \brief Queue the sensors again at their next update times, after
+      /// their last update times were reset.
+      public: void Reset();
+
+      /// \brief Get the number of queued sensors.
+      /// \return Number of sensors.
+      public: size_t Size() const;
+
+      /// \brief Get the earliest update time of the queued sensors.
+      /// \param[out] _time Update time.
+      /// \return False if there are no queued sensors.
+      public: bool NextDue(common::Time &_time) const;
+
+      /// \brief Take the sensors due at a simulation time out of the queue,
+      /// earliest first.
+      /// \param[in] _time Simulation time.
+      /// \param[out] _due The due sensors, to update then Requeue.
+      public: void PopDue(const common::Time &_time, Sensor_V &_due);
+
+      /// \brief Queue sensors taken by PopDue again, at their next update
+      /// times. A sensor whose next update time has already passed, because
+      /// it didn't update, is due one period later.
+      /// \param[in] _sensors The sensors.
+      /// \param[in] _time Simulation time of their update.
+      public: void Requeue(const Sensor_V &_sensors,
+                  const common::Time &_time);
+
+      /// \brief Get the number of overruns of a sensor.
+      /// \param[in] _id Id of the sensor.
+      /// \return Number of overruns, zero for an unknown sensor.
+      public: uint64_t Overruns(const uint32_t _id) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SensorSchedulerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
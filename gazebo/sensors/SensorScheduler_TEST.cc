@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/sensors/AltimeterSensor.hh"
+#include "gazebo/sensors/GpsSensor.hh"
+#include "gazebo/sensors/ImuSensor.hh"
+#include "gazebo/sensors/MagnetometerSensor.hh"
+#include "gazebo/sensors/SensorScheduler.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SensorScheduler_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(SensorScheduler_TEST, Order)
+{
+  sensors::SensorPtr imu(new sensors::ImuSensor());
+  sensors::SensorPtr gps(new sensors::GpsSensor());
+  sensors::SensorPtr altimeter(new sensors::AltimeterSensor());
+  sensors::SensorPtr magnetometer(new sensors::MagnetometerSensor());
+  imu->SetUpdateRate(1000);
+  gps->SetUpdateRate(10);
+  altimeter->SetUpdateRate(30);
+  magnetometer->SetUpdateRate(0);
+
+  sensors::SensorScheduler scheduler;
+  common::Time next;
+  EXPECT_FALSE(scheduler.NextDue(next));
+
+  for (auto sensor : {imu, gps, altimeter, magnetometer})
+    scheduler.Add(sensor);
+  EXPECT_EQ(scheduler.Size(), 4u);
+
+  // Without an update rate, the sensor is due at once
+  ASSERT_TRUE(scheduler.NextDue(next));
+  EXPECT_EQ(next, common::Time::Zero);
+
+  sensors::Sensor_V due;
+  scheduler.PopDue(common::Time::Zero, due);
+  ASSERT_EQ(due.size(), 1u);
+  EXPECT_EQ(due[0], magnetometer);
+  EXPECT_EQ(scheduler.Size(), 3u);
+
+  // Not updated, so due one period later
+  scheduler.Requeue(due, common::Time::Zero);
+  ASSERT_TRUE(scheduler.NextDue(next));
+  EXPECT_EQ(next, common::Time(0, 1000000));
+
+  // Earliest first, ties in order of insertion
+  scheduler.PopDue(common::Time(0, 1000000), due);
+  ASSERT_EQ(due.size(), 2u);
+  EXPECT_EQ(due[0], imu);
+  EXPECT_EQ(due[1], magnetometer);
+  scheduler.Requeue(due, common::Time(0, 1000000));
+
+  // The other sensors aren't touched until due
+  scheduler.PopDue(common::Time(0, 1500000), due);
+  EXPECT_TRUE(due.empty());
+  EXPECT_EQ(scheduler.Size(), 4u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SensorScheduler_TEST, Overruns)
+{
+  sensors::SensorPtr imu(new sensors::ImuSensor());
+  sensors::SensorPtr altimeter(new sensors::AltimeterSensor());
+  sensors::SensorPtr gps(new sensors::GpsSensor());
+  imu->SetUpdateRate(1000);
+  altimeter->SetUpdateRate(30);
+  gps->SetUpdateRate(10);
+
+  sensors::SensorScheduler scheduler;
+  scheduler.Add(imu);
+  scheduler.Add(altimeter);
+  scheduler.Add(gps);
+
+  // The imu is due at 1 ms and the altimeter at 33 ms, so at 50 ms only the
+  // imu missed an update
+  sensors::Sensor_V due;
+  const common::Time late(0.05);
+  scheduler.PopDue(late, due);
+  ASSERT_EQ(due.size(), 2u);
+  EXPECT_EQ(due[0], imu);
+  EXPECT_EQ(due[1], altimeter);
+  EXPECT_EQ(scheduler.Overruns(imu->Id()), 1u);
+  EXPECT_EQ(scheduler.Overruns(altimeter->Id()), 0u);
+  EXPECT_EQ(scheduler.Overruns(gps->Id()), 0u);
+  scheduler.Requeue(due, late);
+
+  // Removed sensors are forgotten
+  EXPECT_TRUE(scheduler.Remove(imu->Id()));
+  EXPECT_FALSE(scheduler.Remove(imu->Id()));
+  EXPECT_EQ(scheduler.Overruns(imu->Id()), 0u);
+  EXPECT_EQ(scheduler.Size(), 2u);
+
+  // Reset queues the sensors at their own update times again
+  scheduler.Reset();
+  common::Time next;
+  ASSERT_TRUE(scheduler.NextDue(next));
+  EXPECT_EQ(next, altimeter->NextUpdateTime());
+
+  scheduler.Clear();
+  EXPECT_EQ(scheduler.Size(), 0u);
+  EXPECT_FALSE(scheduler.NextDue(next));
+
+  // A sensor added late in the simulation was never updated, but is due
+  // at the time it was added, so its first update isn't an overrun
+  const common::Time added(100.0);
+  scheduler.Add(imu, added);
+  ASSERT_TRUE(scheduler.NextDue(next));
+  EXPECT_EQ(next, added);
+  scheduler.PopDue(added + common::Time(0, 500000), due);
+  ASSERT_EQ(due.size(), 1u);
+  EXPECT_EQ(due[0], imu);
+  EXPECT_EQ(scheduler.Overruns(imu->Id()), 0u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
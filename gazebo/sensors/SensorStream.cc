@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/common/Events.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/sensors/SensorStream.hh"
+#include "gazebo/transport/transport.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \brief Packed samples of one kind of sensor.
+    class StreamSamples
+    {
+      /// \brief Add a sample.
+      /// \param[in] _id Id of the sensor.
+      /// \param[in] _stamp Time of the sample.
+      /// \param[in] _values Values of the sample.
+      /// \param[in] _count Number of values.
+      public: void Add(const uint32_t _id, const common::Time &_stamp,
+                  const double *_values, const size_t _count)
+      {
+        this->id.push_back(_id);
+        this->stamp.push_back(_stamp.Double());
+        this->data.insert(this->data.end(), _values, _values + _count);
+      }
+
+      /// \brief Remove the samples, keeping the memory.
+      public: void Clear()
+      {
+        this->id.clear();
+        this->stamp.clear();
+        this->data.clear();
+      }
+
+      /// \brief Sensor id of each sample.
+      public: std::vector<uint32_t> id;
+
+      /// \brief Time of each sample, in seconds.
+      public: std::vector<double> stamp;
+
+      /// \brief Values of the samples, one after the other.
+      public: std::vector<double> data;
+    };
+
+    /// \internal
+    /// \brief Private data for the SensorStream class
+    class SensorStreamPrivate
+    {
+      /// \brief Callback for World Update events.
+      /// \param[in] _info Update information.
+      public: void OnUpdate(const common::UpdateInfo &_info);
+
+      /// \brief Name of the world.
+      public: std::string worldName;
+
+      /// \brief Node for communication.
+      public: transport::NodePtr node;
+
+      /// \brief Publisher of the samples.
+      public: transport::PublisherPtr pub;
+
+      /// \brief Publisher of the layout.
+      public: transport::PublisherPtr layoutPub;
+
+      /// \brief Publication of the layout, to count its subscribers.
+      public: transport::PublicationPtr layoutPublication;
+
+      /// \brief Number of subscribers when the layout was last published.
+      public: unsigned int layoutSubscribers = 0;
+
+      /// \brief Scoped names of the sensors, by id.
+      public: std::map<uint32_t, std::string> sensors;
+
+      /// \brief Version of the layout.
+      public: uint32_t layout = 0;
+
+      /// \brief True if the layout changed since it was published.
+      public: bool layoutChanged = false;
+
+      /// \brief IMU samples.
+      public: StreamSamples imu;
+
+      /// \brief GPS samples.
+      public: StreamSamples gps;
+
+      /// \brief Magnetometer samples.
+      public: StreamSamples magnetometer;
+
+      /// \brief Message reused from one step to the next.
+      public: msgs::SensorStream msg;
+
+      /// \brief Protects the layout and the samples.
+      public: std::mutex mutex;
+
+      /// \brief Connection to World Update events.
+      public: event::ConnectionPtr updateConnection;
+
+      /// \brief Back pointer, for the callback.
+      public: SensorStream *stream = nullptr;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace sensors;
+
+/// \brief Streams by world name.
+static std::map<std::string, std::weak_ptr<SensorStream>> g_streams;
+
+/// \brief Protects g_streams.
+static std::mutex g_streamsMutex;
+
+/////////////////////////////////////////////////
+/// \brief Copy packed values into a repeated field.
+/// \param[in] _values The values.
+/// \param[out] _field The field.
+template<typename T>
+static void copyField(const std::vector<T> &_values,
+    google::protobuf::RepeatedField<T> *_field)
+{
+  _field->Resize(static_cast<int>(_values.size()), T());
+  std::copy(_values.begin(), _values.end(), _field->mutable_data());
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy samples into a message.
+/// \param[in] _samples The samples.
+/// \param[out] _id Field of the ids.
+/// \param[out] _stamp Field of the times.
+/// \param[out] _data Field of the values.
+static void copySamples(const StreamSamples &_samples,
+    google::protobuf::RepeatedField<uint32_t> *_id,
+    google::protobuf::RepeatedField<double> *_stamp,
+    google::protobuf::RepeatedField<double> *_data)
+{
+  copyField(_samples.id, _id);
+  copyField(_samples.stamp, _stamp);
+  copyField(_samples.data, _data);
+}
+
+/////////////////////////////////////////////////
+void SensorStreamPrivate::OnUpdate(const common::UpdateInfo &_info)
+{
+  // The event is shared by all worlds
+  if (_info.worldName == this->worldName)
+    this->stream->Publish(_info.simTime);
+}
+
+/////////////////////////////////////////////////
+SensorStream::SensorStream(physics::WorldPtr _world)
+  : dataPtr(new SensorStreamPrivate)
+{
+  this->dataPtr->stream = this;
+  this->dataPtr->worldName = _world->Name();
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(_world->Name());
+  this->dataPtr->pub =
+    this->dataPtr->node->Advertise<msgs::SensorStream>("~/sensors/stream");
+  this->dataPtr->layoutPub = this->dataPtr->node->Advertise<
+    msgs::SensorStream>("~/sensors/stream/layout");
+  this->dataPtr->layoutPublication =
+    transport::TopicManager::Instance()->FindPublication(
+        this->dataPtr->layoutPub->GetTopic());
+
+  this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&SensorStreamPrivate::OnUpdate, this->dataPtr.get(),
+        std::placeholders::_1));
+}
+
+/////////////////////////////////////////////////
+SensorStream::~SensorStream()
+{
+  this->dataPtr->updateConnection.reset();
+  if (this->dataPtr->node)
+    this->dataPtr->node->Fini();
+}
+
+/////////////////////////////////////////////////
+SensorStreamPtr SensorStream::Join(physics::WorldPtr _world,
+    sdf::ElementPtr _sdf, const uint32_t _id, const std::string &_name)
+{
+  if (!_world || !_sdf)
+    return SensorStreamPtr();
+
+  // The stream is not part of the <sensor> schema, so it is asked for with
+  // a custom element, such as <gz:stream>true</gz:stream>.
+  bool join = false;
+  for (sdf::ElementPtr elem = _sdf->GetFirstElement(); elem;
+       elem = elem->GetNextElement())
+  {
+    const std::string name = elem->GetName();
+    const std::size_t colon = name.find(':');
+    if (colon != std::string::npos && name.substr(colon + 1) == "stream")
+      join = elem->Get<bool>();
+  }
+  if (!join)
+    return SensorStreamPtr();
+
+  SensorStreamPtr stream;
+  {
+    std::lock_guard<std::mutex> lock(g_streamsMutex);
+    stream = g_streams[_world->Name()].lock();
+    if (!stream)
+    {
+      stream.reset(new SensorStream(_world));
+      g_streams[_world->Name()] = stream;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(stream->dataPtr->mutex);
+  stream->dataPtr->sensors[_id] = _name;
+  ++stream->dataPtr->layout;
+  stream->dataPtr->layoutChanged = true;
+  return stream;
+}
+
+/////////////////////////////////////////////////
+void SensorStream::Leave(const uint32_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->sensors.erase(_id) > 0)
+  {
+    ++this->dataPtr->layout;
+    this->dataPtr->layoutChanged = true;
+  }
+}
+
+/////////////////////////////////////////////////
+uint32_t SensorStream::Layout() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->layout;
+}
+
+/////////////////////////////////////////////////
+void SensorStream::AddImu(const uint32_t _id, const common::Time &_stamp,
+    const ignition::math::Quaterniond &_orientation,
+    const ignition::math::Vector3d &_angularVel,
+    const ignition::math::Vector3d &_linearAcc)
+{
+  const double values[10] = {
+    _orientation.W(), _orientation.X(), _orientation.Y(), _orientation.Z(),
+    _angularVel.X(), _angularVel.Y(), _angularVel.Z(),
+    _linearAcc.X(), _linearAcc.Y(), _linearAcc.Z()};
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->imu.Add(_id, _stamp, values, 10);
+}
+
+/////////////////////////////////////////////////
+void SensorStream::AddGps(const uint32_t _id, const common::Time &_stamp,
+    const ignition::math::Vector3d &_position,
+    const ignition::math::Vector3d &_velocity)
+{
+  const double values[6] = {
+    _position.X(), _position.Y(), _position.Z(),
+    _velocity.X(), _velocity.Y(), _velocity.Z()};
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->gps.Add(_id, _stamp, values, 6);
+}
+
+/////////////////////////////////////////////////
+void SensorStream::AddMagnetometer(const uint32_t _id,
+    const common::Time &_stamp, const ignition::math::Vector3d &_field)
+{
+  const double values[3] = {_field.X(), _field.Y(), _field.Z()};
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->magnetometer.Add(_id, _stamp, values, 3);
+}
+
+/////////////////////////////////////////////////
+void SensorStream::Publish(const common::Time &_time)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  msgs::SensorStream &msg = this->dataPtr->msg;
+
+  // Subscribers that connect later get the layout again, whether they
+  // latch or not
+  unsigned int subscribers = 0;
+  if (this->dataPtr->layoutPublication)
+  {
+    subscribers = this->dataPtr->layoutPublication->GetCallbackCount() +
+        this->dataPtr->layoutPublication->GetNodeCount();
+  }
+
+  if (this->dataPtr->layoutChanged ||
+      subscribers != this->dataPtr->layoutSubscribers)
+  {
+    msgs::SensorStream layoutMsg;
+    msgs::Set(layoutMsg.mutable_time(), _time);
+    layoutMsg.set_layout(this->dataPtr->layout);
+    for (auto const &sensor : this->dataPtr->sensors)
+    {
+      layoutMsg.add_sensor_id(sensor.first);
+      layoutMsg.add_sensor_name(sensor.second);
+    }
+    this->dataPtr->layoutPub->Publish(layoutMsg);
+    this->dataPtr->layoutChanged = false;
+    this->dataPtr->layoutSubscribers = subscribers;
+  }
+
+  const bool empty = this->dataPtr->imu.id.empty() &&
+      this->dataPtr->gps.id.empty() && this->dataPtr->magnetometer.id.empty();
+
+  // Nothing is copied for nobody
+  if (!empty && this->dataPtr->pub->HasConnections())
+  {
+    msgs::Set(msg.mutable_time(), _time);
+    msg.set_layout(this->dataPtr->layout);
+    copySamples(this->dataPtr->imu, msg.mutable_imu_id(),
+        msg.mutable_imu_stamp(), msg.mutable_imu_data());
+    copySamples(this->dataPtr->gps, msg.mutable_gps_id(),
+        msg.mutable_gps_stamp(), msg.mutable_gps_data());
+    copySamples(this->dataPtr->magnetometer, msg.mutable_magnetometer_id(),
+        msg.mutable_magnetometer_stamp(), msg.mutable_magnetometer_data());
+    this->dataPtr->pub->Publish(msg);
+  }
+
+  this->dataPtr->imu.Clear();
+  this->dataPtr->gps.Clear();
+  this->dataPtr->magnetometer.Clear();
+}
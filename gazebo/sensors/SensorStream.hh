@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_SENSORSTREAM_HH_
+#define GAZEBO_SENSORS_SENSORSTREAM_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
+#include <sdf/sdf.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/SensorTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class SensorStreamPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class SensorStream SensorStream.hh sensors/sensors.hh
+    /// \brief One stream of the samples of the IMU, GPS and magnetometer
+    /// sensors of a world.
+    ///
+    /// The samples are packed by kind into contiguous buffers, which keep
+    /// their memory from one step to the next, and published as one
+    /// msgs::SensorStream per world step on ~/sensors/stream, only while it
+    /// has subscribers. Large messages go through shared memory to
+    /// subscribers on the same host. The ids and names of the sensors are
+    /// published on ~/sensors/stream/layout when they change, and again
+    /// when a subscriber connects, so late subscribers get the current
+    /// layout at the next step.
+    ///
+    /// A sensor joins the stream with a custom element:
+    ///
+    ///     <sensor name="imu" type="imu">
+    ///       <gz:stream>true</gz:stream>
+    ///       ...
+    ///
+    /// It then publishes on its own topic only while that topic has
+    /// subscribers.
+    class GZ_SENSORS_VISIBLE SensorStream
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World of the sensors.
+      public: explicit SensorStream(physics::WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~SensorStream();
+
+      /// \brief Get the stream of a world if a sensor asks for it, and add
+      /// the sensor to the layout. The stream is created on the first call,
+      /// and lives as long as a sensor holds it.
+      /// \param[in] _world World of the sensor.
+      /// \param[in] _sdf SDF of the sensor.
+      /// \param[in] _id Id of the sensor.
+      /// \param[in] _name Scoped name of the sensor.
+      /// \return The stream, null if the sensor doesn't join it.
+      public: static SensorStreamPtr Join(physics::WorldPtr _world,
+                  sdf::ElementPtr _sdf, const uint32_t _id,
+                  const std::string &_name);
+
+      /// \brief Remove a sensor from the layout.
+      /// \param[in] _id Id of the sensor.
+      public: void Leave(const uint32_t _id);
+
+      /// \brief Get the version of the layout.
+      /// \return Layout version.
+      public: uint32_t Layout() const;
+
+      /// \brief Add an IMU sample.
+      /// \param[in] _id Id of the sensor.
+      /// \param[in] _stamp Time of the sample.
+      /// \param[in] _orientation Orientation.
+      /// \param[in] _angularVel Angular velocity.
+      /// \param[in] _linearAcc Linear acceleration.
+      public: void AddImu(const uint32_t _id, const common::Time &_stamp,
+                  const ignition::math::Quaterniond &_orientation,
+                  const ignition::math::Vector3d &_angularVel,
+                  const ignition::math::Vector3d &_linearAcc);
+
+      /// \brief Add a GPS sample.
+      /// \param[in] _id Id of the sensor.
+      /// \param[in] _stamp Time of the sample.
+      /// \param[in] _position Latitude and longitude in degrees, and
+      /// altitude.
+      /// \param[in] _velocity Velocity east, north and up.
+      public: void AddGps(const uint32_t _id, const common::Time &_stamp,
+                  const ignition::math::Vector3d &_position,
+                  const ignition::math::Vector3d &_velocity);
+
+      /// \brief Add a magnetometer sample.
+      /// \param[in] _id Id of the sensor.
+      /// \param[in] _stamp Time of the sample.
+      /// \param[in] _field Magnetic field, in tesla.
+      public: void AddMagnetometer(const uint32_t _id,
+                  const common::Time &_stamp,
+                  const ignition::math::Vector3d &_field);
+
+      /// \brief Publish the samples added since the last call, and the
+      /// layout if it changed. Called at the beginning of every world
+      /// update.
+      /// \param[in] _time Simulation time.
+      public: void Publish(const common::Time &_time);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SensorStreamPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <mutex>
+
+#include "gazebo/sensors/SensorStream.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class SensorStreamTest : public ServerFixture
+{
+  /// \brief Callback for the stream topic.
+  /// \param[in] _msg Stream message.
+  public: void OnStream(ConstSensorStreamPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stream = *_msg;
+    ++this->streamCount;
+  }
+
+  /// \brief Callback for the layout topic.
+  /// \param[in] _msg Layout message.
+  public: void OnLayout(ConstSensorStreamPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->layout = *_msg;
+    ++this->layoutCount;
+  }
+
+  /// \brief Last stream message.
+  public: msgs::SensorStream stream;
+
+  /// \brief Last layout message.
+  public: msgs::SensorStream layout;
+
+  /// \brief Number of stream messages received.
+  public: int streamCount = 0;
+
+  /// \brief Number of layout messages received.
+  public: int layoutCount = 0;
+
+  /// \brief Protects the messages.
+  public: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+TEST_F(SensorStreamTest, Publish)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Only sensors asking for it join
+  sdf::ElementPtr sensorSdf(new sdf::Element);
+  sensorSdf->SetName("sensor");
+  EXPECT_TRUE(sensors::SensorStream::Join(
+        world, sensorSdf, 7, "default::a::imu") == nullptr);
+
+  sdf::ElementPtr streamElem(new sdf::Element);
+  streamElem->SetName("gz:stream");
+  streamElem->AddValue("bool", "false", true);
+  streamElem->Set(true);
+  sensorSdf->InsertElement(streamElem);
+
+  sensors::SensorStreamPtr stream = sensors::SensorStream::Join(
+      world, sensorSdf, 7, "default::a::imu");
+  ASSERT_TRUE(stream != nullptr);
+  EXPECT_EQ(stream, sensors::SensorStream::Join(
+        world, sensorSdf, 8, "default::a::gps"));
+  EXPECT_EQ(stream->Layout(), 2u);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  transport::SubscriberPtr sub = node->Subscribe("~/sensors/stream",
+      &SensorStreamTest::OnStream, this);
+  transport::SubscriberPtr layoutSub = node->Subscribe(
+      "~/sensors/stream/layout", &SensorStreamTest::OnLayout, this, true);
+
+  // Publish until the subscriber is connected
+  for (int i = 0; i < 100; ++i)
+  {
+    stream->AddImu(7, common::Time(1.0),
+        ignition::math::Quaterniond::Identity,
+        ignition::math::Vector3d(1, 2, 3), ignition::math::Vector3d(4, 5, 6));
+    stream->AddGps(8, common::Time(1.0), ignition::math::Vector3d(7, 8, 9),
+        ignition::math::Vector3d::Zero);
+    stream->Publish(common::Time(2.0));
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->streamCount > 0 && this->layoutCount > 0)
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  ASSERT_GT(this->streamCount, 0);
+  ASSERT_GT(this->layoutCount, 0);
+
+  EXPECT_EQ(this->layout.layout(), 2u);
+  ASSERT_EQ(this->layout.sensor_id_size(), 2);
+  EXPECT_EQ(this->layout.sensor_id(0), 7u);
+  EXPECT_EQ(this->layout.sensor_name(1), "default::a::gps");
+
+  // One sample of each sensor per publication
+  EXPECT_EQ(this->stream.layout(), 2u);
+  ASSERT_EQ(this->stream.imu_id_size(), 1);
+  EXPECT_EQ(this->stream.imu_id(0), 7u);
+  EXPECT_DOUBLE_EQ(this->stream.imu_stamp(0), 1.0);
+  ASSERT_EQ(this->stream.imu_data_size(), 10);
+  EXPECT_DOUBLE_EQ(this->stream.imu_data(0), 1.0);
+  EXPECT_DOUBLE_EQ(this->stream.imu_data(4), 1.0);
+  EXPECT_DOUBLE_EQ(this->stream.imu_data(9), 6.0);
+  ASSERT_EQ(this->stream.gps_data_size(), 6);
+  EXPECT_DOUBLE_EQ(this->stream.gps_data(2), 9.0);
+  EXPECT_EQ(this->stream.magnetometer_id_size(), 0);
+
+  stream->Leave(7);
+  stream->Leave(7);
+  EXPECT_EQ(stream->Layout(), 3u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SensorStreamTest, LateLayoutSubscriber)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  sdf::ElementPtr sensorSdf(new sdf::Element);
+  sensorSdf->SetName("sensor");
+  sdf::ElementPtr streamElem(new sdf::Element);
+  streamElem->SetName("gz:stream");
+  streamElem->AddValue("bool", "false", true);
+  streamElem->Set(true);
+  sensorSdf->InsertElement(streamElem);
+
+  sensors::SensorStreamPtr stream = sensors::SensorStream::Join(
+      world, sensorSdf, 3, "default::b::magnetometer");
+  ASSERT_TRUE(stream != nullptr);
+
+  // The layout is published once, before anybody listens
+  for (int i = 0; i < 10; ++i)
+  {
+    stream->AddMagnetometer(3, common::Time(i * 0.001),
+        ignition::math::Vector3d(1, 2, 3));
+    stream->Publish(common::Time(i * 0.001));
+  }
+
+  // A subscriber that doesn't latch still gets the layout
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  transport::SubscriberPtr sub = node->Subscribe("~/sensors/stream",
+      &SensorStreamTest::OnStream, this);
+  transport::SubscriberPtr layoutSub = node->Subscribe(
+      "~/sensors/stream/layout", &SensorStreamTest::OnLayout, this);
+
+  for (int i = 10; i < 500; ++i)
+  {
+    stream->AddMagnetometer(3, common::Time(i * 0.001),
+        ignition::math::Vector3d(1, 2, 3));
+    stream->Publish(common::Time(i * 0.001));
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->streamCount > 0 && this->layoutCount > 0)
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  ASSERT_GT(this->streamCount, 0);
+  ASSERT_GT(this->layoutCount, 0);
+
+  // The ids of the samples resolve to names through the layout
+  ASSERT_EQ(this->stream.magnetometer_id_size(), 1);
+  EXPECT_EQ(this->stream.layout(), this->layout.layout());
+  ASSERT_EQ(this->layout.sensor_id_size(), 1);
+  EXPECT_EQ(this->layout.sensor_id(0), this->stream.magnetometer_id(0));
+  EXPECT_EQ(this->layout.sensor_name(0), "default::b::magnetometer");
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
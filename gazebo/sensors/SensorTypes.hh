@@ -51,6 +51,8 @@ namespace gazebo
     class GaussianNoiseModel;
     class ImageGaussianNoiseModel;
     class WideAngleCameraSensor;
+    class SensorStream;
+    class WirelessChannel;
     class WirelessTransceiver;
     class WirelessTransmitter;
     class WirelessReceiver;
@@ -131,6 +133,14 @@ namespace gazebo
     typedef std::shared_ptr<ImageGaussianNoiseModel>
         ImageGaussianNoiseModelPtr;
 
+    /// \def SensorStreamPtr
+    /// \brief Shared pointer to SensorStream
+    typedef std::shared_ptr<SensorStream> SensorStreamPtr;
+
+    /// \def WirelessChannelPtr
+    /// \brief Shared pointer to WirelessChannel
+    typedef std::shared_ptr<WirelessChannel> WirelessChannelPtr;
+
     /// \def WirelessTransceiverPtr
     /// \brief Shared pointer to WirelessTransceiver
     typedef std::shared_ptr<WirelessTransceiver> WirelessTransceiverPtr;
@@ -15,6 +15,7 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <functional>
 
 #include <ignition/math/Vector3.hh>
 
@@ -22,6 +23,7 @@
 #include "gazebo/physics/SurfaceParams.hh"
 #include "gazebo/physics/MeshShape.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/Contact.hh"
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/Collision.hh"
 
@@ -191,15 +193,19 @@ void SonarSensor::Load(const std::string &_worldName)
     this->world->Physics()->GetContactManager();
     */
 
-  // Create a contact topic for the collision shape
-  std::string topic =
-    this->world->Physics()->GetContactManager()->CreateFilter(
-        this->dataPtr->sonarCollision->GetScopedName(),
-        this->dataPtr->sonarCollision->GetScopedName());
+  // Create a contact filter for the collision shape
+  physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
+  std::string topic = mgr->CreateFilter(
+      this->dataPtr->sonarCollision->GetScopedName(),
+      this->dataPtr->sonarCollision->GetScopedName());
 
-  // Subscribe to the contact topic
-  this->dataPtr->contactSub = this->node->Subscribe(topic,
-      &SonarSensor::OnContacts, this);
+  // Get the contacts of the filter directly from the contact manager
+  if (!topic.empty())
+  {
+    this->dataPtr->contactsConnection = mgr->ConnectContacts(
+        this->dataPtr->sonarCollision->GetScopedName(),
+        std::bind(&SonarSensor::OnContacts, this, std::placeholders::_1));
+  }
 
   // Advertise the sensor's topic on which we will output range data.
   this->dataPtr->sonarPub = this->node->Advertise<msgs::SonarStamped>(
@@ -236,6 +242,9 @@ void SonarSensor::Init()
 //////////////////////////////////////////////////
 void SonarSensor::Fini()
 {
+  // Disconnect before the filter goes away
+  this->dataPtr->contactsConnection.reset();
+
   if (this->world && this->world->Running())
   {
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
@@ -243,7 +252,6 @@ void SonarSensor::Fini()
   }
 
   this->dataPtr->sonarPub.reset();
-  this->dataPtr->contactSub.reset();
   Sensor::Fini();
 }
 
@@ -309,38 +317,22 @@ bool SonarSensor::UpdateImpl(const bool /*_force*/)
   }
 
 
-  // Iterate over all the contact messages
-  for (auto iter = this->dataPtr->incomingContacts.begin();
-      iter != this->dataPtr->incomingContacts.end(); ++iter)
+  // Iterate over the contact points of all the steps
+  for (auto const &points : this->dataPtr->incomingContacts)
   {
-    // Iterate over all the contacts in the message
-    for (int i = 0; i < (*iter)->contact_size(); ++i)
+    for (auto const &point : points)
     {
-      // Debug output:
-      // std::cout << "C1[" << (*iter)->contact(i).collision1() << "]"
-      //   << "C2[" << (*iter)->contact(i).collision2() << "]\n";
+      // Get the contact position relative to the reference position.
+      pos = point.first - referencePose.Pos();
+
+      // Compute the sensed range.
+      double len = pos.Length() - point.second;
 
-      for (int j = 0; j < (*iter)->contact(i).position_size(); ++j)
+      if (len < this->dataPtr->sonarMsg.sonar().range())
       {
-        // Get the contact position relative to the reference position.
-        pos = msgs::ConvertIgn((*iter)->contact(i).position(j)) -
-          referencePose.Pos();
-
-        // Compute the sensed range.
-        double len = pos.Length() - (*iter)->contact(i).depth(j);
-
-        // Debug output:
-        // std::cout << "  RP[" << referencePose << "]  P[" << pos
-        //   << "] L[" << len << "] D["
-        //   << (*iter)->contact(i).depth(j) << "]\n";
-
-        // Copy the contact message.
-        if (len < this->dataPtr->sonarMsg.sonar().range())
-        {
-          this->dataPtr->sonarMsg.mutable_sonar()->set_range(len);
-          msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
-              referencePose.Rot().RotateVectorReverse(pos));
-        }
+        this->dataPtr->sonarMsg.mutable_sonar()->set_range(len);
+        msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
+            referencePose.Rot().RotateVectorReverse(pos));
       }
     }
   }
@@ -363,15 +355,23 @@ bool SonarSensor::IsActive() const
 }
 
 //////////////////////////////////////////////////
-void SonarSensor::OnContacts(ConstContactsPtr &_msg)
+void SonarSensor::OnContacts(
+    const std::vector<const physics::Contact *> &_contacts)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Only store information if the sensor is active
-  if (this->IsActive() && _msg->contact_size() > 0)
+  if (this->IsActive() && !_contacts.empty())
   {
-    // Store the contacts message for processing in UpdateImpl
-    this->dataPtr->incomingContacts.push_back(_msg);
+    // Store the contact points for processing in UpdateImpl
+    this->dataPtr->incomingContacts.emplace_back();
+    SonarSensorPrivate::ContactPoints_V &points =
+        this->dataPtr->incomingContacts.back();
+    for (auto const contact : _contacts)
+    {
+      for (int j = 0; j < contact->count; ++j)
+        points.emplace_back(contact->positions[j], contact->depths[j]);
+    }
 
     // Prevent the incomingContacts list to grow indefinitely.
     if (this->dataPtr->incomingContacts.size() > 100)
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/util/system.hh"
@@ -98,8 +99,11 @@ namespace gazebo
       // Documentation inherited
       protected: virtual void Fini();
 
-      /// \brief Callback for contact messages from the physics engine.
-      private: void OnContacts(ConstContactsPtr &_msg);
+      /// \brief Callback for the contacts of a step from the contact
+      /// manager, called from the physics thread.
+      /// \param[in] _contacts Contacts of the sonar collision shape.
+      private: void OnContacts(
+                   const std::vector<const physics::Contact *> &_contacts);
 
       /// \internal
       /// \brief Internal data pointer
@@ -19,8 +19,11 @@
 
 #include <list>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include <ignition/math/Pose3.hh>
 
+#include "gazebo/common/Event.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -33,8 +36,10 @@ namespace gazebo
     /// \brief Sonar sensor private data
     class SonarSensorPrivate
     {
-      /// \brief Contact messages list type
-      typedef std::list<boost::shared_ptr<msgs::Contacts const> > ContactMsgs_L;
+      /// \brief Contact points of a step: world position and depth of
+      /// each point.
+      typedef std::vector<std::pair<ignition::math::Vector3d, double> >
+          ContactPoints_V;
 
       /// \brief Update event.
       public: event::EventT<void(msgs::SonarStamped)> update;
@@ -48,8 +53,8 @@ namespace gazebo
       /// \brief Parent entity of this sensor
       public: physics::EntityPtr parentEntity;
 
-      /// \brief Subscription to contact messages from the physics engine
-      public: transport::SubscriberPtr contactSub;
+      /// \brief Connection to the contacts of the sonar collision shape.
+      public: event::ConnectionPtr contactsConnection;
 
       /// \brief Publishes the sonarMsg.
       public: transport::PublisherPtr sonarPub;
@@ -60,8 +65,9 @@ namespace gazebo
       /// \brief Mutex used to protect reading/writing the sonar message.
       public: std::mutex mutex;
 
-      /// \brief List of received contacts from the sonar collision shape.
-      public: ContactMsgs_L incomingContacts;
+      /// \brief Contact points of the sonar collision shape received since
+      /// the last update, one entry per time step with contacts.
+      public: std::list<ContactPoints_V> incomingContacts;
 
       /// \brief Pose of the sonar shape's midpoint.
       public: ignition::math::Pose3d sonarMidPose;
@@ -0,0 +1,464 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include <ignition/math/Line3.hh>
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+
+#include "gazebo/sensors/WirelessReceiver.hh"
+#include "gazebo/sensors/WirelessTransmitter.hh"
+#include "gazebo/sensors/WirelessTransmitterPrivate.hh"
+#include "gazebo/sensors/WirelessChannel.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief State of a transceiver when the links are computed.
+    struct WirelessEndpoint
+    {
+      /// \brief Sensor id.
+      uint32_t id;
+
+      /// \brief Id of the top level model holding the antenna.
+      uint32_t model;
+
+      /// \brief Scoped name of the sensor.
+      std::string name;
+
+      /// \brief World position of the antenna.
+      ignition::math::Vector3d pos;
+
+      /// \brief Antenna gain (dBi).
+      double gain;
+
+      /// \brief Power of a transmitter (dBm).
+      double power;
+
+      /// \brief Frequency of a transmitter (MHz).
+      double freq;
+
+      /// \brief Network name of a transmitter.
+      std::string essid;
+    };
+
+    /// \internal
+    /// \brief Obstruction of a transmitter and receiver pair.
+    struct WirelessObstruction
+    {
+      /// \brief Position of the transmitter.
+      ignition::math::Vector3d txPos;
+
+      /// \brief Position of the receiver.
+      ignition::math::Vector3d rxPos;
+
+      /// \brief Version of the spatial index the result was computed with.
+      uint64_t version;
+
+      /// \brief True if an obstacle is between the pair.
+      bool obstructed;
+    };
+
+    /// \internal
+    /// \brief Private data for WirelessChannel.
+    class WirelessChannelPrivate
+    {
+      /// \brief World of the transceivers.
+      public: physics::WorldPtr world;
+
+      /// \brief Registered transmitters.
+      public: std::vector<WirelessTransmitter *> transmitters;
+
+      /// \brief Registered receivers.
+      public: std::vector<WirelessReceiver *> receivers;
+
+      /// \brief Protects the transmitters and receivers.
+      public: std::mutex sensorsMutex;
+
+      /// \brief Held while the links are computed.
+      public: std::mutex updateMutex;
+
+      /// \brief Simulation time between two computations.
+      public: common::Time period = common::Time(0.1);
+
+      /// \brief Simulation time of the last computation.
+      public: common::Time lastUpdate;
+
+      /// \brief True once the links were computed.
+      public: bool updated = false;
+
+      /// \brief Obstruction of each pair, keyed by the sensor ids of the
+      /// transmitter and the receiver.
+      public: std::unordered_map<uint64_t, WirelessObstruction> cache;
+
+      /// \brief Transmitters of the last computation.
+      public: std::vector<WirelessEndpoint> txs;
+
+      /// \brief Receivers of the last computation.
+      public: std::vector<WirelessEndpoint> rxs;
+
+      /// \brief Signal levels of the last computation, one row of
+      /// receivers per transmitter.
+      public: std::vector<double> levels;
+
+      /// \brief Obstruction of each pair of the last computation.
+      public: std::vector<char> obstructed;
+
+      /// \brief Protects the last computation.
+      public: mutable std::shared_mutex resultsMutex;
+
+      /// \brief Node for publishing the links.
+      public: transport::NodePtr node;
+
+      /// \brief Publisher of the links.
+      public: transport::PublisherPtr linksPub;
+    };
+  }
+}
+
+/// \brief Channels by world name.
+static std::map<std::string, std::weak_ptr<WirelessChannel>> g_channels;
+
+/// \brief Protects g_channels.
+static std::mutex g_channelsMutex;
+
+/////////////////////////////////////////////////
+/// \brief Check for an obstacle on a segment.
+/// \param[in] _index Spatial index of the world.
+/// \param[in] _start Start of the segment.
+/// \param[in] _end End of the segment.
+/// \param[in] _ignoreA Id of a model that isn't an obstacle.
+/// \param[in] _ignoreB Id of another model that isn't an obstacle.
+/// \return True if a link of another model is on the segment.
+static bool blocked(const physics::SpatialIndexPtr &_index,
+    const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end,
+    const uint32_t _ignoreA, const uint32_t _ignoreB)
+{
+  for (auto const &entity : _index->OnSegment(
+        ignition::math::Line3d(_start, _end), physics::Base::LINK))
+  {
+    physics::ModelPtr model = entity->GetParentModel();
+    if (model && model->GetId() != _ignoreA && model->GetId() != _ignoreB)
+      return true;
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+WirelessChannel::WirelessChannel(physics::WorldPtr _world)
+  : dataPtr(new WirelessChannelPrivate)
+{
+  this->dataPtr->world = _world;
+
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(_world->Name());
+  this->dataPtr->linksPub =
+    this->dataPtr->node->Advertise<msgs::WirelessLinks>("~/wireless/links");
+}
+
+/////////////////////////////////////////////////
+WirelessChannel::~WirelessChannel()
+{
+  this->dataPtr->linksPub.reset();
+  if (this->dataPtr->node)
+    this->dataPtr->node->Fini();
+}
+
+/////////////////////////////////////////////////
+WirelessChannelPtr WirelessChannel::Get(physics::WorldPtr _world)
+{
+  if (!_world)
+    return WirelessChannelPtr();
+
+  std::lock_guard<std::mutex> lock(g_channelsMutex);
+  WirelessChannelPtr channel = g_channels[_world->Name()].lock();
+  if (!channel)
+  {
+    channel.reset(new WirelessChannel(_world));
+    g_channels[_world->Name()] = channel;
+  }
+  return channel;
+}
+
+/////////////////////////////////////////////////
+void WirelessChannel::AddTransmitter(WirelessTransmitter *_transmitter)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->sensorsMutex);
+  auto &txs = this->dataPtr->transmitters;
+  if (std::find(txs.begin(), txs.end(), _transmitter) == txs.end())
+    txs.push_back(_transmitter);
+}
+
+/////////////////////////////////////////////////
+void WirelessChannel::AddReceiver(WirelessReceiver *_receiver)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->sensorsMutex);
+  auto &rxs = this->dataPtr->receivers;
+  if (std::find(rxs.begin(), rxs.end(), _receiver) == rxs.end())
+    rxs.push_back(_receiver);
+}
+
+/////////////////////////////////////////////////
+void WirelessChannel::Remove(const WirelessTransceiver *_transceiver)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->sensorsMutex);
+  auto &txs = this->dataPtr->transmitters;
+  txs.erase(std::remove(txs.begin(), txs.end(), _transceiver), txs.end());
+  auto &rxs = this->dataPtr->receivers;
+  rxs.erase(std::remove(rxs.begin(), rxs.end(), _transceiver), rxs.end());
+}
+
+/////////////////////////////////////////////////
+common::Time WirelessChannel::UpdatePeriod() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
+  return this->dataPtr->period;
+}
+
+/////////////////////////////////////////////////
+void WirelessChannel::SetUpdatePeriod(const common::Time &_period)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
+  this->dataPtr->period = _period;
+}
+
+/////////////////////////////////////////////////
+bool WirelessChannel::Update(const bool _force)
+{
+  // Another transceiver is computing the links
+  std::unique_lock<std::mutex> lock(this->dataPtr->updateMutex,
+      std::try_to_lock);
+  if (!lock.owns_lock())
+    return false;
+
+  const common::Time simTime = this->dataPtr->world->SimTime();
+  if (!_force && this->dataPtr->updated &&
+      simTime >= this->dataPtr->lastUpdate &&
+      simTime - this->dataPtr->lastUpdate < this->dataPtr->period)
+  {
+    return false;
+  }
+  this->dataPtr->lastUpdate = simTime;
+  this->dataPtr->updated = true;
+
+  // Take the state of the transceivers
+  std::vector<WirelessEndpoint> txs;
+  std::vector<WirelessEndpoint> rxs;
+  {
+    std::lock_guard<std::mutex> slock(this->dataPtr->sensorsMutex);
+    for (auto const tx : this->dataPtr->transmitters)
+    {
+      txs.push_back({tx->Id(), tx->ParentModelId(), tx->ScopedName(),
+          tx->AntennaPose().Pos(), tx->Gain(), tx->Power(), tx->Freq(),
+          tx->ESSID()});
+    }
+    for (auto const rx : this->dataPtr->receivers)
+    {
+      rxs.push_back({rx->Id(), rx->ParentModelId(), rx->ScopedName(),
+          rx->AntennaPose().Pos(), rx->Gain(), rx->Power(), 0.0, ""});
+    }
+  }
+
+  physics::SpatialIndexPtr index = this->dataPtr->world->SpatialIdx();
+  const uint64_t version = index->Version();
+  const std::size_t pairs = txs.size() * rxs.size();
+
+  // Reuse the obstruction of the pairs that didn't move
+  std::vector<char> obstructed(pairs, 0);
+  std::vector<std::size_t> pending;
+  std::unordered_map<uint64_t, WirelessObstruction> cache;
+  cache.reserve(pairs);
+  for (std::size_t i = 0; i < txs.size(); ++i)
+  {
+    for (std::size_t j = 0; j < rxs.size(); ++j)
+    {
+      const std::size_t k = i * rxs.size() + j;
+      const uint64_t key =
+        (static_cast<uint64_t>(txs[i].id) << 32) | rxs[j].id;
+      auto iter = this->dataPtr->cache.find(key);
+      if (iter != this->dataPtr->cache.end() &&
+          iter->second.version == version &&
+          iter->second.txPos.Equal(txs[i].pos, 1e-3) &&
+          iter->second.rxPos.Equal(rxs[j].pos, 1e-3))
+      {
+        obstructed[k] = iter->second.obstructed;
+        cache[key] = iter->second;
+      }
+      else
+      {
+        pending.push_back(k);
+      }
+    }
+  }
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, pending.size(), 16),
+      [&](const tbb::blocked_range<std::size_t> &_r)
+  {
+    for (std::size_t p = _r.begin(); p != _r.end(); ++p)
+    {
+      const WirelessEndpoint &tx = txs[pending[p] / rxs.size()];
+      const WirelessEndpoint &rx = rxs[pending[p] % rxs.size()];
+      obstructed[pending[p]] =
+        blocked(index, tx.pos, rx.pos, tx.model, rx.model);
+    }
+  });
+
+  for (auto const k : pending)
+  {
+    const WirelessEndpoint &tx = txs[k / rxs.size()];
+    const WirelessEndpoint &rx = rxs[k % rxs.size()];
+    cache[(static_cast<uint64_t>(tx.id) << 32) | rx.id] =
+      {tx.pos, rx.pos, version, obstructed[k] != 0};
+  }
+  this->dataPtr->cache.swap(cache);
+
+  // The random fading is drawn in order, since the generator is shared
+  std::vector<double> levels(pairs);
+  for (std::size_t k = 0; k < pairs; ++k)
+  {
+    const WirelessEndpoint &tx = txs[k / rxs.size()];
+    const WirelessEndpoint &rx = rxs[k % rxs.size()];
+    const double fading = std::abs(ignition::math::Rand::DblNormal(0.0,
+          WirelessTransmitterPrivate::ModelStdDev));
+    levels[k] = ReceivedPower(tx.power, tx.gain, rx.gain, tx.freq,
+        tx.pos.Distance(rx.pos), obstructed[k] != 0, fading);
+  }
+
+  if (this->dataPtr->linksPub && this->dataPtr->linksPub->HasConnections())
+  {
+    msgs::WirelessLinks msg;
+    msgs::Set(msg.mutable_time(), simTime);
+    for (auto const &tx : txs)
+      msg.add_transmitter(tx.name);
+    for (auto const &rx : rxs)
+      msg.add_receiver(rx.name);
+    msg.mutable_signal_level()->Reserve(static_cast<int>(pairs));
+    msg.mutable_obstructed()->Reserve(static_cast<int>(pairs));
+    for (std::size_t k = 0; k < pairs; ++k)
+    {
+      msg.add_signal_level(levels[k]);
+      msg.add_obstructed(obstructed[k] != 0);
+    }
+    this->dataPtr->linksPub->Publish(msg);
+  }
+
+  std::unique_lock<std::shared_mutex> rlock(this->dataPtr->resultsMutex);
+  this->dataPtr->txs.swap(txs);
+  this->dataPtr->rxs.swap(rxs);
+  this->dataPtr->levels.swap(levels);
+  this->dataPtr->obstructed.swap(obstructed);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WirelessChannel::Signals(const uint32_t _receiverId,
+    msgs::WirelessNodes &_nodes) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->resultsMutex);
+
+  const auto &rxs = this->dataPtr->rxs;
+  auto rx = std::find_if(rxs.begin(), rxs.end(),
+      [&](const WirelessEndpoint &_rx) {return _rx.id == _receiverId;});
+  if (rx == rxs.end())
+    return false;
+
+  const std::size_t j = rx - rxs.begin();
+  for (std::size_t i = 0; i < this->dataPtr->txs.size(); ++i)
+  {
+    const WirelessEndpoint &tx = this->dataPtr->txs[i];
+    msgs::WirelessNode *node = _nodes.add_node();
+    node->set_essid(tx.essid);
+    node->set_frequency(tx.freq);
+    node->set_signal_level(this->dataPtr->levels[i * rxs.size() + j]);
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool WirelessChannel::SignalLevel(const uint32_t _transmitterId,
+    const uint32_t _receiverId, double &_level) const
+{
+  std::shared_lock<std::shared_mutex> lock(this->dataPtr->resultsMutex);
+
+  const auto &txs = this->dataPtr->txs;
+  const auto &rxs = this->dataPtr->rxs;
+  auto tx = std::find_if(txs.begin(), txs.end(),
+      [&](const WirelessEndpoint &_tx) {return _tx.id == _transmitterId;});
+  auto rx = std::find_if(rxs.begin(), rxs.end(),
+      [&](const WirelessEndpoint &_rx) {return _rx.id == _receiverId;});
+  if (tx == txs.end() || rx == rxs.end())
+    return false;
+
+  _level = this->dataPtr->levels[
+    (tx - txs.begin()) * rxs.size() + (rx - rxs.begin())];
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::vector<bool> WirelessChannel::Obstructed(
+    const ignition::math::Vector3d &_start,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    const uint32_t _ignoreModel) const
+{
+  physics::SpatialIndexPtr index = this->dataPtr->world->SpatialIdx();
+
+  // std::vector<bool> can't be written from several threads
+  std::vector<char> hits(_ends.size(), 0);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, _ends.size(), 16),
+      [&](const tbb::blocked_range<std::size_t> &_r)
+  {
+    for (std::size_t i = _r.begin(); i != _r.end(); ++i)
+      hits[i] = blocked(index, _start, _ends[i], _ignoreModel, _ignoreModel);
+  });
+
+  return std::vector<bool>(hits.begin(), hits.end());
+}
+
+/////////////////////////////////////////////////
+double WirelessChannel::ReceivedPower(const double _power,
+    const double _txGain, const double _rxGain, const double _freq,
+    const double _distance, const bool _obstructed, const double _fading)
+{
+  const double n = _obstructed ? WirelessTransmitterPrivate::NObstacle :
+    WirelessTransmitterPrivate::NEmpty;
+  const double distance = std::max(1.0, _distance);
+  const double wavelength = common::SpeedOfLight / (_freq * 1000000);
+
+  return _power + _txGain + _rxGain - _fading +
+      20 * log10(wavelength) - 20 * log10(4 * M_PI) -
+      10 * n * log10(distance);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_WIRELESSCHANNEL_HH_
+#define GAZEBO_SENSORS_WIRELESSCHANNEL_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/SensorTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class WirelessChannelPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class WirelessChannel WirelessChannel.hh sensors/sensors.hh
+    /// \brief Radio links between the wireless transmitters and receivers
+    /// of a world.
+    ///
+    /// The channel computes the received signal level of every
+    /// transmitter at every receiver at once, once per update period of
+    /// simulation time. Obstacles are found with the bounding boxes of
+    /// the world's spatial index (physics::World::SpatialIdx), tested in
+    /// parallel and without the physics lock. The models holding the
+    /// transmitter and the receiver are not obstacles. The obstruction of
+    /// a pair is reused while neither end moved and nothing moved in the
+    /// index.
+    ///
+    /// The links are published on ~/wireless/links as msgs::WirelessLinks.
+    class GZ_SENSORS_VISIBLE WirelessChannel
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World of the transceivers.
+      public: explicit WirelessChannel(physics::WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~WirelessChannel();
+
+      /// \brief Get the channel of a world. It is created on the first
+      /// call, and lives as long as a transceiver holds it.
+      /// \param[in] _world The world.
+      /// \return The channel.
+      public: static WirelessChannelPtr Get(physics::WorldPtr _world);
+
+      /// \brief Add a transmitter.
+      /// \param[in] _transmitter Transmitter, which must be removed before
+      /// it is destroyed.
+      public: void AddTransmitter(WirelessTransmitter *_transmitter);
+
+      /// \brief Add a receiver.
+      /// \param[in] _receiver Receiver, which must be removed before it is
+      /// destroyed.
+      public: void AddReceiver(WirelessReceiver *_receiver);
+
+      /// \brief Remove a transmitter or a receiver.
+      /// \param[in] _transceiver The transceiver.
+      public: void Remove(const WirelessTransceiver *_transceiver);
+
+      /// \brief Get the simulation time between two computations of the
+      /// links.
+      /// \return Update period.
+      public: common::Time UpdatePeriod() const;
+
+      /// \brief Set the simulation time between two computations of the
+      /// links. The default is 0.1 s.
+      /// \param[in] _period Update period.
+      public: void SetUpdatePeriod(const common::Time &_period);
+
+      /// \brief Compute the links if the update period elapsed. Called by
+      /// the transceivers from their own update; when several call it at
+      /// once, one computes and the others use the previous links.
+      /// \param[in] _force Compute the links even if the period didn't
+      /// elapse.
+      /// \return True if the links were computed.
+      public: bool Update(const bool _force = false);
+
+      /// \brief Get the signal of every transmitter at a receiver, from the
+      /// last computation of the links.
+      /// \param[in] _receiverId Sensor id of the receiver.
+      /// \param[out] _nodes One node per transmitter, with its essid,
+      /// frequency and signal level.
+      /// \return False if the receiver isn't in the last computation.
+      public: bool Signals(const uint32_t _receiverId,
+                  msgs::WirelessNodes &_nodes) const;
+
+      /// \brief Get the signal level of a transmitter at a receiver, from
+      /// the last computation of the links.
+      /// \param[in] _transmitterId Sensor id of the transmitter.
+      /// \param[in] _receiverId Sensor id of the receiver.
+      /// \param[out] _level Signal level (dBm).
+      /// \return False if the pair isn't in the last computation.
+      public: bool SignalLevel(const uint32_t _transmitterId,
+                  const uint32_t _receiverId, double &_level) const;
+
+      /// \brief Check for obstacles between a point and other points, in
+      /// parallel.
+      /// \param[in] _start Start of the segments.
+      /// \param[in] _ends End of each segment.
+      /// \param[in] _ignoreModel Id of a model, such as the one holding
+      /// the antenna, that is not an obstacle.
+      /// \return True for each segment crossing an obstacle.
+      public: std::vector<bool> Obstructed(
+                  const ignition::math::Vector3d &_start,
+                  const std::vector<ignition::math::Vector3d> &_ends,
+                  const uint32_t _ignoreModel) const;
+
+      /// \brief Received power, with the Hata-Okumura propagation model.
+      /// \param[in] _power Transmitter power (dBm).
+      /// \param[in] _txGain Transmitter gain (dBi).
+      /// \param[in] _rxGain Receiver gain (dBi).
+      /// \param[in] _freq Frequency (MHz).
+      /// \param[in] _distance Distance between the antennas (m).
+      /// \param[in] _obstructed True if there is an obstacle between the
+      /// antennas.
+      /// \param[in] _fading Random fading (dB), subtracted from the power.
+      /// \return Received power (dBm).
+      public: static double ReceivedPower(const double _power,
+                  const double _txGain, const double _rxGain,
+                  const double _freq, const double _distance,
+                  const bool _obstructed, const double _fading);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WirelessChannelPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
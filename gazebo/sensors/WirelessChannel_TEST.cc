@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/sensors/WirelessChannel.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class WirelessChannelTest : public ServerFixture
+{
+  /// \brief Callback for the links topic.
+  /// \param[in] _msg Links message.
+  public: void OnLinks(ConstWirelessLinksPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->links = *_msg;
+    ++this->linksCount;
+  }
+
+  /// \brief Last links message.
+  public: msgs::WirelessLinks links;
+
+  /// \brief Number of links messages received.
+  public: int linksCount = 0;
+
+  /// \brief Protects the links.
+  public: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+/// \brief A transmitter, a receiver in the open and a receiver behind a box
+TEST_F(WirelessChannelTest, Links)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnWirelessTransmitterSensor("tx", "wirelessTx",
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      "osrf", 2450.0, 14.5, 2.6, false);
+  SpawnWirelessReceiverSensor("rx1", "wirelessRx1",
+      ignition::math::Vector3d(3, 0, 0.5), ignition::math::Vector3d::Zero,
+      2412.0, 2484.0, 14.5, 2.5, -90.0, false);
+  SpawnWirelessReceiverSensor("rx2", "wirelessRx2",
+      ignition::math::Vector3d(-2, 0, 0.5), ignition::math::Vector3d::Zero,
+      2412.0, 2484.0, 14.5, 2.5, -90.0, false);
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(-1, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  auto mgr = sensors::SensorManager::Instance();
+  sensors::SensorPtr tx = mgr->GetSensor("wirelessTx");
+  sensors::SensorPtr rx1 = mgr->GetSensor("wirelessRx1");
+  sensors::SensorPtr rx2 = mgr->GetSensor("wirelessRx2");
+  ASSERT_TRUE(tx != nullptr);
+  ASSERT_TRUE(rx1 != nullptr);
+  ASSERT_TRUE(rx2 != nullptr);
+
+  sensors::WirelessChannelPtr channel = sensors::WirelessChannel::Get(world);
+  ASSERT_TRUE(channel != nullptr);
+  EXPECT_EQ(channel, sensors::WirelessChannel::Get(world));
+  EXPECT_EQ(channel->UpdatePeriod(), common::Time(0.1));
+
+  // The antenna models are not obstacles, the box is
+  const std::vector<bool> obstructed = channel->Obstructed(
+      ignition::math::Vector3d(0, 0, 0.5),
+      {ignition::math::Vector3d(3, 0, 0.5),
+       ignition::math::Vector3d(-2, 0, 0.5),
+       ignition::math::Vector3d(0, 0, 0.5)},
+      world->ModelByName("tx")->GetId());
+  EXPECT_EQ(obstructed, std::vector<bool>({false, true, false}));
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  transport::SubscriberPtr sub = node->Subscribe("~/wireless/links",
+      &WirelessChannelTest::OnLinks, this);
+
+  // The world is paused, so the links are only computed when forced
+  EXPECT_TRUE(channel->Update(true));
+  EXPECT_FALSE(channel->Update());
+
+  double level1 = 0;
+  double level2 = 0;
+  EXPECT_TRUE(channel->SignalLevel(tx->Id(), rx1->Id(), level1));
+  EXPECT_TRUE(channel->SignalLevel(tx->Id(), rx2->Id(), level2));
+  EXPECT_FALSE(channel->SignalLevel(rx1->Id(), rx2->Id(), level2));
+
+  // Average over the random fading
+  double sum1 = 0;
+  double sum2 = 0;
+  const int samples = 50;
+  for (int i = 0; i < samples; ++i)
+  {
+    EXPECT_TRUE(channel->Update(true));
+    channel->SignalLevel(tx->Id(), rx1->Id(), level1);
+    channel->SignalLevel(tx->Id(), rx2->Id(), level2);
+    sum1 += level1;
+    sum2 += level2;
+  }
+  EXPECT_GT(sum1 / samples, sum2 / samples);
+
+  msgs::WirelessNodes nodes;
+  EXPECT_TRUE(channel->Signals(rx1->Id(), nodes));
+  ASSERT_EQ(nodes.node_size(), 1);
+  EXPECT_EQ(nodes.node(0).essid(), "osrf");
+  EXPECT_DOUBLE_EQ(nodes.node(0).frequency(), 2450.0);
+
+  // One transmitter by two receivers
+  int sleep = 0;
+  while (sleep++ < 50)
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->linksCount > 0)
+        break;
+    }
+    channel->Update(true);
+    common::Time::MSleep(100);
+  }
+  std::lock_guard<std::mutex> lock(this->mutex);
+  ASSERT_GT(this->linksCount, 0);
+  ASSERT_EQ(this->links.transmitter_size(), 1);
+  ASSERT_EQ(this->links.receiver_size(), 2);
+  EXPECT_EQ(this->links.transmitter(0), tx->ScopedName());
+  EXPECT_EQ(this->links.signal_level_size(), 2);
+  ASSERT_EQ(this->links.obstructed_size(), 2);
+  for (int j = 0; j < 2; ++j)
+  {
+    EXPECT_EQ(this->links.obstructed(j),
+        this->links.receiver(j) == rx2->ScopedName());
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief An obstacle placed between two fixed transceivers, then out of
+/// the way again
+TEST_F(WirelessChannelTest, MovingObstacle)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnWirelessTransmitterSensor("tx", "wirelessTx",
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      "osrf", 2450.0, 14.5, 2.6, false);
+  SpawnWirelessReceiverSensor("rx", "wirelessRx",
+      ignition::math::Vector3d(3, 0, 0.5), ignition::math::Vector3d::Zero,
+      2412.0, 2484.0, 14.5, 2.5, -90.0, false);
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(1.5, 3, 0.5), ignition::math::Vector3d::Zero,
+      true);
+
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != nullptr);
+
+  sensors::WirelessChannelPtr channel = sensors::WirelessChannel::Get(world);
+  ASSERT_TRUE(channel != nullptr);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init("default");
+  transport::SubscriberPtr sub = node->Subscribe("~/wireless/links",
+      &WirelessChannelTest::OnLinks, this);
+
+  // Compute the links and wait for their publication
+  auto obstructed = [&]()
+  {
+    int count;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      count = this->linksCount;
+    }
+    for (int i = 0; i < 50; ++i)
+    {
+      channel->Update(true);
+      common::Time::MSleep(100);
+      std::lock_guard<std::mutex> lock(this->mutex);
+      if (this->linksCount > count && this->links.obstructed_size() == 1)
+        return this->links.obstructed(0);
+    }
+    ADD_FAILURE() << "No links received";
+    return false;
+  };
+
+  // The world is paused, so the box is only moved by SetWorldPose, never
+  // by a physics step
+  EXPECT_FALSE(obstructed());
+
+  box->SetWorldPose(ignition::math::Pose3d(1.5, 0, 0.5, 0, 0, 0));
+  EXPECT_TRUE(obstructed());
+
+  box->SetWorldPose(ignition::math::Pose3d(1.5, -3, 0.5, 0, 0, 0));
+  EXPECT_FALSE(obstructed());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WirelessChannelTest, ReceivedPower)
+{
+  // Closer than a meter counts as a meter
+  EXPECT_DOUBLE_EQ(
+      sensors::WirelessChannel::ReceivedPower(14.5, 2.6, 2.6, 2442, 0.5,
+        false, 0),
+      sensors::WirelessChannel::ReceivedPower(14.5, 2.6, 2.6, 2442, 1.0,
+        false, 0));
+
+  // Obstacles and fading lower the power
+  const double open = sensors::WirelessChannel::ReceivedPower(14.5, 2.6, 2.6,
+      2442, 10, false, 0);
+  EXPECT_GT(open, sensors::WirelessChannel::ReceivedPower(14.5, 2.6, 2.6,
+      2442, 10, true, 0));
+  EXPECT_DOUBLE_EQ(open - 3, sensors::WirelessChannel::ReceivedPower(14.5,
+      2.6, 2.6, 2442, 10, false, 3));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
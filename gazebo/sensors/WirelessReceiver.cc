@@ -18,13 +18,12 @@
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/sensors/SensorFactory.hh"
-#include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/sensors/WirelessChannel.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 
 #include "gazebo/sensors/WirelessReceiverPrivate.hh"
 #include "gazebo/sensors/WirelessReceiver.hh"
-#include "gazebo/sensors/WirelessTransmitter.hh"
 
 using namespace gazebo;
 using namespace sensors;
@@ -47,6 +46,8 @@ WirelessReceiver::~WirelessReceiver()
 void WirelessReceiver::Init()
 {
   WirelessTransceiver::Init();
+
+  this->channel->AddReceiver(this);
 }
 
 /////////////////////////////////////////////////
@@ -100,43 +101,35 @@ void WirelessReceiver::Load(const std::string &_worldName)
 }
 
 //////////////////////////////////////////////////
-bool WirelessReceiver::UpdateImpl(const bool /*_force*/)
+bool WirelessReceiver::UpdateImpl(const bool _force)
 {
-  std::string txEssid;
-  msgs::WirelessNodes msg;
-  double rxPower;
-  double txFreq;
-
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
 
-  ignition::math::Pose3d myPos = this->referencePose;
-  Sensor_V sensors = SensorManager::Instance()->GetSensors();
-  for (Sensor_V::iterator it = sensors.begin(); it != sensors.end(); ++it)
+  // The signal of every transmitter is computed by the channel, for all
+  // the receivers at once
+  this->channel->Update(_force);
+
+  msgs::WirelessNodes nodes;
+  if (!this->channel->Signals(this->Id(), nodes))
   {
-    if ((*it)->Type() == "wireless_transmitter")
+    // This receiver was added after the last computation
+    this->channel->Update(true);
+    this->channel->Signals(this->Id(), nodes);
+  }
+
+  msgs::WirelessNodes msg;
+  for (auto const &node : nodes.node())
+  {
+    // Discard if the frequency received is out of our frequency range,
+    // or if the received signal strengh is lower than the sensivity
+    if ((node.frequency() < this->MinFreqFiltered()) ||
+        (node.frequency() > this->MaxFreqFiltered()) ||
+        (node.signal_level() < this->Sensitivity()))
     {
-      std::shared_ptr<gazebo::sensors::WirelessTransmitter> transmitter =
-          std::static_pointer_cast<WirelessTransmitter>(*it);
-
-      txFreq = transmitter->Freq();
-      rxPower = transmitter->SignalStrength(myPos, this->Gain());
-
-      // Discard if the frequency received is out of our frequency range,
-      // or if the received signal strengh is lower than the sensivity
-      if ((txFreq < this->MinFreqFiltered()) ||
-          (txFreq > this->MaxFreqFiltered()) ||
-          (rxPower < this->Sensitivity()))
-      {
-        continue;
-      }
-
-      txEssid = transmitter->ESSID();
-
-      msgs::WirelessNode *wirelessNode = msg.add_node();
-      wirelessNode->set_essid(txEssid);
-      wirelessNode->set_frequency(txFreq);
-      wirelessNode->set_signal_level(rxPower);
+      continue;
     }
+
+    *msg.add_node() = node;
   }
   if (msg.node_size() > 0)
   {
@@ -23,6 +23,7 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 
+#include "gazebo/sensors/WirelessChannel.hh"
 #include "gazebo/sensors/WirelessTransceiver.hh"
 
 using namespace gazebo;
@@ -61,6 +62,7 @@ void WirelessTransceiver::Load(const std::string &_worldName)
   GZ_ASSERT(this->parentEntity.lock() != nullptr, "parentEntity is null");
 
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
+  this->modelId = this->parentEntity.lock()->GetParentModel()->GetId();
 
   if (!this->sdf->HasElement("transceiver"))
   {
@@ -91,11 +93,18 @@ void WirelessTransceiver::Load(const std::string &_worldName)
 void WirelessTransceiver::Init()
 {
   Sensor::Init();
+
+  this->channel = WirelessChannel::Get(this->world);
 }
 
 /////////////////////////////////////////////////
 void WirelessTransceiver::Fini()
 {
+  if (this->channel)
+  {
+    this->channel->Remove(this);
+    this->channel.reset();
+  }
   this->pub.reset();
   this->parentEntity.lock().reset();
   Sensor::Fini();
@@ -112,3 +121,19 @@ double WirelessTransceiver::Gain() const
 {
   return this->gain;
 }
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d WirelessTransceiver::AntennaPose() const
+{
+  physics::LinkPtr parent = this->parentEntity.lock();
+  if (!parent)
+    return this->referencePose;
+
+  return this->pose + parent->WorldPose();
+}
+
+/////////////////////////////////////////////////
+uint32_t WirelessTransceiver::ParentModelId() const
+{
+  return this->modelId;
+}
@@ -23,6 +23,7 @@
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/sensors/Sensor.hh"
+#include "gazebo/sensors/SensorTypes.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -62,6 +63,15 @@ namespace gazebo
       /// \return Receiver power (dBm).
       public: double Power() const;
 
+      /// \brief Get the world pose of the antenna, from the current pose
+      /// of the parent link.
+      /// \return Pose of the antenna.
+      public: ignition::math::Pose3d AntennaPose() const;
+
+      /// \brief Get the id of the top level model holding the parent link.
+      /// \return Model id.
+      public: uint32_t ParentModelId() const;
+
       /// \brief Publisher to publish propagation model data
       protected: transport::PublisherPtr pub;
 
@@ -76,6 +86,13 @@ namespace gazebo
 
       /// \brief Sensor reference pose
       protected: ignition::math::Pose3d referencePose;
+
+      /// \brief Id of the top level model holding the parent link.
+      protected: uint32_t modelId = 0;
+
+      /// \brief Radio links of the world, shared with the other
+      /// transceivers.
+      protected: WirelessChannelPtr channel;
     };
     /// \}
   }
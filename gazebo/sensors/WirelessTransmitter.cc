@@ -14,11 +14,15 @@
  * limitations under the License.
  *
 */
+#include <vector>
+
 #include <ignition/math/Rand.hh>
+#include <ignition/math/Vector2.hh>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/physics.hh"
 #include "gazebo/sensors/SensorFactory.hh"
+#include "gazebo/sensors/WirelessChannel.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 
@@ -79,52 +83,58 @@ void WirelessTransmitter::Init()
 {
   WirelessTransceiver::Init();
 
-  // This ray will be used in SignalStrength() for checking obstacles
-  // between the transmitter and a given point.
-  this->dataPtr->testRay = boost::dynamic_pointer_cast<RayShape>(
-      this->world->Physics()->CreateShape("ray", CollisionPtr()));
+  this->channel->AddTransmitter(this);
 }
 
 //////////////////////////////////////////////////
-bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
+bool WirelessTransmitter::UpdateImpl(const bool _force)
 {
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
 
+  this->channel->Update(_force);
+
   if (this->dataPtr->visualize)
   {
-    msgs::PropagationGrid msg;
-    ignition::math::Pose3d pos;
-    ignition::math::Pose3d worldPose;
-    double strength;
-    msgs::PropagationParticle *p;
-
     // Iterate using a rectangular grid, but only choose the points within
     // a circunference of radius MaxRadius
+    std::vector<ignition::math::Vector2d> cells;
+    std::vector<ignition::math::Vector3d> points;
     for (double x = -this->dataPtr->MaxRadius;
          x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
     {
       for (double y = -this->dataPtr->MaxRadius;
            y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
       {
-        pos.Set(x, y, 0.0, 0, 0, 0);
-
-        worldPose = pos + this->referencePose;
+        ignition::math::Pose3d pos(x, y, 0.0, 0, 0, 0);
+        ignition::math::Pose3d worldPose = pos + this->referencePose;
 
         if (this->referencePose.Pos().Distance(worldPose.Pos()) <=
             this->dataPtr->MaxRadius)
         {
-          // For the propagation model assume the receiver antenna has the same
-          // gain as the transmitter
-          strength = this->SignalStrength(worldPose, this->Gain());
-
-          // Add a new particle to the grid
-          p = msg.add_particle();
-          p->set_x(x);
-          p->set_y(y);
-          p->set_signal_level(strength);
+          cells.push_back(ignition::math::Vector2d(x, y));
+          points.push_back(worldPose.Pos());
         }
       }
     }
+
+    // Test all the cells for obstacles at once
+    const std::vector<bool> obstructed = this->channel->Obstructed(
+        this->referencePose.Pos(), points, this->ParentModelId());
+
+    msgs::PropagationGrid msg;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+      // For the propagation model assume the receiver antenna has the same
+      // gain as the transmitter
+      double strength = this->SignalStrength(points[i], this->Gain(),
+          obstructed[i]);
+
+      // Add a new particle to the grid
+      msgs::PropagationParticle *p = msg.add_particle();
+      p->set_x(cells[i].X());
+      p->set_y(cells[i].Y());
+      p->set_signal_level(strength);
+    }
     this->pub->Publish(msg);
   }
 
@@ -148,46 +158,28 @@ double WirelessTransmitter::SignalStrength(
     const ignition::math::Pose3d &_receiver,
     const double _rxGain)
 {
-  std::string entityName;
-  double dist;
-  ignition::math::Vector3d end = _receiver.Pos();
-  ignition::math::Vector3d start = this->referencePose.Pos();
-
-  // Avoid computing the intersection of coincident points
-  // This prevents an assertion in bullet (issue #849)
-  if (start == end)
+  // Looking for obstacles between the transmitter and the receiver
+  bool obstructed = false;
+  if (this->channel)
   {
-    end.Z() += 0.00001;
+    obstructed = this->channel->Obstructed(this->referencePose.Pos(),
+        {_receiver.Pos()}, this->ParentModelId())[0];
   }
 
-  // Acquire the mutex for avoiding race condition with the physics engine
-  boost::recursive_mutex::scoped_lock lock(*(
-        this->world->Physics()->GetPhysicsUpdateMutex()));
-
-  // Compute the value of n depending on the obstacles between Tx and Rx
-  double n = WirelessTransmitterPrivate::NEmpty;
-
-  // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
-
-  // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
-  {
-    n = WirelessTransmitterPrivate::NObstacle;
-  }
+  return this->SignalStrength(_receiver.Pos(), _rxGain, obstructed);
+}
 
-  double distance = std::max(1.0,
-      this->referencePose.Pos().Distance(_receiver.Pos()));
+/////////////////////////////////////////////////
+double WirelessTransmitter::SignalStrength(
+    const ignition::math::Vector3d &_receiver, const double _rxGain,
+    const bool _obstructed)
+{
   double x = std::abs(ignition::math::Rand::DblNormal(0.0,
         WirelessTransmitterPrivate::ModelStdDev));
-  double wavelength = common::SpeedOfLight / (this->Freq() * 1000000);
-
-  // Hata-Okumara propagation model
-  double rxPower = this->Power() + this->Gain() + _rxGain - x +
-      20 * log10(wavelength) - 20 * log10(4 * M_PI) - 10 * n * log10(distance);
 
-  return rxPower;
+  return WirelessChannel::ReceivedPower(this->Power(), this->Gain(),
+      _rxGain, this->Freq(), this->referencePose.Pos().Distance(_receiver),
+      _obstructed, x);
 }
 
 /////////////////////////////////////////////////
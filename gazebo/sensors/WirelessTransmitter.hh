@@ -68,6 +68,18 @@ namespace gazebo
       public: double SignalStrength(const ignition::math::Pose3d &_receiver,
           const double _rxGain);
 
+      /// \brief Returns the signal strength in a given world's point (dBm),
+      /// when the obstacles between the transmitter and the point are
+      /// already known.
+      /// \param[in] _receiver Position of the receiver
+      /// \param[in] _rxGain Receiver gain value
+      /// \param[in] _obstructed True if there is an obstacle between the
+      /// transmitter and the receiver
+      /// \return Signal strength in a world's point (dBm).
+      /// \sa WirelessChannel::Obstructed
+      public: double SignalStrength(const ignition::math::Vector3d &_receiver,
+          const double _rxGain, const bool _obstructed);
+
       /// \brief Get the std dev of the Gaussian random variable used in the
       /// propagation model.
       /// \return The standard deviation of the propagation model.
@@ -56,9 +56,6 @@ namespace gazebo
 
       /// \brief Reception frequency (MHz).
       public: double freq = 2442.0;
-
-      // \brief Ray used to test for collisions when placing entities
-      public: physics::RayShapePtr testRay;
     };
   }
 }
@@ -58,3 +58,89 @@ unsigned int CallbackHelper::GetId() const
 {
   return this->id;
 }
+
+/////////////////////////////////////////////////
+void CallbackHelper::SetMaxRate(const double _hz)
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+  this->period = _hz > 0 ? 1.0 / _hz : 0.0;
+}
+
+/////////////////////////////////////////////////
+double CallbackHelper::MaxRate() const
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+  return this->period > 0 ? 1.0 / this->period : 0.0;
+}
+
+/////////////////////////////////////////////////
+void CallbackHelper::SetLatestOnly(const bool _latestOnly)
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+  this->latestOnly = _latestOnly;
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::LatestOnly() const
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+  return this->latestOnly;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check a publication time against a rate limit.
+/// \param[in] _period Minimum time between two messages, zero for none.
+/// \param[in] _last Publication time of the last accepted message.
+/// \param[in] _stamp Publication time of the message.
+/// \return True if the message passes the limit.
+static bool passesRate(const double _period, const common::Time &_last,
+    const common::Time &_stamp)
+{
+  // A stamp older than the last accepted one restarts the limit
+  return _period <= 0 || _last == common::Time::Zero || _stamp < _last ||
+    (_stamp - _last).Double() >= _period;
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::Due(const common::Time &_stamp) const
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+  return passesRate(this->period, this->lastStamp, _stamp);
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::Accept(const common::Time &_stamp, const bool _latest,
+    const bool _rateApplied)
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+
+  if (!_latest && this->latestOnly)
+    return false;
+
+  // The publisher checked the rate against its own publication times.
+  // Checking again against reception times would drop messages that
+  // arrive closer together because of network jitter.
+  if (_rateApplied)
+    return true;
+
+  if (!passesRate(this->period, this->lastStamp, _stamp))
+    return false;
+
+  if (this->period > 0)
+    this->lastStamp = _stamp;
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool CallbackHelper::Throttled(const double _maxRate,
+    const bool _latestOnly) const
+{
+  std::lock_guard<std::mutex> lock(this->policyMutex);
+
+  if (this->period <= 0 && !this->latestOnly)
+    return false;
+
+  const double rate = this->period > 0 ? 1.0 / this->period : 0.0;
+  return rate == _maxRate && this->latestOnly == _latestOnly;
+}
@@ -26,6 +26,7 @@
 #include <mutex>
 
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/Exception.hh"
 
@@ -87,6 +88,56 @@ namespace gazebo
       /// \return The unique ID of this callback.
       public: unsigned int GetId() const;
 
+      /// \brief Set the maximum rate at which this callback gets messages.
+      /// \param[in] _hz Maximum number of messages per second of
+      /// publication time. Zero means no limit.
+      /// \sa Accept
+      public: void SetMaxRate(const double _hz);
+
+      /// \brief Get the maximum rate at which this callback gets messages.
+      /// \return Maximum number of messages per second, zero if there is
+      /// no limit.
+      public: double MaxRate() const;
+
+      /// \brief Set whether this callback only wants the latest message of
+      /// a backlog.
+      /// \param[in] _latestOnly True to skip the older messages.
+      /// \sa Accept
+      public: void SetLatestOnly(const bool _latestOnly);
+
+      /// \brief Does this callback only want the latest message?
+      /// \return True if the older messages of a backlog are skipped.
+      public: bool LatestOnly() const;
+
+      /// \brief Check whether a message would pass the rate limit of this
+      /// callback, without counting it.
+      /// \param[in] _stamp Publication time of the message.
+      /// \return True if the message would be accepted.
+      public: bool Due(const common::Time &_stamp) const;
+
+      /// \brief Decide whether this callback gets a message, and count
+      /// the message against the rate limit if it does.
+      /// \param[in] _stamp Publication time of the message.
+      /// \param[in] _latest False if a newer message is already waiting,
+      /// in which case a latest-only callback skips this one.
+      /// \param[in] _rateApplied True if the publisher already applied the
+      /// rate limit of this callback, see Throttled. The message then
+      /// isn't checked against the limit again.
+      /// \return True if the message should be handed to this callback.
+      public: bool Accept(const common::Time &_stamp,
+                          const bool _latest = true,
+                          const bool _rateApplied = false);
+
+      /// \brief Check whether a remote publisher already applied the
+      /// delivery policy of this callback to the messages of a link.
+      /// \param[in] _maxRate Maximum rate of the link, zero for none.
+      /// \param[in] _latestOnly True if the link only carries the latest
+      /// messages.
+      /// \return True if this callback has a rate limit or only wants the
+      /// latest messages, and the link has the same policy.
+      public: bool Throttled(const double _maxRate,
+                             const bool _latestOnly) const;
+
       /// \brief True means that the callback helper will get the last
       /// published message on the topic.
       protected: bool latching;
@@ -94,6 +145,19 @@ namespace gazebo
       /// \brief Mutex to protect the latching variable.
       protected: mutable std::mutex latchingMutex;
 
+      /// \brief Minimum publication time between two accepted messages, in
+      /// seconds. Zero means no limit.
+      private: double period = 0;
+
+      /// \brief True if only the latest message of a backlog is wanted.
+      private: bool latestOnly = false;
+
+      /// \brief Publication time of the last accepted message.
+      private: common::Time lastStamp;
+
+      /// \brief Mutex to protect the delivery policy.
+      private: mutable std::mutex policyMutex;
+
       /// \brief A counter to generate the unique id of this callback.
       private: static unsigned int idCounter;
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/transport/CallbackHelper.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class CallbackHelperTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+void OnEmpty(ConstEmptyPtr &/*_msg*/)
+{
+}
+
+/////////////////////////////////////////////////
+TEST_F(CallbackHelperTest, NoPolicy)
+{
+  transport::CallbackHelperT<msgs::Empty> helper(&OnEmpty);
+  EXPECT_DOUBLE_EQ(helper.MaxRate(), 0.0);
+  EXPECT_FALSE(helper.LatestOnly());
+
+  // Everything is accepted, even several messages with the same stamp
+  for (int i = 0; i < 10; ++i)
+  {
+    EXPECT_TRUE(helper.Accept(common::Time(1, 0), false));
+    EXPECT_TRUE(helper.Accept(common::Time(1, 0)));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(CallbackHelperTest, MaxRate)
+{
+  transport::CallbackHelperT<msgs::Empty> helper(&OnEmpty);
+  helper.SetMaxRate(10);
+  EXPECT_DOUBLE_EQ(helper.MaxRate(), 10.0);
+
+  // 1 kHz of messages over one second gets through at 10 Hz
+  unsigned int accepted = 0;
+  for (int i = 0; i < 1000; ++i)
+  {
+    common::Time stamp(1, i * 1000000);
+    const bool due = helper.Due(stamp);
+    const bool accept = helper.Accept(stamp);
+    EXPECT_EQ(due, accept);
+    if (accept)
+      ++accepted;
+  }
+  EXPECT_EQ(accepted, 10u);
+
+  // Due doesn't count the message
+  EXPECT_TRUE(helper.Due(common::Time(3, 0)));
+  EXPECT_TRUE(helper.Due(common::Time(3, 0)));
+  EXPECT_TRUE(helper.Accept(common::Time(3, 0)));
+  EXPECT_FALSE(helper.Due(common::Time(3, 0)));
+
+  // An older stamp, e.g. after a time reset, restarts the limit
+  EXPECT_TRUE(helper.Accept(common::Time(0, 0)));
+
+  // Removing the limit
+  helper.SetMaxRate(0);
+  EXPECT_DOUBLE_EQ(helper.MaxRate(), 0.0);
+  EXPECT_TRUE(helper.Accept(common::Time(3, 0)));
+  EXPECT_TRUE(helper.Accept(common::Time(3, 0)));
+}
+
+/////////////////////////////////////////////////
+TEST_F(CallbackHelperTest, LatestOnly)
+{
+  transport::CallbackHelperT<msgs::Empty> helper(&OnEmpty);
+  helper.SetLatestOnly(true);
+  EXPECT_TRUE(helper.LatestOnly());
+
+  // Only the last message of a backlog is accepted
+  EXPECT_FALSE(helper.Accept(common::Time(1, 0), false));
+  EXPECT_FALSE(helper.Accept(common::Time(2, 0), false));
+  EXPECT_TRUE(helper.Accept(common::Time(3, 0), true));
+
+  // Combined with a rate limit
+  helper.SetMaxRate(1);
+  EXPECT_TRUE(helper.Accept(common::Time(4, 0)));
+  EXPECT_FALSE(helper.Accept(common::Time(4, 500000000)));
+  EXPECT_FALSE(helper.Accept(common::Time(5, 0), false));
+  EXPECT_TRUE(helper.Accept(common::Time(5, 0)));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
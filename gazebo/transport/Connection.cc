@@ -49,6 +49,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
@@ -297,8 +299,14 @@ void Connection::EnqueueMsg(const std::string &_buffer,
     boost::function<void(uint32_t)> _cb, uint32_t _id, bool _force)
 {
   // Don't enqueue empty messages
-  if (_buffer.empty() || !this->IsOpen())
+  if (_buffer.empty())
+  {
+    return;
+  }
+
+  if (!this->IsOpen())
   {
+    this->stats.AddDropped();
     return;
   }
 
@@ -322,6 +330,9 @@ void Connection::EnqueueMsg(const std::string &_buffer,
       this->writeQueue.back() += std::string(headerBuffer) + _buffer;
       this->callbacks.back().push_back(std::make_pair(_cb, _id));
     }
+
+    this->stats.AddOutgoing(_buffer.size());
+    this->stats.UpdateQueueDepth(++this->writeQueueMsgs);
   }
 
   if (_force)
@@ -403,6 +414,8 @@ void Connection::PostWrite()
     for (auto const &callback : this->callbacks.front())
       if (!callback.first.empty())
         callback.first(callback.second);
+    this->writeQueueMsgs -= std::min(this->writeQueueMsgs,
+        this->callbacks.front().size());
     this->callbacks.pop_front();
   }
 
@@ -490,6 +503,10 @@ void Connection::Close()
   boost::recursive_mutex::scoped_lock lock2(this->writeMutex);
   this->writeQueue.clear();
   this->callbacks.clear();
+
+  // Messages that were never written are lost.
+  this->stats.AddDropped(this->writeQueueMsgs);
+  this->writeQueueMsgs = 0;
 }
 
 //////////////////////////////////////////////////
@@ -571,12 +588,19 @@ bool Connection::Read(std::string &data)
       throw boost::system::system_error(error);
 
     data = std::string(&incoming[0], incoming.size());
+    this->stats.AddIncoming(data.size());
     result = true;
   }
 
   return result;
 }
 
+//////////////////////////////////////////////////
+const TransportStats &Connection::Stats() const
+{
+  return this->stats;
+}
+
 //////////////////////////////////////////////////
 std::string Connection::GetLocalAddress() const
 {
@@ -37,6 +37,7 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/WeakBind.hh"
+#include "gazebo/transport/TransportStats.hh"
 #include "gazebo/util/system.hh"
 
 #define HEADER_LENGTH 8
@@ -304,6 +305,7 @@ namespace gazebo
                 std::string data(&this->inboundData[0],
                                   this->inboundData.size());
                 this->inboundData.clear();
+                this->stats.AddIncoming(data.size());
 
                 if (data.empty())
                   gzerr << "OnReadData got empty data!!!\n";
@@ -343,6 +345,13 @@ namespace gazebo
       /// \return GAZEBO_IP_WHITE_LIST
       public: std::string GetIPWhiteList() const;
 
+      /// \brief Get the traffic counters of the connection. The queue
+      /// high-water mark is the highest number of messages waiting to be
+      /// written, and messages enqueued on a closed connection are
+      /// counted as dropped.
+      /// \return Counters of the connection.
+      public: const TransportStats &Stats() const;
+
       /// \brief Post write.
       /// Called afer a write is finished.
       private: void PostWrite();
@@ -442,6 +451,12 @@ namespace gazebo
       /// \brief Number of writes that are being processed.
       private: unsigned int writeCount;
 
+      /// \brief Number of messages in writeQueue.
+      private: std::size_t writeQueueMsgs = 0;
+
+      /// \brief Traffic counters.
+      private: TransportStats stats;
+
       /// \brief Local URI string
       private: std::string localURI;
 
@@ -21,6 +21,7 @@
 #include "gazebo/common/Events.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/ShmRing.hh"
 
 #include "gazebo/gazebo_config.h"
 
@@ -483,6 +484,18 @@ void ConnectionManager::OnRead(ConnectionPtr _connection,
     SubscriptionTransportPtr subLink(new SubscriptionTransport());
     subLink->Init(_connection, sub.latching());
 
+    // Skip the messages the subscriber doesn't want before sending them
+    subLink->SetMaxRate(sub.max_rate());
+    subLink->SetLatestOnly(sub.latest_only());
+
+    // Hand over large messages through shared memory if the subscriber
+    // lives in our shared memory namespace.
+    if (ShmRing::Enabled() && sub.has_shm_host_id() &&
+        !sub.shm_host_id().empty() && sub.shm_host_id() == ShmRing::HostId())
+    {
+      subLink->SetShm(true);
+    }
+
     // Connect the publisher to this transport mechanism
     TopicManager::Instance()->ConnectPubToSub(sub.topic(), subLink);
   }
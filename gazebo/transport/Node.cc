@@ -16,8 +16,12 @@
 */
 #include <boost/algorithm/string.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
+#include <iterator>
+#include <utility>
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publication.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -192,19 +196,46 @@ void Node::ProcessPublishers()
 }
 
 /////////////////////////////////////////////////
-bool Node::HandleData(const std::string &_topic, const std::string &_msg)
+bool Node::HandleData(const std::string &_topic, const std::string &_msg,
+    const common::Time &_stamp, const double _linkRate,
+    const bool _linkLatestOnly)
 {
+  const common::Time stamp =
+    _stamp == common::Time::Zero ? common::Time::GetWallTime() : _stamp;
+
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgs[_topic].push_back(_msg);
+
+  // Don't queue messages that every callback would skip
+  bool latestOnly = false;
+  if (!this->Wanted(_topic, stamp, _linkRate, _linkLatestOnly, latestOnly))
+    return true;
+
+  auto &msgs = this->incomingMsgs[_topic];
+  if (latestOnly)
+    msgs.clear();
+  msgs.push_back({_msg, stamp, _linkRate, _linkLatestOnly});
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
 
 /////////////////////////////////////////////////
-bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg)
+bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg,
+    const common::Time &_stamp)
 {
+  const common::Time stamp =
+    _stamp == common::Time::Zero ? common::Time::GetWallTime() : _stamp;
+
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgsLocal[_topic].push_back(_msg);
+
+  // Don't queue messages that every callback would skip
+  bool latestOnly = false;
+  if (!this->Wanted(_topic, stamp, 0, false, latestOnly))
+    return true;
+
+  auto &msgs = this->incomingMsgsLocal[_topic];
+  if (latestOnly)
+    msgs.clear();
+  msgs.push_back(std::make_pair(_msg, stamp));
   ConnectionManager::Instance()->TriggerUpdate();
   return true;
 }
@@ -223,35 +254,43 @@ void Node::ProcessIncoming()
 
   // For each topic
   {
-    std::list<std::string>::iterator msgIter;
-    std::map<std::string, std::list<std::string> >::iterator inIter;
-    std::map<std::string, std::list<std::string> >::iterator endIter;
-
     boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
-    inIter = this->incomingMsgs.begin();
-    endIter = this->incomingMsgs.end();
 
-    for (; inIter != endIter; ++inIter)
+    for (auto const &in : this->incomingMsgs)
     {
       // Find the callbacks for the topic
-      cbIter = this->callbacks.find(inIter->first);
+      cbIter = this->callbacks.find(in.first);
       if (cbIter != this->callbacks.end())
       {
-        std::list<std::string>::iterator msgInIter;
-        std::list<std::string>::iterator msgEndIter;
-
-        msgInIter = inIter->second.begin();
-        msgEndIter = inIter->second.end();
+        PublicationPtr publication =
+          TopicManager::Instance()->FindPublication(in.first);
 
         // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        for (auto msgIter = in.second.begin(); msgIter != in.second.end();
+             ++msgIter)
         {
-          // Send the message to all callbacks
+          auto const &msg = *msgIter;
+          const bool latest = std::next(msgIter) == in.second.end();
+
+          // Send the message to all callbacks that want it. The remote
+          // publisher already throttled it for the callbacks with the same
+          // policy as the link.
           for (liter = cbIter->second.begin();
               liter != cbIter->second.end(); ++liter)
           {
-            (*liter)->HandleData(*msgIter,
-                boost::bind(&dummy_callback_fn, _1), 0);
+            const bool rateApplied =
+              (*liter)->Throttled(msg.linkRate, msg.linkLatestOnly);
+            if ((*liter)->Accept(msg.stamp, latest, rateApplied))
+            {
+              (*liter)->HandleData(msg.data,
+                  boost::bind(&dummy_callback_fn, _1), 0);
+            }
+          }
+
+          if (publication)
+          {
+            publication->Stats().AddLatency(
+                common::Time::GetWallTime() - msg.stamp);
           }
         }
       }
@@ -261,34 +300,36 @@ void Node::ProcessIncoming()
   }
 
   {
-    std::list<MessagePtr>::iterator msgIter;
-    std::map<std::string, std::list<MessagePtr> >::iterator inIter;
-    std::map<std::string, std::list<MessagePtr> >::iterator endIter;
-
     boost::recursive_mutex::scoped_lock lock2(this->incomingMutex);
-    inIter = this->incomingMsgsLocal.begin();
-    endIter = this->incomingMsgsLocal.end();
 
-    for (; inIter != endIter; ++inIter)
+    for (auto const &in : this->incomingMsgsLocal)
     {
       // Find the callbacks for the topic
-      cbIter = this->callbacks.find(inIter->first);
+      cbIter = this->callbacks.find(in.first);
       if (cbIter != this->callbacks.end())
       {
-        std::list<MessagePtr>::iterator msgInIter;
-        std::list<MessagePtr>::iterator msgEndIter;
-
-        msgInIter = inIter->second.begin();
-        msgEndIter = inIter->second.end();
+        PublicationPtr publication =
+          TopicManager::Instance()->FindPublication(in.first);
 
         // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        for (auto msgIter = in.second.begin(); msgIter != in.second.end();
+             ++msgIter)
         {
-          // Send the message to all callbacks
+          auto const &msg = *msgIter;
+          const bool latest = std::next(msgIter) == in.second.end();
+
+          // Send the message to all callbacks that want it
           for (liter = cbIter->second.begin();
               liter != cbIter->second.end(); ++liter)
           {
-            (*liter)->HandleMessage(*msgIter);
+            if ((*liter)->Accept(msg.second, latest))
+              (*liter)->HandleMessage(msg.first);
+          }
+
+          if (publication)
+          {
+            publication->Stats().AddLatency(
+                common::Time::GetWallTime() - msg.second);
           }
         }
       }
@@ -360,6 +401,69 @@ bool Node::HasLatchedSubscriber(const std::string &_topic) const
   return false;
 }
 
+/////////////////////////////////////////////////
+bool Node::SubscriptionPolicy(const std::string &_topic, double &_maxRate,
+    bool &_latestOnly) const
+{
+  boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+
+  Callback_M::const_iterator iter = this->callbacks.find(_topic);
+  if (iter == this->callbacks.end() || iter->second.empty())
+    return false;
+
+  _maxRate = iter->second.front()->MaxRate();
+  _latestOnly = true;
+  for (auto const &cb : iter->second)
+  {
+    const double rate = cb->MaxRate();
+    _maxRate = (_maxRate <= 0 || rate <= 0) ? 0 : std::max(_maxRate, rate);
+    _latestOnly = _latestOnly && cb->LatestOnly();
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool Node::Wanted(const std::string &_topic, const common::Time &_stamp,
+    const double _linkRate, const bool _linkLatestOnly,
+    bool &_latestOnly) const
+{
+  _latestOnly = false;
+
+  Callback_M::const_iterator iter = this->callbacks.find(_topic);
+  if (iter == this->callbacks.end() || iter->second.empty())
+    return true;
+
+  bool wanted = false;
+  _latestOnly = true;
+  for (auto const &cb : iter->second)
+  {
+    wanted = wanted || cb->Throttled(_linkRate, _linkLatestOnly) ||
+      cb->Due(_stamp);
+    _latestOnly = _latestOnly && cb->LatestOnly();
+  }
+
+  return wanted;
+}
+
+/////////////////////////////////////////////////
+SubscriberPtr Node::SubscribeCallback(const SubscribeOptions &_ops,
+    const CallbackHelperPtr &_callback)
+{
+  _callback->SetMaxRate(_ops.MaxRate());
+  _callback->SetLatestOnly(_ops.LatestOnly());
+
+  {
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    this->callbacks[_ops.GetTopic()].push_back(_callback);
+  }
+
+  SubscriberPtr result = TopicManager::Instance()->Subscribe(_ops);
+  result->SetCallbackId(_callback->GetId());
+
+  return result;
+}
+
 /////////////////////////////////////////////////
 void Node::RemoveCallback(const std::string &_topic, unsigned int _id)
 {
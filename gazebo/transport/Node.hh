@@ -24,8 +24,10 @@
 #include <map>
 #include <list>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/util/system.hh"
@@ -147,6 +149,17 @@ namespace gazebo
       /// \return True if a latched subscriber exists.
       public: bool HasLatchedSubscriber(const std::string &_topic) const;
 
+      /// \brief Get the loosest delivery policy of the subscribers on a
+      /// topic, which is the policy a link from a remote publisher can
+      /// use without holding back messages from any of them.
+      /// \param[in] _topic Name of the topic to check.
+      /// \param[out] _maxRate Highest maximum rate of the subscribers, zero
+      /// if one of them has no limit.
+      /// \param[out] _latestOnly True if every subscriber only wants the
+      /// latest message.
+      /// \return False if there is no subscriber on the topic.
+      public: bool SubscriptionPolicy(const std::string &_topic,
+                  double &_maxRate, bool &_latestOnly) const;
 
       /// \brief A convenience function for a one-time publication of
       /// a message. This is inefficient, compared to
@@ -347,18 +360,72 @@ namespace gazebo
         return result;
       }
 
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// with delivery options
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _options Latching, maximum rate and latest-only
+      /// options. The topic and node of the options are ignored.
+      /// \return Pointer to new Subscriber object
+      public: template<typename M, typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const boost::shared_ptr<M const> &), T *_obj,
+          const SubscribeOptions &_options)
+      {
+        SubscribeOptions ops(_options);
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _options.GetLatching());
+
+        return this->SubscribeCallback(ops, CallbackHelperPtr(
+              new CallbackHelperT<M>(boost::bind(_fp, _obj, _1),
+                ops.GetLatching())));
+      }
+
+      /// \brief Subscribe to a topic using a bare function as the callback,
+      /// with delivery options
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Function to be called on receipt of new message
+      /// \param[in] _options Latching, maximum rate and latest-only
+      /// options. The topic and node of the options are ignored.
+      /// \return Pointer to new Subscriber object
+      public: template<typename M>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(*_fp)(const boost::shared_ptr<M const> &),
+          const SubscribeOptions &_options)
+      {
+        SubscribeOptions ops(_options);
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _options.GetLatching());
+
+        return this->SubscribeCallback(ops, CallbackHelperPtr(
+              new CallbackHelperT<M>(_fp, ops.GetLatching())));
+      }
+
       /// \brief Handle incoming data.
       /// \param[in] _topic Topic for which the data was received
       /// \param[in] _msg The message that was received
+      /// \param[in] _stamp Wall time at which the data was received, used
+      /// to measure the latency to the callbacks. Zero means now.
+      /// \param[in] _linkRate Rate limit the remote publisher already
+      /// applied to the data, zero for none.
+      /// \param[in] _linkLatestOnly True if the remote publisher only sent
+      /// the latest messages.
       /// \return true if the message was handled successfully, false otherwise
       public: bool HandleData(const std::string &_topic,
-                              const std::string &_msg);
+                              const std::string &_msg,
+                              const common::Time &_stamp = common::Time::Zero,
+                              const double _linkRate = 0,
+                              const bool _linkLatestOnly = false);
 
       /// \brief Handle incoming msg.
       /// \param[in] _topic Topic for which the data was received
       /// \param[in] _msg The message that was received
+      /// \param[in] _stamp Wall time at which the message was published,
+      /// used to measure the latency to the callbacks. Zero means now.
       /// \return true if the message was handled successfully, false otherwise
-      public: bool HandleMessage(const std::string &_topic, MessagePtr _msg);
+      public: bool HandleMessage(const std::string &_topic, MessagePtr _msg,
+                  const common::Time &_stamp = common::Time::Zero);
 
       /// \brief Add a latched message to the node for publication.
       ///
@@ -390,6 +457,30 @@ namespace gazebo
       /// \param[in] _id Id of the callback.
       public: void RemoveCallback(const std::string &_topic, unsigned int _id);
 
+      /// \brief Register a callback with the delivery options of a
+      /// subscription, and subscribe to its topic.
+      /// \param[in] _ops Options of the subscription.
+      /// \param[in] _callback Callback of the subscription.
+      /// \return Pointer to new Subscriber object
+      private: SubscriberPtr SubscribeCallback(const SubscribeOptions &_ops,
+                   const CallbackHelperPtr &_callback);
+
+      /// \brief Check whether a message on a topic is wanted by any of
+      /// the callbacks of the topic, and whether only the latest message
+      /// needs to be kept. Must be called with incomingMutex locked.
+      /// \param[in] _topic Topic of the message.
+      /// \param[in] _stamp Publication time of the message.
+      /// \param[in] _linkRate Rate limit the remote publisher already
+      /// applied to the message, zero for none.
+      /// \param[in] _linkLatestOnly True if the remote publisher only sent
+      /// the latest messages.
+      /// \param[out] _latestOnly True if every callback only wants the
+      /// latest message.
+      /// \return False if every callback would skip the message.
+      private: bool Wanted(const std::string &_topic,
+                   const common::Time &_stamp, const double _linkRate,
+                   const bool _linkLatestOnly, bool &_latestOnly) const;
+
       /// \internal
       /// \brief Private implementation of Init() and TryInit()
       /// \param[in] _space Namespace to initialize this Node to. Use an empty
@@ -414,14 +505,37 @@ namespace gazebo
       private: typedef std::list<CallbackHelperPtr> Callback_L;
       private: typedef std::map<std::string, Callback_L> Callback_M;
       private: Callback_M callbacks;
-      private: std::map<std::string, std::list<std::string> > incomingMsgs;
 
-      /// \brief List of newly arrive messages
-      private: std::map<std::string, std::list<MessagePtr> > incomingMsgsLocal;
+      /// \brief Newly arrived data.
+      private: class IncomingData
+      {
+        /// \brief The serialized message.
+        public: std::string data;
+
+        /// \brief Time at which the data was received.
+        public: common::Time stamp;
+
+        /// \brief Rate limit the remote publisher already applied, zero
+        /// for none.
+        public: double linkRate;
+
+        /// \brief True if the remote publisher only sent the latest
+        /// messages.
+        public: bool linkLatestOnly;
+      };
+
+      /// \brief List of newly arrived data, by topic.
+      private: std::map<std::string, std::list<IncomingData> > incomingMsgs;
+
+      /// \brief List of newly arrive messages, with the time at which they
+      /// were published.
+      private: std::map<std::string,
+               std::list<std::pair<MessagePtr, common::Time> > >
+               incomingMsgsLocal;
 
       private: boost::mutex publisherMutex;
       private: boost::mutex publisherDeleteMutex;
-      private: boost::recursive_mutex incomingMutex;
+      private: mutable boost::recursive_mutex incomingMutex;
 
       /// \brief make sure we don't call ProcessingIncoming simultaneously
       /// from separate threads.
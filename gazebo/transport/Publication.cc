@@ -15,11 +15,14 @@
  *
 */
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/common/WeakBind.hh"
 #include "SubscriptionTransport.hh"
 #include "Publication.hh"
+#include "ShmRing.hh"
 #include "Node.hh"
 
 using namespace gazebo;
@@ -136,8 +139,11 @@ void Publication::AddTransport(const PublicationTransportPtr &_publink)
   // Don't add a duplicate transport
   if (add)
   {
+    // The data carries the delivery policy of the link, so that local
+    // subscribers don't throttle it a second time.
     _publink->AddCallback(common::weakBind(&Publication::LocalPublish,
-                this->shared_from_this(), _1));
+                this->shared_from_this(), _1, _publink->MaxRate(),
+                _publink->LatestOnly()));
     this->transports.push_back(_publink);
   }
 }
@@ -177,6 +183,29 @@ void Publication::RemoveTransport(const std::string &host_, unsigned int port_)
   }
 }
 
+//////////////////////////////////////////////////
+bool Publication::RemoveThrottledTransports(const double _maxRate,
+    const bool _latestOnly)
+{
+  bool removed = false;
+  auto iter = this->transports.begin();
+  while (iter != this->transports.end())
+  {
+    const double rate = (*iter)->MaxRate();
+    if ((rate > 0 && (_maxRate <= 0 || _maxRate > rate)) ||
+        ((*iter)->LatestOnly() && !_latestOnly))
+    {
+      (*iter)->Fini();
+      iter = this->transports.erase(iter);
+      removed = true;
+    }
+    else
+      ++iter;
+  }
+
+  return removed;
+}
+
 //////////////////////////////////////////////////
 void Publication::RemoveSubscription(const NodePtr &_node)
 {
@@ -245,10 +274,16 @@ void Publication::RemoveSubscription(const std::string &_host,
 }
 
 //////////////////////////////////////////////////
-void Publication::LocalPublish(const std::string &_data)
+void Publication::LocalPublish(const std::string &_data,
+    const double _linkRate, const bool _linkLatestOnly)
 {
   std::list<NodePtr>::iterator iter, endIter;
 
+  this->stats.AddIncoming(_data.size());
+
+  // The latency of remote messages is measured from their reception.
+  const common::Time stamp = common::Time::GetWallTime();
+
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
 
@@ -256,7 +291,8 @@ void Publication::LocalPublish(const std::string &_data)
     endIter = this->nodes.end();
     while (iter != endIter)
     {
-      if ((*iter)->HandleData(this->topic, _data))
+      if ((*iter)->HandleData(this->topic, _data, stamp, _linkRate,
+            _linkLatestOnly))
         ++iter;
       else
         this->nodes.erase(iter++);
@@ -290,11 +326,15 @@ void Publication::LocalPublish(const std::string &_data)
 
 //////////////////////////////////////////////////
 int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
-    uint32_t _id)
+    uint32_t _id, const common::Time &_stamp)
 {
   int result = 0;
+  std::size_t bytes = 0;
   std::list<NodePtr>::iterator iter, endIter;
 
+  const common::Time stamp =
+    _stamp == common::Time::Zero ? common::Time::GetWallTime() : _stamp;
+
   {
     boost::mutex::scoped_lock lock(this->nodeMutex);
 
@@ -302,7 +342,7 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     endIter = this->nodes.end();
     while (iter != endIter)
     {
-      if ((*iter)->HandleMessage(this->topic, _msg))
+      if ((*iter)->HandleMessage(this->topic, _msg, stamp))
         ++iter;
       else
         this->nodes.erase(iter++);
@@ -319,14 +359,54 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
 
     if (!this->callbacks.empty())
     {
+      // The message is serialized, and written into shared memory, only
+      // once some subscriber wants it.
       std::string data;
-      _msg->SerializeToString(&data);
+      std::string shmDesc;
+      bool serialized = false;
+      bool shmWritten = false;
+
       std::list<CallbackHelperPtr>::iterator cbIter;
       cbIter = this->callbacks.begin();
 
       while (cbIter != this->callbacks.end())
       {
-        if ((*cbIter)->HandleData(data, _cb, _id))
+        // Subscribers that asked for a lower rate skip this message.
+        if (!(*cbIter)->Accept(stamp))
+        {
+          if (!_cb.empty())
+            _cb(_id);
+          ++result;
+          ++cbIter;
+          continue;
+        }
+
+        if (!serialized)
+        {
+          _msg->SerializeToString(&data);
+          bytes = data.size();
+          serialized = true;
+        }
+
+        // Large messages are written once into shared memory, and
+        // subscribers on this host only receive a small descriptor.
+        bool useShm = false;
+        if (data.size() >= ShmRing::kMinPayloadSize)
+        {
+          SubscriptionTransportPtr subptr =
+            boost::dynamic_pointer_cast<SubscriptionTransport>(*cbIter);
+          if (subptr && subptr->Shm())
+          {
+            if (!shmWritten)
+            {
+              this->WriteShm(data, shmDesc);
+              shmWritten = true;
+            }
+            useShm = !shmDesc.empty();
+          }
+        }
+
+        if ((*cbIter)->HandleData(useShm ? shmDesc : data, _cb, _id))
         {
           ++result;
           ++cbIter;
@@ -346,9 +426,72 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     }
   }
 
+  if (bytes == 0)
+  {
+#if GOOGLE_PROTOBUF_VERSION < 3001000
+    bytes = _msg->ByteSize();
+#else
+    bytes = _msg->ByteSizeLong();
+#endif
+  }
+  this->stats.AddOutgoing(bytes);
+
   return result;
 }
 
+//////////////////////////////////////////////////
+bool Publication::WriteShm(const std::string &_data, std::string &_descriptor)
+{
+  // Create a new ring when messages outgrow the current slots. Leave some
+  // headroom so that slowly growing messages don't recreate it every time.
+  if (!this->shmRing || this->shmRing->SlotSize() < _data.size())
+  {
+    ShmRingPtr ring = ShmRing::Create(ShmRing::UniqueName(),
+        ShmRing::kDefaultSlotCount, _data.size() + _data.size() / 4);
+
+    // Subscribers may still have descriptors of the current ring queued
+    if (ring)
+      ring->SetPrevious(this->shmRing);
+    this->shmRing = ring;
+  }
+
+  if (!this->shmRing || !this->shmRing->Write(_data, _descriptor))
+  {
+    _descriptor.clear();
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+TransportStats &Publication::Stats()
+{
+  return this->stats;
+}
+
+//////////////////////////////////////////////////
+void Publication::FillStats(msgs::TransportStats::Topic &_msg) const
+{
+  _msg.set_name(this->topic);
+  _msg.set_msg_type(this->msgType);
+  this->stats.Fill(_msg);
+
+  boost::mutex::scoped_lock lock(this->callbackMutex);
+  for (auto const &cb : this->callbacks)
+  {
+    SubscriptionTransportPtr subptr =
+      boost::dynamic_pointer_cast<SubscriptionTransport>(cb);
+    if (!subptr || !subptr->GetConnection())
+      continue;
+
+    const TransportStats &connStats = subptr->GetConnection()->Stats();
+    _msg.set_dropped(_msg.dropped() + connStats.Dropped());
+    _msg.set_queue_high_water(std::max<uint64_t>(_msg.queue_high_water(),
+          connStats.QueueHighWater()));
+  }
+}
+
 //////////////////////////////////////////////////
 std::string Publication::GetMsgType() const
 {
@@ -27,7 +27,9 @@
 #include <vector>
 #include <map>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/transport/CallbackHelper.hh"
+#include "gazebo/transport/TransportStats.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/PublicationTransport.hh"
 #include "gazebo/util/system.hh"
@@ -114,17 +116,26 @@ namespace gazebo
 
       /// \brief Publish data to local subscribers (skip serialization)
       /// \param[in] _data The data to be published
-      public: void LocalPublish(const std::string &_data);
+      /// \param[in] _linkRate Rate limit the remote publisher of the data
+      /// already applied, zero for none.
+      /// \param[in] _linkLatestOnly True if the remote publisher only sends
+      /// the latest messages.
+      public: void LocalPublish(const std::string &_data,
+                  const double _linkRate = 0,
+                  const bool _linkLatestOnly = false);
 
       /// \brief Publish data to remote subscribers
       /// \param[in] _msg Message to be published
       /// \param[in] _cb Callback to be invoked after publishing
       /// is completed
+      /// \param[in] _stamp Wall time at which the message was published,
+      /// used to measure the latency to local subscribers. Zero means now.
       /// \return Number of remote subscribers that will receive the
       /// message.
       public: int Publish(MessagePtr _msg,
                   boost::function<void(uint32_t)> _cb,
-                  uint32_t _id);
+                  uint32_t _id,
+                  const common::Time &_stamp = common::Time::Zero);
 
       /// \brief Remove a publisher.
       /// \param[in] _pub Pointer to publisher object to remove.
@@ -160,13 +171,45 @@ namespace gazebo
       /// \return true if the transport exists, false otherwise
       public: bool HasTransport(const std::string &_host, unsigned int _port);
 
+      /// \brief Remove the transports from remote publishers that were
+      /// negotiated for subscribers with a lower maximum rate, or for
+      /// latest-only subscribers, and so would hold back messages from a
+      /// new subscriber. The remote publishers are then connected again
+      /// with the policy of all the subscribers.
+      /// \param[in] _maxRate Maximum rate of the new subscriber, zero for
+      /// no limit.
+      /// \param[in] _latestOnly True if the new subscriber only wants the
+      /// latest message.
+      /// \return True if a transport was removed.
+      public: bool RemoveThrottledTransports(const double _maxRate,
+                  const bool _latestOnly);
+
       /// \brief Add a publisher
       /// \param[in,out] _pub Pointer to publisher object to be added
       public: void AddPublisher(PublisherPtr _pub);
 
+      /// \brief Get the traffic counters of the topic.
+      /// \return Counters of the topic.
+      public: TransportStats &Stats();
+
+      /// \brief Write the statistics of the topic into a message. The
+      /// drops and queue high-water marks of the open connections to
+      /// remote subscribers are included.
+      /// \param[out] _msg Message to fill.
+      public: void FillStats(msgs::TransportStats::Topic &_msg) const;
+
       /// \brief Remove nodes that have been marked for removal
       private: void RemoveNodes();
 
+      /// \brief Write serialized data into the shared memory ring,
+      /// creating or growing the ring as needed.
+      /// \param[in] _data Serialized message.
+      /// \param[out] _descriptor Descriptor to send to shared memory
+      /// subscribers. Empty on failure.
+      /// \return True on success.
+      private: bool WriteShm(const std::string &_data,
+                   std::string &_descriptor);
+
       /// \brief Unique if of the publication.
       private: unsigned int id;
 
@@ -211,6 +254,13 @@ namespace gazebo
 
       /// \brief Publishers and their last messages.
       private: std::map<uint32_t, MessagePtr> prevMsgs;
+
+      /// \brief Traffic counters of the topic.
+      private: TransportStats stats;
+
+      /// \brief Shared memory ring for subscribers on this host. Created
+      /// on the first large message, and protected by callbackMutex.
+      private: ShmRingPtr shmRing;
     };
     /// \}
   }
@@ -19,6 +19,7 @@
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
 #include "gazebo/transport/PublicationTransport.hh"
+#include "gazebo/transport/ShmRing.hh"
 #include "gazebo/common/WeakBind.hh"
 
 using namespace gazebo;
@@ -55,9 +56,12 @@ PublicationTransport::~PublicationTransport()
 }
 
 /////////////////////////////////////////////////
-void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
+void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched,
+    const double _maxRate, const bool _latestOnly)
 {
   this->connection = _conn;
+  this->maxRate = _maxRate;
+  this->latestOnly = _latestOnly;
   msgs::Subscribe sub;
   sub.set_topic(this->topic);
   sub.set_msg_type(this->msgType);
@@ -65,6 +69,17 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
   sub.set_port(this->connection->GetLocalPort());
   sub.set_latching(_latched);
 
+  // Let the publisher skip the messages no local subscriber wants
+  if (_maxRate > 0)
+    sub.set_max_rate(_maxRate);
+  if (_latestOnly)
+    sub.set_latest_only(true);
+
+  // Offer to receive large messages through shared memory. The publisher
+  // accepts only if it lives in the same shared memory namespace.
+  if (ShmRing::Enabled() && !ShmRing::HostId().empty())
+    sub.set_shm_host_id(ShmRing::HostId());
+
   this->connection->EnqueueMsg(msgs::Package("sub", sub));
 
   // Put this in PublicationTransportPtr
@@ -74,6 +89,18 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
 }
 
 
+/////////////////////////////////////////////////
+double PublicationTransport::MaxRate() const
+{
+  return this->maxRate;
+}
+
+/////////////////////////////////////////////////
+bool PublicationTransport::LatestOnly() const
+{
+  return this->latestOnly;
+}
+
 /////////////////////////////////////////////////
 void PublicationTransport::AddCallback(
     const boost::function<void(const std::string &)> &cb_)
@@ -90,14 +117,49 @@ void PublicationTransport::OnPublish(const std::string &_data)
         common::weakBind(&PublicationTransport::OnPublish,
             this->shared_from_this(), _1));
 
-    if (!_data.empty())
+    if (!_data.empty() && this->callback)
     {
-      if (this->callback)
+      if (ShmRing::IsDescriptor(_data))
+      {
+        std::string data;
+        if (this->ReadShm(_data, data))
+          (this->callback)(data);
+      }
+      else
         (this->callback)(_data);
     }
   }
 }
 
+/////////////////////////////////////////////////
+bool PublicationTransport::ReadShm(const std::string &_descriptor,
+    std::string &_data)
+{
+  std::lock_guard<std::mutex> lock(this->shmMutex);
+
+  // The publisher creates a new ring when its messages outgrow the slots,
+  // so reopen whenever the descriptor names a different ring.
+  const std::string name = ShmRing::DescriptorName(_descriptor);
+  if (!this->shmRing || this->shmRing->Name() != name)
+    this->shmRing = ShmRing::Open(name);
+
+  // The ring is gone if the publisher replaced it and recycled the slots
+  // of its replacement since.
+  if (!this->shmRing || !this->shmRing->Read(_descriptor, _data))
+  {
+    if (!this->shmDropWarned)
+    {
+      gzwarn << "Dropped a shared memory message on topic[" << this->topic
+             << "] that was overwritten before it could be read. "
+             << "This warning is printed only once." << std::endl;
+      this->shmDropWarned = true;
+    }
+    return false;
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 const ConnectionPtr PublicationTransport::GetConnection() const
 {
@@ -20,9 +20,11 @@
 
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <mutex>
 #include <string>
 
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/util/system.hh"
 
@@ -53,7 +55,22 @@ namespace gazebo
       /// \param[in] _conn The underlying connection.
       /// \param[in] _latched True to grab the last message sent on the
       /// topic.
-      public: void Init(const ConnectionPtr &_conn, bool _latched);
+      /// \param[in] _maxRate Maximum rate of messages asked from the
+      /// publisher, zero for no limit.
+      /// \param[in] _latestOnly True to ask the publisher for the latest
+      /// message only.
+      public: void Init(const ConnectionPtr &_conn, bool _latched,
+                        const double _maxRate = 0,
+                        const bool _latestOnly = false);
+
+      /// \brief Get the maximum rate of messages asked from the publisher.
+      /// \return Maximum number of messages per second, zero if there is
+      /// no limit.
+      public: double MaxRate() const;
+
+      /// \brief Was the publisher asked for the latest message only?
+      /// \return True if the publisher drops superseded messages.
+      public: bool LatestOnly() const;
 
       /// \brief Finalize the transport
       public: void Fini();
@@ -79,6 +96,13 @@ namespace gazebo
       /// \param[in] _data Data to be published.
       private: void OnPublish(const std::string &_data);
 
+      /// \brief Copy a message out of the publisher's shared memory ring.
+      /// \param[in] _descriptor Descriptor received from the publisher.
+      /// \param[out] _data The serialized message.
+      /// \return True if the message could be read.
+      private: bool ReadShm(const std::string &_descriptor,
+                   std::string &_data);
+
       /// \brief The topic for this publication transport.
       private: std::string topic;
 
@@ -88,9 +112,27 @@ namespace gazebo
       /// \brief The connection for the publication transport
       private: ConnectionPtr connection;
 
+      /// \brief Maximum rate of messages asked from the publisher.
+      private: double maxRate = 0;
+
+      /// \brief True if the publisher was asked for the latest message only.
+      private: bool latestOnly = false;
+
       /// \brief Callback used when OnPublish is called.
       private: boost::function<void (const std::string &)> callback;
 
+      /// \brief Shared memory ring of the remote publisher, opened on the
+      /// first descriptor that is received.
+      private: ShmRingPtr shmRing;
+
+      /// \brief True if a warning about a dropped shared memory message
+      /// was produced.
+      private: bool shmDropWarned = false;
+
+      /// \brief Protects the shared memory ring. Reads are dispatched
+      /// from concurrent tasks.
+      private: std::mutex shmMutex;
+
       /// \brief Counter to give the publication transport a unique id.
       private: static int counter;
 
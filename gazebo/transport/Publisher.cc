@@ -18,6 +18,7 @@
  * Author: Nate Koenig
  */
 #include <boost/bind.hpp>
+#include <utility>
 
 #include <ignition/math/Helpers.hh>
 
@@ -26,6 +27,7 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/TransportStats.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -125,11 +127,13 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
   {
     boost::mutex::scoped_lock lock(this->mutex);
 
-    this->messages.push_back(msgPtr);
+    this->messages.push_back(
+        std::make_pair(msgPtr, common::Time::GetWallTime()));
 
     if (this->messages.size() > this->queueLimit)
     {
       this->messages.pop_front();
+      this->publication->Stats().AddDropped();
 
       if (!queueLimitWarned)
       {
@@ -140,6 +144,8 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
         queueLimitWarned = true;
       }
     }
+
+    this->publication->Stats().UpdateQueueDepth(this->messages.size());
   }
 
   TopicManager::Instance()->AddNodeToProcess(this->node);
@@ -158,7 +164,7 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
 //////////////////////////////////////////////////
 void Publisher::SendMessage()
 {
-  std::list<MessagePtr> localBuffer;
+  std::list<std::pair<MessagePtr, common::Time> > localBuffer;
   std::list<uint32_t> localIds;
 
   {
@@ -186,8 +192,8 @@ void Publisher::SendMessage()
     std::list<uint32_t>::iterator pubIter = localIds.begin();
 
     // Send all the current messages
-    for (std::list<MessagePtr>::iterator iter = localBuffer.begin();
-        iter != localBuffer.end(); ++iter, ++pubIter)
+    for (auto iter = localBuffer.begin(); iter != localBuffer.end();
+        ++iter, ++pubIter)
     {
       // Expected number of calls to the callback function
       // Publisher::OnPublishComplete() triggered by subscriber callbacks.
@@ -212,9 +218,9 @@ void Publisher::SendMessage()
       // calling of OnPublishComplete() happens asynchronously though
       // (the subscriber callback SubscriptionTransport::HandleData() only
       // enqueues the message!).
-      int result = this->publication->Publish(*iter,
+      int result = this->publication->Publish(iter->first,
           common::weakBind(&Publisher::OnPublishComplete,
-              this->shared_from_this(), _1), *pubIter);
+              this->shared_from_this(), _1), *pubIter, iter->second);
 
       // It is possible that OnPublishComplete() was called less times than
       // initially expected, which happens when a callback of the
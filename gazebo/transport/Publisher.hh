@@ -27,6 +27,7 @@
 #include <string>
 #include <list>
 #include <map>
+#include <utility>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/transport/TransportTypes.hh"
@@ -169,8 +170,9 @@ namespace gazebo
       /// was produced.
       private: bool queueLimitWarned;
 
-      /// \brief List of messages to publish.
-      private: std::list<MessagePtr> messages;
+      /// \brief List of messages to publish, with the time at which they
+      /// were published.
+      private: std::list<std::pair<MessagePtr, common::Time> > messages;
 
       /// \brief For mutual exclusion.
       private: mutable boost::mutex mutex;
@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __linux__
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/ShmRing.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+const uint64_t ShmRing::kMinPayloadSize = 64 * 1024;
+const uint32_t ShmRing::kDefaultSlotCount = 8;
+
+namespace
+{
+  /// \brief Marks the start of a ring.
+  const uint32_t kRingMagic = 0x475a5352;
+
+  /// \brief Descriptor prefix. 'G' (0x47) has wire type 7, which is
+  /// invalid for the first byte of a serialized protobuf message.
+  const char kDescMagic[4] = {'G', 'Z', 'S', 'M'};
+
+  /// \brief Size of magic, slot, sequence and payload size fields.
+  const std::size_t kDescHeaderSize = 4 + 4 + 8 + 8;
+
+  /// \brief Alignment of slots inside the ring.
+  const uint64_t kSlotAlign = 64;
+
+  /// \brief Header at the start of the mapped region.
+  struct RingHeader
+  {
+    uint32_t magic;
+    uint32_t slotCount;
+    uint64_t slotSize;
+    uint64_t slotStride;
+  };
+
+  /// \brief Header at the start of every slot.
+  struct SlotHeader
+  {
+    /// \brief Sequence number of the payload, zero while being written.
+    std::atomic<uint64_t> seq;
+
+    /// \brief Payload size in bytes.
+    uint64_t size;
+  };
+
+  /// \brief Offset of the first slot.
+  const uint64_t kRingHeaderSize =
+    ((sizeof(RingHeader) + kSlotAlign - 1) / kSlotAlign) * kSlotAlign;
+
+  /// \brief Offset of a payload inside its slot.
+  const uint64_t kSlotHeaderSize =
+    ((sizeof(SlotHeader) + kSlotAlign - 1) / kSlotAlign) * kSlotAlign;
+
+  /////////////////////////////////////////////////
+  bool ParseDescriptor(const std::string &_desc, uint32_t &_slot,
+      uint64_t &_seq, uint64_t &_size, std::string &_name)
+  {
+    if (!ShmRing::IsDescriptor(_desc) || _desc.size() <= kDescHeaderSize)
+      return false;
+
+    const char *ptr = _desc.data() + sizeof(kDescMagic);
+    memcpy(&_slot, ptr, sizeof(_slot));
+    ptr += sizeof(_slot);
+    memcpy(&_seq, ptr, sizeof(_seq));
+    ptr += sizeof(_seq);
+    memcpy(&_size, ptr, sizeof(_size));
+    _name = _desc.substr(kDescHeaderSize);
+    return true;
+  }
+}
+
+/////////////////////////////////////////////////
+ShmRing::ShmRing()
+{
+}
+
+/////////////////////////////////////////////////
+ShmRing::~ShmRing()
+{
+#ifdef __linux__
+  if (this->region)
+    munmap(this->region, this->regionSize);
+  if (this->owner)
+    shm_unlink(this->name.c_str());
+#endif
+}
+
+/////////////////////////////////////////////////
+ShmRingPtr ShmRing::Create(const std::string &_name,
+    const uint32_t _slotCount, const uint64_t _slotSize)
+{
+#ifdef __linux__
+  if (_slotCount == 0 || _slotSize == 0)
+    return ShmRingPtr();
+
+  const uint64_t stride = kSlotHeaderSize +
+    ((_slotSize + kSlotAlign - 1) / kSlotAlign) * kSlotAlign;
+  const std::size_t size = kRingHeaderSize + stride * _slotCount;
+
+  // Remove a stale object left behind by a crashed process.
+  shm_unlink(_name.c_str());
+
+  int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    gzerr << "Unable to create shared memory[" << _name << "]: "
+          << strerror(errno) << std::endl;
+    return ShmRingPtr();
+  }
+
+  if (ftruncate(fd, size) != 0)
+  {
+    gzerr << "Unable to size shared memory[" << _name << "] to "
+          << size << " bytes: " << strerror(errno) << std::endl;
+    close(fd);
+    shm_unlink(_name.c_str());
+    return ShmRingPtr();
+  }
+
+  void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+  {
+    gzerr << "Unable to map shared memory[" << _name << "]: "
+          << strerror(errno) << std::endl;
+    shm_unlink(_name.c_str());
+    return ShmRingPtr();
+  }
+
+  ShmRingPtr ring(new ShmRing());
+  ring->name = _name;
+  ring->region = static_cast<unsigned char *>(addr);
+  ring->regionSize = size;
+  ring->slotCount = _slotCount;
+  ring->slotSize = _slotSize;
+  ring->slotStride = stride;
+  ring->owner = true;
+
+  for (uint32_t i = 0; i < _slotCount; ++i)
+  {
+    SlotHeader *slot = new (ring->Slot(i)) SlotHeader;
+    slot->seq.store(0, std::memory_order_relaxed);
+    slot->size = 0;
+  }
+
+  RingHeader *header = reinterpret_cast<RingHeader *>(ring->region);
+  header->slotCount = _slotCount;
+  header->slotSize = _slotSize;
+  header->slotStride = stride;
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = kRingMagic;
+
+  return ring;
+#else
+  gzerr << "Shared memory transport is not supported on this platform. "
+        << "Unable to create[" << _name << "]\n";
+  (void)_slotCount;
+  (void)_slotSize;
+  return ShmRingPtr();
+#endif
+}
+
+/////////////////////////////////////////////////
+ShmRingPtr ShmRing::Open(const std::string &_name)
+{
+#ifdef __linux__
+  int fd = shm_open(_name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    // The owner removed a ring that was replaced, or exited
+    if (errno == ENOENT)
+      return ShmRingPtr();
+
+    gzerr << "Unable to open shared memory[" << _name << "]: "
+          << strerror(errno) << std::endl;
+    return ShmRingPtr();
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<uint64_t>(st.st_size) < kRingHeaderSize)
+  {
+    gzerr << "Shared memory[" << _name << "] is too small\n";
+    close(fd);
+    return ShmRingPtr();
+  }
+
+  const std::size_t size = st.st_size;
+  void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+  {
+    gzerr << "Unable to map shared memory[" << _name << "]: "
+          << strerror(errno) << std::endl;
+    return ShmRingPtr();
+  }
+
+  ShmRingPtr ring(new ShmRing());
+  ring->name = _name;
+  ring->region = static_cast<unsigned char *>(addr);
+  ring->regionSize = size;
+
+  const RingHeader *header = reinterpret_cast<const RingHeader *>(addr);
+  if (header->magic != kRingMagic)
+  {
+    gzerr << "Shared memory[" << _name << "] is not a gazebo ring\n";
+    return ShmRingPtr();
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  if (kRingHeaderSize + header->slotStride * header->slotCount > size)
+  {
+    gzerr << "Shared memory[" << _name << "] has an invalid header\n";
+    return ShmRingPtr();
+  }
+
+  ring->slotCount = header->slotCount;
+  ring->slotSize = header->slotSize;
+  ring->slotStride = header->slotStride;
+
+  return ring;
+#else
+  gzerr << "Shared memory transport is not supported on this platform. "
+        << "Unable to open[" << _name << "]\n";
+  return ShmRingPtr();
+#endif
+}
+
+/////////////////////////////////////////////////
+bool ShmRing::Write(const std::string &_data, std::string &_descriptor)
+{
+  if (!this->owner || _data.size() > this->slotSize)
+    return false;
+
+  // Sequence numbers start at one, zero marks a slot being written.
+  const uint64_t newSeq = ++this->seq;
+  const uint32_t index = static_cast<uint32_t>(newSeq % this->slotCount);
+  unsigned char *slotPtr = this->Slot(index);
+  SlotHeader *slot = reinterpret_cast<SlotHeader *>(slotPtr);
+
+  slot->seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->size = _data.size();
+  memcpy(slotPtr + kSlotHeaderSize, _data.data(), _data.size());
+  slot->seq.store(newSeq, std::memory_order_release);
+
+  // Descriptors of the previous ring are older than the one of the
+  // recycled slot.
+  if (this->previous && newSeq > this->slotCount)
+    this->previous.reset();
+
+  const uint64_t size = _data.size();
+  _descriptor.resize(kDescHeaderSize + this->name.size());
+  char *ptr = &_descriptor[0];
+  memcpy(ptr, kDescMagic, sizeof(kDescMagic));
+  ptr += sizeof(kDescMagic);
+  memcpy(ptr, &index, sizeof(index));
+  ptr += sizeof(index);
+  memcpy(ptr, &newSeq, sizeof(newSeq));
+  ptr += sizeof(newSeq);
+  memcpy(ptr, &size, sizeof(size));
+  ptr += sizeof(size);
+  memcpy(ptr, this->name.data(), this->name.size());
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool ShmRing::Read(const std::string &_descriptor, std::string &_data) const
+{
+  uint32_t index;
+  uint64_t wantSeq;
+  uint64_t size;
+  std::string descName;
+  if (!ParseDescriptor(_descriptor, index, wantSeq, size, descName) ||
+      descName != this->name || index >= this->slotCount ||
+      size > this->slotSize)
+  {
+    return false;
+  }
+
+  const unsigned char *slotPtr = this->Slot(index);
+  const SlotHeader *slot = reinterpret_cast<const SlotHeader *>(slotPtr);
+
+  if (slot->seq.load(std::memory_order_acquire) != wantSeq)
+    return false;
+
+  _data.assign(reinterpret_cast<const char *>(slotPtr + kSlotHeaderSize),
+      size);
+
+  // The writer may have recycled the slot while we were copying.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot->seq.load(std::memory_order_relaxed) == wantSeq;
+}
+
+/////////////////////////////////////////////////
+unsigned char *ShmRing::Slot(const uint32_t _slot) const
+{
+  return this->region + kRingHeaderSize + this->slotStride * _slot;
+}
+
+/////////////////////////////////////////////////
+void ShmRing::SetPrevious(const ShmRingPtr &_ring)
+{
+  this->previous = _ring;
+}
+
+/////////////////////////////////////////////////
+std::string ShmRing::Name() const
+{
+  return this->name;
+}
+
+/////////////////////////////////////////////////
+uint32_t ShmRing::SlotCount() const
+{
+  return this->slotCount;
+}
+
+/////////////////////////////////////////////////
+uint64_t ShmRing::SlotSize() const
+{
+  return this->slotSize;
+}
+
+/////////////////////////////////////////////////
+bool ShmRing::IsDescriptor(const std::string &_data)
+{
+  return _data.size() > sizeof(kDescMagic) &&
+    memcmp(_data.data(), kDescMagic, sizeof(kDescMagic)) == 0;
+}
+
+/////////////////////////////////////////////////
+std::string ShmRing::DescriptorName(const std::string &_descriptor)
+{
+  uint32_t index;
+  uint64_t seq;
+  uint64_t size;
+  std::string result;
+  if (!ParseDescriptor(_descriptor, index, seq, size, result))
+    result.clear();
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::string ShmRing::UniqueName()
+{
+  static std::atomic<unsigned int> counter(0);
+#ifdef __linux__
+  const std::string pid = std::to_string(getpid());
+#else
+  const std::string pid = "0";
+#endif
+  return "/gazebo_" + pid + "_" + std::to_string(counter++);
+}
+
+/////////////////////////////////////////////////
+bool ShmRing::Enabled()
+{
+#ifdef __linux__
+  static const bool enabled = []()
+  {
+    const char *env = getenv("GAZEBO_SHM_TRANSPORT");
+    return !env || std::string(env) != "0";
+  }();
+  return enabled;
+#else
+  return false;
+#endif
+}
+
+/////////////////////////////////////////////////
+std::string ShmRing::HostId()
+{
+#ifdef __linux__
+  static const std::string hostId = []()
+  {
+    // The boot id identifies the kernel, and the device of /dev/shm
+    // identifies the IPC namespace. Containers with a private /dev/shm
+    // therefore get their own identifier.
+    std::string bootId;
+    std::ifstream bootFile("/proc/sys/kernel/random/boot_id");
+    if (!bootFile || !std::getline(bootFile, bootId) || bootId.empty())
+      return std::string();
+
+    struct stat st;
+    if (stat("/dev/shm", &st) != 0)
+      return std::string();
+
+    return bootId + ":" + std::to_string(st.st_dev);
+  }();
+  return hostId;
+#else
+  return std::string();
+#endif
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_SHMRING_HH_
+#define GAZEBO_TRANSPORT_SHMRING_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class ShmRing ShmRing.hh transport/transport.hh
+    /// \brief A ring of fixed size slots in POSIX shared memory.
+    ///
+    /// A publication writes each large serialized message once into the
+    /// next slot of its ring, and sends only a small descriptor over the
+    /// TCP connection of every subscriber that lives on the same host.
+    /// Subscribers map the ring read-only and copy the payload out of the
+    /// slot named by the descriptor.
+    ///
+    /// Every slot carries a sequence number which is cleared while the
+    /// slot is being written. A reader that falls more than SlotCount()
+    /// messages behind the writer detects that its slot has been
+    /// recycled and drops the message.
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_SHM_TRANSPORT: Set to 0 to disable the shared memory
+    /// transport, and always send full messages over TCP.
+    class GZ_TRANSPORT_VISIBLE ShmRing
+    {
+      /// \brief Constructor. Use Create() or Open() instead.
+      private: ShmRing();
+
+      /// \brief Destructor. Unmaps the ring, and removes the shared memory
+      /// object if this ring was created by the calling process.
+      public: virtual ~ShmRing();
+
+      /// \brief Create a new ring, owned by the calling process.
+      /// \param[in] _name Name of the shared memory object. Must start
+      /// with a '/'.
+      /// \param[in] _slotCount Number of slots in the ring.
+      /// \param[in] _slotSize Maximum payload size of a slot in bytes.
+      /// \return Pointer to the ring, or null on error.
+      public: static ShmRingPtr Create(const std::string &_name,
+                  const uint32_t _slotCount, const uint64_t _slotSize);
+
+      /// \brief Open an existing ring for reading.
+      /// \param[in] _name Name of the shared memory object.
+      /// \return Pointer to the ring, or null on error. No error is printed
+      /// if the owner already removed the ring.
+      public: static ShmRingPtr Open(const std::string &_name);
+
+      /// \brief Copy a payload into the next slot of the ring.
+      /// \param[in] _data Payload to write. Must not be larger than
+      /// SlotSize().
+      /// \param[out] _descriptor Descriptor to send to subscribers in
+      /// place of the payload.
+      /// \return True on success.
+      public: bool Write(const std::string &_data, std::string &_descriptor);
+
+      /// \brief Copy the payload referenced by a descriptor out of the
+      /// ring.
+      /// \param[in] _descriptor Descriptor produced by Write().
+      /// \param[out] _data The payload.
+      /// \return False if the descriptor is invalid or the slot has been
+      /// overwritten since the descriptor was produced.
+      public: bool Read(const std::string &_descriptor,
+                  std::string &_data) const;
+
+      /// \brief Keep the ring that this ring replaces mapped, and its
+      /// shared memory object linked, until this ring recycles its first
+      /// slot. Subscribers may still have descriptors of the previous
+      /// ring queued, and read them in order before the descriptors of
+      /// this ring. Once a slot is recycled, those descriptors would be
+      /// stale anyway.
+      /// \param[in] _ring The replaced ring.
+      public: void SetPrevious(const ShmRingPtr &_ring);
+
+      /// \brief Get the name of the shared memory object.
+      /// \return Name of the shared memory object.
+      public: std::string Name() const;
+
+      /// \brief Get the number of slots in the ring.
+      /// \return Number of slots.
+      public: uint32_t SlotCount() const;
+
+      /// \brief Get the maximum payload size of a slot.
+      /// \return Slot size in bytes.
+      public: uint64_t SlotSize() const;
+
+      /// \brief Is the given data a shared memory descriptor? Descriptors
+      /// start with a byte that can not start a serialized protobuf
+      /// message, so they can share a connection with regular messages.
+      /// \param[in] _data Data read from a connection.
+      /// \return True if _data is a descriptor.
+      public: static bool IsDescriptor(const std::string &_data);
+
+      /// \brief Get the name of the ring a descriptor refers to.
+      /// \param[in] _descriptor A descriptor.
+      /// \return Ring name, or an empty string if _descriptor is invalid.
+      public: static std::string DescriptorName(
+                  const std::string &_descriptor);
+
+      /// \brief Generate a shared memory object name that is unique across
+      /// processes and calls.
+      /// \return A name suitable for Create().
+      public: static std::string UniqueName();
+
+      /// \brief Is the shared memory transport enabled in this process?
+      /// \return False on unsupported platforms, or when disabled through
+      /// GAZEBO_SHM_TRANSPORT.
+      public: static bool Enabled();
+
+      /// \brief Get a string that identifies the shared memory namespace
+      /// of this process. Two processes can exchange data through a ring
+      /// only when their identifiers match.
+      /// \return Identifier, or an empty string if unsupported.
+      public: static std::string HostId();
+
+      /// \brief Messages smaller than this are always sent over TCP.
+      public: static const uint64_t kMinPayloadSize;
+
+      /// \brief Default number of slots in a publication's ring.
+      public: static const uint32_t kDefaultSlotCount;
+
+      /// \brief Get a pointer to the header of a slot.
+      /// \param[in] _slot Slot index.
+      /// \return Pointer into the mapped region.
+      private: unsigned char *Slot(const uint32_t _slot) const;
+
+      /// \brief Name of the shared memory object.
+      private: std::string name;
+
+      /// \brief Start of the mapped region.
+      private: unsigned char *region = nullptr;
+
+      /// \brief Size of the mapped region.
+      private: std::size_t regionSize = 0;
+
+      /// \brief Number of slots.
+      private: uint32_t slotCount = 0;
+
+      /// \brief Payload capacity of a slot.
+      private: uint64_t slotSize = 0;
+
+      /// \brief Distance between the start of two slots.
+      private: uint64_t slotStride = 0;
+
+      /// \brief Sequence number of the last write. Only used by the owner.
+      private: uint64_t seq = 0;
+
+      /// \brief True if this process created the ring.
+      private: bool owner = false;
+
+      /// \brief Ring replaced by this one, kept alive for the subscribers
+      /// that didn't read all of its descriptors yet.
+      private: ShmRingPtr previous;
+    };
+    /// \}
+  }
+}
+#endif
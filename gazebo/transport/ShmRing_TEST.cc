@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/transport/ShmRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ShmRingTest : public gazebo::testing::AutoLogFixture { };
+
+#ifdef __linux__
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, WriteRead)
+{
+  transport::ShmRingPtr writer = transport::ShmRing::Create(
+      transport::ShmRing::UniqueName(), 4, 1024);
+  ASSERT_TRUE(writer != nullptr);
+  EXPECT_EQ(writer->SlotCount(), 4u);
+  EXPECT_EQ(writer->SlotSize(), 1024u);
+
+  transport::ShmRingPtr reader = transport::ShmRing::Open(writer->Name());
+  ASSERT_TRUE(reader != nullptr);
+  EXPECT_EQ(reader->SlotCount(), 4u);
+  EXPECT_EQ(reader->SlotSize(), 1024u);
+
+  std::string payload(1000, 'a');
+  payload[0] = 'x';
+  payload[999] = 'y';
+
+  std::string desc;
+  EXPECT_TRUE(writer->Write(payload, desc));
+  EXPECT_TRUE(transport::ShmRing::IsDescriptor(desc));
+  EXPECT_LT(desc.size(), 64u);
+  EXPECT_EQ(transport::ShmRing::DescriptorName(desc), writer->Name());
+
+  std::string data;
+  EXPECT_TRUE(reader->Read(desc, data));
+  EXPECT_EQ(data, payload);
+
+  // Payloads larger than a slot are rejected
+  EXPECT_FALSE(writer->Write(std::string(1025, 'b'), desc));
+
+  // Readers can't write
+  EXPECT_FALSE(reader->Write(payload, desc));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, Overwrite)
+{
+  transport::ShmRingPtr writer = transport::ShmRing::Create(
+      transport::ShmRing::UniqueName(), 2, 16);
+  ASSERT_TRUE(writer != nullptr);
+  transport::ShmRingPtr reader = transport::ShmRing::Open(writer->Name());
+  ASSERT_TRUE(reader != nullptr);
+
+  std::string desc1, desc2, desc3;
+  EXPECT_TRUE(writer->Write("first", desc1));
+  EXPECT_TRUE(writer->Write("second", desc2));
+
+  std::string data;
+  EXPECT_TRUE(reader->Read(desc1, data));
+  EXPECT_EQ(data, "first");
+
+  // The third write recycles the slot of the first
+  EXPECT_TRUE(writer->Write("third", desc3));
+  EXPECT_FALSE(reader->Read(desc1, data));
+  EXPECT_TRUE(reader->Read(desc2, data));
+  EXPECT_EQ(data, "second");
+  EXPECT_TRUE(reader->Read(desc3, data));
+  EXPECT_EQ(data, "third");
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, Unlink)
+{
+  std::string name = transport::ShmRing::UniqueName();
+  EXPECT_NE(name, transport::ShmRing::UniqueName());
+
+  {
+    transport::ShmRingPtr writer = transport::ShmRing::Create(name, 2, 16);
+    ASSERT_TRUE(writer != nullptr);
+  }
+
+  // The owner removes the shared memory object on destruction
+  EXPECT_TRUE(transport::ShmRing::Open(name) == nullptr);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, Replace)
+{
+  transport::ShmRingPtr writer = transport::ShmRing::Create(
+      transport::ShmRing::UniqueName(), 2, 16);
+  ASSERT_TRUE(writer != nullptr);
+  const std::string oldName = writer->Name();
+
+  // A descriptor still queued for a reader which didn't open the ring yet
+  std::string oldDesc;
+  EXPECT_TRUE(writer->Write("old", oldDesc));
+
+  // Messages outgrew the slots, the writer replaces its ring
+  transport::ShmRingPtr ring = transport::ShmRing::Create(
+      transport::ShmRing::UniqueName(), 2, 64);
+  ASSERT_TRUE(ring != nullptr);
+  ring->SetPrevious(writer);
+  writer = ring;
+
+  std::string desc1, desc2, desc3;
+  EXPECT_TRUE(writer->Write("new1", desc1));
+  EXPECT_TRUE(writer->Write("new2", desc2));
+
+  // The replaced ring is kept until a slot of the new one is recycled
+  std::string data;
+  transport::ShmRingPtr reader = transport::ShmRing::Open(oldName);
+  ASSERT_TRUE(reader != nullptr);
+  EXPECT_TRUE(reader->Read(oldDesc, data));
+  EXPECT_EQ(data, "old");
+  reader.reset();
+
+  EXPECT_TRUE(writer->Write("new3", desc3));
+  EXPECT_TRUE(transport::ShmRing::Open(oldName) == nullptr);
+
+  reader = transport::ShmRing::Open(writer->Name());
+  ASSERT_TRUE(reader != nullptr);
+  EXPECT_FALSE(reader->Read(desc1, data));
+  EXPECT_TRUE(reader->Read(desc3, data));
+  EXPECT_EQ(data, "new3");
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, HostId)
+{
+  EXPECT_FALSE(transport::ShmRing::HostId().empty());
+  EXPECT_EQ(transport::ShmRing::HostId(), transport::ShmRing::HostId());
+}
+#endif
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, Descriptor)
+{
+  EXPECT_FALSE(transport::ShmRing::IsDescriptor(""));
+  EXPECT_FALSE(transport::ShmRing::IsDescriptor("GZSM"));
+  EXPECT_FALSE(transport::ShmRing::IsDescriptor("\x0a\x04test"));
+  EXPECT_TRUE(transport::ShmRing::DescriptorName("GZSMxyz").empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
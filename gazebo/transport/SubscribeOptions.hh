@@ -103,10 +103,58 @@ namespace gazebo
                 return this->latching;
               }
 
+      /// \brief Set whether to latch the latest message.
+      /// \param[in] _latching True to get the last message published
+      /// before the subscription.
+      public: void SetLatching(const bool _latching)
+              {
+                this->latching = _latching;
+              }
+
+      /// \brief Set the maximum rate at which the subscriber gets
+      /// messages. Remote publishers skip serializing and sending the
+      /// messages that come sooner.
+      /// \param[in] _hz Maximum number of messages per second of
+      /// publication time. Zero means no limit.
+      public: void SetMaxRate(const double _hz)
+              {
+                this->maxRate = _hz > 0 ? _hz : 0.0;
+              }
+
+      /// \brief Get the maximum rate at which the subscriber gets messages.
+      /// \return Maximum number of messages per second, zero if there is
+      /// no limit.
+      public: double MaxRate() const
+              {
+                return this->maxRate;
+              }
+
+      /// \brief Set whether the subscriber only wants the latest message.
+      /// Messages that are superseded while they wait in a queue, on either
+      /// side of the connection, are then dropped.
+      /// \param[in] _latestOnly True to only get the latest message.
+      public: void SetLatestOnly(const bool _latestOnly)
+              {
+                this->latestOnly = _latestOnly;
+              }
+
+      /// \brief Does the subscriber only want the latest message?
+      /// \return True if superseded messages are dropped.
+      public: bool LatestOnly() const
+              {
+                return this->latestOnly;
+              }
+
       private: std::string topic;
       private: std::string msgType;
       private: NodePtr node;
       private: bool latching;
+
+      /// \brief Maximum rate of messages, zero for no limit.
+      private: double maxRate = 0;
+
+      /// \brief True if only the latest message is wanted.
+      private: bool latestOnly = false;
     };
     /// \}
   }
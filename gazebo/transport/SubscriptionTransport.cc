@@ -16,6 +16,7 @@
 */
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include "gazebo/common/WeakBind.hh"
 #include "gazebo/transport/ConnectionManager.hh"
 #include "gazebo/transport/SubscriptionTransport.hh"
 
@@ -58,7 +59,15 @@ bool SubscriptionTransport::HandleData(const std::string &_newdata,
   bool result = false;
   if (this->connection->IsOpen())
   {
-    this->connection->EnqueueMsg(_newdata, _cb, _id);
+    if (this->LatestOnly())
+    {
+      // The publisher doesn't wait for a latest-only subscriber
+      this->EnqueueLatest(_newdata);
+      if (!_cb.empty())
+        _cb(_id);
+    }
+    else
+      this->connection->EnqueueMsg(_newdata, _cb, _id);
     result = true;
   }
   else
@@ -79,3 +88,58 @@ bool SubscriptionTransport::IsLocal() const
 {
   return false;
 }
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::SetShm(const bool _enable)
+{
+  this->shm = _enable;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::Shm() const
+{
+  return this->shm;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::EnqueueLatest(const std::string &_data)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->latestMutex);
+    if (this->latestInFlight)
+    {
+      this->latestData = _data;
+      this->latestPending = true;
+      return;
+    }
+    this->latestInFlight = true;
+  }
+
+  this->connection->EnqueueMsg(_data,
+      common::weakBind(&SubscriptionTransport::OnLatestWritten,
+        this->shared_from_this(), _1), 0);
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::OnLatestWritten(uint32_t /*_id*/)
+{
+  std::string data;
+  {
+    std::lock_guard<std::mutex> lock(this->latestMutex);
+    if (!this->latestPending)
+    {
+      this->latestInFlight = false;
+      return;
+    }
+    data.swap(this->latestData);
+    this->latestPending = false;
+  }
+
+  ConnectionPtr conn = this->connection;
+  if (conn && conn->IsOpen())
+  {
+    conn->EnqueueMsg(data,
+        common::weakBind(&SubscriptionTransport::OnLatestWritten,
+          this->shared_from_this(), _1), 0);
+  }
+}
@@ -17,8 +17,10 @@
 #ifndef _SUBSCRIPTIONTRANSPORT_HH_
 #define _SUBSCRIPTIONTRANSPORT_HH_
 
+#include <boost/enable_shared_from_this.hpp>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <mutex>
 #include <string>
 
 #include "Connection.hh"
@@ -36,7 +38,15 @@ namespace gazebo
     /// transport/transport.hh
     /// \brief Handles sending data over the wire to
     /// remote subscribers
-    class GZ_TRANSPORT_VISIBLE SubscriptionTransport : public CallbackHelper
+    ///
+    /// The remote subscriber can ask for a maximum rate and for the latest
+    /// message only, see msgs::Subscribe. Messages over the rate are
+    /// skipped before they are serialized. A latest-only subscriber has at
+    /// most one message written to the connection and one waiting, which
+    /// newer messages replace, so a slow subscriber doesn't hold back the
+    /// publisher or grow the write queue.
+    class GZ_TRANSPORT_VISIBLE SubscriptionTransport : public CallbackHelper,
+      public boost::enable_shared_from_this<SubscriptionTransport>
     {
       /// \brief Constructor
       public: SubscriptionTransport();
@@ -71,7 +81,46 @@ namespace gazebo
       /// is tied to a  remote connection
       public: virtual bool IsLocal() const;
 
+      /// \brief Set whether the remote subscriber shares memory with this
+      /// process. Large messages are then handed over as shared memory
+      /// descriptors.
+      /// \param[in] _enable True to enable the shared memory transport.
+      /// \sa ShmRing
+      public: void SetShm(const bool _enable);
+
+      /// \brief Does the remote subscriber accept shared memory
+      /// descriptors?
+      /// \return True if the shared memory transport is enabled.
+      public: bool Shm() const;
+
+      /// \brief Write the message to the connection, or keep it until the
+      /// message being written is sent, replacing any message kept before.
+      /// \param[in] _data The message.
+      private: void EnqueueLatest(const std::string &_data);
+
+      /// \brief Called when a message of a latest-only subscriber is
+      /// written, to write the message kept meanwhile.
+      /// \param[in] _id Unused.
+      private: void OnLatestWritten(uint32_t _id);
+
       private: ConnectionPtr connection;
+
+      /// \brief True if the remote subscriber accepts shared memory
+      /// descriptors.
+      private: bool shm = false;
+
+      /// \brief True while a message of a latest-only subscriber is in
+      /// the write queue of the connection.
+      private: bool latestInFlight = false;
+
+      /// \brief True if latestData holds a message to write.
+      private: bool latestPending = false;
+
+      /// \brief Latest message kept while latestInFlight.
+      private: std::string latestData;
+
+      /// \brief Mutex to protect the latest-only state.
+      private: std::mutex latestMutex;
     };
     /// \}
   }
@@ -18,6 +18,7 @@
 #include <tbb/blocked_range.h>
 
 #include <boost/function.hpp>
+#include <algorithm>
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publication.hh"
@@ -68,8 +69,11 @@ TopicManager::~TopicManager()
 //////////////////////////////////////////////////
 void TopicManager::Init()
 {
-  this->advertisedTopics.clear();
-  this->advertisedTopicsEnd = this->advertisedTopics.end();
+  {
+    boost::recursive_mutex::scoped_lock lock(this->advertisedTopicsMutex);
+    this->advertisedTopics.clear();
+    this->advertisedTopicsEnd = this->advertisedTopics.end();
+  }
   this->subscribedNodes.clear();
   this->nodes.clear();
 }
@@ -81,15 +85,21 @@ void TopicManager::Fini()
   this->ProcessNodes(true);
   // ConnectionManager::Instance()->RunUpdate();
 
-  PublicationPtr_M::iterator iter;
-  for (iter = this->advertisedTopics.begin();
-       iter != this->advertisedTopics.end(); ++iter)
+  std::vector<std::string> topics;
   {
-    this->Unadvertise(iter->first);
+    boost::recursive_mutex::scoped_lock lock(this->advertisedTopicsMutex);
+    for (auto const &iter : this->advertisedTopics)
+      topics.push_back(iter.first);
   }
 
-  this->advertisedTopics.clear();
-  this->advertisedTopicsEnd = this->advertisedTopics.end();
+  for (auto const &topic : topics)
+    this->Unadvertise(topic);
+
+  {
+    boost::recursive_mutex::scoped_lock lock(this->advertisedTopicsMutex);
+    this->advertisedTopics.clear();
+    this->advertisedTopicsEnd = this->advertisedTopics.end();
+  }
   this->subscribedNodes.clear();
   this->nodes.clear();
 }
@@ -112,11 +122,8 @@ void TopicManager::RemoveNode(unsigned int _id)
     if ((*iter)->GetId() == _id)
     {
       // Remove the node from all publications.
-      for (PublicationPtr_M::iterator piter = this->advertisedTopics.begin();
-           piter != this->advertisedTopics.end(); ++piter)
-      {
-        piter->second->RemoveSubscription(*iter);
-      }
+      for (auto const &pub : this->Publications())
+        pub->RemoveSubscription(*iter);
 
       // Remove the node from all subscriptions.
       boost::mutex::scoped_lock subscriber_lock(this->subscriberMutex);
@@ -216,6 +223,7 @@ void TopicManager::Publish(const std::string &_topic, MessagePtr _message,
 //////////////////////////////////////////////////
 PublicationPtr TopicManager::FindPublication(const std::string &_topic)
 {
+  boost::recursive_mutex::scoped_lock lock(this->advertisedTopicsMutex);
   PublicationPtr_M::iterator iter = this->advertisedTopics.find(_topic);
   if (iter != this->advertisedTopicsEnd)
     return iter->second;
@@ -241,8 +249,14 @@ SubscriberPtr TopicManager::Subscribe(const SubscribeOptions &_ops)
 
   // If the publication exits, just add the subscription to it
   if (pub)
+  {
     pub->AddSubscription(_ops.GetNode());
 
+    // Links from remote publishers that skip messages this subscriber
+    // wants are dropped, and connected again below with a looser policy.
+    pub->RemoveThrottledTransports(_ops.MaxRate(), _ops.LatestOnly());
+  }
+
   // Use this to find other remote publishers
   ConnectionManager::Instance()->Subscribe(_ops.GetTopic(), _ops.GetMsgType(),
                                            _ops.GetLatching());
@@ -343,18 +357,32 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
       SubNodeMap::iterator nodeIter = this->subscribedNodes.find(_pub.topic());
 
       // Find if any local node has a latched subscriber for the new topic
-      // publication transport.
+      // publication transport, and the loosest delivery policy of the
+      // local subscribers.
+      double maxRate = 0;
+      bool latestOnly = false;
+      bool first = true;
       if (nodeIter != this->subscribedNodes.end())
       {
         std::list<NodePtr>::iterator cbIter;
         for (cbIter = nodeIter->second.begin();
-             cbIter != nodeIter->second.end() && !latched; ++cbIter)
+             cbIter != nodeIter->second.end(); ++cbIter)
         {
-          latched = (*cbIter)->HasLatchedSubscriber(_pub.topic());
+          latched = latched || (*cbIter)->HasLatchedSubscriber(_pub.topic());
+
+          double rate = 0;
+          bool latest = false;
+          if (!(*cbIter)->SubscriptionPolicy(_pub.topic(), rate, latest))
+            continue;
+
+          maxRate = (first || (maxRate > 0 && rate > 0)) ?
+            std::max(maxRate, rate) : 0;
+          latestOnly = (first || latestOnly) && latest;
+          first = false;
         }
       }
 
-      publink->Init(conn, latched);
+      publink->Init(conn, latched, maxRate, latestOnly);
 
       publication->AddTransport(publink);
     }
@@ -367,7 +395,9 @@ void TopicManager::ConnectSubToPub(const msgs::Publish &_pub)
 PublicationPtr TopicManager::UpdatePublications(const std::string &_topic,
                                                 const std::string &_msgType)
 {
-  // Find a current publication on this topic
+  // Find a current publication on this topic. The lock makes the find and
+  // the insert atomic, so two advertisers can't create the same topic.
+  boost::recursive_mutex::scoped_lock lock(this->advertisedTopicsMutex);
   PublicationPtr pub = this->FindPublication(_topic);
 
   if (pub)
@@ -444,8 +474,8 @@ void TopicManager::GetTopicNamespaces(std::list<std::string> &_namespaces)
 //////////////////////////////////////////////////
 void TopicManager::ClearBuffers()
 {
-  for (auto iter : this->advertisedTopics)
-    iter.second->ClearPrevMsgs();
+  for (auto const &pub : this->Publications())
+    pub->ClearPrevMsgs();
 }
 
 //////////////////////////////////////////////////
@@ -453,3 +483,26 @@ void TopicManager::PauseIncoming(bool _pause)
 {
   this->pauseIncoming = _pause;
 }
+
+//////////////////////////////////////////////////
+void TopicManager::Stats(msgs::TransportStats &_msg)
+{
+  _msg.Clear();
+  msgs::Set(_msg.mutable_stamp(), common::Time::GetWallTime());
+
+  for (auto const &pub : this->Publications())
+    pub->FillStats(*_msg.add_topic());
+}
+
+//////////////////////////////////////////////////
+std::vector<PublicationPtr> TopicManager::Publications()
+{
+  std::vector<PublicationPtr> pubs;
+
+  boost::recursive_mutex::scoped_lock lock(this->advertisedTopicsMutex);
+  pubs.reserve(this->advertisedTopics.size());
+  for (auto const &iter : this->advertisedTopics)
+    pubs.push_back(iter.second);
+
+  return pubs;
+}
@@ -236,10 +236,20 @@ namespace gazebo
       /// \param[in] _pause If true pause processing; otherwse unpause
       public: void PauseIncoming(bool _pause);
 
+      /// \brief Get the transport statistics of all the topics of this
+      /// process.
+      /// \param[out] _msg Message to fill.
+      public: void Stats(msgs::TransportStats &_msg);
+
       /// \brief Add a node to the list of nodes that requires processing.
       /// \param[in] _ptr Node to process.
       public: void AddNodeToProcess(NodePtr _ptr);
 
+      /// \brief Get a snapshot of the advertised publications, so they can
+      /// be iterated while topics are advertised from other threads.
+      /// \return The publications.
+      private: std::vector<PublicationPtr> Publications();
+
       /// \brief A map of string->list of Node pointers
       typedef std::map<std::string, std::list<NodePtr> > SubNodeMap;
 
@@ -254,6 +264,9 @@ namespace gazebo
 
       private: boost::recursive_mutex nodeMutex;
 
+      /// \brief Protects advertisedTopics.
+      private: boost::recursive_mutex advertisedTopicsMutex;
+
       /// \brief Used to protect subscription connection creation.
       private: boost::mutex subscriberMutex;
 
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+
+#include "gazebo/transport/TransportStats.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+const unsigned int TransportStats::kLatencyBins;
+
+//////////////////////////////////////////////////
+TransportStats::TransportStats()
+  : msgsOut(0), bytesOut(0), msgsIn(0), bytesIn(0), dropped(0),
+    queueHighWater(0)
+{
+  for (auto &bin : this->latency)
+    bin.store(0, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TransportStats::AddOutgoing(const std::size_t _bytes)
+{
+  this->msgsOut.fetch_add(1, std::memory_order_relaxed);
+  this->bytesOut.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TransportStats::AddIncoming(const std::size_t _bytes)
+{
+  this->msgsIn.fetch_add(1, std::memory_order_relaxed);
+  this->bytesIn.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TransportStats::AddDropped(const uint64_t _count)
+{
+  this->dropped.fetch_add(_count, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TransportStats::UpdateQueueDepth(const std::size_t _depth)
+{
+  uint64_t prev = this->queueHighWater.load(std::memory_order_relaxed);
+  while (_depth > prev &&
+         !this->queueHighWater.compare_exchange_weak(prev, _depth,
+             std::memory_order_relaxed))
+  {
+  }
+}
+
+//////////////////////////////////////////////////
+void TransportStats::AddLatency(const common::Time &_latency)
+{
+  this->latency[LatencyBin(_latency)].fetch_add(1, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t TransportStats::MsgsOut() const
+{
+  return this->msgsOut.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t TransportStats::BytesOut() const
+{
+  return this->bytesOut.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t TransportStats::MsgsIn() const
+{
+  return this->msgsIn.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t TransportStats::BytesIn() const
+{
+  return this->bytesIn.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t TransportStats::Dropped() const
+{
+  return this->dropped.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t TransportStats::QueueHighWater() const
+{
+  return this->queueHighWater.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+std::vector<uint64_t> TransportStats::LatencyHistogram() const
+{
+  std::vector<uint64_t> result(kLatencyBins);
+  for (unsigned int i = 0; i < kLatencyBins; ++i)
+    result[i] = this->latency[i].load(std::memory_order_relaxed);
+  return result;
+}
+
+//////////////////////////////////////////////////
+void TransportStats::Fill(msgs::TransportStats::Topic &_msg) const
+{
+  _msg.set_msgs_out(this->MsgsOut());
+  _msg.set_bytes_out(this->BytesOut());
+  _msg.set_msgs_in(this->MsgsIn());
+  _msg.set_bytes_in(this->BytesIn());
+  _msg.set_dropped(this->Dropped());
+  _msg.set_queue_high_water(this->QueueHighWater());
+
+  _msg.clear_latency();
+  for (auto const &count : this->LatencyHistogram())
+    _msg.add_latency(count);
+}
+
+//////////////////////////////////////////////////
+unsigned int TransportStats::LatencyBin(const common::Time &_latency)
+{
+  if (_latency.sec < 0 || (_latency.sec == 0 && _latency.nsec < 1000))
+    return 0;
+
+  uint64_t usec = static_cast<uint64_t>(_latency.sec) * 1000000u +
+    static_cast<uint64_t>(_latency.nsec) / 1000u;
+
+  // The bin is the number of significant bits of the latency in
+  // microseconds.
+  unsigned int bin = 0;
+  while (usec > 0 && bin < kLatencyBins - 1)
+  {
+    usec >>= 1;
+    ++bin;
+  }
+
+  return bin;
+}
+
+//////////////////////////////////////////////////
+common::Time TransportStats::LatencyPercentile(
+    const std::vector<uint64_t> &_histogram, const double _percentile)
+{
+  uint64_t total = 0;
+  for (auto const &count : _histogram)
+    total += count;
+
+  if (total == 0)
+    return common::Time::Zero;
+
+  const double rank =
+    std::max(1.0, std::min(1.0, std::max(0.0, _percentile)) * total);
+
+  uint64_t count = 0;
+  unsigned int bin = 0;
+  for (; bin < _histogram.size(); ++bin)
+  {
+    count += _histogram[bin];
+    if (count >= rank)
+      break;
+  }
+
+  // Upper bound of the bin, or lower bound of the unbounded last bin.
+  const unsigned int last = static_cast<unsigned int>(
+      std::min<std::size_t>(_histogram.size(), kLatencyBins)) - 1;
+  unsigned int exponent = bin;
+  if (bin >= last)
+    exponent = last > 0 ? last - 1 : 0;
+  const uint64_t usec = uint64_t(1) << exponent;
+
+  return common::Time(static_cast<int32_t>(usec / 1000000u),
+      static_cast<int32_t>((usec % 1000000u) * 1000u));
+}
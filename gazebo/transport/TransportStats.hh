@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_TRANSPORTSTATS_HH_
+#define GAZEBO_TRANSPORT_TRANSPORTSTATS_HH_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class TransportStats TransportStats.hh transport/transport.hh
+    /// \brief Counters of the traffic on a topic or a connection.
+    ///
+    /// All the counters are atomics updated with relaxed ordering, so
+    /// they can be updated from the publishing, reading and writing
+    /// threads without locks, and read at any time. A snapshot taken
+    /// while messages are in flight may be slightly inconsistent between
+    /// counters, but each counter only grows.
+    class GZ_TRANSPORT_VISIBLE TransportStats
+    {
+      /// \brief Number of bins of the latency histogram. Bin 0 counts
+      /// latencies below 1 microsecond, and bin i counts latencies in
+      /// [2^(i-1), 2^i) microseconds. The last bin is unbounded.
+      public: static const unsigned int kLatencyBins = 24;
+
+      /// \brief Constructor.
+      public: TransportStats();
+
+      /// \brief Count a message sent.
+      /// \param[in] _bytes Size of the message.
+      public: void AddOutgoing(const std::size_t _bytes);
+
+      /// \brief Count a message received.
+      /// \param[in] _bytes Size of the message.
+      public: void AddIncoming(const std::size_t _bytes);
+
+      /// \brief Count dropped messages.
+      /// \param[in] _count Number of dropped messages.
+      public: void AddDropped(const uint64_t _count = 1);
+
+      /// \brief Update the queue high-water mark.
+      /// \param[in] _depth Current number of messages in the queue.
+      public: void UpdateQueueDepth(const std::size_t _depth);
+
+      /// \brief Count the latency of a message in the histogram.
+      /// \param[in] _latency Time from publication to callback.
+      public: void AddLatency(const common::Time &_latency);
+
+      /// \brief Get the number of messages sent.
+      /// \return Number of messages sent.
+      public: uint64_t MsgsOut() const;
+
+      /// \brief Get the number of bytes sent.
+      /// \return Number of bytes sent.
+      public: uint64_t BytesOut() const;
+
+      /// \brief Get the number of messages received.
+      /// \return Number of messages received.
+      public: uint64_t MsgsIn() const;
+
+      /// \brief Get the number of bytes received.
+      /// \return Number of bytes received.
+      public: uint64_t BytesIn() const;
+
+      /// \brief Get the number of dropped messages.
+      /// \return Number of dropped messages.
+      public: uint64_t Dropped() const;
+
+      /// \brief Get the highest queue depth.
+      /// \return Highest number of messages seen in the queue.
+      public: uint64_t QueueHighWater() const;
+
+      /// \brief Get the latency histogram.
+      /// \return Number of messages in each of the kLatencyBins bins.
+      public: std::vector<uint64_t> LatencyHistogram() const;
+
+      /// \brief Write the counters into a message.
+      /// \param[out] _msg Message to fill. The name and message type of
+      /// the topic are not set.
+      public: void Fill(msgs::TransportStats::Topic &_msg) const;
+
+      /// \brief Get the histogram bin of a latency.
+      /// \param[in] _latency Latency.
+      /// \return Bin index, in [0, kLatencyBins).
+      public: static unsigned int LatencyBin(const common::Time &_latency);
+
+      /// \brief Get an upper bound of a percentile of a latency histogram.
+      /// \param[in] _histogram Latency histogram.
+      /// \param[in] _percentile Percentile, in [0, 1].
+      /// \return Upper bound of the bin holding the percentile, or the
+      /// lower bound of the last bin if the percentile falls in it. Zero
+      /// if the histogram is empty.
+      public: static common::Time LatencyPercentile(
+                  const std::vector<uint64_t> &_histogram,
+                  const double _percentile);
+
+      /// \brief Number of messages sent.
+      private: std::atomic<uint64_t> msgsOut;
+
+      /// \brief Number of bytes sent.
+      private: std::atomic<uint64_t> bytesOut;
+
+      /// \brief Number of messages received.
+      private: std::atomic<uint64_t> msgsIn;
+
+      /// \brief Number of bytes received.
+      private: std::atomic<uint64_t> bytesIn;
+
+      /// \brief Number of dropped messages.
+      private: std::atomic<uint64_t> dropped;
+
+      /// \brief Highest queue depth.
+      private: std::atomic<uint64_t> queueHighWater;
+
+      /// \brief Latency histogram.
+      private: std::array<std::atomic<uint64_t>, kLatencyBins> latency;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/transport/TopicManager.hh"
+#include "gazebo/transport/TransportStats.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TransportStatsTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(TransportStatsTest, Counters)
+{
+  transport::TransportStats stats;
+  EXPECT_EQ(stats.MsgsOut(), 0u);
+  EXPECT_EQ(stats.QueueHighWater(), 0u);
+
+  stats.AddOutgoing(100);
+  stats.AddOutgoing(20);
+  stats.AddIncoming(7);
+  stats.AddDropped();
+  stats.AddDropped(3);
+  stats.UpdateQueueDepth(5);
+  stats.UpdateQueueDepth(2);
+
+  EXPECT_EQ(stats.MsgsOut(), 2u);
+  EXPECT_EQ(stats.BytesOut(), 120u);
+  EXPECT_EQ(stats.MsgsIn(), 1u);
+  EXPECT_EQ(stats.BytesIn(), 7u);
+  EXPECT_EQ(stats.Dropped(), 4u);
+  EXPECT_EQ(stats.QueueHighWater(), 5u);
+
+  msgs::TransportStats::Topic msg;
+  msg.set_name("/test");
+  msg.set_msg_type("gazebo.msgs.Empty");
+  stats.Fill(msg);
+  EXPECT_TRUE(msg.IsInitialized());
+  EXPECT_EQ(msg.bytes_out(), 120u);
+  EXPECT_EQ(msg.queue_high_water(), 5u);
+  EXPECT_EQ(msg.latency_size(),
+      static_cast<int>(transport::TransportStats::kLatencyBins));
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportStatsTest, Latency)
+{
+  using transport::TransportStats;
+
+  EXPECT_EQ(TransportStats::LatencyBin(common::Time(0, 500)), 0u);
+  EXPECT_EQ(TransportStats::LatencyBin(common::Time(0, 1000)), 1u);
+  EXPECT_EQ(TransportStats::LatencyBin(common::Time(0, 3000)), 2u);
+  EXPECT_EQ(TransportStats::LatencyBin(common::Time(0, 1000000)), 10u);
+  EXPECT_EQ(TransportStats::LatencyBin(common::Time(-1, 0)), 0u);
+  EXPECT_EQ(TransportStats::LatencyBin(common::Time(3600, 0)),
+      TransportStats::kLatencyBins - 1);
+
+  TransportStats stats;
+  EXPECT_EQ(TransportStats::LatencyPercentile(stats.LatencyHistogram(), 0.5),
+      common::Time::Zero);
+
+  // 90 messages around 100 us, and 10 around 10 ms
+  for (int i = 0; i < 90; ++i)
+    stats.AddLatency(common::Time(0, 100000));
+  for (int i = 0; i < 10; ++i)
+    stats.AddLatency(common::Time(0, 10000000));
+
+  auto histogram = stats.LatencyHistogram();
+  EXPECT_EQ(histogram[7], 90u);
+  EXPECT_EQ(histogram[14], 10u);
+
+  EXPECT_EQ(TransportStats::LatencyPercentile(histogram, 0.5),
+      common::Time(0, 128000));
+  EXPECT_EQ(TransportStats::LatencyPercentile(histogram, 0.99),
+      common::Time(0, 16384000));
+}
+
+/////////////////////////////////////////////////
+TEST_F(TransportStatsTest, Threads)
+{
+  transport::TransportStats stats;
+
+  const unsigned int threadCount = 4;
+  const unsigned int msgCount = 10000;
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < threadCount; ++t)
+  {
+    threads.push_back(std::thread([&stats, t]()
+    {
+      for (unsigned int i = 0; i < msgCount; ++i)
+      {
+        stats.AddOutgoing(2);
+        stats.UpdateQueueDepth(t * msgCount + i);
+      }
+    }));
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_EQ(stats.MsgsOut(), threadCount * msgCount);
+  EXPECT_EQ(stats.BytesOut(), 2u * threadCount * msgCount);
+  EXPECT_EQ(stats.QueueHighWater(), threadCount * msgCount - 1);
+}
+
+/////////////////////////////////////////////////
+// Advertise topics while the stats are gathered from another thread
+TEST_F(TransportStatsTest, ConcurrentAdvertise)
+{
+  transport::TopicManager *manager = transport::TopicManager::Instance();
+  manager->Init();
+
+  const unsigned int topicCount = 500;
+  std::thread advertiser([manager]()
+  {
+    for (unsigned int i = 0; i < topicCount; ++i)
+    {
+      manager->UpdatePublications("/test/concurrent/" + std::to_string(i),
+          "gazebo.msgs.Empty");
+    }
+  });
+
+  msgs::TransportStats msg;
+  int previous = 0;
+  while (previous < static_cast<int>(topicCount))
+  {
+    manager->Stats(msg);
+    EXPECT_GE(msg.topic_size(), previous);
+    previous = msg.topic_size();
+  }
+  advertiser.join();
+
+  manager->Stats(msg);
+  EXPECT_EQ(msg.topic_size(), static_cast<int>(topicCount));
+  EXPECT_TRUE(manager->FindPublication("/test/concurrent/0") != nullptr);
+  manager->Init();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
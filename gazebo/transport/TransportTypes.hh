@@ -36,6 +36,7 @@ namespace gazebo
     class Publisher;
     class Publication;
     class PublicationTransport;
+    class ShmRing;
     class Subscriber;
     class SubscriptionTransport;
     class Node;
@@ -67,6 +68,10 @@ namespace gazebo
     /// \def SubscriptionTransportPtr
     /// \brief Shared_ptr to SubscriptionTransportPtr
     typedef boost::shared_ptr<SubscriptionTransport> SubscriptionTransportPtr;
+
+    /// \def ShmRingPtr
+    /// \brief Shared_ptr to ShmRing
+    typedef boost::shared_ptr<ShmRing> ShmRingPtr;
   }
 }
 #endif
@@ -148,6 +148,7 @@ void LogPlay::Open(const std::string &_logFile)
   this->ReadHeader();
 
   this->dataPtr->logCurrXml = this->dataPtr->logStartXml;
+  this->dataPtr->cursorXml = nullptr;
   this->dataPtr->encoding.clear();
 
   // Extract the start/end log times from the log.
@@ -728,15 +729,85 @@ bool LogPlayPrivate::ChunkData(
     gzthrow("Encoding missing for a chunk in log file[" + this->filename + "]");
   }
 
-  if (this->encoding == "txt")
-    _data = _xml->GetText();
-  else if (this->encoding == "bz2")
+  if (!LogPlay::DecodeChunk(this->encoding, _xml->GetText(), _data))
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
+    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
+      << this->filename << "]\n";
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+tinyxml2::XMLElement *LogPlayPrivate::ChunkXml(const unsigned int _index)
+{
+  if (!this->logStartXml)
+    return nullptr;
+
+  if (!this->cursorXml || _index < this->cursorIndex)
+  {
+    this->cursorXml = this->logStartXml->FirstChildElement("chunk");
+    this->cursorIndex = 0;
+  }
+
+  while (this->cursorXml && this->cursorIndex < _index)
+  {
+    this->cursorXml = this->cursorXml->NextSiblingElement("chunk");
+    ++this->cursorIndex;
+  }
+
+  return this->cursorXml;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::RawChunk(const unsigned int _index, std::string &_encoding,
+    const char *&_text) const
+{
+  auto xml = this->dataPtr->ChunkXml(_index);
+  if (!xml)
+    return false;
+
+  const char *encoding = xml->Attribute("encoding");
+  _encoding = encoding ? encoding : "";
+  _text = xml->GetText();
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::ChunkSimTime(const unsigned int _index,
+    common::Time &_min, common::Time &_max) const
+{
+  auto xml = this->dataPtr->ChunkXml(_index);
+  if (!xml)
+    return false;
+
+  const char *minStr = xml->Attribute(LogPlayPrivate::kMinSimTime);
+  const char *maxStr = xml->Attribute(LogPlayPrivate::kMaxSimTime);
+  if (!minStr || !maxStr)
+    return false;
 
+  std::stringstream minStream(minStr);
+  std::stringstream maxStream(maxStr);
+  minStream >> _min;
+  maxStream >> _max;
+
+  return !minStream.fail() && !maxStream.fail();
+}
+
+/////////////////////////////////////////////////
+bool LogPlay::DecodeChunk(const std::string &_encoding, const char *_text,
+    std::string &_data)
+{
+  std::string data = _text ? _text : "";
+
+  if (_encoding == "txt")
+    _data = data;
+  else if (_encoding == "bz2")
+  {
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    std::string buffer = Base64Decode(data);
 
     // Decompress the bz2 data
     {
@@ -749,13 +820,10 @@ bool LogPlayPrivate::ChunkData(
       _data += '\0';
     }
   }
-  else if (this->encoding == "zlib")
+  else if (_encoding == "zlib")
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
-
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    std::string buffer = Base64Decode(data);
 
     // Decompress the zlib data
     {
@@ -769,15 +837,50 @@ bool LogPlayPrivate::ChunkData(
     }
   }
   else
-  {
-    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
-      << this->filename << "]\n";
     return false;
-  }
 
   return true;
 }
 
+/////////////////////////////////////////////////
+std::string LogPlay::ChunkSimTimeAttributes(const std::string &_data)
+{
+  const std::string startTag = "<sim_time>";
+  const std::string endTag = "</sim_time>";
+
+  common::Time min, max;
+  bool found = false;
+
+  auto from = _data.find(startTag);
+  while (from != std::string::npos)
+  {
+    from += startTag.size();
+    auto to = _data.find(endTag, from);
+    if (to == std::string::npos)
+      break;
+
+    std::stringstream ss(_data.substr(from, to - from));
+    common::Time time;
+    ss >> time;
+    if (!ss.fail())
+    {
+      min = found ? std::min(min, time) : time;
+      max = found ? std::max(max, time) : time;
+      found = true;
+    }
+
+    from = _data.find(startTag, to + endTag.size());
+  }
+
+  if (!found)
+    return std::string();
+
+  std::ostringstream attributes;
+  attributes << " " << LogPlayPrivate::kMinSimTime << "='" << min << "' "
+    << LogPlayPrivate::kMaxSimTime << "='" << max << "'";
+  return attributes.str();
+}
+
 /////////////////////////////////////////////////
 std::string LogPlay::Encoding() const
 {
@@ -140,6 +140,43 @@ namespace gazebo
       /// \return True if the _index was valid.
       public: bool Chunk(const unsigned int _index, std::string &_data) const;
 
+      /// \brief Get the encoded text of a chunk without decoding it, so
+      /// that chunks can be decoded concurrently with DecodeChunk.
+      /// Consecutive calls with increasing indices take constant time.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _encoding Encoding of the chunk (txt, zlib or bz2).
+      /// \param[out] _text Encoded text of the chunk. It is valid while
+      /// the log file is open.
+      /// \return True if the _index was valid.
+      public: bool RawChunk(const unsigned int _index, std::string &_encoding,
+                  const char *&_text) const;
+
+      /// \brief Get the range of simulation times of the frames in a
+      /// chunk, without decoding the chunk. Logs written by older versions
+      /// don't record the range.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _min Lowest simulation time in the chunk.
+      /// \param[out] _max Highest simulation time in the chunk.
+      /// \return True if the chunk records its simulation time range.
+      public: bool ChunkSimTime(const unsigned int _index,
+                  common::Time &_min, common::Time &_max) const;
+
+      /// \brief Decode the text of a chunk. This function is thread safe.
+      /// \param[in] _encoding Encoding of the chunk (txt, zlib or bz2).
+      /// \param[in] _text Encoded text of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return False if the encoding is invalid.
+      public: static bool DecodeChunk(const std::string &_encoding,
+                  const char *_text, std::string &_data);
+
+      /// \brief Get the attributes that record the range of simulation
+      /// times of a chunk, for the writers of log files.
+      /// \param[in] _data Decoded chunk data.
+      /// \return The attributes, with a leading space, or an empty string
+      /// if _data has no simulation time.
+      public: static std::string ChunkSimTimeAttributes(
+                  const std::string &_data);
+
       /// \brief Get the type of encoding used for current chunck in the
       /// open log file.
       /// \return The type of encoding. An empty string will be returned if
@@ -47,6 +47,12 @@ namespace gazebo
                   tinyxml2::XMLElement *_xml,
                   std::string &_data);
 
+      /// \brief Find a chunk by index, starting from the chunk found by
+      /// the previous call when possible.
+      /// \param[in] _index Index of the chunk.
+      /// \return The chunk's XML element, or nullptr if _index is invalid.
+      public: tinyxml2::XMLElement *ChunkXml(const unsigned int _index);
+
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
 
@@ -71,6 +77,19 @@ namespace gazebo
       /// \brief Current position in the log file.
       public: tinyxml2::XMLElement *logCurrXml = nullptr;
 
+      /// \brief Chunk found by the last call to ChunkXml.
+      public: tinyxml2::XMLElement *cursorXml = nullptr;
+
+      /// \brief Index of cursorXml.
+      public: unsigned int cursorIndex = 0;
+
+      /// \brief XML attribute holding the lowest simulation time of a chunk.
+      public: static constexpr const char *kMinSimTime = "sim_time_min";
+
+      /// \brief XML attribute holding the highest simulation time of a
+      /// chunk.
+      public: static constexpr const char *kMaxSimTime = "sim_time_max";
+
       /// \brief Name of the log file.
       public: std::string filename;
 
@@ -52,6 +52,7 @@
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/gazebo_config.h"
 #include "gazebo/transport/transport.hh"
+#include "gazebo/util/LogPlay.hh"
 #include "gazebo/util/LogRecordPrivate.hh"
 #include "gazebo/util/LogRecord.hh"
 
@@ -798,7 +799,12 @@ unsigned int LogRecordPrivate::Log::Update()
 
       this->buffer.append("<chunk encoding='");
       this->buffer.append(encodingLocal);
-      this->buffer.append("'>\n");
+      this->buffer.append("'");
+
+      // Record the simulation times, so that readers can skip the chunk
+      // without decompressing it.
+      this->buffer.append(LogPlay::ChunkSimTimeAttributes(data));
+      this->buffer.append(">\n");
 
       this->buffer.append("<![CDATA[");
       // Compress the data.
@@ -15,19 +15,418 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <ignition/math/Matrix3.hh>
+
 #include "gazebo/common/Assert.hh"
+#include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/HeightmapData.hh"
 #include "plugins/BuoyancyPlugin.hh"
 
+namespace gazebo
+{
+  /// \brief Buoyancy of a link, computed by ComputeBuoyancy.
+  class LinkBuoyancy
+  {
+    /// \brief The link.
+    public: physics::LinkPtr link;
+
+    /// \brief Volume properties of the link.
+    public: const VolumeProperties *props = nullptr;
+
+    /// \brief Buoyancy force in the world frame.
+    public: ignition::math::Vector3d force;
+
+    /// \brief Center of buoyancy in the world frame.
+    public: ignition::math::Vector3d center;
+
+    /// \brief True if the link is at least partly submerged.
+    public: bool submerged = false;
+  };
+
+  /// \internal
+  /// \brief Private data for the BuoyancyPlugin class
+  class BuoyancyPluginPrivate
+  {
+    /// \brief Height of the fluid surface.
+    /// \param[in] _x X coordinate in the world frame.
+    /// \param[in] _y Y coordinate in the world frame.
+    /// \return Height of the surface.
+    public: double Level(const double _x, const double _y) const;
+
+    /// \brief True if there is a fluid surface, false if the links are
+    /// always fully submerged.
+    public: bool hasSurface = false;
+
+    /// \brief Height of the fluid plane.
+    public: double level = 0;
+
+    /// \brief Heights of the fluid heightmap, row by row along +y. Empty
+    /// for a plane.
+    public: std::vector<float> heights;
+
+    /// \brief Number of heights per row and per column.
+    public: unsigned int vertSize = 0;
+
+    /// \brief Size of the fluid heightmap.
+    public: ignition::math::Vector3d heightmapSize;
+
+    /// \brief Center of the fluid heightmap.
+    public: ignition::math::Vector3d heightmapPos;
+
+    /// \brief Buoyant links, with their buoyancy of the current step.
+    public: std::vector<LinkBuoyancy> links;
+
+    /// \brief Batch updating the plugins of the world.
+    public: std::shared_ptr<BuoyancyBatch> batch;
+  };
+
+  /// \brief Updates the buoyancy plugins of a world together: each plugin
+  /// computes its buoyancy in parallel, then the forces are applied
+  /// serially.
+  class BuoyancyBatch
+  {
+    /// \brief Constructor.
+    /// \param[in] _worldName Name of the world.
+    public: explicit BuoyancyBatch(const std::string &_worldName);
+
+    /// \brief Add a plugin.
+    /// \param[in] _plugin The plugin.
+    public: void Add(BuoyancyPlugin *_plugin);
+
+    /// \brief Remove a plugin.
+    /// \param[in] _plugin The plugin.
+    public: void Remove(BuoyancyPlugin *_plugin);
+
+    /// \brief Callback for World Update events.
+    /// \param[in] _info Update information.
+    private: void OnUpdate(const common::UpdateInfo &_info);
+
+    /// \brief Name of the world.
+    private: std::string worldName;
+
+    /// \brief Plugins of the world.
+    private: std::vector<BuoyancyPlugin *> plugins;
+
+    /// \brief Protects plugins.
+    private: std::mutex mutex;
+
+    /// \brief Connection to World Update events.
+    private: event::ConnectionPtr updateConnection;
+  };
+}
+
 using namespace gazebo;
 
 GZ_REGISTER_MODEL_PLUGIN(BuoyancyPlugin)
 
+/// \brief Batches of the worlds, by world name.
+static std::map<std::string, std::weak_ptr<BuoyancyBatch>> g_batches;
+
+/// \brief Protects g_batches.
+static std::mutex g_batchesMutex;
+
+/// \brief Maximum number of samples along each axis of a shape.
+static const int kMaxSamplesPerAxis = 64;
+
+/// \brief Kind of sampled shape.
+enum class SampledShape
+{
+  /// \brief Box, or bounding box of another shape.
+  BOX,
+
+  /// \brief Sphere.
+  SPHERE,
+
+  /// \brief Cylinder along z.
+  CYLINDER
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the volume to sample of a collision.
+/// \param[in] _collision The collision.
+/// \param[out] _size Size of the box around the shape, in the collision
+/// frame.
+/// \param[out] _center Center of the box, in the collision frame.
+/// \return Kind of shape.
+static SampledShape sampledBox(const physics::CollisionPtr &_collision,
+    ignition::math::Vector3d &_size, ignition::math::Vector3d &_center)
+{
+  physics::ShapePtr shape = _collision->GetShape();
+  _center = ignition::math::Vector3d::Zero;
+
+  if (shape->HasType(physics::Base::BOX_SHAPE))
+  {
+    _size = boost::dynamic_pointer_cast<physics::BoxShape>(shape)->Size();
+    return SampledShape::BOX;
+  }
+  else if (shape->HasType(physics::Base::SPHERE_SHAPE))
+  {
+    const double radius =
+        boost::dynamic_pointer_cast<physics::SphereShape>(shape)->GetRadius();
+    _size.Set(2 * radius, 2 * radius, 2 * radius);
+    return SampledShape::SPHERE;
+  }
+  else if (shape->HasType(physics::Base::CYLINDER_SHAPE))
+  {
+    auto cylinder = boost::dynamic_pointer_cast<physics::CylinderShape>(shape);
+    const double radius = cylinder->GetRadius();
+    _size.Set(2 * radius, 2 * radius, cylinder->GetLength());
+    return SampledShape::CYLINDER;
+  }
+
+  // Other shapes are sampled by their bounding box, brought back from the
+  // world frame into the collision frame.
+  const ignition::math::AxisAlignedBox box = _collision->BoundingBox();
+  const ignition::math::Pose3d pose = _collision->WorldPose();
+  ignition::math::Vector3d min(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  ignition::math::Vector3d max = -min;
+  for (int i = 0; i < 8; ++i)
+  {
+    const ignition::math::Vector3d corner(
+        (i & 1) ? box.Max().X() : box.Min().X(),
+        (i & 2) ? box.Max().Y() : box.Min().Y(),
+        (i & 4) ? box.Max().Z() : box.Min().Z());
+    const ignition::math::Vector3d local =
+        pose.Rot().RotateVectorReverse(corner - pose.Pos());
+    min.Min(local);
+    max.Max(local);
+  }
+  _size = max - min;
+  _center = (min + max) * 0.5;
+  return SampledShape::BOX;
+}
+
+/////////////////////////////////////////////////
+/// \brief Add the samples of a collision to the volume properties of its
+/// link.
+/// \param[in] _collision The collision.
+/// \param[in] _voxelSize Distance between samples.
+/// \param[in,out] _props Volume properties of the link.
+static void sampleCollision(const physics::CollisionPtr &_collision,
+    const double _voxelSize, VolumeProperties &_props)
+{
+  const double volume = _collision->GetShape()->ComputeVolume();
+  if (volume <= 0)
+    return;
+
+  ignition::math::Vector3d size, center;
+  const SampledShape kind = sampledBox(_collision, size, center);
+
+  int count[3];
+  double step[3];
+  for (int a = 0; a < 3; ++a)
+  {
+    count[a] = ignition::math::clamp(
+        static_cast<int>(std::ceil(size[a] / _voxelSize)),
+        1, kMaxSamplesPerAxis);
+    step[a] = size[a] / count[a];
+  }
+
+  const double radius2 = size.X() * size.X() * 0.25;
+  std::vector<ignition::math::Vector3d> points;
+  for (int k = 0; k < count[2]; ++k)
+  {
+    for (int j = 0; j < count[1]; ++j)
+    {
+      for (int i = 0; i < count[0]; ++i)
+      {
+        const ignition::math::Vector3d p(
+            (i + 0.5) * step[0] - size.X() * 0.5,
+            (j + 0.5) * step[1] - size.Y() * 0.5,
+            (k + 0.5) * step[2] - size.Z() * 0.5);
+
+        if ((kind == SampledShape::SPHERE && p.SquaredLength() > radius2) ||
+            (kind == SampledShape::CYLINDER &&
+             p.X() * p.X() + p.Y() * p.Y() > radius2))
+        {
+          continue;
+        }
+        points.push_back(p + center);
+      }
+    }
+  }
+
+  // A shape smaller than a voxel keeps its center
+  if (points.empty())
+    points.push_back(center);
+
+  // The samples share the exact volume of the shape
+  const ignition::math::Pose3d pose = _collision->RelativePose();
+  const double sampleVolume = volume / points.size();
+  for (const auto &p : points)
+  {
+    const ignition::math::Vector3d linkPoint =
+        pose.Pos() + pose.Rot().RotateVector(p);
+    _props.sampleX.push_back(linkPoint.X());
+    _props.sampleY.push_back(linkPoint.Y());
+    _props.sampleZ.push_back(linkPoint.Z());
+    _props.sampleVolume.push_back(sampleVolume);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Sample the collisions of a link.
+/// \param[in] _link The link.
+/// \param[in] _voxelSize Distance between samples, zero for a tenth of the
+/// largest shape.
+/// \param[in,out] _props Volume properties of the link. The samples keep
+/// its volume and center of volume.
+static void sampleLink(const physics::LinkPtr &_link, const double _voxelSize,
+    VolumeProperties &_props)
+{
+  double voxelSize = _voxelSize;
+  if (voxelSize <= 0)
+  {
+    for (auto collision : _link->GetCollisions())
+    {
+      ignition::math::Vector3d size, center;
+      sampledBox(collision, size, center);
+      voxelSize = std::max(voxelSize, size.Max() / 10.0);
+    }
+  }
+
+  if (voxelSize > 0)
+  {
+    for (auto collision : _link->GetCollisions())
+      sampleCollision(collision, voxelSize, _props);
+  }
+
+  // Scale and move the samples to the volume and center of volume, which
+  // may have been set in SDF.
+  double volumeSum = 0;
+  ignition::math::Vector3d weightedPosSum;
+  for (size_t i = 0; i < _props.sampleVolume.size(); ++i)
+  {
+    volumeSum += _props.sampleVolume[i];
+    weightedPosSum += _props.sampleVolume[i] * ignition::math::Vector3d(
+        _props.sampleX[i], _props.sampleY[i], _props.sampleZ[i]);
+  }
+
+  if (volumeSum <= 0)
+  {
+    // No sampled shape, use a cube of the volume at the center of volume
+    _props.sampleX.assign(1, _props.cov.X());
+    _props.sampleY.assign(1, _props.cov.Y());
+    _props.sampleZ.assign(1, _props.cov.Z());
+    _props.sampleVolume.assign(1, _props.volume);
+    _props.sampleHeight = std::cbrt(_props.volume);
+    return;
+  }
+
+  const ignition::math::Vector3d offset =
+      _props.cov - weightedPosSum / volumeSum;
+  const double scale = _props.volume / volumeSum;
+  for (size_t i = 0; i < _props.sampleVolume.size(); ++i)
+  {
+    _props.sampleX[i] += offset.X();
+    _props.sampleY[i] += offset.Y();
+    _props.sampleZ[i] += offset.Z();
+    _props.sampleVolume[i] *= scale;
+  }
+  _props.sampleHeight = voxelSize;
+}
+
+/////////////////////////////////////////////////
+double BuoyancyPluginPrivate::Level(const double _x, const double _y) const
+{
+  if (this->heights.empty())
+    return this->level;
+
+  // Bilinear interpolation, clamped to the edges of the heightmap
+  const double last = this->vertSize - 1;
+  const double u = ignition::math::clamp((_x - this->heightmapPos.X()) /
+      this->heightmapSize.X() + 0.5, 0.0, 1.0) * last;
+  const double v = ignition::math::clamp((_y - this->heightmapPos.Y()) /
+      this->heightmapSize.Y() + 0.5, 0.0, 1.0) * last;
+  const unsigned int x0 = std::min(static_cast<unsigned int>(u),
+      this->vertSize - 2);
+  const unsigned int y0 = std::min(static_cast<unsigned int>(v),
+      this->vertSize - 2);
+  const double dx = u - x0;
+  const double dy = v - y0;
+
+  const float *row0 = &this->heights[y0 * this->vertSize + x0];
+  const float *row1 = row0 + this->vertSize;
+  const double h0 = row0[0] + (row0[1] - row0[0]) * dx;
+  const double h1 = row1[0] + (row1[1] - row1[0]) * dx;
+  return this->heightmapPos.Z() + h0 + (h1 - h0) * dy;
+}
+
+/////////////////////////////////////////////////
+BuoyancyBatch::BuoyancyBatch(const std::string &_worldName)
+  : worldName(_worldName)
+{
+  this->updateConnection = event::Events::ConnectWorldUpdateBegin(
+      std::bind(&BuoyancyBatch::OnUpdate, this, std::placeholders::_1));
+}
+
+/////////////////////////////////////////////////
+void BuoyancyBatch::Add(BuoyancyPlugin *_plugin)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (std::find(this->plugins.begin(), this->plugins.end(), _plugin) ==
+      this->plugins.end())
+  {
+    this->plugins.push_back(_plugin);
+  }
+}
+
+/////////////////////////////////////////////////
+void BuoyancyBatch::Remove(BuoyancyPlugin *_plugin)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->plugins.erase(
+      std::remove(this->plugins.begin(), this->plugins.end(), _plugin),
+      this->plugins.end());
+}
+
+/////////////////////////////////////////////////
+void BuoyancyBatch::OnUpdate(const common::UpdateInfo &_info)
+{
+  // The event is shared by all worlds
+  if (_info.worldName != this->worldName)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->plugins.empty())
+    return;
+
+  const ignition::math::Vector3d gravity =
+      this->plugins.front()->model->GetWorld()->Gravity();
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, this->plugins.size()),
+      [&](const tbb::blocked_range<size_t> &_r)
+  {
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+      this->plugins[i]->ComputeBuoyancy(gravity);
+  });
+
+  // Forces are applied one at a time, the physics engine isn't thread safe
+  for (auto plugin : this->plugins)
+    plugin->ApplyBuoyancy();
+}
+
 /////////////////////////////////////////////////
 BuoyancyPlugin::BuoyancyPlugin()
   // Density of liquid water at 1 atm pressure and 15 degrees Celsius.
-  : fluidDensity(999.1026)
+  : fluidDensity(999.1026),
+    dataPtr(new BuoyancyPluginPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+BuoyancyPlugin::~BuoyancyPlugin()
 {
+  if (this->dataPtr->batch)
+    this->dataPtr->batch->Remove(this);
 }
 
 /////////////////////////////////////////////////
@@ -135,42 +534,204 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
         volumeSum += volume;
         weightedPosSum += volume*collision->WorldPose().Pos();
       }
+      if (volumeSum <= 0)
+      {
+        gzwarn << "Link [" << link->GetName() << "] has no volume, it won't "
+               << "be buoyant" << std::endl;
+        continue;
+      }
+
       // Subtract the center of volume into the link frame.
       this->volPropsMap[id].cov =
           weightedPosSum/volumeSum - link->WorldPose().Pos();
       this->volPropsMap[id].volume = volumeSum;
     }
   }
+
+  // The fluid surface, if any
+  if (this->sdf->HasElement("fluid_level"))
+  {
+    this->dataPtr->hasSurface = true;
+    this->dataPtr->level = this->sdf->Get<double>("fluid_level");
+  }
+
+  if (this->sdf->HasElement("fluid_heightmap"))
+  {
+    sdf::ElementPtr heightmapElem = this->sdf->GetElement("fluid_heightmap");
+    const std::string uri = heightmapElem->HasElement("uri") ?
+        heightmapElem->Get<std::string>("uri") : "";
+    const std::string filename = common::find_file(uri);
+    std::unique_ptr<common::HeightmapData> data(filename.empty() ? nullptr :
+        common::HeightmapDataLoader::LoadTerrainFile(filename));
+    if (!data || data->GetWidth() < 2 ||
+        data->GetWidth() != data->GetHeight())
+    {
+      gzerr << "Unable to load square fluid heightmap [" << uri << "]"
+            << std::endl;
+    }
+    else
+    {
+      this->dataPtr->heightmapSize = heightmapElem->HasElement("size") ?
+          heightmapElem->Get<ignition::math::Vector3d>("size") :
+          ignition::math::Vector3d::One;
+      this->dataPtr->heightmapPos = heightmapElem->HasElement("pos") ?
+          heightmapElem->Get<ignition::math::Vector3d>("pos") :
+          ignition::math::Vector3d::Zero;
+
+      // Heights range from 0 to the size along z, as for HeightmapShape
+      this->dataPtr->vertSize = data->GetWidth();
+      ignition::math::Vector3d scale(
+          this->dataPtr->heightmapSize.X() / this->dataPtr->vertSize,
+          this->dataPtr->heightmapSize.Y() / this->dataPtr->vertSize, 1.0);
+      const double maxElevation = data->GetMaxElevation();
+      if (!ignition::math::equal(maxElevation, 0.0))
+        scale.Z() = std::fabs(this->dataPtr->heightmapSize.Z()) / maxElevation;
+      data->FillHeightMap(1, this->dataPtr->vertSize,
+          this->dataPtr->heightmapSize, scale, true, this->dataPtr->heights);
+      this->dataPtr->hasSurface = true;
+    }
+  }
+
+  // Sample the links once, the surface only changes how many samples are
+  // submerged.
+  if (this->dataPtr->hasSurface)
+  {
+    const double voxelSize = this->sdf->HasElement("voxel_size") ?
+        this->sdf->Get<double>("voxel_size") : 0.0;
+    for (auto link : this->model->GetLinks())
+    {
+      auto iter = this->volPropsMap.find(link->GetId());
+      if (iter != this->volPropsMap.end() && iter->second.volume > 0)
+        sampleLink(link, voxelSize, iter->second);
+    }
+  }
 }
 
 /////////////////////////////////////////////////
 void BuoyancyPlugin::Init()
 {
-  this->updateConnection = event::Events::ConnectWorldUpdateBegin(
-      std::bind(&BuoyancyPlugin::OnUpdate, this));
+  // The links don't change after load, so the map isn't searched at every
+  // step.
+  this->dataPtr->links.clear();
+  for (auto link : this->model->GetLinks())
+  {
+    auto iter = this->volPropsMap.find(link->GetId());
+    if (iter == this->volPropsMap.end() || iter->second.volume <= 0)
+      continue;
+
+    LinkBuoyancy linkBuoyancy;
+    linkBuoyancy.link = link;
+    linkBuoyancy.props = &iter->second;
+    this->dataPtr->links.push_back(linkBuoyancy);
+  }
+
+  const std::string worldName = this->model->GetWorld()->Name();
+  std::lock_guard<std::mutex> lock(g_batchesMutex);
+  this->dataPtr->batch = g_batches[worldName].lock();
+  if (!this->dataPtr->batch)
+  {
+    this->dataPtr->batch.reset(new BuoyancyBatch(worldName));
+    g_batches[worldName] = this->dataPtr->batch;
+  }
+  this->dataPtr->batch->Add(this);
 }
 
 /////////////////////////////////////////////////
 void BuoyancyPlugin::OnUpdate()
 {
-  for (auto link : this->model->GetLinks())
+  this->ComputeBuoyancy(this->model->GetWorld()->Gravity());
+  this->ApplyBuoyancy();
+}
+
+/////////////////////////////////////////////////
+void BuoyancyPlugin::ComputeBuoyancy(const ignition::math::Vector3d &_gravity)
+{
+  for (auto &linkBuoyancy : this->dataPtr->links)
   {
-    VolumeProperties volumeProperties = this->volPropsMap[link->GetId()];
-    double volume = volumeProperties.volume;
-    GZ_ASSERT(volume > 0, "Nonpositive volume found in volume properties!");
+    const VolumeProperties &props = *linkBuoyancy.props;
+    const ignition::math::Pose3d linkFrame = linkBuoyancy.link->WorldPose();
 
     // By Archimedes' principle,
     // buoyancy = -(mass*gravity)*fluid_density/object_density
     // object_density = mass/volume, so the mass term cancels.
     // Therefore,
-    ignition::math::Vector3d buoyancy =
-        -this->fluidDensity * volume * this->model->GetWorld()->Gravity();
+    if (!this->dataPtr->hasSurface)
+    {
+      linkBuoyancy.force = -this->fluidDensity * props.volume * _gravity;
+      linkBuoyancy.center =
+          linkFrame.Pos() + linkFrame.Rot().RotateVector(props.cov);
+      linkBuoyancy.submerged = true;
+      continue;
+    }
+
+    // With a surface, only the volume of the submerged samples counts. A
+    // sample goes from dry to submerged over its height, which keeps the
+    // force continuous as the link crosses the surface.
+    const ignition::math::Matrix3d rot(linkFrame.Rot());
+    const double r00 = rot(0, 0), r01 = rot(0, 1), r02 = rot(0, 2);
+    const double r10 = rot(1, 0), r11 = rot(1, 1), r12 = rot(1, 2);
+    const double r20 = rot(2, 0), r21 = rot(2, 1), r22 = rot(2, 2);
+    const double tx = linkFrame.Pos().X();
+    const double ty = linkFrame.Pos().Y();
+    const double tz = linkFrame.Pos().Z();
+    const double invHeight = 1.0 / props.sampleHeight;
+
+    const size_t count = props.sampleVolume.size();
+    const double *sx = props.sampleX.data();
+    const double *sy = props.sampleY.data();
+    const double *sz = props.sampleZ.data();
+    const double *sv = props.sampleVolume.data();
+
+    double volume = 0;
+    double cx = 0;
+    double cy = 0;
+    double cz = 0;
+    auto accumulate = [&](auto &&_level)
+    {
+      for (size_t i = 0; i < count; ++i)
+      {
+        const double x = r00 * sx[i] + r01 * sy[i] + r02 * sz[i] + tx;
+        const double y = r10 * sx[i] + r11 * sy[i] + r12 * sz[i] + ty;
+        const double z = r20 * sx[i] + r21 * sy[i] + r22 * sz[i] + tz;
+        const double fraction = std::min(1.0, std::max(0.0,
+            (_level(x, y) - z) * invHeight + 0.5));
+        const double w = sv[i] * fraction;
+        volume += w;
+        cx += w * x;
+        cy += w * y;
+        cz += w * z;
+      }
+    };
+
+    if (this->dataPtr->heights.empty())
+    {
+      const double level = this->dataPtr->level;
+      accumulate([level](double, double) { return level; });
+    }
+    else
+    {
+      const BuoyancyPluginPrivate *data = this->dataPtr.get();
+      accumulate([data](double _x, double _y) { return data->Level(_x, _y); });
+    }
 
-    ignition::math::Pose3d linkFrame = link->WorldPose();
-    // rotate buoyancy into the link frame before applying the force.
-    ignition::math::Vector3d buoyancyLinkFrame =
-        linkFrame.Rot().Inverse().RotateVector(buoyancy);
+    linkBuoyancy.submerged = volume > 0;
+    if (!linkBuoyancy.submerged)
+      continue;
+
+    linkBuoyancy.force = -this->fluidDensity * volume * _gravity;
+    linkBuoyancy.center.Set(cx / volume, cy / volume, cz / volume);
+  }
+}
 
-    link->AddLinkForce(buoyancyLinkFrame, volumeProperties.cov);
+/////////////////////////////////////////////////
+void BuoyancyPlugin::ApplyBuoyancy()
+{
+  for (const auto &linkBuoyancy : this->dataPtr->links)
+  {
+    if (linkBuoyancy.submerged)
+    {
+      linkBuoyancy.link->AddForceAtWorldPosition(
+          linkBuoyancy.force, linkBuoyancy.center);
+    }
   }
 }
@@ -19,6 +19,8 @@
 #define GAZEBO_PLUGINS_BUOYANCYPLUGIN_HH_
 
 #include <map>
+#include <memory>
+#include <vector>
 #include <ignition/math/Vector3.hh>
 
 #include "gazebo/common/Event.hh"
@@ -27,6 +29,10 @@
 
 namespace gazebo
 {
+  // Forward declare private data classes.
+  class BuoyancyBatch;
+  class BuoyancyPluginPrivate;
+
   /// \brief A class for storing the volume properties of a link.
   class VolumeProperties
   {
@@ -38,6 +44,22 @@ namespace gazebo
 
     /// \brief Volume of this link.
     public: double volume;
+
+    /// \brief X coordinates of the volume samples in the link frame.
+    public: std::vector<double> sampleX;
+
+    /// \brief Y coordinates of the volume samples in the link frame.
+    public: std::vector<double> sampleY;
+
+    /// \brief Z coordinates of the volume samples in the link frame.
+    public: std::vector<double> sampleZ;
+
+    /// \brief Volume of each sample. The sum is the volume of the link.
+    public: std::vector<double> sampleVolume;
+
+    /// \brief Height of a sample, over which it goes from dry to
+    /// submerged.
+    public: double sampleHeight = 0;
   };
 
   /// \brief A plugin that simulates buoyancy of an object immersed in fluid.
@@ -57,11 +79,32 @@ namespace gazebo
   /// to compute these properties from the link collision shapes. This
   /// computation will not be accurate if the object is not composed of simple
   /// collision shapes.
+  ///
+  /// Without a fluid surface the links are always fully submerged. A surface
+  /// is either a horizontal plane at a height:
+  /// <fluid_level>0</fluid_level>
+  /// or a heightmap image, placed like the heightmap geometry of SDF:
+  /// <fluid_heightmap>
+  ///   <uri>file://media/materials/textures/waves.png</uri>
+  ///   <size>100 100 2</size>
+  ///   <pos>0 0 -1</pos>
+  /// </fluid_heightmap>
+  /// With a surface, the collision shapes of each link are sampled once at
+  /// load on a grid of <voxel_size> meters, which defaults to a tenth of the
+  /// largest shape of the link. The submerged volume and the center of
+  /// buoyancy are then computed from the samples below the surface. Boxes,
+  /// spheres and cylinders are sampled exactly, other shapes by their
+  /// bounding box, and the links of <link> elements keep their volume and
+  /// center of volume. The plugins of a world are updated together, in
+  /// parallel across models.
   class GZ_PLUGIN_VISIBLE BuoyancyPlugin : public ModelPlugin
   {
     /// \brief Constructor.
     public: BuoyancyPlugin();
 
+    /// \brief Destructor.
+    public: virtual ~BuoyancyPlugin();
+
     /// \brief Read the model SDF to compute volume and center of volume for
     /// each link, and store those properties in volPropsMap.
     public: virtual void Load(physics::ModelPtr _model, sdf::ElementPtr _sdf);
@@ -69,10 +112,21 @@ namespace gazebo
     // Documentation inherited
     public: virtual void Init();
 
-    /// \brief Callback for World Update events.
+    /// \brief Compute and apply the buoyancy of the links. The plugins of a
+    /// world are updated together by ComputeBuoyancy and ApplyBuoyancy
+    /// instead.
     protected: virtual void OnUpdate();
 
-    /// \brief Connection to World Update events.
+    /// \brief Compute the buoyancy of the links without applying it. Only
+    /// reads the physics state, so the plugins of a world can compute in
+    /// parallel.
+    /// \param[in] _gravity Gravity of the world.
+    protected: void ComputeBuoyancy(const ignition::math::Vector3d &_gravity);
+
+    /// \brief Apply the buoyancy computed by ComputeBuoyancy.
+    protected: void ApplyBuoyancy();
+
+    /// \brief Unused, the plugins of a world share one connection.
     protected: event::ConnectionPtr updateConnection;
 
     /// \brief Pointer to model containing the plugin.
@@ -88,6 +142,13 @@ namespace gazebo
     /// \brief Map of <link ID, point> pairs mapping link IDs to the CoV (center
     /// of volume) and volume of the link.
     protected: std::map<int, VolumeProperties> volPropsMap;
+
+    /// \brief The batch updates the plugins of a world.
+    private: friend class BuoyancyBatch;
+
+    /// \internal
+    /// \brief Private data pointer.
+    private: std::unique_ptr<BuoyancyPluginPrivate> dataPtr;
   };
 }
 
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Density of the fluid, in kg/m^3.
+static const double kFluidDensity = 1000;
+
+/// \brief Mass of each box link, in kg. Lighter than the water it displaces
+/// when half submerged, so the boxes are pushed up.
+static const double kMass = 100;
+
+class BuoyancyPluginTest : public ServerFixture
+{
+  /// \brief Spawn a model of unit boxes with a buoyancy plugin and a fluid
+  /// surface at z = 0. The links don't collide with each other, and no link
+  /// is joined.
+  /// \param[in] _name Name of the model.
+  /// \param[in] _pos Position of the model.
+  /// \param[in] _linkPos Position of each link in the model.
+  protected: void SpawnBuoyantBoxes(const std::string &_name,
+                 const ignition::math::Vector3d &_pos,
+                 const std::vector<ignition::math::Vector3d> &_linkPos)
+  {
+    // Inertia of a unit cube
+    const double inertia = kMass / 6.0;
+
+    std::ostringstream sdf;
+    sdf << "<sdf version='" << SDF_VERSION << "'>"
+        << "<model name='" << _name << "'>"
+        << "<pose>" << _pos << " 0 0 0</pose>";
+    for (unsigned int i = 0; i < _linkPos.size(); ++i)
+    {
+      sdf << "<link name='link_" << i << "'>"
+          << "  <pose>" << _linkPos[i] << " 0 0 0</pose>"
+          << "  <inertial>"
+          << "    <mass>" << kMass << "</mass>"
+          << "    <inertia>"
+          << "      <ixx>" << inertia << "</ixx>"
+          << "      <iyy>" << inertia << "</iyy>"
+          << "      <izz>" << inertia << "</izz>"
+          << "    </inertia>"
+          << "  </inertial>"
+          << "  <collision name='collision'>"
+          << "    <geometry><box><size>1 1 1</size></box></geometry>"
+          << "  </collision>"
+          << "</link>";
+    }
+    sdf << "<plugin name='buoyancy' filename='libBuoyancyPlugin.so'>"
+        << "  <fluid_density>" << kFluidDensity << "</fluid_density>"
+        << "  <fluid_level>0</fluid_level>"
+        << "</plugin>"
+        << "</model>"
+        << "</sdf>";
+    SpawnSDF(sdf.str());
+  }
+
+  /// \brief Get the force applied by the plugin to a link during the last
+  /// step, from the velocity the link gained from rest.
+  /// \param[in] _link The link.
+  /// \return Buoyancy force in the world frame.
+  protected: ignition::math::Vector3d BuoyancyForce(
+                 const physics::LinkPtr &_link)
+  {
+    physics::WorldPtr world = _link->GetWorld();
+    const double dt = world->Physics()->GetMaxStepSize();
+    return kMass * (_link->WorldLinearVel() / dt - world->Gravity());
+  }
+};
+
+/////////////////////////////////////////////////
+/// \brief A box half in the fluid is pushed up by the weight of the fluid
+/// it displaces.
+TEST_F(BuoyancyPluginTest, HalfSubmerged)
+{
+  Load("worlds/blank.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBuoyantBoxes("box", ignition::math::Vector3d::Zero,
+      {ignition::math::Vector3d::Zero});
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink("link_0");
+  ASSERT_TRUE(link != nullptr);
+
+  world->Step(1);
+
+  // F = rho * g * V_submerged, with half of the unit box submerged
+  const double expected = kFluidDensity * -world->Gravity().Z() * 0.5;
+  const ignition::math::Vector3d force = this->BuoyancyForce(link);
+  EXPECT_NEAR(force.X(), 0, 1e-6);
+  EXPECT_NEAR(force.Y(), 0, 1e-6);
+  EXPECT_NEAR(force.Z(), expected, expected * 1e-6);
+
+  // Upright, the force goes through the center of gravity
+  EXPECT_NEAR(link->WorldAngularVel().Length(), 0, 1e-9);
+}
+
+/////////////////////////////////////////////////
+/// \brief The center of buoyancy of a half submerged box is at the center
+/// of its submerged half, below its center of gravity.
+TEST_F(BuoyancyPluginTest, CenterOfBuoyancy)
+{
+  Load("worlds/blank.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Buoyancy opposes gravity. With gravity along x as well, the force has a
+  // lever arm about the center of gravity through the depth of the center
+  // of buoyancy alone.
+  world->SetGravity(ignition::math::Vector3d(1.0, 0, -9.8));
+
+  SpawnBuoyantBoxes("box", ignition::math::Vector3d::Zero,
+      {ignition::math::Vector3d::Zero});
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink("link_0");
+  ASSERT_TRUE(link != nullptr);
+
+  world->Step(1);
+
+  const double dt = world->Physics()->GetMaxStepSize();
+  const ignition::math::Vector3d force = this->BuoyancyForce(link);
+  EXPECT_NEAR(force.X(), -kFluidDensity * 0.5, 1e-3);
+
+  // torque_y = z * force_x, for a center of buoyancy at depth z below the
+  // center of gravity
+  const double torqueY =
+      link->WorldAngularVel().Y() / dt * link->GetInertial()->IYY();
+  const double depth = torqueY / force.X();
+  EXPECT_LT(depth, 0);
+  EXPECT_NEAR(depth, -0.25, 1e-3);
+  EXPECT_NEAR(link->WorldAngularVel().X(), 0, 1e-9);
+  EXPECT_NEAR(link->WorldAngularVel().Z(), 0, 1e-9);
+}
+
+/////////////////////////////////////////////////
+/// \brief A box out of the fluid only falls.
+TEST_F(BuoyancyPluginTest, OutOfFluid)
+{
+  Load("worlds/blank.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBuoyantBoxes("box", ignition::math::Vector3d(0, 0, 5),
+      {ignition::math::Vector3d::Zero});
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink("link_0");
+  ASSERT_TRUE(link != nullptr);
+
+  world->Step(1);
+
+  EXPECT_NEAR(this->BuoyancyForce(link).Length(), 0, 1e-6);
+  EXPECT_NEAR(link->WorldAngularVel().Length(), 0, 1e-9);
+}
+
+/////////////////////////////////////////////////
+/// \brief The links of a model, and the models of a world, are updated in
+/// one batch. Each link is pushed as if it were alone.
+TEST_F(BuoyancyPluginTest, BatchMatchesSingleLink)
+{
+  Load("worlds/blank.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBuoyantBoxes("single", ignition::math::Vector3d(0, 0, 0.2),
+      {ignition::math::Vector3d::Zero});
+  SpawnBuoyantBoxes("multi", ignition::math::Vector3d(0, 3, 0.2),
+      {ignition::math::Vector3d::Zero, ignition::math::Vector3d(3, 0, 0),
+       ignition::math::Vector3d(6, 0, 0)});
+
+  physics::ModelPtr single = world->ModelByName("single");
+  ASSERT_TRUE(single != nullptr);
+  physics::ModelPtr multi = world->ModelByName("multi");
+  ASSERT_TRUE(multi != nullptr);
+  ASSERT_EQ(multi->GetLinks().size(), 3u);
+
+  world->Step(1);
+
+  const ignition::math::Vector3d expected =
+      this->BuoyancyForce(single->GetLink("link_0"));
+  EXPECT_GT(expected.Z(), 0);
+
+  for (auto const &link : multi->GetLinks())
+  {
+    const ignition::math::Vector3d force = this->BuoyancyForce(link);
+    EXPECT_NEAR(force.X(), expected.X(), 1e-6);
+    EXPECT_NEAR(force.Y(), expected.Y(), 1e-6);
+    EXPECT_NEAR(force.Z(), expected.Z(), 1e-6);
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
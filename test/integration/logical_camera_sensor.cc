@@ -133,6 +133,49 @@ TEST_F(LogicalCameraSensor, Box)
   ASSERT_EQ(cam->Image().model_size(), 1);
 }
 
+/////////////////////////////////////////////////
+// Models placed with SetWorldPose, not by a physics step, are seen at
+// their new pose
+TEST_F(LogicalCameraSensor, PlacedModel)
+{
+  Load("worlds/logical_camera.world", true);
+
+  // Wait until the sensors have been initialized
+  while (!sensors::SensorManager::Instance()->SensorsInitialized())
+    common::Time::MSleep(1000);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  sensors::LogicalCameraSensorPtr cam = std::dynamic_pointer_cast<
+    sensors::LogicalCameraSensor>(sensors::get_sensor("logical_camera"));
+  ASSERT_TRUE(cam != NULL);
+
+  // Out of the frustum
+  SpawnBox("spawn_box", ignition::math::Vector3d(0.5, 0.5, 0.5),
+      ignition::math::Vector3d(0, 4, 0.5),
+      ignition::math::Vector3d::Zero);
+  physics::ModelPtr box = world->ModelByName("spawn_box");
+  ASSERT_TRUE(box != NULL);
+
+  cam->Update(true);
+  ASSERT_EQ(cam->Image().model_size(), 1);
+  EXPECT_EQ(cam->Image().model(0).name(), "ground_plane");
+
+  // Into the frustum, in front of the camera
+  box->SetWorldPose(ignition::math::Pose3d(2, 0, 0.5, 0, 0, 0));
+  cam->Update(true);
+  ASSERT_EQ(cam->Image().model_size(), 2);
+  EXPECT_EQ(cam->Image().model(1).name(), "spawn_box");
+  EXPECT_NEAR(cam->Image().model(1).pose().position().x(), 2, 1e-3);
+
+  // Out again, behind the camera
+  box->SetWorldPose(ignition::math::Pose3d(-2, 0, 0.5, 0, 0, 0));
+  cam->Update(true);
+  ASSERT_EQ(cam->Image().model_size(), 1);
+  EXPECT_EQ(cam->Image().model(0).name(), "ground_plane");
+}
+
 /////////////////////////////////////////////////
 TEST_F(LogicalCameraSensor, NestedModels)
 {
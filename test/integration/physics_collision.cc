@@ -349,6 +349,57 @@ TEST_F(PhysicsCollisionTest, ModelSelfCollide)
   Unload();
 }
 
+/////////////////////////////////////////////////
+// A model made static or dynamic after loading collides like one loaded
+// that way. Static geoms only collide with moving ones in ODE.
+TEST_F(PhysicsCollisionTest, ToggleStatic)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::ContactManager *contactManager =
+      world->Physics()->GetContactManager();
+  ASSERT_TRUE(contactManager != NULL);
+  contactManager->SetNeverDropContacts(true);
+
+  // A static box sunk into the static ground plane
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.45), ignition::math::Vector3d::Zero,
+      true);
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(box != NULL);
+
+  auto boxContacts = [&]()
+  {
+    world->Step(1);
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < contactManager->GetContactCount(); ++i)
+    {
+      physics::Contact *contact = contactManager->GetContacts()[i];
+      if (contact->collision1->GetModel() == box ||
+          contact->collision2->GetModel() == box)
+      {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  EXPECT_EQ(boxContacts(), 0u);
+
+  box->SetStatic(false);
+  EXPECT_GT(boxContacts(), 0u);
+
+  box->SetStatic(true);
+  EXPECT_EQ(boxContacts(), 0u);
+
+  box->SetStatic(false);
+  EXPECT_GT(boxContacts(), 0u);
+
+  Unload();
+}
+
 /////////////////////////////////////////////////
 TEST_P(PhysicsCollisionTest, GetBoundingBox)
 {
@@ -40,6 +40,10 @@ int g_latchCreatedAfterPub = 0;
 int g_latchCreatedAfterPub2 = 0;
 int g_subBeforeClear = 0;
 int g_subAfterClear = 0;
+int g_unlimited = 0;
+int g_rateLimited = 0;
+int g_latestOnly = 0;
+double g_latestOnlyX = -1;
 
 void ReceiveBeforeClear(ConstVector3dPtr &/*_msg*/)
 {
@@ -51,6 +55,22 @@ void ReceiveAfterClear(ConstVector3dPtr &/*_msg*/)
   g_subAfterClear++;
 }
 
+void ReceiveUnlimited(ConstVector3dPtr &/*_msg*/)
+{
+  g_unlimited++;
+}
+
+void ReceiveRateLimited(ConstVector3dPtr &/*_msg*/)
+{
+  g_rateLimited++;
+}
+
+void ReceiveLatestOnly(ConstVector3dPtr &_msg)
+{
+  g_latestOnly++;
+  g_latestOnlyX = _msg->x();
+}
+
 void ReceiveNoLatchCreatedAfterPub(ConstVector3dPtr &/*_msg*/)
 {
   g_noLatchCreatedAfterPub++;
@@ -788,6 +808,63 @@ TEST_F(TransportTest, TryInit)
   EXPECT_EQ(physics::get_world()->Name(), node->GetTopicNamespace());
 }
 
+/////////////////////////////////////////////////
+// Subscribers with a maximum rate, or that only want the latest message
+TEST_F(TransportTest, SubscribeOptions)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub = node->Advertise<msgs::Vector3d>("~/policy");
+
+  transport::SubscribeOptions rateOps;
+  rateOps.SetMaxRate(20);
+  transport::SubscribeOptions latestOps;
+  latestOps.SetLatestOnly(true);
+
+  transport::SubscriberPtr unlimitedSub =
+    node->Subscribe("~/policy", &ReceiveUnlimited);
+  transport::SubscriberPtr rateSub =
+    node->Subscribe("~/policy", &ReceiveRateLimited, rateOps);
+  transport::SubscriberPtr latestSub =
+    node->Subscribe("~/policy", &ReceiveLatestOnly, latestOps);
+
+  double maxRate = -1;
+  bool latestOnly = true;
+  EXPECT_TRUE(node->SubscriptionPolicy("~/policy", maxRate, latestOnly));
+  EXPECT_DOUBLE_EQ(maxRate, 0.0);
+  EXPECT_FALSE(latestOnly);
+
+  // 500 messages over about half a second
+  const int count = 500;
+  for (int i = 0; i < count; ++i)
+  {
+    pub->Publish(msgs::Convert(ignition::math::Vector3d(i, 0, 0)));
+    common::Time::MSleep(1);
+  }
+
+  for (int i = 0; i < 100 && (g_unlimited < count ||
+       g_latestOnlyX < count - 1); ++i)
+  {
+    common::Time::MSleep(10);
+  }
+
+  EXPECT_EQ(g_unlimited, count);
+  EXPECT_GT(g_rateLimited, 0);
+  EXPECT_LT(g_rateLimited, count / 4);
+  EXPECT_GT(g_latestOnly, 0);
+  EXPECT_LE(g_latestOnly, count);
+  EXPECT_DOUBLE_EQ(g_latestOnlyX, count - 1);
+
+  // Without the unlimited subscriber, the loosest policy is 20 Hz
+  unlimitedSub.reset();
+  latestSub.reset();
+  EXPECT_TRUE(node->SubscriptionPolicy("~/policy", maxRate, latestOnly));
+  EXPECT_DOUBLE_EQ(maxRate, 20.0);
+  EXPECT_FALSE(latestOnly);
+}
+
 /////////////////////////////////////////////////
 // Main
 int main(int argc, char **argv)
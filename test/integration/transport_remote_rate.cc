@@ -0,0 +1,316 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gazebo/gazebo.hh>
+#include <gazebo/transport/transport.hh>
+#include <gazebo/msgs/msgs.hh>
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+using namespace gazebo;
+
+/**
+ * \brief Test class for gtest which forks into parent and child process.
+ * The child process publishes, the parent process subscribes with
+ * delivery options, so that the publisher throttles a remote link.
+ */
+class TransportRemoteRateTest: public ::testing::Test
+{
+ protected:
+
+  TransportRemoteRateTest()
+    :fakeProgramName("TransportRemoteRateTest"),
+     pid(-1)
+  {}
+  virtual ~TransportRemoteRateTest() {}
+
+  virtual void SetUp()
+  {
+    pid = fork();
+    if (pid > 0)
+    {
+      // parent process
+      gazebo::setupServer(1, (char**)&fakeProgramName);
+    }
+    else if (pid == 0)
+    {
+      // child process
+      if (!gazebo::transport::init())
+      {
+        gzerr << "Unable to initialize transport.\n";
+      }
+      else
+      {
+        gazebo::transport::run();
+      }
+    }
+  }
+
+  virtual void TearDown()
+  {
+    KillChildProcess();
+    gazebo::shutdown();
+  }
+
+ protected:
+
+  bool IsParent()
+  {
+    return pid > 0;
+  }
+
+  bool IsChild()
+  {
+    return pid == 0;
+  }
+
+  bool ForkSuccess()
+  {
+    return pid >= 0;
+  }
+
+  // \brief can be used from the parent to check if the child is still running
+  // \retval 1 child is still running
+  // \retval 0 child is not running
+  // \retval -1 this is not the parent process
+  int ChildRunning()
+  {
+    if (!IsParent()) return -1;
+    int child_status;
+    // result will be 0 if child is still running
+    pid_t result = waitpid(pid, &child_status, WNOHANG);
+    return result == 0;
+  }
+
+ private:
+  // kills the child process, if it's the parent process.
+  void KillChildProcess()
+  {
+    if (IsParent())
+    {
+      kill(pid, SIGKILL);
+    }
+  }
+
+  // \brief fake program name as argv for gazebo::setupServer()
+  const char * fakeProgramName;
+
+  // \brief PID for child process which will run the remote publisher
+  pid_t pid;
+};
+
+// A message received by a subscriber: the publication wall time of the
+// message in the remote process, the wall time it was received at, and
+// its index.
+struct Received
+{
+  double published;
+  double received;
+  double index;
+};
+
+std::mutex g_mutex;
+std::vector<Received> g_rate10;
+std::vector<Received> g_rate50;
+std::vector<Received> g_latest;
+
+void Record(std::vector<Received> &_list, ConstVector3dPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_mutex);
+  _list.push_back({_msg->x(), common::Time::GetWallTime().Double(),
+      _msg->y()});
+}
+
+void ReceiveRate10(ConstVector3dPtr &_msg)
+{
+  Record(g_rate10, _msg);
+}
+
+void ReceiveRate50(ConstVector3dPtr &_msg)
+{
+  Record(g_rate50, _msg);
+}
+
+void ReceiveLatest(ConstVector3dPtr &_msg)
+{
+  Record(g_latest, _msg);
+  // A slow subscriber, for which the link has to skip messages
+  common::Time::MSleep(20);
+}
+
+// Wait until a list has messages, then collect it for a while.
+std::vector<Received> Collect(std::vector<Received> &_list,
+    const double _seconds)
+{
+  for (int i = 0; i < 1000; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      if (!_list.empty())
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+
+  // Let the link settle before measuring
+  common::Time::MSleep(500);
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    _list.clear();
+  }
+
+  common::Time::Sleep(common::Time(_seconds));
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  return _list;
+}
+
+// Delivered rate, measured with the publication times of the remote
+// process.
+double Rate(const std::vector<Received> &_list)
+{
+  if (_list.size() < 2)
+    return 0;
+  return (_list.size() - 1) /
+    (_list.back().published - _list.front().published);
+}
+
+// Smallest and largest time between two delivered messages, measured with
+// the publication times of the remote process.
+void Intervals(const std::vector<Received> &_list, double &_min, double &_max)
+{
+  _min = 1e9;
+  _max = 0;
+  for (size_t i = 1; i < _list.size(); ++i)
+  {
+    const double dt = _list[i].published - _list[i-1].published;
+    _min = std::min(_min, dt);
+    _max = std::max(_max, dt);
+  }
+}
+
+/////////////////////////////////////////////////
+// Subscribers with a maximum rate or that only want the latest message,
+// on links that the remote publisher throttles.
+TEST_F(TransportRemoteRateTest, RemoteRate)
+{
+  // only continue if the forking has succeeded
+  ASSERT_EQ(ForkSuccess(), true);
+
+  // The child publishes as fast as it can, stamping each message with its
+  // publication wall time and index.
+  if (IsChild())
+  {
+    ASSERT_FALSE(gazebo::transport::is_stopped());
+
+    transport::NodePtr nodeRemote(new transport::Node());
+    nodeRemote->Init();
+    transport::PublisherPtr ratePub =
+      nodeRemote->Advertise<msgs::Vector3d>("/gazebo/ttest/rate", 10000);
+    transport::PublisherPtr latestPub =
+      nodeRemote->Advertise<msgs::Vector3d>("/gazebo/ttest/latest", 10000);
+
+    // publish forever until child process is killed
+    for (int i = 0; true; ++i)
+    {
+      const msgs::Vector3d msg = msgs::Convert(ignition::math::Vector3d(
+            common::Time::GetWallTime().Double(), i, 0));
+      ratePub->Publish(msg);
+      latestPub->Publish(msg);
+      common::Time::NSleep(200000);
+    }
+    return;
+  }
+
+  // at this point, it can only be the parent process
+  ASSERT_TRUE(IsParent());
+  ASSERT_EQ(ChildRunning(), 1);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+
+  // A 10 Hz subscriber. The publisher throttles the link at 10 Hz, and the
+  // subscriber must not drop messages that arrive closer together.
+  transport::SubscribeOptions rate10Ops;
+  rate10Ops.SetMaxRate(10);
+  transport::SubscriberPtr rate10Sub =
+    node->Subscribe("/gazebo/ttest/rate", &ReceiveRate10, rate10Ops);
+
+  std::vector<Received> rate10 = Collect(g_rate10, 3.0);
+  ASSERT_GT(rate10.size(), 20u);
+  EXPECT_NEAR(Rate(rate10), 10.0, 0.2);
+
+  double minDt, maxDt;
+  Intervals(rate10, minDt, maxDt);
+  EXPECT_GE(minDt, 0.099);
+  EXPECT_LT(maxDt, 0.11);
+
+  // A looser 50 Hz subscriber drops the 10 Hz link and reconnects at
+  // 50 Hz. The 10 Hz subscriber is then throttled on reception.
+  transport::SubscribeOptions rate50Ops;
+  rate50Ops.SetMaxRate(50);
+  transport::SubscriberPtr rate50Sub =
+    node->Subscribe("/gazebo/ttest/rate", &ReceiveRate50, rate50Ops);
+
+  std::vector<Received> rate50 = Collect(g_rate50, 3.0);
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    rate10 = g_rate10;
+  }
+  ASSERT_GT(rate50.size(), 100u);
+  EXPECT_NEAR(Rate(rate50), 50.0, 1.0);
+  Intervals(rate50, minDt, maxDt);
+  EXPECT_GE(minDt, 0.0198);
+  EXPECT_LT(maxDt, 0.025);
+
+  // Only the messages received during the 50 Hz measurement
+  rate10.erase(std::remove_if(rate10.begin(), rate10.end(),
+        [&](const Received &_r)
+        {
+          return _r.published < rate50.front().published ||
+                 _r.published > rate50.back().published;
+        }), rate10.end());
+  ASSERT_GT(rate10.size(), 20u);
+  EXPECT_NEAR(Rate(rate10), 10.0, 1.0);
+  Intervals(rate10, minDt, maxDt);
+  EXPECT_GE(minDt, 0.08);
+  EXPECT_LT(maxDt, 0.15);
+
+  // A slow latest-only subscriber. The link only carries the latest
+  // messages, so the subscriber keeps up with the publisher.
+  transport::SubscribeOptions latestOps;
+  latestOps.SetLatestOnly(true);
+  transport::SubscriberPtr latestSub =
+    node->Subscribe("/gazebo/ttest/latest", &ReceiveLatest, latestOps);
+
+  std::vector<Received> latest = Collect(g_latest, 2.0);
+  ASSERT_GT(latest.size(), 20u);
+  // The child publishes at several kHz, the subscriber takes 20 ms per
+  // message.
+  EXPECT_LT(latest.size(), 150u);
+  for (size_t i = 1; i < latest.size(); ++i)
+  {
+    EXPECT_GT(latest[i].index, latest[i-1].index);
+    // Without latest-only, a backlog would build up
+    EXPECT_LT(latest[i].received - latest[i].published, 0.1);
+  }
+}
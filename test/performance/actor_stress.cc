@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gazebo/common/Timer.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+class ActorStress_TEST : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a world with walking actors on a grid.
+/// \param[in] _count Number of actors.
+/// \return World SDF.
+std::string CrowdWorld(const unsigned int _count)
+{
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?><sdf version='1.6'><world name='default'>"
+      << "<physics type='ode'><max_step_size>0.001</max_step_size>"
+      << "</physics>";
+
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    const double x = (i % 20) * 2.0;
+    const double y = (i / 20) * 2.0;
+    sdf << "<actor name='actor_" << i << "'>"
+        << "<skin><filename>walk.dae</filename></skin>"
+        << "<animation name='walking'><filename>walk.dae</filename>"
+        << "<interpolate_x>true</interpolate_x></animation>"
+        << "<script><loop>true</loop><auto_start>true</auto_start>"
+        << "<trajectory id='0' type='walking'>"
+        << "<waypoint><time>0</time><pose>" << x << " " << y
+        << " 0 0 0 0</pose></waypoint>"
+        << "<waypoint><time>4</time><pose>" << x + 1.5 << " " << y
+        << " 0 0 0 0</pose></waypoint>"
+        << "</trajectory></script></actor>";
+  }
+
+  sdf << "</world></sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Step a world with a crowd of walking actors, whose skeleton
+/// animations are sampled as a batch by the world.
+TEST_F(ActorStress_TEST, WalkingCrowd)
+{
+  const unsigned int actorCount = 200;
+
+  boost::filesystem::path worldFile =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_actor_stress_%%%%-%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << CrowdWorld(actorCount);
+  }
+
+  Load(worldFile.string(), true);
+  boost::filesystem::remove(worldFile);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  ASSERT_EQ(world->ModelCount(), actorCount);
+
+  physics::ActorPtr actor = boost::dynamic_pointer_cast<physics::Actor>(
+      world->ModelByName("actor_0"));
+  ASSERT_TRUE(actor != nullptr);
+  ignition::math::Pose3d startPose = actor->WorldPose();
+
+  // One second of simulation, about 30 animation frames per actor
+  const unsigned int steps = 1000;
+  common::Timer timer;
+  timer.Start();
+  world->Step(steps);
+  common::Time elapsed = timer.GetElapsed();
+
+  EXPECT_TRUE(actor->WorldPose().IsFinite());
+  EXPECT_NE(actor->WorldPose(), startPose);
+
+  gzmsg << actorCount << " actors: " << elapsed.Double() / steps * 1e3
+        << " ms per step ("
+        << actorCount * 30.0 / elapsed.Double() << " actor frames/s)\n";
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
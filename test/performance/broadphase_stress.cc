@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ode/ODEPhysics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+class BroadphaseStress_TEST : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a world mixing a 1 km static slab, rows of
+/// static shelves, and small boxes dropped onto the shelves.
+/// \param[in] _shelfCount Number of shelves.
+/// \param[in] _boxCount Number of small boxes.
+/// \return World SDF.
+std::string WarehouseWorld(const unsigned int _shelfCount,
+    const unsigned int _boxCount)
+{
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?><sdf version='1.6'><world name='default'>"
+      << "<physics type='ode'><max_step_size>0.001</max_step_size>"
+      << "</physics>"
+      << "<model name='terrain'><static>true</static><pose>0 0 -0.5 0 0 0"
+      << "</pose><link name='link'><collision name='c'><geometry><box>"
+      << "<size>1000 1000 1</size></box></geometry></collision></link>"
+      << "</model>";
+
+  for (unsigned int s = 0; s < _shelfCount; ++s)
+  {
+    sdf << "<model name='shelf_" << s << "'><static>true</static><pose>"
+        << (s % 20) * 4.0 << " " << (s / 20) * 2.0 << " 1 0 0 0</pose>"
+        << "<link name='link'><collision name='c'><geometry><box>"
+        << "<size>3 0.5 2</size></box></geometry></collision></link>"
+        << "</model>";
+  }
+
+  for (unsigned int b = 0; b < _boxCount; ++b)
+  {
+    const unsigned int s = b % _shelfCount;
+    sdf << "<model name='box_" << b << "'><pose>"
+        << (s % 20) * 4.0 + 0.1 * (b / _shelfCount) << " " << (s / 20) * 2.0
+        << " 2.1 0 0 0</pose><link name='link'><collision name='c'>"
+        << "<geometry><box><size>0.05 0.05 0.05</size></box></geometry>"
+        << "</collision></link></model>";
+  }
+
+  sdf << "</world></sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Compare the broadphase time and pair count of every broadphase
+/// in a world with a large static terrain, many static shelves and small
+/// moving boxes.
+TEST_F(BroadphaseStress_TEST, Warehouse)
+{
+  const unsigned int shelfCount = 300;
+  const unsigned int boxCount = 600;
+
+  boost::filesystem::path worldFile =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_broadphase_stress_%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << WarehouseWorld(shelfCount, boxCount);
+  }
+
+  Load(worldFile.string(), true);
+  boost::filesystem::remove(worldFile);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ODEPhysicsPtr ode =
+      boost::dynamic_pointer_cast<physics::ODEPhysics>(world->Physics());
+  ASSERT_TRUE(ode != nullptr);
+
+  // Let the boxes settle on the shelves
+  world->Step(500);
+
+  const unsigned int steps = 200;
+  for (auto const &type : {"hash", "sap", "quadtree"})
+  {
+    ASSERT_TRUE(ode->SetParam("broadphase", std::string(type)));
+
+    // The first step rebuilds the space
+    world->Step(1);
+
+    double time = 0;
+    int pairs = 0;
+    for (unsigned int i = 0; i < steps; ++i)
+    {
+      world->Step(1);
+      time += boost::any_cast<double>(ode->GetParam("broadphase_time"));
+      pairs = boost::any_cast<int>(ode->GetParam("broadphase_pairs"));
+    }
+
+    // Every box rests on a static shelf
+    EXPECT_GE(pairs, static_cast<int>(boxCount)) << type;
+
+    gzmsg << type << ": " << time / steps * 1e3 << " ms per step, "
+          << pairs << " pairs\n";
+  }
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Physics engine, and whether the engine runs multithreaded:
+/// the task-parallel world for bullet, or island threads for ode.
+typedef std::tuple<std::string, bool> ThreadingParam;
+
+class BulletThreading_TEST : public ServerFixture,
+    public testing::WithParamInterface<ThreadingParam>
+{
+  /// \brief Load a world and report the average wall time of a step.
+  /// \param[in] _models SDF of the models of the world.
+  /// \param[in] _settleSteps Steps taken before timing.
+  /// \param[in] _steps Number of timed steps.
+  public: void Run(const std::string &_models,
+              const unsigned int _settleSteps, const unsigned int _steps);
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a box model.
+/// \param[in] _name Name of the model.
+/// \param[in] _pos Position of the model.
+/// \param[in] _size Edge length of the box.
+/// \return Model SDF.
+std::string BoxModel(const std::string &_name,
+    const ignition::math::Vector3d &_pos, const double _size)
+{
+  std::ostringstream sdf;
+  sdf << "<model name='" << _name << "'><pose>" << _pos << " 0 0 0</pose>"
+      << "<link name='link'><inertial><mass>1</mass></inertial>"
+      << "<collision name='c'><geometry><box><size>" << _size << " "
+      << _size << " " << _size << "</size></box></geometry></collision>"
+      << "</link></model>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+void BulletThreading_TEST::Run(const std::string &_models,
+    const unsigned int _settleSteps, const unsigned int _steps)
+{
+  const std::string engine = std::get<0>(GetParam());
+  const bool threaded = std::get<1>(GetParam());
+  const unsigned int threads =
+      std::max(2u, std::thread::hardware_concurrency());
+
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?><sdf version='1.6'><world name='default'>"
+      << "<physics type='" << engine << "'>"
+      << "<max_step_size>0.001</max_step_size>";
+  if (engine == "bullet")
+  {
+    sdf << "<bullet><gz:multithreaded>" << (threaded ? "true" : "false")
+        << "</gz:multithreaded></bullet>";
+  }
+  else
+  {
+    sdf << "<ode><solver><island_threads>" << (threaded ? threads : 0)
+        << "</island_threads></solver></ode>";
+  }
+  sdf << "</physics>"
+      << "<model name='ground'><static>true</static><link name='link'>"
+      << "<collision name='c'><geometry><plane><normal>0 0 1</normal>"
+      << "<size>1000 1000</size></plane></geometry></collision></link>"
+      << "</model>"
+      << _models
+      << "</world></sdf>";
+
+  boost::filesystem::path worldFile =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_bullet_threading_%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << sdf.str();
+  }
+
+  Load(worldFile.string(), true, engine);
+  boost::filesystem::remove(worldFile);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  ASSERT_EQ(world->Physics()->GetType(), engine);
+
+  if (engine == "bullet")
+  {
+    // The task-parallel world needs Bullet 2.88 or later
+    const bool multithreaded =
+        boost::any_cast<bool>(world->Physics()->GetParam("multithreaded"));
+    if (threaded && !multithreaded)
+    {
+      gzmsg << "Multithreaded Bullet world not supported, skipping\n";
+      return;
+    }
+    EXPECT_EQ(multithreaded, threaded);
+  }
+
+  world->Step(_settleSteps);
+
+  auto start = std::chrono::steady_clock::now();
+  world->Step(_steps);
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  // Nothing fell through the ground
+  for (auto const &model : world->Models())
+    EXPECT_GT(model->WorldPose().Pos().Z(), -0.01) << model->GetName();
+
+  gzmsg << engine << (threaded ? " multithreaded: " : " single-threaded: ")
+        << elapsed.count() / _steps << " ms per step, "
+        << world->ModelCount() << " models\n";
+}
+
+/////////////////////////////////////////////////
+/// \brief A swarm of boxes resting apart on the ground, so every box is
+/// its own simulation island.
+TEST_P(BulletThreading_TEST, Swarm)
+{
+  const unsigned int rows = 40;
+  std::ostringstream models;
+  for (unsigned int i = 0; i < rows * rows; ++i)
+  {
+    models << BoxModel("box_" + std::to_string(i),
+        ignition::math::Vector3d((i % rows) * 1.0, (i / rows) * 1.0, 0.1),
+        0.2);
+  }
+
+  Run(models.str(), 500, 500);
+}
+
+/////////////////////////////////////////////////
+/// \brief Towers of stacked boxes that touch each other, so the boxes form
+/// a few large simulation islands.
+TEST_P(BulletThreading_TEST, Stacking)
+{
+  const unsigned int towers = 8;
+  const unsigned int height = 10;
+  const double size = 0.5;
+  std::ostringstream models;
+  for (unsigned int t = 0; t < towers * towers; ++t)
+  {
+    for (unsigned int h = 0; h < height; ++h)
+    {
+      models << BoxModel(
+          "box_" + std::to_string(t) + "_" + std::to_string(h),
+          ignition::math::Vector3d((t % towers) * size, (t / towers) * size,
+            size * (h + 0.5)),
+          size);
+    }
+  }
+
+  Run(models.str(), 500, 500);
+}
+
+INSTANTIATE_TEST_CASE_P(Threading, BulletThreading_TEST,
+    ::testing::Combine(::testing::Values("bullet", "ode"),
+      ::testing::Bool()));
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
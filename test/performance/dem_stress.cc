@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gdal_priv.h>
+
+#include "gazebo/common/Dem.hh"
+#include "gazebo/common/Timer.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class DemStressTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Get the resident memory of the process.
+/// \return Resident memory in bytes.
+uint64_t ResidentBytes()
+{
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a synthetic GeoTIFF DEM of rolling hills.
+/// \param[in] _filename File to write.
+/// \param[in] _size Number of samples along each side.
+/// \return True on success.
+bool WriteDem(const std::string &_filename, const int _size)
+{
+  GDALAllRegister();
+  GDALDriver *driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+  if (!driver)
+    return false;
+
+  char **options = nullptr;
+  options = CSLSetNameValue(options, "TILED", "YES");
+  GDALDataset *dataSet = driver->Create(_filename.c_str(), _size, _size, 1,
+      GDT_Float32, options);
+  CSLDestroy(options);
+  if (!dataSet)
+    return false;
+
+  // About 30 m per sample, near the equator
+  double transform[6] = {0.0, 0.0003, 0.0, 0.0, 0.0, -0.0003};
+  dataSet->SetGeoTransform(transform);
+  dataSet->SetProjection(
+      "GEOGCS[\"WGS 84\",DATUM[\"WGS_1984\",SPHEROID[\"WGS 84\",6378137,"
+      "298.257223563]],PRIMEM[\"Greenwich\",0],UNIT[\"degree\","
+      "0.0174532925199433]]");
+
+  GDALRasterBand *band = dataSet->GetRasterBand(1);
+  std::vector<float> row(_size);
+  bool result = true;
+  for (int y = 0; y < _size && result; ++y)
+  {
+    for (int x = 0; x < _size; ++x)
+      row[x] = 100.0f + 50.0f * std::sin(x * 0.01f) * std::cos(y * 0.013f);
+    result = band->RasterIO(GF_Write, 0, y, _size, 1, row.data(), _size, 1,
+        GDT_Float32, 0, 0) == CE_None;
+  }
+
+  GDALClose(dataSet);
+  return result;
+}
+
+/////////////////////////////////////////////////
+// Load synthetic DEMs of increasing size, and report the time to load them
+// and to fill a heightmap, and the resident memory they use.
+TEST_F(DemStressTest, SyntheticSizes)
+{
+  boost::filesystem::path dir = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_dem_stress_%%%%-%%%%");
+  boost::filesystem::create_directories(dir);
+
+  for (const int size : {513, 2049, 4097})
+  {
+    std::string filename = (dir / ("dem_" + std::to_string(size) + ".tif"))
+        .string();
+    ASSERT_TRUE(WriteDem(filename, size));
+
+    uint64_t rssBefore = ResidentBytes();
+    common::Timer timer;
+
+    common::Dem dem;
+    timer.Start();
+    ASSERT_EQ(dem.Load(filename), 0);
+    common::Time loadTime = timer.GetElapsed();
+    uint64_t rssLoad = ResidentBytes();
+
+    EXPECT_NEAR(dem.GetMinElevation(), 50.0, 1.0);
+    EXPECT_NEAR(dem.GetMaxElevation(), 150.0, 1.0);
+
+    // Lazy access decodes a single tile
+    EXPECT_NEAR(dem.GetElevation(0, 0), 100.0, 1e-3);
+
+    const unsigned int vertSize = 513;
+    std::vector<float> heights;
+    timer.Reset();
+    timer.Start();
+    dem.FillHeightMap(
+        1, vertSize, ignition::math::Vector3d(1000, 1000, 100),
+        ignition::math::Vector3d(1000.0 / vertSize, 1000.0 / vertSize, 1.0),
+        false, heights);
+    common::Time fillTime = timer.GetElapsed();
+    EXPECT_EQ(heights.size(), vertSize * vertSize);
+
+    const uint64_t rasterBytes = static_cast<uint64_t>(dem.GetWidth()) *
+        dem.GetHeight() * sizeof(float);
+    const uint64_t loadGrowth = rssLoad > rssBefore ? rssLoad - rssBefore : 0;
+
+    gzmsg << dem.GetWidth() << "x" << dem.GetHeight() << ": load "
+          << loadTime.Double() * 1e3 << " ms, fill "
+          << fillTime.Double() * 1e3 << " ms, raster "
+          << rasterBytes / 1024 << " KiB, resident growth after load "
+          << loadGrowth / 1024 << " KiB\n";
+
+    // The decoded raster is paged out of the process after loading
+    if (rasterBytes > 64u * 1024 * 1024)
+      EXPECT_LT(loadGrowth, rasterBytes / 2);
+  }
+
+  boost::filesystem::remove_all(dir);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gazebo/common/Timer.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+class LinkPoseStress_TEST : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the SDF of a world with models made of chains of free
+/// falling links, spread out so that they don't touch each other.
+/// \param[in] _modelCount Number of models.
+/// \param[in] _linkCount Number of links per model.
+/// \return World SDF.
+std::string FallingLinksWorld(const unsigned int _modelCount,
+    const unsigned int _linkCount)
+{
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?><sdf version='1.6'><world name='default'>"
+      << "<physics type='ode'><max_step_size>0.001</max_step_size>"
+      << "</physics>";
+
+  for (unsigned int m = 0; m < _modelCount; ++m)
+  {
+    sdf << "<model name='model_" << m << "'><pose>" << (m % 50) * 2.0
+        << " " << (m / 50) * 2.0 << " 100 0 0 0</pose>";
+    for (unsigned int l = 0; l < _linkCount; ++l)
+    {
+      sdf << "<link name='link_" << l << "'><pose>" << l * 0.2
+          << " 0 0 0 0 0</pose><collision name='c'><geometry><box>"
+          << "<size>0.1 0.1 0.1</size></box></geometry></collision></link>";
+    }
+    sdf << "</model>";
+  }
+
+  sdf << "</world></sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Step a world where thousands of links move every step, so that
+/// writing back the poses computed by the physics engine dominates.
+TEST_F(LinkPoseStress_TEST, ManyMovingLinks)
+{
+  const unsigned int modelCount = 500;
+  const unsigned int linkCount = 10;
+
+  boost::filesystem::path worldFile =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("gazebo_link_pose_stress_%%%%.world");
+  {
+    std::ofstream out(worldFile.string());
+    out << FallingLinksWorld(modelCount, linkCount);
+  }
+
+  Load(worldFile.string(), true);
+  boost::filesystem::remove(worldFile);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+  ASSERT_EQ(world->ModelCount(), modelCount);
+
+  physics::LinkPtr link = world->ModelByName("model_0")->GetLink("link_3");
+  ASSERT_TRUE(link != nullptr);
+  physics::CollisionPtr collision = link->GetCollision("c");
+  ASSERT_TRUE(collision != nullptr);
+
+  const unsigned int steps = 500;
+  common::Timer timer;
+  timer.Start();
+  world->Step(steps);
+  common::Time elapsed = timer.GetElapsed();
+
+  // The links fell, and their collisions followed
+  EXPECT_LT(link->WorldPose().Pos().Z(), 100.0);
+  EXPECT_EQ(collision->WorldPose(), link->WorldPose());
+
+  gzmsg << modelCount * linkCount << " moving links: "
+        << elapsed.Double() / steps * 1e3 << " ms per step\n";
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
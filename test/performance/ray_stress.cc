@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Timer.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/sensors/sensors.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+class RayStress_TEST : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Get the length of every ray of a shape.
+/// \param[in] _shape The shape.
+/// \param[out] _lengths Ray lengths.
+void RayLengths(physics::MultiRayShapePtr _shape,
+    std::vector<double> &_lengths)
+{
+  _lengths.resize(_shape->RayCount());
+  for (unsigned int i = 0; i < _shape->RayCount(); ++i)
+    _lengths[i] = _shape->Ray(i)->GetLength();
+}
+
+/////////////////////////////////////////////////
+/// \brief Scale the ray_cpu.world setup up to many 16x1800 lidars, and
+/// compare updating them one by one with updating them as a batch.
+TEST_F(RayStress_TEST, ManySensors)
+{
+  Load("worlds/ray_cpu.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  if (world->Physics()->GetType() != "ode")
+  {
+    gzdbg << "Skipped test since the batched ray casts are ODE only\n";
+    return;
+  }
+
+  // Obstacles around the sensors
+  const unsigned int boxCount = 40;
+  for (unsigned int i = 0; i < boxCount; ++i)
+  {
+    double angle = 2.0 * IGN_PI * i / boxCount;
+    SpawnBox("box_" + std::to_string(i),
+        ignition::math::Vector3d(0.5, 0.5, 1.0 + (i % 3)),
+        ignition::math::Vector3d(6 * cos(angle), 6 * sin(angle), 0.5));
+  }
+
+  const unsigned int sensorCount = 8;
+  std::vector<physics::MultiRayShapePtr> shapes;
+  for (unsigned int i = 0; i < sensorCount; ++i)
+  {
+    double angle = 2.0 * IGN_PI * i / sensorCount;
+    std::string name = "lidar_" + std::to_string(i);
+    SpawnRaySensor(name + "_model", name,
+        ignition::math::Vector3d(2 * cos(angle), 2 * sin(angle), 1.0),
+        ignition::math::Vector3d::Zero, -IGN_PI, IGN_PI, -0.26, 0.26,
+        0.1, 30, 0.01, 1800, 16);
+
+    sensors::RaySensorPtr sensor =
+      std::dynamic_pointer_cast<sensors::RaySensor>(
+          sensors::SensorManager::Instance()->GetSensor(name));
+    ASSERT_TRUE(sensor != nullptr);
+
+    // Keep the sensor thread away from the shapes while they are timed.
+    sensor->SetActive(false);
+    shapes.push_back(sensor->LaserShape());
+    ASSERT_TRUE(shapes.back() != nullptr);
+  }
+
+  world->Step(1);
+
+  const unsigned int iterations = 10;
+  unsigned int rayCount = 0;
+  for (auto const &shape : shapes)
+    rayCount += shape->RayCount();
+
+  // One shape at a time
+  common::Timer timer;
+  timer.Start();
+  for (unsigned int i = 0; i < iterations; ++i)
+  {
+    for (auto const &shape : shapes)
+      shape->Update();
+  }
+  common::Time serialTime = timer.GetElapsed();
+
+  std::vector<std::vector<double> > serialLengths(shapes.size());
+  for (unsigned int s = 0; s < shapes.size(); ++s)
+    RayLengths(shapes[s], serialLengths[s]);
+
+  // All shapes at once
+  timer.Reset();
+  timer.Start();
+  for (unsigned int i = 0; i < iterations; ++i)
+    physics::MultiRayShape::UpdateBatch(shapes);
+  common::Time batchTime = timer.GetElapsed();
+
+  // Both paths must produce the same ranges
+  std::vector<double> lengths;
+  unsigned int hits = 0;
+  for (unsigned int s = 0; s < shapes.size(); ++s)
+  {
+    RayLengths(shapes[s], lengths);
+    ASSERT_EQ(lengths.size(), serialLengths[s].size());
+    for (unsigned int i = 0; i < lengths.size(); ++i)
+    {
+      EXPECT_DOUBLE_EQ(lengths[i], serialLengths[s][i]);
+      if (lengths[i] < shapes[s]->GetMaxRange() - shapes[s]->GetMinRange())
+        ++hits;
+    }
+  }
+  EXPECT_GT(hits, 0u);
+
+  gzmsg << sensorCount << " sensors, " << rayCount << " rays, "
+        << hits << " hits\n";
+  gzmsg << "Update:      " << serialTime.Double() / iterations * 1e3
+        << " ms per step ("
+        << rayCount * iterations / serialTime.Double() << " rays/s)\n";
+  gzmsg << "UpdateBatch: " << batchTime.Double() / iterations * 1e3
+        << " ms per step ("
+        << rayCount * iterations / batchTime.Double() << " rays/s)\n";
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <string>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/ShmRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ShmTransportStressTest : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Receives serialized images, or shared memory descriptors of
+/// serialized images, and parses them like a remote subscriber would.
+class Receiver
+{
+  /// \brief Constructor
+  /// \param[in] _conn Connection to read from.
+  public: explicit Receiver(transport::ConnectionPtr _conn)
+          : conn(_conn)
+  {
+    this->conn->AsyncRead(boost::bind(&Receiver::OnRead, this, _1));
+  }
+
+  /// \brief Called for every message read from the connection.
+  /// \param[in] _data Serialized image or descriptor.
+  public: void OnRead(const std::string &_data)
+  {
+    this->conn->AsyncRead(boost::bind(&Receiver::OnRead, this, _1));
+
+    boost::mutex::scoped_lock lock(this->mutex);
+    std::string data;
+    if (transport::ShmRing::IsDescriptor(_data))
+    {
+      if (!this->ring)
+        this->ring = transport::ShmRing::Open(
+            transport::ShmRing::DescriptorName(_data));
+      if (!this->ring || !this->ring->Read(_data, data))
+        ++this->dropped;
+    }
+    else
+      data = _data;
+
+    msgs::ImageStamped msg;
+    if (msg.ParseFromString(data))
+      this->bytes += msg.image().data().size();
+
+    ++this->count;
+    this->condition.notify_all();
+  }
+
+  /// \brief Wait until at least _count messages were received.
+  /// \param[in] _count Number of messages.
+  /// \return False on timeout.
+  public: bool WaitFor(const unsigned int _count)
+  {
+    boost::mutex::scoped_lock lock(this->mutex);
+    while (this->count < _count)
+    {
+      if (!this->condition.timed_wait(lock,
+            boost::posix_time::milliseconds(10000)))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Connection to read from.
+  public: transport::ConnectionPtr conn;
+
+  /// \brief Shared memory ring of the sender.
+  public: transport::ShmRingPtr ring;
+
+  /// \brief Number of messages received.
+  public: unsigned int count = 0;
+
+  /// \brief Number of messages that could not be read from the ring.
+  public: unsigned int dropped = 0;
+
+  /// \brief Number of image bytes received.
+  public: uint64_t bytes = 0;
+
+  /// \brief Protects the counters.
+  public: boost::mutex mutex;
+
+  /// \brief Signaled on every received message.
+  public: boost::condition_variable condition;
+};
+
+/////////////////////////////////////////////////
+/// \brief Send _frames 1080p RGB images over a loopback connection.
+/// \param[in] _shm True to send shared memory descriptors.
+/// \param[in] _frames Number of images to send.
+/// \return Wall time to send and receive all images.
+common::Time SendImages(const bool _shm, const unsigned int _frames)
+{
+  boost::mutex acceptMutex;
+  boost::condition_variable acceptCondition;
+  transport::ConnectionPtr accepted;
+
+  transport::ConnectionPtr server(new transport::Connection());
+  server->Listen(0, [&](const transport::ConnectionPtr &_conn)
+      {
+        boost::mutex::scoped_lock lock(acceptMutex);
+        accepted = _conn;
+        acceptCondition.notify_all();
+      });
+
+  transport::ConnectionPtr client(new transport::Connection());
+  EXPECT_TRUE(client->Connect("127.0.0.1", server->GetLocalPort()));
+
+  {
+    boost::mutex::scoped_lock lock(acceptMutex);
+    while (!accepted)
+      acceptCondition.wait(lock);
+  }
+  Receiver receiver(accepted);
+
+  const unsigned int width = 1920;
+  const unsigned int height = 1080;
+  std::string pixels(width * height * 3, 'p');
+
+  msgs::ImageStamped msg;
+  msgs::Set(msg.mutable_time(), common::Time::GetWallTime());
+  msg.mutable_image()->set_width(width);
+  msg.mutable_image()->set_height(height);
+  msg.mutable_image()->set_pixel_format(3);
+  msg.mutable_image()->set_step(width * 3);
+  msg.mutable_image()->set_data(pixels);
+
+  transport::ShmRingPtr ring;
+  if (_shm)
+  {
+    ring = transport::ShmRing::Create(transport::ShmRing::UniqueName(),
+        transport::ShmRing::kDefaultSlotCount, msg.ByteSize() * 2);
+    EXPECT_TRUE(ring != nullptr);
+  }
+
+  // Keep fewer frames in flight than there are slots, so that the ring is
+  // never overrun. The same window is used for both paths.
+  const unsigned int window = transport::ShmRing::kDefaultSlotCount - 1;
+
+  common::Time start = common::Time::GetWallTime();
+  for (unsigned int i = 0; i < _frames; ++i)
+  {
+    if (i >= window)
+      EXPECT_TRUE(receiver.WaitFor(i - window + 1));
+
+    std::string data;
+    msg.SerializeToString(&data);
+    if (_shm)
+    {
+      std::string desc;
+      EXPECT_TRUE(ring->Write(data, desc));
+      client->EnqueueMsg(desc, true);
+    }
+    else
+      client->EnqueueMsg(data, true);
+  }
+  EXPECT_TRUE(receiver.WaitFor(_frames));
+  common::Time elapsed = common::Time::GetWallTime() - start;
+
+  EXPECT_EQ(receiver.dropped, 0u);
+  EXPECT_EQ(receiver.bytes, static_cast<uint64_t>(_frames) * pixels.size());
+
+  client->Shutdown();
+  server->Shutdown();
+  return elapsed;
+}
+
+/////////////////////////////////////////////////
+// Compare sending 1080p images to a subscriber on the same host over
+// loopback TCP with sending shared memory descriptors.
+TEST_F(ShmTransportStressTest, TcpVersusShm)
+{
+  if (!transport::ShmRing::Enabled())
+  {
+    gzdbg << "Skipped test since the shared memory transport is disabled\n";
+    SUCCEED();
+    return;
+  }
+
+  const unsigned int frames = 500;
+
+  common::Time tcpTime = SendImages(false, frames);
+  common::Time shmTime = SendImages(true, frames);
+
+  gzmsg << "TCP: " << frames << " frames in " << tcpTime << " s ("
+        << frames / tcpTime.Double() << " Hz)\n";
+  gzmsg << "SHM: " << frames << " frames in " << shmTime << " s ("
+        << frames / shmTime.Double() << " Hz)\n";
+
+  // The shared memory path skips the socket copies, so it should never be
+  // slower than TCP.
+  EXPECT_LT(shmTime.Double(), tcpTime.Double());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/gazebo.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/physics.hh"
+#include "test_config.h"
+
+using namespace gazebo;
+
+/// \brief Number of steps taken by each world.
+static const unsigned int g_steps = 2000;
+
+/// \brief Number of worlds, or of processes for the baseline.
+static const unsigned int g_worldCount =
+    std::max(2u, std::thread::hardware_concurrency());
+
+/// \brief Total steps per second of the multi-process baseline.
+static double g_processStepsPerSec = 0;
+
+/////////////////////////////////////////////////
+/// \brief Get a world with boxes and mesh collisions dropped on the ground.
+/// \return The world SDF.
+std::string WorldSDF()
+{
+  const std::string mesh =
+      std::string(PROJECT_SOURCE_PATH) + "/test/data/box.dae";
+
+  std::ostringstream sdf;
+  sdf << "<?xml version='1.0' ?><sdf version='1.6'><world name='batch'>"
+      << "<physics type='ode'><max_step_size>0.001</max_step_size>"
+      << "<real_time_update_rate>0</real_time_update_rate></physics>"
+      << "<model name='ground'><static>true</static><link name='link'>"
+      << "<collision name='c'><geometry><plane><normal>0 0 1</normal>"
+      << "<size>100 100</size></plane></geometry></collision></link>"
+      << "</model>";
+  for (unsigned int i = 0; i < 25; ++i)
+  {
+    sdf << "<model name='model_" << i << "'><pose>" << (i % 5) * 1.5 << " "
+        << (i / 5) * 1.5 << " " << 0.5 + (i % 3) * 0.3 << " 0.1 0.2 0</pose>"
+        << "<link name='link'><inertial><mass>1</mass></inertial>"
+        << "<collision name='c'><geometry>";
+    if (i % 2)
+    {
+      sdf << "<mesh><uri>file://" << mesh << "</uri>"
+          << "<scale>0.5 0.5 0.5</scale></mesh>";
+    }
+    else
+    {
+      sdf << "<box><size>0.5 0.5 0.5</size></box>";
+    }
+    sdf << "</geometry></collision></link></model>";
+  }
+  sdf << "</world></sdf>";
+  return sdf.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Start a server, and load the worlds.
+/// \param[in] _count Number of copies of the world.
+/// \return The worlds.
+std::vector<physics::WorldPtr> LoadBatch(const unsigned int _count)
+{
+  std::vector<physics::WorldPtr> worlds;
+  if (!gazebo::setupServer())
+    return worlds;
+
+  sdf::SDFPtr sdf(new sdf::SDF);
+  if (!sdf::init(sdf) || !sdf::readString(WorldSDF(), sdf))
+    return worlds;
+
+  worlds = physics::create_world_batch(sdf->Root()->GetElement("world"),
+      _count, ignition::math::Rand::Seed());
+  physics::init_worlds(nullptr);
+  return worlds;
+}
+
+/////////////////////////////////////////////////
+/// \brief Run the worlds until they took g_steps steps.
+void RunBatch()
+{
+  physics::run_worlds(g_steps);
+  while (physics::worlds_running())
+    common::Time::MSleep(1);
+}
+
+/////////////////////////////////////////////////
+/// \brief Baseline: one world per process. This test forks, so it runs
+/// before anything is set up in the test process.
+TEST(WorldBatch, MultiProcess)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<pid_t> pids;
+  for (unsigned int i = 0; i < g_worldCount; ++i)
+  {
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+      // Each process needs its own master
+      const std::string uri =
+          "http://localhost:" + std::to_string(11445 + i);
+      setenv("GAZEBO_MASTER_URI", uri.c_str(), 1);
+
+      auto worlds = LoadBatch(1);
+      if (worlds.size() != 1u)
+        _exit(1);
+      RunBatch();
+      const bool done = worlds[0]->Iterations() == g_steps;
+      gazebo::shutdown();
+      _exit(done ? 0 : 1);
+    }
+    pids.push_back(pid);
+  }
+
+  for (auto const pid : pids)
+  {
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  g_processStepsPerSec = g_worldCount * g_steps / elapsed.count();
+
+  gzmsg << g_worldCount << " processes: " << elapsed.count() << " s, "
+        << g_processStepsPerSec << " steps/s\n";
+}
+
+/////////////////////////////////////////////////
+/// \brief All the worlds in this process, each on its own thread.
+TEST(WorldBatch, InProcess)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  auto worlds = LoadBatch(g_worldCount);
+  ASSERT_EQ(worlds.size(), g_worldCount);
+
+  std::chrono::duration<double> loaded =
+      std::chrono::steady_clock::now() - start;
+
+  // Each world has its own name, and so its own topic namespace, and its
+  // own seed
+  std::set<std::string> names;
+  std::set<uint32_t> seeds;
+  for (auto const &world : worlds)
+  {
+    names.insert(world->Name());
+    seeds.insert(world->Seed());
+    EXPECT_EQ(world->ModelCount(), 26u);
+  }
+  EXPECT_EQ(names.size(), g_worldCount);
+  EXPECT_EQ(seeds.size(), g_worldCount);
+  EXPECT_TRUE(physics::has_world("batch_0"));
+
+  RunBatch();
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double stepsPerSec = g_worldCount * g_steps / elapsed.count();
+
+  // The worlds are identical and independent, so they end in the same
+  // state
+  for (auto const &world : worlds)
+  {
+    EXPECT_EQ(world->Iterations(), g_steps);
+    for (auto const &model : world->Models())
+    {
+      EXPECT_GT(model->WorldPose().Pos().Z(), -0.01) << model->GetName();
+      EXPECT_EQ(model->WorldPose(),
+          worlds[0]->ModelByName(model->GetName())->WorldPose())
+          << world->Name() << "::" << model->GetName();
+    }
+  }
+
+  gzmsg << g_worldCount << " worlds in one process: " << elapsed.count()
+        << " s, including " << loaded.count() << " s to load, "
+        << stepsPerSec << " steps/s\n";
+  if (g_processStepsPerSec > 0)
+  {
+    gzmsg << "Speedup over one process per world: "
+          << stepsPerSec / g_processStepsPerSec << "\n";
+  }
+
+  gazebo::shutdown();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
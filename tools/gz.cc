@@ -16,6 +16,8 @@
 */
 #include <stdio.h>
 #include <signal.h>
+#include <algorithm>
+#include <vector>
 #include <tinyxml.h>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
@@ -853,7 +855,9 @@ StatsCommand::StatsCommand()
     ("world-name,w", po::value<std::string>(), "World name.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run.")
     ("plot,p", "Output comma-separated values, useful for processing and "
-     "plotting.");
+     "plotting.")
+    ("plugins", "Print the time spent by each plugin in its event "
+     "callbacks.");
 }
 
 /////////////////////////////////////////////////
@@ -863,6 +867,10 @@ void StatsCommand::HelpDetailed()
     "\tPrint gzserver statics to standard out. If a name for the world, \n"
     "\toption -w, is not specified, the first world found on \n"
     "\tthe Gazebo master will be used.\n"
+    "\n"
+    "\tWith --plugins, print once per second the calls per second, and \n"
+    "\tthe wall and CPU milliseconds per second spent by each plugin in \n"
+    "\tits event callbacks, slowest first.\n"
     << std::endl;
 }
 
@@ -877,8 +885,11 @@ bool StatsCommand::RunImpl()
   transport::NodePtr node(new transport::Node());
   node->Init(worldName);
 
-  transport::SubscriberPtr sub =
-    node->Subscribe("~/world_stats", &StatsCommand::CB, this);
+  transport::SubscriberPtr sub;
+  if (this->vm.count("plugins"))
+    sub = node->Subscribe("~/plugins/stats", &StatsCommand::PluginsCB, this);
+  else
+    sub = node->Subscribe("~/world_stats", &StatsCommand::CB, this);
 
   boost::mutex::scoped_lock lock(this->sigMutex);
   if (this->vm.count("duration"))
@@ -955,6 +966,90 @@ void StatsCommand::CB(ConstWorldStatisticsPtr &_msg)
         percent, simTime.Double(), realTime.Double(), paused);
 }
 
+/////////////////////////////////////////////////
+void StatsCommand::PluginsCB(ConstPluginStatsPtr &_msg)
+{
+  GZ_ASSERT(_msg, "Invalid message received");
+
+  common::Time stamp = msgs::Convert(_msg->stamp());
+  double dt = (stamp - this->prevPluginsTime).Double();
+  bool first = !this->pluginsReceived;
+
+  // Time spent by each plugin since the previous statistics
+  struct Row
+  {
+    const msgs::PluginStats::Plugin *plugin;
+    double calls;
+    double wall;
+    double cpu;
+  };
+  std::vector<Row> rows;
+
+  for (int i = 0; i < _msg->plugin_size(); ++i)
+  {
+    const msgs::PluginStats::Plugin &plugin = _msg->plugin(i);
+    auto prevIter = this->prevPlugins.find(plugin.name());
+    if (!first && dt > 0)
+    {
+      msgs::PluginStats::Plugin prev;
+      if (prevIter != this->prevPlugins.end())
+        prev = prevIter->second;
+
+      rows.push_back(Row{&plugin,
+          (plugin.calls() - prev.calls()) / dt,
+          (plugin.wall_time() - prev.wall_time()) / dt,
+          (plugin.cpu_time() - prev.cpu_time()) / dt});
+    }
+  }
+
+  std::sort(rows.begin(), rows.end(),
+      [](const Row &_a, const Row &_b) { return _a.wall > _b.wall; });
+
+  if (this->vm.count("plot"))
+  {
+    static bool header = true;
+    if (header)
+    {
+      std::cout << "# time (sec), plugin, calls per sec, "
+        << "wall (ms per sec), cpu (ms per sec), max wall (ms), "
+        << "over budget, skipped\n";
+      header = false;
+    }
+
+    for (auto const &row : rows)
+    {
+      printf("%16.6f, %s, %.2f, %.3f, %.3f, %.3f, %llu, %llu\n",
+          stamp.Double(), row.plugin->name().c_str(), row.calls,
+          row.wall * 1e3, row.cpu * 1e3, row.plugin->max_wall_time() * 1e3,
+          static_cast<unsigned long long>(row.plugin->over_budget()),
+          static_cast<unsigned long long>(row.plugin->skipped()));
+    }
+  }
+  else if (!rows.empty())
+  {
+    printf("%-48s %9s %10s %10s %10s %10s %9s %8s\n", "Plugin", "Calls/s",
+        "Wall ms/s", "CPU ms/s", "Max ms", "Budget ms", "Over", "Skipped");
+
+    for (auto const &row : rows)
+    {
+      printf("%-48s %9.2f %10.3f %10.3f %10.3f %10.3f %9llu %8llu\n",
+          row.plugin->name().c_str(), row.calls, row.wall * 1e3,
+          row.cpu * 1e3, row.plugin->max_wall_time() * 1e3,
+          row.plugin->budget() * 1e3,
+          static_cast<unsigned long long>(row.plugin->over_budget()),
+          static_cast<unsigned long long>(row.plugin->skipped()));
+    }
+    printf("\n");
+  }
+  fflush(stdout);
+
+  this->prevPlugins.clear();
+  for (int i = 0; i < _msg->plugin_size(); ++i)
+    this->prevPlugins[_msg->plugin(i).name()] = _msg->plugin(i);
+  this->prevPluginsTime = stamp;
+  this->pluginsReceived = true;
+}
+
 /////////////////////////////////////////////////
 SDFCommand::SDFCommand()
   : Command("sdf",
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <list>
+#include <map>
 #include <boost/thread.hpp>
 #include <boost/program_options.hpp>
 #include <ignition/math/Pose3.hh>
@@ -195,11 +196,25 @@ namespace gazebo
     /// \param[in] _msg World statistics message.
     private: void CB(ConstWorldStatisticsPtr &_msg);
 
+    /// \brief Plugin statistics callback.
+    /// \param[in] _msg Plugin statistics message.
+    private: void PluginsCB(ConstPluginStatsPtr &_msg);
+
     /// \brief Sim time buffer
     private: std::list<common::Time> simTimes;
 
     /// \brief Real time buffer
     private: std::list<common::Time> realTimes;
+
+    /// \brief Previous statistics of each plugin, used to compute rates.
+    private: std::map<std::string, msgs::PluginStats::Plugin> prevPlugins;
+
+    /// \brief Time of the previous plugin statistics.
+    private: common::Time prevPluginsTime;
+
+    /// \brief True once plugin statistics were received, rates are only
+    /// computed from the following ones.
+    private: bool pluginsReceived = false;
   };
 
   /// \brief SDF command
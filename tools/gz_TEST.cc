@@ -101,14 +101,14 @@ void waitForMsg(const std::string &_cmd)
 }
 
 /////////////////////////////////////////////////
-void init()
+void init(const std::string &_world = "simple_arm_test.world")
 {
   g_pid = fork();
 
   if (!g_pid)
   {
     boost::filesystem::path worldFilePath = TEST_PATH;
-    worldFilePath = worldFilePath / "worlds" / "simple_arm_test.world";
+    worldFilePath = worldFilePath / "worlds" / _world;
     if (execlp("gzserver", "gzserver", worldFilePath.string().c_str(),
         "--iters", "60000", NULL) < 0)
     {
@@ -668,6 +668,33 @@ TEST_F(gzTest, Stats)
   fini();
 }
 
+/////////////////////////////////////////////////
+TEST_F(gzTest, StatsPlugins)
+{
+  // A world with model plugins connected to the world update
+  init("lift_drag_plugin.world");
+
+  std::string helpOutput = custom_exec_str("gz help stats");
+  EXPECT_NE(helpOutput.find("--plugins"), std::string::npos);
+
+  std::string output = custom_exec_str("gz stats --plugins -d 5");
+  EXPECT_EQ(output.find("Factor["), std::string::npos);
+  EXPECT_NE(output.find("Calls/s"), std::string::npos);
+  EXPECT_NE(output.find("lift_drag_demo_model::gazebo_wing_1"),
+      std::string::npos);
+  EXPECT_NE(output.find("lift_drag_demo_model::gazebo_wing_2"),
+      std::string::npos);
+
+  // Plot option
+  output = custom_exec_str("gz stats --plugins -d 5 -p");
+  EXPECT_NE(output.find("# time (sec), plugin, calls per sec,"),
+      std::string::npos);
+  EXPECT_NE(output.find(", lift_drag_demo_model::gazebo_wing_1, "),
+      std::string::npos);
+
+  fini();
+}
+
 /////////////////////////////////////////////////
 TEST_F(gzTest, Topic)
 {
@@ -700,6 +727,11 @@ TEST_F(gzTest, Topic)
   output = custom_exec_str("gz topic -b /gazebo/default/world_stats -d 10");
   EXPECT_NE(output.find("Total["), std::string::npos);
 
+  // Stats
+  output = custom_exec_str("gz topic -s world_stats -d 4");
+  EXPECT_NE(output.find("/gazebo/default/world_stats"), std::string::npos);
+  EXPECT_EQ(output.find("/gazebo/default/pose/info"), std::string::npos);
+
   // Request
   output = custom_exec_str("gz topic -r entity_list");
   EXPECT_NE(output.find("models {"), std::string::npos);
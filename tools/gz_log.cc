@@ -14,6 +14,13 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/posix_time/posix_time_io.hpp>
@@ -25,6 +32,15 @@
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
 
+#include <tbb/pipeline.h>
+
+#include <gazebo/gazebo_config.h>
+#ifndef USE_EXTERNAL_TINYXML2
+#include <gazebo/tinyxml2.h>
+#else
+#include <tinyxml2.h>
+#endif
+
 #include <gazebo/util/util.hh>
 #include "gz_log.hh"
 
@@ -32,6 +48,99 @@ sdf::ElementPtr g_stateSdf;
 
 using namespace gazebo;
 
+namespace
+{
+  /// \brief A chunk of a log file, on its way through LogCommand::Stream.
+  struct LogChunk
+  {
+    /// \brief Sequence number among the chunks that are not skipped.
+    uint64_t seq = 0;
+
+    /// \brief True for the first chunk of the log file.
+    bool first = false;
+
+    /// \brief Encoding of the chunk.
+    std::string encoding;
+
+    /// \brief Encoded text of the chunk, owned by LogPlay.
+    const char *text = nullptr;
+
+    /// \brief Frames of the chunk. After decimation, only the frames
+    /// that are output remain, and after filtering they hold the output.
+    std::vector<std::string> frames;
+  };
+
+  /// \brief Shared pointer to a chunk.
+  using LogChunkPtr = std::shared_ptr<LogChunk>;
+
+  /// \brief Progress of the hz decimation, published for the input stage
+  /// of LogCommand::Stream.
+  struct Decimation
+  {
+    /// \brief Protects the other members.
+    std::mutex mutex;
+
+    /// \brief Number of chunks decimated so far.
+    uint64_t count = 0;
+
+    /// \brief Simulation time of the last frame output.
+    common::Time prevTime;
+  };
+
+  /// \brief Tag at the start of a frame.
+  const std::string kStartFrame = "<sdf ";
+
+  /// \brief Tag at the end of a frame.
+  const std::string kEndFrame = "</sdf>";
+
+  /// \brief Tag at the start of a simulation time.
+  const std::string kStartTime = "<sim_time>";
+
+  /// \brief Tag at the end of a simulation time.
+  const std::string kEndTime = "</sim_time>";
+
+  /////////////////////////////////////////////////
+  /// \brief Get the simulation time of a frame without parsing it.
+  /// \param[in] _frame The frame.
+  /// \return The simulation time, or zero if the frame has none.
+  common::Time FrameSimTime(const std::string &_frame)
+  {
+    common::Time result;
+
+    auto from = _frame.find(kStartTime);
+    if (from != std::string::npos)
+    {
+      std::istringstream stream(_frame.substr(from + kStartTime.size(),
+            _frame.find(kEndTime, from) - from - kStartTime.size()));
+      int32_t sec = 0;
+      int32_t nsec = 0;
+      stream >> sec >> nsec;
+      result.Set(sec, nsec);
+    }
+
+    return result;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Split decoded chunk data into frames.
+  /// \param[in] _data The decoded chunk data.
+  /// \param[out] _frames The frames.
+  void SplitFrames(const std::string &_data, std::vector<std::string> &_frames)
+  {
+    size_t pos = 0;
+    while (true)
+    {
+      auto from = _data.find(kStartFrame, pos);
+      auto to = _data.find(kEndFrame, pos);
+      if (from == std::string::npos || to == std::string::npos)
+        break;
+
+      _frames.push_back(_data.substr(from, to + kEndFrame.size() - from));
+      pos = to + kEndFrame.size();
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 FilterBase::FilterBase(bool _xmlOutput, const std::string &_stamp)
 : xmlOutput(_xmlOutput), stamp(_stamp)
@@ -167,6 +276,10 @@ void JointFilter::Init(const std::string &_filter)
 
     if (this->parts.empty())
       this->parts.push_back(_filter);
+
+    // The first element in the filter must be a joint name or a star.
+    this->regex = boost::regex(
+        boost::replace_all_copy(this->parts.front(), "*", ".*"));
   }
 }
 
@@ -234,11 +347,7 @@ std::string JointFilter::Filter(gazebo::physics::ModelState &_state)
   /// Get an iterator to the list of the command line parts.
   partIter = this->parts.begin();
 
-  // The first element in the filter must be a link name or a star.
-  std::string regexStr = *partIter;
-  boost::replace_all(regexStr, "*", ".*");
-  boost::regex regex(regexStr);
-  states = _state.GetJointStates(regex);
+  states = _state.GetJointStates(this->regex);
 
   ++partIter;
 
@@ -281,6 +390,7 @@ LinkFilter::LinkFilter(bool _xmlOutput, const std::string &_stamp)
 void LinkFilter::Init(const std::string &_filter)
 {
   this->parts.clear();
+  this->matchAll = true;
 
   if (!_filter.empty())
   {
@@ -288,6 +398,14 @@ void LinkFilter::Init(const std::string &_filter)
 
     if (this->parts.empty())
       this->parts.push_back(_filter);
+
+    // The first element in the filter must be a link name or a star.
+    if (this->parts.front() != "*")
+    {
+      this->matchAll = false;
+      this->regex = boost::regex(
+          boost::replace_all_copy(this->parts.front(), "*", ".*"));
+    }
   }
 }
 
@@ -338,14 +456,8 @@ std::string LinkFilter::Filter(gazebo::physics::ModelState &_state)
   /// Get an iterator to the list of the command line parts.
   partIter = this->parts.begin();
 
-  // The first element in the filter must be a link name or a star.
-  if (*partIter != "*")
-  {
-    std::string regexStr = *partIter;
-    boost::replace_all(regexStr, "*", ".*");
-    boost::regex regex(regexStr);
-    states = _state.GetLinkStates(regex);
-  }
+  if (!this->matchAll)
+    states = _state.GetLinkStates(this->regex);
   else
     states = _state.GetLinkStates();
 
@@ -396,6 +508,7 @@ void ModelFilter::Init(const std::string &_filter)
   this->linkFilter = NULL;
   this->jointFilter = NULL;
   this->parts.clear();
+  this->matchAll = true;
 
   if (_filter.empty())
     return;
@@ -412,6 +525,15 @@ void ModelFilter::Init(const std::string &_filter)
       this->parts.push_back(mainParts.front());
   }
 
+  // The first element in the filter must be a model name or a star.
+  if (!this->parts.empty() && !this->parts.front().empty() &&
+      this->parts.front() != "*")
+  {
+    this->matchAll = false;
+    this->regex = boost::regex(
+        boost::replace_all_copy(this->parts.front(), "*", ".*"));
+  }
+
   if (mainParts.empty())
     return;
 
@@ -467,30 +589,34 @@ std::string ModelFilter::FilterParts(gazebo::physics::ModelState &_state,
 }
 
 /////////////////////////////////////////////////
-std::string ModelFilter::Filter(gazebo::physics::WorldState &_state)
+bool ModelFilter::Match(const std::string &_name) const
 {
-  std::ostringstream result;
+  return this->matchAll || boost::regex_match(_name, this->regex);
+}
 
+/////////////////////////////////////////////////
+std::string ModelFilter::Filter(gazebo::physics::WorldState &_state)
+{
   gazebo::physics::ModelState_M states;
-  std::list<std::string>::iterator partIter = this->parts.begin();
-
-  // The first element in the filter must be a model name or a star.
-  if (partIter != this->parts.end() && !this->parts.empty() &&
-      !(*partIter).empty() && (*partIter) != "*")
-  {
-    std::string regexStr = *partIter;
-    boost::replace_all(regexStr, "*", ".*");
-    boost::regex regex(regexStr);
-    states = _state.GetModelStates(regex);
-  }
+  if (!this->matchAll)
+    states = _state.GetModelStates(this->regex);
   else
     states = _state.GetModelStates();
 
+  return this->Filter(states);
+}
+
+/////////////////////////////////////////////////
+std::string ModelFilter::Filter(gazebo::physics::ModelState_M &_states)
+{
+  std::ostringstream result;
+
+  std::list<std::string>::iterator partIter = this->parts.begin();
   ++partIter;
 
   // Filter all the model states that were found.
   for (gazebo::physics::ModelState_M::iterator iter =
-      states.begin(); iter != states.end(); ++iter)
+      _states.begin(); iter != _states.end(); ++iter)
   {
     // If no link filter, and no model parts, then output the
     // whole model state.
@@ -522,11 +648,25 @@ std::string ModelFilter::Filter(gazebo::physics::WorldState &_state)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+/// \brief Create an SDF element from a description file.
+/// \param[in] _filename Name of the description file.
+/// \return The element.
+static sdf::ElementPtr SdfPrototype(const std::string &_filename)
+{
+  sdf::ElementPtr elem(new sdf::Element);
+  sdf::initFile(_filename, elem);
+  return elem;
+}
+
 /////////////////////////////////////////////////
 StateFilter::StateFilter(bool _xmlOutput, const std::string &_stamp,
               double _hz)
 : FilterBase(_xmlOutput, _stamp), filter(_xmlOutput, _stamp),
-  hz(_hz)
+  hz(_hz),
+  stateSdf([proto = SdfPrototype("state.sdf")]() {return proto->Clone();}),
+  modelSdf([proto = SdfPrototype("model_state.sdf")]()
+      {return proto->Clone();})
 {}
 
 /////////////////////////////////////////////////
@@ -535,37 +675,163 @@ void StateFilter::Init(const std::string &_filter)
   this->filter.Init(_filter);
 }
 
+/////////////////////////////////////////////////
+double StateFilter::Hz() const
+{
+  return this->hz;
+}
+
+/////////////////////////////////////////////////
+bool StateFilter::Due(const gazebo::common::Time &_simTime,
+    const gazebo::common::Time &_prevTime) const
+{
+  return this->hz <= 0.0 || _prevTime == gazebo::common::Time::Zero ||
+    (_simTime - _prevTime).Double() >= 1.0 / this->hz;
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a time element.
+/// \param[in] _parent Parent of the element.
+/// \param[in] _name Name of the element.
+/// \return The time, or zero if the element doesn't exist.
+static gazebo::common::Time XmlTime(const tinyxml2::XMLElement *_parent,
+    const char *_name)
+{
+  gazebo::common::Time result;
+
+  auto elem = _parent->FirstChildElement(_name);
+  if (elem && elem->GetText())
+  {
+    int32_t sec = 0;
+    int32_t nsec = 0;
+    std::istringstream stream(elem->GetText());
+    stream >> sec >> nsec;
+    result.Set(sec, nsec);
+  }
+
+  return result;
+}
+
 /////////////////////////////////////////////////
 std::string StateFilter::Filter(const std::string &_stateString)
 {
+  tinyxml2::XMLDocument doc;
+  if (doc.Parse(_stateString.c_str(), _stateString.size()) !=
+      tinyxml2::XML_SUCCESS)
+  {
+    return this->FilterSdf(_stateString);
+  }
+
+  // Insertions hold whole model descriptions, which are formatted by SDF.
+  auto sdfXml = doc.FirstChildElement("sdf");
+  auto stateXml = sdfXml ? sdfXml->FirstChildElement("state") : nullptr;
+  if (!stateXml || !sdfXml->Attribute("version") ||
+      stateXml->FirstChildElement("insertions"))
+  {
+    return this->FilterSdf(_stateString);
+  }
+
   gazebo::physics::WorldState state;
+  const char *worldName = stateXml->Attribute("world_name");
+  state.SetName(worldName ? worldName : "");
+  state.SetSimTime(XmlTime(stateXml, "sim_time"));
+  state.SetWallTime(XmlTime(stateXml, "wall_time"));
+  state.SetRealTime(XmlTime(stateXml, "real_time"));
+
+  auto iterationsXml = stateXml->FirstChildElement("iterations");
+  if (iterationsXml && iterationsXml->GetText())
+  {
+    uint64_t iterations = 0;
+    std::istringstream stream(iterationsXml->GetText());
+    stream >> iterations;
+    state.SetIterations(iterations);
+  }
 
-  // Read and parse the state information
-  g_stateSdf->Clear();
-  sdf::readString(_stateString, g_stateSdf);
-  state.Load(g_stateSdf);
+  auto deletionsXml = stateXml->FirstChildElement("deletions");
+  if (deletionsXml)
+  {
+    std::vector<std::string> deletions;
+    for (auto nameXml = deletionsXml->FirstChildElement("name"); nameXml;
+        nameXml = nameXml->NextSiblingElement("name"))
+    {
+      std::string name = nameXml->GetText() ? nameXml->GetText() : "";
+      boost::trim(name);
+      deletions.push_back(name);
+    }
+    state.SetDeletions(deletions);
+  }
 
-  std::ostringstream result;
+  // Only parse the models selected by the filter.
+  const std::string sdfStart = std::string("<sdf version='") +
+    sdfXml->Attribute("version") + "'>";
+  sdf::ElementPtr modelSdfLocal = this->modelSdf.local();
 
-  if (this->hz > 0.0 && this->prevTime != gazebo::common::Time::Zero)
+  gazebo::physics::ModelState_M models;
+  for (auto modelXml = stateXml->FirstChildElement("model"); modelXml;
+      modelXml = modelXml->NextSiblingElement("model"))
   {
-    if ((state.GetSimTime() - this->prevTime).Double() <
-        1.0 / this->hz)
+    const char *name = modelXml->Attribute("name");
+    if (!name || !this->filter.Match(name) || models.count(name))
+      continue;
+
+    tinyxml2::XMLPrinter printer(nullptr, true);
+    modelXml->Accept(&printer);
+
+    modelSdfLocal->Clear();
+    if (!sdf::readString(sdfStart + printer.CStr() + "</sdf>",
+          modelSdfLocal))
     {
-      return result.str();
+      return this->FilterSdf(_stateString);
     }
+
+    gazebo::physics::ModelState modelState(modelSdfLocal);
+    modelState.SetSimTime(state.GetSimTime());
+    modelState.SetWallTime(state.GetWallTime());
+    modelState.SetRealTime(state.GetRealTime());
+    modelState.SetIterations(state.GetIterations());
+    models.insert(std::make_pair(std::string(name), modelState));
+  }
+
+  return this->Output(state, models);
+}
+
+/////////////////////////////////////////////////
+std::string StateFilter::FilterSdf(const std::string &_stateString)
+{
+  gazebo::physics::WorldState state;
+
+  // Read and parse the state information
+  sdf::ElementPtr stateSdfLocal = this->stateSdf.local();
+  stateSdfLocal->Clear();
+  sdf::readString(_stateString, stateSdfLocal);
+  state.Load(stateSdfLocal);
+
+  gazebo::physics::ModelState_M models;
+  for (auto const &model : state.GetModelStates())
+  {
+    if (this->filter.Match(model.first))
+      models.insert(model);
   }
 
+  return this->Output(state, models);
+}
+
+/////////////////////////////////////////////////
+std::string StateFilter::Output(gazebo::physics::WorldState &_state,
+    gazebo::physics::ModelState_M &_models)
+{
+  std::ostringstream result;
+
   if (this->xmlOutput)
   {
     result << "<sdf version='" << SDF_VERSION << "'>\n"
-      << "<state world_name='" << state.GetName() << "'>\n"
-      << "<sim_time>" << state.GetSimTime() << "</sim_time>\n"
-      << "<real_time>" << state.GetRealTime() << "</real_time>\n"
-      << "<wall_time>" << state.GetWallTime() << "</wall_time>\n"
-      << "<iterations>" << state.GetIterations() << "</iterations>\n";
+      << "<state world_name='" << _state.GetName() << "'>\n"
+      << "<sim_time>" << _state.GetSimTime() << "</sim_time>\n"
+      << "<real_time>" << _state.GetRealTime() << "</real_time>\n"
+      << "<wall_time>" << _state.GetWallTime() << "</wall_time>\n"
+      << "<iterations>" << _state.GetIterations() << "</iterations>\n";
 
-    auto insertions = state.Insertions();
+    auto insertions = _state.Insertions();
     if (insertions.size() > 0)
       result << "<insertions>" << std::endl;
     for (auto insertion : insertions)
@@ -573,7 +839,7 @@ std::string StateFilter::Filter(const std::string &_stateString)
     if (insertions.size() > 0)
       result << "</insertions>" << std::endl;
 
-    auto deletions = state.Deletions();
+    auto deletions = _state.Deletions();
     if (deletions.size() > 0)
       result << "<deletions>" << std::endl;
     for (auto deletion : deletions)
@@ -582,12 +848,11 @@ std::string StateFilter::Filter(const std::string &_stateString)
       result << "</deletions>" << std::endl;
   }
 
-  result << this->filter.Filter(state);
+  result << this->filter.Filter(_models);
 
   if (this->xmlOutput)
     result << "</state></sdf>\n";
 
-  this->prevTime = state.GetSimTime();
   return result.str();
 }
 
@@ -838,7 +1103,7 @@ void LogCommand::Output(const std::string &_outFilename,
     return;
   }
 
-  std::string stateString, bufferString;
+  std::string bufferString;
 
   std::string encoding = _encoding.empty() ? play->Encoding() : _encoding;
   if (encoding != "txt" && encoding != "zlib" && encoding != "bz2")
@@ -860,25 +1125,25 @@ void LogCommand::Output(const std::string &_outFilename,
   filter.Init(_filter);
 
   unsigned int i = 0;
-  while (play->Step(stateString))
-  {
-    if (i == 0 && !_raw)
-    {
-      this->OutputWriter(outFile, stateString, _raw, encoding);
-    }
-    else
-    {
-      bufferString += filter.Filter(stateString);
-
-      if (i%1000 == 0 && !bufferString.empty())
+  this->Stream(filter, _raw,
+      [&](const std::string &_frame, const bool _first)
       {
-        this->OutputWriter(outFile, bufferString, _raw, encoding);
-        bufferString.clear();
-      }
-    }
+        if (_first && !_raw)
+        {
+          this->OutputWriter(outFile, _frame, _raw, encoding);
+          return true;
+        }
 
-    ++i;
-  }
+        bufferString += _frame;
+
+        if (++i % 1000 == 0 && !bufferString.empty())
+        {
+          this->OutputWriter(outFile, bufferString, _raw, encoding);
+          bufferString.clear();
+        }
+
+        return true;
+      });
 
   if (!bufferString.empty())
     this->OutputWriter(outFile, bufferString, _raw, encoding);
@@ -897,7 +1162,6 @@ void LogCommand::Echo(const std::string &_filter, bool _raw,
     const std::string &_stamp, double _hz)
 {
   gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
-  std::string stateString;
 
   // Output the header
   if (!_raw)
@@ -906,27 +1170,22 @@ void LogCommand::Echo(const std::string &_filter, bool _raw,
   StateFilter filter(!_raw, _stamp, _hz);
   filter.Init(_filter);
 
-  unsigned int i = 0;
-  while (play->Step(stateString))
-  {
-    if (i > 0)
-      stateString = filter.Filter(stateString);
-    else if (i == 0 && _raw)
-      stateString.clear();
-
-    if (!stateString.empty())
-    {
-      if (!_raw)
-        std::cout << "<chunk encoding='txt'><![CDATA[\n";
+  this->Stream(filter, false,
+      [&](const std::string &_frame, const bool _first)
+      {
+        if (!_frame.empty() && !(_first && _raw))
+        {
+          if (!_raw)
+            std::cout << "<chunk encoding='txt'><![CDATA[\n";
 
-      std::cout << stateString;
+          std::cout << _frame;
 
-      if (!_raw)
-        std::cout << "]]></chunk>\n";
-    }
+          if (!_raw)
+            std::cout << "]]></chunk>\n";
+        }
 
-    ++i;
-  }
+        return true;
+      });
 
   if (!_raw)
     std::cout << "</gazebo_log>\n";
@@ -936,7 +1195,6 @@ void LogCommand::Echo(const std::string &_filter, bool _raw,
 void LogCommand::Step(const std::string &_filter, bool _raw,
     const std::string &_stamp, double _hz)
 {
-  std::string stateString;
   gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
 
   if (!_raw)
@@ -947,37 +1205,187 @@ void LogCommand::Step(const std::string &_filter, bool _raw,
   StateFilter filter(!_raw, _stamp, _hz);
   filter.Init(_filter);
 
-  unsigned int i = 0;
-  while (play->Step(stateString) && c != 'q')
+  this->Stream(filter, false,
+      [&](const std::string &_frame, const bool _first)
+      {
+        // Only wait for user input if there is some state to output.
+        if (!_frame.empty() && !(_first && _raw))
+        {
+          if (!_raw)
+            std::cout << "<chunk encoding='txt'><![CDATA[\n";
+          std::cout << _frame;
+
+          if (!_raw)
+            std::cout << "]]></chunk>\n";
+
+          std::cout << "\n--- Press space to continue, 'q' to quit ---\n";
+
+          c = '\0';
+
+          // Wait for a space or 'q' key press
+          while (c != ' ' && c != 'q')
+            c = this->GetChar();
+        }
+
+        return c != 'q';
+      });
+
+  if (!_raw)
+    std::cout << "</gazebo_log>\n";
+}
+
+/////////////////////////////////////////////////
+void LogCommand::Stream(StateFilter &_filter, const bool _filterFirst,
+    std::function<bool (const std::string &, const bool)> _output)
+{
+  gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
+
+  // Bound the number of chunks in memory.
+  const size_t maxChunks =
+    std::max(4u, 4 * std::thread::hardware_concurrency());
+
+  const bool decimate = _filter.Hz() > 0.0;
+  Decimation decimation;
+  std::atomic<bool> stop(false);
+
+  // State of the input stage. While known is true, prevTime is the time of
+  // the last frame output, and chunks can be skipped exactly. Otherwise a
+  // chunk whose frames are not known yet is being decimated, and
+  // decimation.prevTime is a lower bound of the time.
+  unsigned int index = 0;
+  uint64_t seq = 0;
+  uint64_t pendingCount = 0;
+  bool known = true;
+  common::Time prevTime;
+
+  // Read the encoded chunks in order, and skip the chunks that only have
+  // frames dropped by decimation.
+  auto read = [&](tbb::flow_control &_fc) -> LogChunkPtr
+  {
+    while (!stop)
+    {
+      LogChunkPtr chunk(new LogChunk);
+      if (!play->RawChunk(index, chunk->encoding, chunk->text))
+        break;
+
+      chunk->first = index == 0;
+      common::Time minTime, maxTime;
+      const bool hasTime = !chunk->first &&
+        play->ChunkSimTime(index, minTime, maxTime);
+      ++index;
+
+      if (decimate)
+      {
+        common::Time lastTime = prevTime;
+        if (!known)
+        {
+          std::lock_guard<std::mutex> lock(decimation.mutex);
+          known = decimation.count >= pendingCount;
+          lastTime = decimation.prevTime;
+          if (known)
+            prevTime = lastTime;
+        }
+
+        // All the frames are within the time range of the chunk.
+        if (hasTime && !_filter.Due(maxTime, lastTime))
+          continue;
+
+        // Only the first frame of a single time is output.
+        if (known && hasTime && minTime == maxTime)
+          prevTime = maxTime;
+        else
+        {
+          known = false;
+          pendingCount = seq + 1;
+        }
+      }
+
+      chunk->seq = seq++;
+      return chunk;
+    }
+
+    _fc.stop();
+    return LogChunkPtr();
+  };
+
+  // Decode the chunks on all cores.
+  auto decode = [&](LogChunkPtr _chunk) -> LogChunkPtr
+  {
+    std::string data;
+    if (!gazebo::util::LogPlay::DecodeChunk(_chunk->encoding, _chunk->text,
+          data))
+    {
+      std::cerr << "Invalid encoding[" << _chunk->encoding << "] in chunk.\n";
+    }
+    SplitFrames(data, _chunk->frames);
+    return _chunk;
+  };
+
+  // Apply the hz rate to the frames in order.
+  common::Time decimationTime;
+  auto decimateFrames = [&](LogChunkPtr _chunk) -> LogChunkPtr
   {
-    if (i > 0)
-      stateString = filter.Filter(stateString);
-    else if (i == 0 && _raw)
-      stateString.clear();
+    if (!decimate)
+      return _chunk;
 
-    // Only wait for user input if there is some state to output.
-    if (!stateString.empty())
+    std::vector<std::string> frames;
+    for (unsigned int i = 0; i < _chunk->frames.size(); ++i)
     {
-      if (!_raw)
-        std::cout << "<chunk encoding='txt'><![CDATA[\n";
-      std::cout << stateString;
+      // The first frame of the log describes the world.
+      if (_chunk->first && i == 0)
+      {
+        frames.push_back(std::move(_chunk->frames[i]));
+        continue;
+      }
 
-      if (!_raw)
-        std::cout << "]]></chunk>\n";
+      common::Time simTime = FrameSimTime(_chunk->frames[i]);
+      if (_filter.Due(simTime, decimationTime))
+      {
+        decimationTime = simTime;
+        frames.push_back(std::move(_chunk->frames[i]));
+      }
+    }
+    _chunk->frames.swap(frames);
 
-      std::cout << "\n--- Press space to continue, 'q' to quit ---\n";
+    std::lock_guard<std::mutex> lock(decimation.mutex);
+    decimation.count = _chunk->seq + 1;
+    decimation.prevTime = decimationTime;
 
-      c = '\0';
+    return _chunk;
+  };
 
-      // Wait for a space or 'q' key press
-      while (c != ' ' && c != 'q')
-        c = this->GetChar();
+  // Filter the frames on all cores.
+  auto filter = [&](LogChunkPtr _chunk) -> LogChunkPtr
+  {
+    for (unsigned int i = 0; i < _chunk->frames.size(); ++i)
+    {
+      if (!_chunk->first || i > 0 || _filterFirst)
+        _chunk->frames[i] = _filter.Filter(_chunk->frames[i]);
     }
-    ++i;
-  }
+    return _chunk;
+  };
 
-  if (!_raw)
-    std::cout << "</gazebo_log>\n";
+  // Output the frames in order.
+  auto output = [&](LogChunkPtr _chunk)
+  {
+    for (unsigned int i = 0; i < _chunk->frames.size() && !stop; ++i)
+    {
+      if (!_output(_chunk->frames[i], _chunk->first && i == 0))
+        stop = true;
+    }
+  };
+
+  tbb::parallel_pipeline(maxChunks,
+      tbb::make_filter<void, LogChunkPtr>(
+        tbb::filter::serial_in_order, read) &
+      tbb::make_filter<LogChunkPtr, LogChunkPtr>(
+        tbb::filter::parallel, decode) &
+      tbb::make_filter<LogChunkPtr, LogChunkPtr>(
+        tbb::filter::serial_in_order, decimateFrames) &
+      tbb::make_filter<LogChunkPtr, LogChunkPtr>(
+        tbb::filter::parallel, filter) &
+      tbb::make_filter<LogChunkPtr, void>(
+        tbb::filter::serial_in_order, output));
 }
 
 /////////////////////////////////////////////////
@@ -1074,7 +1482,9 @@ void LogCommand::OutputWriter(std::ofstream &_outFile,
 {
   if (!_raw)
   {
-    std::string buffer = "<chunk encoding='" + _encoding + "'>\n<![CDATA[";
+    std::string buffer = "<chunk encoding='" + _encoding + "'" +
+      gazebo::util::LogPlay::ChunkSimTimeAttributes(_stateString) +
+      ">\n<![CDATA[";
 
     if (_encoding == "txt")
       buffer.append(_stateString);
@@ -17,9 +17,14 @@
 #ifndef GAZEBO_TOOLS_GZLOG_HH_
 #define GAZEBO_TOOLS_GZLOG_HH_
 
+#include <functional>
 #include <string>
 #include <list>
 
+#include <boost/regex.hpp>
+#include <tbb/enumerable_thread_specific.h>
+#include <sdf/sdf.hh>
+
 #include <gazebo/physics/WorldState.hh>
 #include "gz.hh"
 
@@ -87,6 +92,9 @@ namespace gazebo
 
     /// \brief The list of filter strings.
     public: std::list<std::string> parts;
+
+    /// \brief Regular expression matching the joint names.
+    private: boost::regex regex;
   };
 
   /// \brief Filter for link state.
@@ -117,6 +125,12 @@ namespace gazebo
 
     /// \brief The list of filter strings.
     public: std::list<std::string> parts;
+
+    /// \brief True if all the links match.
+    private: bool matchAll = true;
+
+    /// \brief Regular expression matching the link names.
+    private: boost::regex regex;
   };
 
   /// \brief Filter for model state.
@@ -148,6 +162,17 @@ namespace gazebo
     /// \return Filtered string.
     public: std::string Filter(gazebo::physics::WorldState &_state);
 
+    /// \brief Filter a set of model states that were selected with
+    /// Match, and output the result as a string.
+    /// \param[in] _states The model states to filter.
+    /// \return Filtered string.
+    public: std::string Filter(gazebo::physics::ModelState_M &_states);
+
+    /// \brief Check if a model is selected by the filter.
+    /// \param[in] _name Name of the model.
+    /// \return True if the model should be filtered and output.
+    public: bool Match(const std::string &_name) const;
+
     /// \brief The list of model parts to filter.
     public: std::list<std::string> parts;
 
@@ -156,6 +181,12 @@ namespace gazebo
 
     /// \brief Pointer to the joint filter.
     public: JointFilter *jointFilter;
+
+    /// \brief True if all the models match.
+    private: bool matchAll = true;
+
+    /// \brief Regular expression matching the model names.
+    private: boost::regex regex;
   };
 
   /// \brief Filter interface for an entire state.
@@ -172,19 +203,48 @@ namespace gazebo
     /// \param[_in] _filter The filter parameters
     public: void Init(const std::string &_filter);
 
-    /// \brief Perform filtering
+    /// \brief Perform filtering. Only the models selected by the filter
+    /// are parsed, unless the state has insertions. This function can be
+    /// called from several threads at once. Use Due for hz decimation.
     /// \param[in] _stateString The string to filter.
     /// \return Filtered string
     public: std::string Filter(const std::string &_stateString);
 
+    /// \brief Check if a state is output at the hz rate of the filter.
+    /// \param[in] _simTime Simulation time of the state.
+    /// \param[in] _prevTime Simulation time of the previous state that
+    /// was output.
+    /// \return True if the state should be output.
+    public: bool Due(const gazebo::common::Time &_simTime,
+                const gazebo::common::Time &_prevTime) const;
+
+    /// \brief Get the rate at which to output states.
+    /// \return The rate in Hz, zero or negative for all states.
+    public: double Hz() const;
+
+    /// \brief Filter a state by parsing all of it as SDF.
+    /// \param[in] _stateString The string to filter.
+    /// \return Filtered string
+    private: std::string FilterSdf(const std::string &_stateString);
+
+    /// \brief Output a state and its selected models.
+    /// \param[in] _state The state.
+    /// \param[in] _models The models selected by the model filter.
+    /// \return Filtered string
+    private: std::string Output(gazebo::physics::WorldState &_state,
+                 gazebo::physics::ModelState_M &_models);
+
     /// \brief Filter for a model.
     private: ModelFilter filter;
 
     /// \brief Rate at which to output states.
     private: double hz;
 
-    /// \brief Previous time a state was output.
-    private: gazebo::common::Time prevTime;
+    /// \brief State SDF element of each thread.
+    private: tbb::enumerable_thread_specific<sdf::ElementPtr> stateSdf;
+
+    /// \brief Model state SDF element of each thread.
+    private: tbb::enumerable_thread_specific<sdf::ElementPtr> modelSdf;
   };
 
   /// \brief Log command
@@ -240,6 +300,20 @@ namespace gazebo
     private: void Step(const std::string &_filter, bool _raw,
                  const std::string &_stamp, double _hz);
 
+    /// \brief Stream the frames of the open log file through a filter.
+    /// Chunks are decoded and frames are filtered on all cores, with a
+    /// bounded number of chunks in flight, and the results are passed to
+    /// _output in log order. Chunks that only hold states dropped by the
+    /// hz rate of the filter are skipped without being decoded, when the
+    /// log records their simulation times.
+    /// \param[in] _filter The filter.
+    /// \param[in] _filterFirst True to filter the first frame, which holds
+    /// the world description, instead of passing it through.
+    /// \param[in] _output Called with each filtered frame, and true for
+    /// the first frame. Return false to stop.
+    private: void Stream(StateFilter &_filter, const bool _filterFirst,
+                 std::function<bool (const std::string &, const bool)> _output);
+
     /// \brief Start or stop logging
     /// \param[in] _start True to start logging
     private: void Record(bool _start);
@@ -24,6 +24,8 @@
 #include <sdf/sdf_config.h>
 
 #include <stdio.h>
+#include <fstream>
+#include <iterator>
 #include <string>
 
 // This header file isn't needed if shasums are used
@@ -474,6 +476,41 @@ TEST(gz_log, Output)
 #endif
 }
 
+/////////////////////////////////////////////////
+/// Check that written chunks record their simulation times, and that hz
+/// filtering skips chunks by those times with the same result.
+TEST(gz_log, OutputSimTimeRange)
+{
+  std::ostringstream newFileStream, stream;
+  newFileStream << "/tmp/__gz_log_time_test" << std::this_thread::get_id()
+    << ".log";
+
+  stream << GZ_LOG_PATH + " -f " << PROJECT_SOURCE_PATH
+    << "/test/data/pr2_state.log"
+    << " -o " << newFileStream.str() << " -n zlib";
+  custom_exec(stream.str());
+
+  std::ifstream newFile(newFileStream.str());
+  std::string contents((std::istreambuf_iterator<char>(newFile)),
+      std::istreambuf_iterator<char>());
+  EXPECT_NE(contents.find("sim_time_min='"), std::string::npos);
+  EXPECT_NE(contents.find("sim_time_max='"), std::string::npos);
+
+  std::string echo = custom_exec(
+      std::string(GZ_LOG_PATH + " -e -r -z 1.0 --filter pr2.pose.z -f ") +
+      newFileStream.str());
+  boost::trim_right(echo);
+  EXPECT_EQ("-0.000008", echo);
+
+  echo = custom_exec(
+      std::string(GZ_LOG_PATH + " -e -r --filter pr2.pose.z -f ") +
+      newFileStream.str());
+  boost::trim_right(echo);
+  EXPECT_EQ("-0.000008 \n-0.000015", echo);
+
+  std::remove(newFileStream.str().c_str());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
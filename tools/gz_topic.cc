@@ -52,11 +52,15 @@ TopicCommand::TopicCommand()
      "View topic data using a QT widget.")
     ("hz,z", po::value<std::string>(), "Get publish frequency.")
     ("bw,b", po::value<std::string>(), "Get topic bandwidth.")
+    ("stats,s", po::value<std::string>()->implicit_value(""),
+     "Get rates, bandwidth, queue high-water marks, drops and latency of "
+     "the topics of the server. An optional string only shows the topics "
+     "that contain it.")
     ("publish,p", po::value<std::string>(), "Publish message on a topic.")
     ("request,r", po::value<std::string>(), "Send a request.")
     ("unformatted,u", "Output data from echo without formatting.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run. "
-     "Applicable with echo, hz, and bw")
+     "Applicable with echo, hz, bw, and stats")
     ("msg,m", po::value<std::string>(), "Message to send on topic. "
      "Applicable with publish and request")
     ("file,f", po::value<std::string>(), "Path to a file containing the "
@@ -96,6 +100,8 @@ bool TopicCommand::RunImpl()
     this->Hz(this->vm["hz"].as<std::string>());
   else if (this->vm.count("bw"))
     this->Bw(this->vm["bw"].as<std::string>());
+  else if (this->vm.count("stats"))
+    this->Stats(this->vm["stats"].as<std::string>());
   else if (this->vm.count("view"))
     this->View(this->vm["view"].as<std::string>());
   else if (this->vm.count("publish"))
@@ -347,6 +353,82 @@ void TopicCommand::Bw(const std::string &_topic)
     this->sigCondition.wait(lock);
 }
 
+/////////////////////////////////////////////////
+void TopicCommand::StatsCB(ConstTransportStatsPtr &_msg)
+{
+  common::Time stamp = msgs::Convert(_msg->stamp());
+  double dt = (stamp - this->prevStatsTime).Double();
+  bool first = this->prevStats.empty();
+
+  if (!first && dt > 0)
+  {
+    printf("%-48s %9s %9s %10s %7s %8s %10s %10s\n", "Topic", "Out Hz",
+        "In Hz", "KB/s", "Queue", "Dropped", "p50 ms", "p99 ms");
+  }
+
+  for (int i = 0; i < _msg->topic_size(); ++i)
+  {
+    const msgs::TransportStats::Topic &topic = _msg->topic(i);
+    if (topic.name().find(this->statsFilter) == std::string::npos)
+      continue;
+
+    auto prevIter = this->prevStats.find(topic.name());
+    if (!first && dt > 0)
+    {
+      msgs::TransportStats::Topic prev;
+      if (prevIter != this->prevStats.end())
+        prev = prevIter->second;
+
+      // Latency of the messages received since the previous statistics
+      std::vector<uint64_t> latency(topic.latency_size());
+      for (int j = 0; j < topic.latency_size(); ++j)
+      {
+        latency[j] = topic.latency(j);
+        if (j < prev.latency_size())
+          latency[j] -= std::min(latency[j], prev.latency(j));
+      }
+
+      double bytes = static_cast<double>(
+          topic.bytes_out() + topic.bytes_in() -
+          prev.bytes_out() - prev.bytes_in());
+
+      printf("%-48s %9.2f %9.2f %10.2f %7llu %8llu %10.3f %10.3f\n",
+          topic.name().c_str(),
+          (topic.msgs_out() - prev.msgs_out()) / dt,
+          (topic.msgs_in() - prev.msgs_in()) / dt,
+          bytes / dt / 1024.0,
+          static_cast<unsigned long long>(topic.queue_high_water()),
+          static_cast<unsigned long long>(topic.dropped()),
+          transport::TransportStats::LatencyPercentile(latency, 0.5).Double()
+          * 1e3,
+          transport::TransportStats::LatencyPercentile(latency, 0.99).Double()
+          * 1e3);
+    }
+
+    this->prevStats[topic.name()] = topic;
+  }
+
+  if (!first && dt > 0)
+    printf("\n");
+
+  this->prevStatsTime = stamp;
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::Stats(const std::string &_filter)
+{
+  this->statsFilter = _filter;
+  transport::SubscriberPtr sub = this->node->Subscribe("~/transport/stats",
+      &TopicCommand::StatsCB, this);
+
+  boost::mutex::scoped_lock lock(this->sigMutex);
+  if (this->vm.count("duration"))
+    this->sigCondition.timed_wait(lock,
+        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+  else
+    this->sigCondition.wait(lock);
+}
+
 /////////////////////////////////////////////////
 void TopicCommand::View(const std::string &_topic)
 {
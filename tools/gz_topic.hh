@@ -17,6 +17,7 @@
 #ifndef _GZ_TOPIC_HH_
 #define _GZ_TOPIC_HH_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -72,6 +73,15 @@ namespace gazebo
     /// \param[in] _topic Topic name.
     private: void Bw(const std::string &_topic);
 
+    /// \brief Callback used by Stats() to receive transport statistics.
+    /// \param[in] _msg Transport statistics of the server.
+    private: void StatsCB(ConstTransportStatsPtr &_msg);
+
+    /// \brief Output transport statistics of the topics of the server.
+    /// \param[in] _filter Only topics that contain this string are
+    /// output. Empty outputs all the topics.
+    private: void Stats(const std::string &_filter);
+
     /// \brief View topic information using QT.
     /// \param[in] _topic Name of the topic to view. Empty will bring up
     /// a topic selector.
@@ -103,6 +113,16 @@ namespace gazebo
 
     /// \brief Buffer of message publish times, used by Bw().
     private: std::vector<common::Time> bwTime;
+
+    /// \brief Topic filter used by Stats().
+    private: std::string statsFilter;
+
+    /// \brief Previous statistics of each topic, used by Stats() to
+    /// compute rates.
+    private: std::map<std::string, msgs::TransportStats::Topic> prevStats;
+
+    /// \brief Time of the previous statistics, used by Stats().
+    private: common::Time prevStatsTime;
   };
 }
 #endif